@@ -98,6 +98,7 @@ install_build_dependencies() {
         
         # System libraries
         "libc6-dev"
+        "zlib1g-dev"
         "libstdc++-dev"
     )
     
@@ -6,9 +6,15 @@
 #include "threading/ThreadManager.h"
 #include "calibration/CalibrationManager.h"
 #include "control/OrgasmControlAlgorithm.h"
+#include "threading/ControlScheduler.h"
+#include "hardware/FluidSensor.h"
+#include "hardware/MotionSensor.h"
+#include "logging/SessionRecording.h"
 
 #include <QDebug>
+#include <QDir>
 #include <QMutexLocker>
+#include <QStandardPaths>
 #include <stdexcept>
 
 VacuumController::VacuumController(QObject *parent)
@@ -18,13 +24,14 @@ VacuumController::VacuumController(QObject *parent)
     , m_tankPressure(0.0)
     , m_maxPressure(75.0)   // 75 mmHg max (MPX5010DP sensor range)
     , m_antiDetachmentThreshold(50.0)  // Default threshold
-    , m_updateTimer(new QTimer(this))
+    , m_updateTimer(new ControlTimer(this))
     , m_initialized(false)
     , m_simulationMode(false)
+    , m_sessionRecordingDirectory(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/sessions")
 {
     // Set up update timer for real-time monitoring
     m_updateTimer->setInterval(50);  // 20Hz update rate for smooth UI
-    connect(m_updateTimer, &QTimer::timeout, this, &VacuumController::onUpdateTimer);
+    connect(m_updateTimer, &ControlTimer::timeout, this, &VacuumController::onUpdateTimer);
 }
 
 VacuumController::~VacuumController()
@@ -42,9 +49,13 @@ bool VacuumController::initialize()
         
         // Connect internal signals
         connectSignals();
+
+        // Run every periodic tick from one phase-aligned base rate
+        attachScheduledTasks();
         
         // Start monitoring timer
         m_updateTimer->start();
+        m_controlScheduler->start();
         
         setState(STOPPED);
         m_initialized = true;
@@ -68,9 +79,15 @@ void VacuumController::shutdown()
     
     // Stop all operations
     emergencyStop();
-    
+
+    // After the emergency stop, so its outputs and transitions are recorded
+    stopSessionRecording();
+
     // Stop timer
     m_updateTimer->stop();
+    if (m_controlScheduler) {
+        m_controlScheduler->stop();
+    }
     
     // Shutdown subsystems in reverse order
     if (m_threadManager) {
@@ -96,6 +113,28 @@ bool VacuumController::isSystemReady() const
            m_hardwareManager->isReady();
 }
 
+bool VacuumController::startSessionRecording(const QString& filePath)
+{
+    if (!m_sessionRecorder) {
+        qWarning() << "Cannot start session recording: controller not initialized";
+        return false;
+    }
+    if (!m_sessionRecorder->open(filePath)) {
+        emit systemError(QString("Session recording failed: %1").arg(m_sessionRecorder->lastError()));
+        return false;
+    }
+    // Outputs already in force are the starting point of the recording
+    m_hardwareManager->recordActuatorState();
+    return true;
+}
+
+void VacuumController::stopSessionRecording()
+{
+    if (m_sessionRecorder) {
+        m_sessionRecorder->close();
+    }
+}
+
 void VacuumController::startMonitoringThreads()
 {
     if (m_threadManager && !m_threadManager->areAllThreadsRunning()) {
@@ -185,6 +224,9 @@ void VacuumController::resetEmergencyStop()
 {
     if (m_systemState == EMERGENCY_STOP) {
         if (m_hardwareManager && m_hardwareManager->resetEmergencyStop()) {
+            if (m_patternEngine) {
+                m_patternEngine->invalidateAppliedOutputs();
+            }
             setState(STOPPED);
             qDebug() << "Emergency stop reset";
         } else {
@@ -228,8 +270,10 @@ void VacuumController::updateSensorReadings()
     if (!m_hardwareManager) return;
     
     try {
-        double avl = m_hardwareManager->readAVLPressure();
-        double tank = m_hardwareManager->readTankPressure();
+        // One snapshot so both readings come from the same sample
+        const SensorSnapshot snapshot = m_hardwareManager->getSensorSnapshot();
+        double avl = snapshot.avlPressure;
+        double tank = snapshot.tankPressure;
         
         {
             QMutexLocker locker(&m_dataMutex);
@@ -273,6 +317,8 @@ void VacuumController::setState(SystemState newState)
 
 void VacuumController::initializeSubsystems()
 {
+    m_controlScheduler = std::make_unique<ControlScheduler>();
+
     // Initialize hardware manager first
     m_hardwareManager = std::make_unique<HardwareManager>();
     if (!m_hardwareManager->initialize()) {
@@ -299,6 +345,29 @@ void VacuumController::initializeSubsystems()
 
     // Initialize orgasm control algorithm
     m_orgasmControlAlgorithm = std::make_unique<OrgasmControlAlgorithm>(m_hardwareManager.get());
+
+    // Arousal features run on every acquisition sample; rebind whenever the
+    // thread manager recreates the acquisition thread
+    m_orgasmControlAlgorithm->setSampleSource(m_threadManager->getDataAcquisitionThread());
+    connect(m_threadManager.get(), &ThreadManager::dataSourceChanged,
+            m_orgasmControlAlgorithm.get(), &OrgasmControlAlgorithm::setSampleSource);
+
+    // Recording stays attached; it only writes while a file is open
+    m_sessionRecorder = std::make_unique<SessionRecorder>();
+    m_hardwareManager->setSessionRecorder(m_sessionRecorder.get());
+    m_orgasmControlAlgorithm->setSessionRecorder(m_sessionRecorder.get());
+
+    // A session starts on the caller's thread, so the recording is open
+    // before the session start record is appended; a stop from the control
+    // loop is queued to this thread, keeping the file close off the loop
+    connect(m_orgasmControlAlgorithm.get(), &OrgasmControlAlgorithm::stateChanged,
+            this, [this](OrgasmControlAlgorithm::ControlState state) {
+        if (state == OrgasmControlAlgorithm::ControlState::STOPPED) {
+            stopSessionRecording();
+        } else if (!m_sessionRecorder->isOpen() && QDir().mkpath(m_sessionRecordingDirectory)) {
+            startSessionRecording(QDir(m_sessionRecordingDirectory).filePath(SessionRecorder::defaultFileName()));
+        }
+    });
 }
 
 void VacuumController::connectSignals()
@@ -318,6 +387,34 @@ void VacuumController::connectSignals()
     }
 }
 
+void VacuumController::attachScheduledTasks()
+{
+    ControlScheduler* scheduler = m_controlScheduler.get();
+
+    // Offsets spread the slower tasks over the period instead of stacking
+    // them on cycle 0. At the 100 Hz base rate the 20 Hz readings run on
+    // cycles 0 and 5, fluid on 2, the safety check and the arousal logic it
+    // guards together on 4, and the pattern safety check on 7 with the 50 Hz
+    // setpoint on odd cycles. Every-cycle tasks need no offset.
+
+    // Sense: sensor reads and the UI-facing pressure snapshot
+    if (FluidSensor* fluid = m_hardwareManager->getFluidSensor()) {
+        fluid->attachToScheduler(scheduler, FLUID_TASK_OFFSET);
+    }
+    if (MotionSensor* motion = m_hardwareManager->getMotionSensor()) {
+        motion->attachToScheduler(scheduler);
+    }
+    m_updateTimer->attach(scheduler, ControlScheduler::Stage::SENSE, "VacuumController.readings");
+
+    // Control: safety checks ahead of the arousal/pattern logic they guard
+    m_safetyManager->attachToScheduler(scheduler, SAFETY_TASK_OFFSET);
+    m_patternEngine->attachToScheduler(scheduler, PATTERN_TASK_OFFSET);
+    m_orgasmControlAlgorithm->attachToScheduler(scheduler, SAFETY_TASK_OFFSET);
+
+    // Actuate: seal maintenance
+    m_antiDetachmentMonitor->attachToScheduler(scheduler);
+}
+
 void VacuumController::setSimulationMode(bool enabled)
 {
     m_simulationMode = enabled;
@@ -15,6 +15,9 @@ class AntiDetachmentMonitor;
 class ThreadManager;
 class CalibrationManager;
 class OrgasmControlAlgorithm;
+class ControlScheduler;
+class ControlTimer;
+class SessionRecorder;
 
 /**
  * @brief Main controller class for the vacuum therapy system
@@ -55,6 +58,17 @@ public:
     ThreadManager* getThreadManager() const { return m_threadManager.get(); }
     CalibrationManager* getCalibrationManager() const { return m_calibrationManager.get(); }
     OrgasmControlAlgorithm* getOrgasmControlAlgorithm() const { return m_orgasmControlAlgorithm.get(); }
+    ControlScheduler* getControlScheduler() const { return m_controlScheduler.get(); }
+    SessionRecorder* getSessionRecorder() const { return m_sessionRecorder.get(); }
+
+    // Session recording: sensor snapshots, actuator outputs, arousal
+    // estimates and state transitions into one memory-mapped file. Every
+    // control session is recorded into the recording directory unless a
+    // recording is already open; the recording ends with the session.
+    bool startSessionRecording(const QString& filePath);
+    void stopSessionRecording();
+    void setSessionRecordingDirectory(const QString& directory) { m_sessionRecordingDirectory = directory; }
+    QString getSessionRecordingDirectory() const { return m_sessionRecordingDirectory; }
 
     // Simulation mode for testing
     void setSimulationMode(bool enabled);
@@ -103,6 +117,15 @@ private:
     void setState(SystemState newState);
     void initializeSubsystems();
     void connectSignals();
+    void attachScheduledTasks();
+
+    // Shared cyclic executive; declared first so it outlives every subsystem
+    // whose periodic tasks it runs
+    std::unique_ptr<ControlScheduler> m_controlScheduler;
+
+    // Attached to the hardware manager and the control algorithm for their
+    // whole lifetime, so it is declared before them as well
+    std::unique_ptr<SessionRecorder> m_sessionRecorder;
 
     // Subsystem managers
     std::unique_ptr<HardwareManager> m_hardwareManager;
@@ -127,12 +150,18 @@ private:
     double m_antiDetachmentThreshold;  // Anti-detachment activation threshold
     
     // Update timer for real-time monitoring
-    QTimer* m_updateTimer;
+    ControlTimer* m_updateTimer;
     
     // System status
     bool m_initialized;
     bool m_simulationMode;
     QString m_lastError;
+    QString m_sessionRecordingDirectory;
+
+    // Scheduler cycle offsets for the slower periodic tasks
+    static const int FLUID_TASK_OFFSET = 2;
+    static const int SAFETY_TASK_OFFSET = 4;    // Also the control algorithm it guards
+    static const int PATTERN_TASK_OFFSET = 7;
 };
 
 #endif // VACUUMCONTROLLER_H
@@ -0,0 +1,167 @@
+#include "ArousalFeatureExtractor.h"
+#include <algorithm>
+#include <cmath>
+
+ArousalFeatureExtractor::ArousalFeatureExtractor(double sampleRateHz, int varianceWindowSamples)
+    : m_sampleRateHz(0.0)
+    , m_windowSize(0)
+    , m_sampleCount(0)
+    , m_windowPos(0)
+    , m_mean(0.0)
+    , m_m2(0.0)
+    , m_samplesSinceResum(0)
+    , m_b0(0.0), m_b2(0.0), m_a1(0.0), m_a2(0.0)
+    , m_x1(0.0), m_x2(0.0), m_y1(0.0), m_y2(0.0)
+    , m_powerAlpha(0.0)
+    , m_bandPower(0.0)
+    , m_derivativeSpan(1)
+    , m_recentPos(0)
+    , m_lastTimestampNs(0)
+    , m_intervalEwmaNs(0.0)
+{
+    configure(sampleRateHz, varianceWindowSamples);
+}
+
+void ArousalFeatureExtractor::configure(double sampleRateHz, int varianceWindowSamples, double fillValue)
+{
+    // The band must stay below Nyquist; 2.5 Hz is the lowest usable rate
+    m_sampleRateHz = std::max(sampleRateHz, 2.5 * CONTRACTION_BAND_HIGH_HZ);
+    m_windowSize = std::max(2, varianceWindowSamples);
+    m_window.assign(static_cast<size_t>(m_windowSize), fillValue);
+
+    updateBandPassCoefficients();
+    m_powerAlpha = 1.0 - std::exp(-1.0 / (BAND_POWER_TIME_CONSTANT_S * m_sampleRateHz));
+
+    m_derivativeSpan = std::max(1, static_cast<int>(std::lround(DERIVATIVE_SPAN_S * m_sampleRateHz)));
+    m_recent.assign(static_cast<size_t>(m_derivativeSpan + 1), fillValue);
+    m_recentNs.assign(static_cast<size_t>(m_derivativeSpan + 1), 0);
+
+    reset(fillValue);
+}
+
+void ArousalFeatureExtractor::updateBandPassCoefficients()
+{
+    // Center on the geometric mean of the band, bandwidth = band width
+    const double centerHz = std::sqrt(CONTRACTION_BAND_LOW_HZ * CONTRACTION_BAND_HIGH_HZ);
+    const double q = centerHz / (CONTRACTION_BAND_HIGH_HZ - CONTRACTION_BAND_LOW_HZ);
+    const double w0 = 2.0 * M_PI * centerHz / m_sampleRateHz;
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+
+    m_b0 = alpha / a0;
+    m_b2 = -alpha / a0;     // b1 = 0
+    m_a1 = -2.0 * std::cos(w0) / a0;
+    m_a2 = (1.0 - alpha) / a0;
+}
+
+void ArousalFeatureExtractor::reset(double fillValue)
+{
+    std::fill(m_window.begin(), m_window.end(), fillValue);
+    m_windowPos = 0;
+    m_mean = fillValue;
+    m_m2 = 0.0;
+    m_samplesSinceResum = 0;
+
+    // Steady state for a constant input: band-pass output is zero
+    m_x1 = m_x2 = fillValue;
+    m_y1 = m_y2 = 0.0;
+    m_bandPower = 0.0;
+
+    std::fill(m_recent.begin(), m_recent.end(), fillValue);
+    std::fill(m_recentNs.begin(), m_recentNs.end(), int64_t(0));
+    m_recentPos = 0;
+
+    m_lastTimestampNs = 0;
+    m_intervalEwmaNs = 0.0;
+
+    m_sampleCount = 0;
+}
+
+void ArousalFeatureExtractor::addSample(double value, int64_t timestampNs)
+{
+    if (m_lastTimestampNs > 0 && timestampNs > m_lastTimestampNs) {
+        const double intervalNs = static_cast<double>(timestampNs - m_lastTimestampNs);
+        m_intervalEwmaNs = (m_intervalEwmaNs > 0.0)
+                           ? m_intervalEwmaNs + INTERVAL_EWMA_ALPHA * (intervalNs - m_intervalEwmaNs)
+                           : intervalNs;
+    }
+    m_lastTimestampNs = timestampNs;
+
+    addSample(value);
+    m_recentNs[static_cast<size_t>(m_recentPos)] = timestampNs;
+}
+
+void ArousalFeatureExtractor::addSample(double value)
+{
+    // Sliding variance: replace the oldest window value
+    const double oldest = m_window[static_cast<size_t>(m_windowPos)];
+    m_window[static_cast<size_t>(m_windowPos)] = value;
+    m_windowPos = (m_windowPos + 1) % m_windowSize;
+
+    const double oldMean = m_mean;
+    m_mean += (value - oldest) / m_windowSize;
+    m_m2 += (value - oldest) * (value - m_mean + oldest - oldMean);
+
+    if (++m_samplesSinceResum >= m_windowSize) {
+        resumWindow();
+    }
+
+    // Band-pass and exponentially weighted mean square
+    const double y = m_b0 * value + m_b2 * m_x2 - m_a1 * m_y1 - m_a2 * m_y2;
+    m_x2 = m_x1;
+    m_x1 = value;
+    m_y2 = m_y1;
+    m_y1 = y;
+    m_bandPower += m_powerAlpha * (y * y - m_bandPower);
+
+    // Derivative ring
+    m_recentPos = (m_recentPos + 1) % (m_derivativeSpan + 1);
+    m_recent[static_cast<size_t>(m_recentPos)] = value;
+    m_recentNs[static_cast<size_t>(m_recentPos)] = 0;
+
+    m_sampleCount++;
+}
+
+void ArousalFeatureExtractor::resumWindow()
+{
+    // Exact two-pass recomputation, amortized O(1) per sample
+    double sum = 0.0;
+    for (double v : m_window) {
+        sum += v;
+    }
+    m_mean = sum / m_windowSize;
+
+    double m2 = 0.0;
+    for (double v : m_window) {
+        m2 += (v - m_mean) * (v - m_mean);
+    }
+    m_m2 = m2;
+    m_samplesSinceResum = 0;
+}
+
+double ArousalFeatureExtractor::variance() const
+{
+    return std::max(0.0, m_m2 / m_windowSize);
+}
+
+double ArousalFeatureExtractor::derivativePerSecond() const
+{
+    // Newest minus the sample m_derivativeSpan steps back
+    const size_t newestPos = static_cast<size_t>(m_recentPos);
+    const size_t oldestPos = static_cast<size_t>((m_recentPos + 1) % (m_derivativeSpan + 1));
+    const double rise = m_recent[newestPos] - m_recent[oldestPos];
+
+    // Real elapsed time when both endpoints are timestamped (robust to jitter
+    // and dropped samples), nominal sample spacing otherwise
+    const int64_t newestNs = m_recentNs[newestPos];
+    const int64_t oldestNs = m_recentNs[oldestPos];
+    if (newestNs > 0 && oldestNs > 0 && newestNs > oldestNs) {
+        return rise / (static_cast<double>(newestNs - oldestNs) * 1e-9);
+    }
+    return rise / m_derivativeSpan * m_sampleRateHz;
+}
+
+double ArousalFeatureExtractor::measuredSampleRateHz() const
+{
+    return m_intervalEwmaNs > 0.0 ? 1e9 / m_intervalEwmaNs : 0.0;
+}
@@ -0,0 +1,89 @@
+#ifndef AROUSALFEATUREEXTRACTOR_H
+#define AROUSALFEATUREEXTRACTOR_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Streaming pressure features for arousal estimation
+ *
+ * Every feature is updated in O(1) per sample, so the arousal estimate can
+ * run at the acquisition rate instead of re-scanning a history window each
+ * tick:
+ *  - variance: population variance over a sliding window (sliding Welford
+ *    update; the window is re-summed exactly once per window length to
+ *    keep rounding drift bounded)
+ *  - contraction power: mean-square output of a band-pass biquad centered
+ *    in the 0.8-1.2 Hz orgasmic contraction band, averaged over ~2 s
+ *  - derivative: slope across the last DERIVATIVE_SPAN_S seconds (as a
+ *    sample count at the configured rate), in units per second (from
+ *    sample timestamps when given)
+ *
+ * Filter coefficients follow the configured sample rate. When samples carry
+ * timestamps the actual arrival rate is tracked (measuredSampleRateHz()) so
+ * the owner can reconfigure if the source rate changes. Qt-free; not
+ * thread-safe (owned by the arousal loop).
+ */
+class ArousalFeatureExtractor
+{
+public:
+    ArousalFeatureExtractor(double sampleRateHz, int varianceWindowSamples);
+
+    // Changing the rate or window resets all state to the given level
+    void configure(double sampleRateHz, int varianceWindowSamples, double fillValue = 0.0);
+
+    // Start from a steady signal at this level (e.g. calibrated baseline)
+    void reset(double fillValue);
+
+    void addSample(double value);
+    void addSample(double value, int64_t timestampNs);
+
+    double variance() const;
+    double contractionPower() const { return m_bandPower; }
+    double derivativePerSecond() const;
+
+    double sampleRateHz() const { return m_sampleRateHz; }
+    int varianceWindowSamples() const { return m_windowSize; }
+    int derivativeSpanSamples() const { return m_derivativeSpan; }
+    uint64_t sampleCount() const { return m_sampleCount; }
+    double measuredSampleRateHz() const;   // 0 until two timestamped samples arrived
+
+    static constexpr double CONTRACTION_BAND_LOW_HZ = 0.8;
+    static constexpr double CONTRACTION_BAND_HIGH_HZ = 1.2;
+    static constexpr double BAND_POWER_TIME_CONSTANT_S = 2.0;   // ~2 contraction periods
+    static constexpr double DERIVATIVE_SPAN_S = 0.4;            // Time between slope endpoints
+    static constexpr double INTERVAL_EWMA_ALPHA = 0.05;
+
+private:
+    void updateBandPassCoefficients();
+    void resumWindow();
+
+    double m_sampleRateHz;
+    int m_windowSize;
+    uint64_t m_sampleCount;
+
+    // Sliding variance window
+    std::vector<double> m_window;
+    int m_windowPos;
+    double m_mean;
+    double m_m2;
+    int m_samplesSinceResum;
+
+    // Band-pass biquad (RBJ, 0 dB peak gain) and mean-square integrator
+    double m_b0, m_b2, m_a1, m_a2;
+    double m_x1, m_x2, m_y1, m_y2;
+    double m_powerAlpha;
+    double m_bandPower;
+
+    // Derivative history: last m_derivativeSpan + 1 samples
+    int m_derivativeSpan;
+    std::vector<double> m_recent;
+    std::vector<int64_t> m_recentNs;            // 0 = no timestamp
+    int m_recentPos;
+
+    // Arrival interval estimate
+    int64_t m_lastTimestampNs;
+    double m_intervalEwmaNs;
+};
+
+#endif // AROUSALFEATUREEXTRACTOR_H
@@ -5,6 +5,9 @@
 #include "../hardware/TENSController.h"
 #include "../hardware/HeartRateSensor.h"
 #include "../hardware/FluidSensor.h"
+#include "../performance/HotPathTrace.h"
+#include "../threading/SampleBatchSubscriber.h"
+#include "../logging/SessionRecording.h"
 #include <QDebug>
 #include <QThread>
 #include <algorithm>
@@ -21,8 +24,9 @@ OrgasmControlAlgorithm::OrgasmControlAlgorithm(HardwareManager* hardware, QObjec
     , m_tensController(hardware ? hardware->getTENSController() : nullptr)
     , m_heartRateSensor(nullptr)
     , m_fluidSensor(hardware ? hardware->getFluidSensor() : nullptr)
-    , m_updateTimer(new QTimer(this))
-    , m_safetyTimer(new QTimer(this))
+    , m_updateTimer(new ControlTimer(this))
+    , m_safetyTimer(new ControlTimer(this))
+    , m_sessionRecorder(nullptr)
     , m_state(ControlState::STOPPED)
     , m_mode(Mode::MANUAL)
     , m_emergencyStop(false)
@@ -39,6 +43,11 @@ OrgasmControlAlgorithm::OrgasmControlAlgorithm(HardwareManager* hardware, QObjec
     , m_baselineClitoral(0.0)
     , m_baselineAVL(0.0)
     , m_historyIndex(0)
+    , m_pressureFeatures(1000.0 / UPDATE_INTERVAL_MS, qRound(VARIANCE_WINDOW_S * 1000.0 / UPDATE_INTERVAL_MS))
+    , m_sampleSubscriber(nullptr)
+    , m_latestClitoral(0.0)
+    , m_latestAVL(0.0)
+    , m_lastStreamSampleNs(0)
     , m_currentHeartRate(0)
     , m_baselineHeartRate(70)
     , m_heartRateContribution(0.0)
@@ -94,21 +103,18 @@ OrgasmControlAlgorithm::OrgasmControlAlgorithm(HardwareManager* hardware, QObjec
     , m_milkingTargetArousal(MILKING_TARGET_AROUSAL)
 {
     // Initialize history buffers
-    m_pressureHistory.resize(HISTORY_SIZE);
-    m_pressureHistory.fill(0.0);
     m_arousalHistory.resize(HISTORY_SIZE);
     m_arousalHistory.fill(0.0);
 
-    // Bug #2 fix: Initialize QElapsedTimers to a known state
-    // QElapsedTimer::elapsed() returns undefined values if start() was never called
+    // Bug #2 fix: Initialize session timers to a known state
     // Using invalidate() puts them in "not started" state; isValid() returns false
     m_sessionTimer.invalidate();
     m_stateTimer.invalidate();
     m_resealTimer.invalidate();
 
     // Connect timers
-    connect(m_updateTimer, &QTimer::timeout, this, &OrgasmControlAlgorithm::onUpdateTick);
-    connect(m_safetyTimer, &QTimer::timeout, this, &OrgasmControlAlgorithm::onSafetyCheck);
+    connect(m_updateTimer, &ControlTimer::timeout, this, &OrgasmControlAlgorithm::onUpdateTick);
+    connect(m_safetyTimer, &ControlTimer::timeout, this, &OrgasmControlAlgorithm::onSafetyCheck);
 
     // Connect fluid sensor signals if available
     if (m_fluidSensor && m_fluidSensor->isReady()) {
@@ -160,15 +166,22 @@ OrgasmControlAlgorithm::~OrgasmControlAlgorithm()
     stop();
 }
 
+void OrgasmControlAlgorithm::attachToScheduler(ControlScheduler* scheduler, int offset)
+{
+    // Safety check runs ahead of the update, in the same cycle of the control stage
+    m_safetyTimer->attach(scheduler, ControlScheduler::Stage::CONTROL, "OrgasmControl.safety", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+    m_updateTimer->attach(scheduler, ControlScheduler::Stage::CONTROL, "OrgasmControl.update", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+}
+
 // ============================================================================
 // Control Methods
 // ============================================================================
 
-void OrgasmControlAlgorithm::startAdaptiveEdgingInternal(int targetCycles)
+bool OrgasmControlAlgorithm::startAdaptiveEdgingInternal(int targetCycles)
 {
     if (m_state != ControlState::STOPPED) {
         qWarning() << "Cannot start: algorithm already running";
-        return;
+        return false;
     }
 
     // Reset all session state
@@ -186,12 +199,15 @@ void OrgasmControlAlgorithm::startAdaptiveEdgingInternal(int targetCycles)
     startSessionTimers();
 
     qDebug() << "Started Adaptive Edging with target cycles:" << targetCycles;
+    return true;
 }
 
 void OrgasmControlAlgorithm::startAdaptiveEdging(int targetCycles)
 {
     QMutexLocker locker(&m_mutex);
-    startAdaptiveEdgingInternal(targetCycles);
+    if (startAdaptiveEdgingInternal(targetCycles)) {
+        recordSessionStart();
+    }
 }
 
 void OrgasmControlAlgorithm::startForcedOrgasm(int targetOrgasms, int maxDurationMs)
@@ -221,6 +237,7 @@ void OrgasmControlAlgorithm::startForcedOrgasm(int targetOrgasms, int maxDuratio
 
     qDebug() << "Started Forced Orgasm with target:" << targetOrgasms
              << "max duration:" << maxDurationMs << "ms";
+    recordSessionStart();
 }
 
 void OrgasmControlAlgorithm::startDenial(int durationMs)
@@ -231,7 +248,9 @@ void OrgasmControlAlgorithm::startDenial(int durationMs)
     // which would otherwise overwrite it with ADAPTIVE_EDGING
 
     // Use edging logic but never allow release
-    startAdaptiveEdgingInternal(999);  // Very high target - duration is the limit
+    if (!startAdaptiveEdgingInternal(999)) {  // Very high target - duration is the limit
+        return;
+    }
 
     // Bug #7 fix: Denial-specific initialization AFTER base edging initialization
     // Set denial mode and duration AFTER initialization
@@ -246,19 +265,22 @@ void OrgasmControlAlgorithm::startDenial(int durationMs)
     m_pointOfNoReturnReached = false;
 
     setMode(Mode::DENIAL);
+    recordSessionStart();
 }
 
 void OrgasmControlAlgorithm::startMilking(int durationMs, int failureMode)
 {
     QMutexLocker locker(&m_mutex);
-    startMilkingInternal(durationMs, failureMode);
+    if (startMilkingInternal(durationMs, failureMode)) {
+        recordSessionStart();
+    }
 }
 
-void OrgasmControlAlgorithm::startMilkingInternal(int durationMs, int failureMode)
+bool OrgasmControlAlgorithm::startMilkingInternal(int durationMs, int failureMode)
 {
     if (m_state != ControlState::STOPPED) {
         qWarning() << "Cannot start milking: algorithm already running";
-        return;
+        return false;
     }
 
     qDebug() << "Starting milking session:" << durationMs << "ms, failure mode:" << failureMode;
@@ -284,12 +306,17 @@ void OrgasmControlAlgorithm::startMilkingInternal(int durationMs, int failureMod
 
     // Start session timers (consolidated from duplicate code)
     startSessionTimers();
+    return true;
 }
 
 void OrgasmControlAlgorithm::stop()
 {
     QMutexLocker locker(&m_mutex);
+    stopInternal();
+}
 
+void OrgasmControlAlgorithm::stopInternal()
+{
     m_updateTimer->stop();
     m_safetyTimer->stop();
 
@@ -458,6 +485,11 @@ void OrgasmControlAlgorithm::setHeartRateSensor(HeartRateSensor* sensor)
         m_heartRateEnabled = false;
         m_heartRateWeight = 0.0;
     }
+
+    // Acquisition snapshots (and so the sensor log) carry the heart rate too
+    if (m_hardware) {
+        m_hardware->setHeartRateSensor(sensor);
+    }
 }
 
 void OrgasmControlAlgorithm::setHeartRateEnabled(bool enabled)
@@ -501,8 +533,9 @@ void OrgasmControlAlgorithm::onUpdateTick()
                 if (m_hardware) {
                     // Bug #12 fix: Only accumulate valid pressure readings
                     // MEDIUM-3 fix: Use class-level constants instead of local static constexpr
-                    double clitoralReading = m_hardware->readClitoralPressure();
-                    double avlReading = m_hardware->readAVLPressure();
+                    const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+                    double clitoralReading = snapshot.clitoralPressure;
+                    double avlReading = snapshot.avlPressure;
 
                     // Only include valid readings in calibration
                     if (clitoralReading >= SafetyConstants::MIN_VALID_PRESSURE && clitoralReading <= PRESSURE_MAX_VALID_CONTROL &&
@@ -540,8 +573,8 @@ void OrgasmControlAlgorithm::onUpdateTick()
                     break;
                 }
 
-                std::fill(m_pressureHistory.begin(), m_pressureHistory.end(), m_baselineClitoral);
                 m_historyIndex.store(0, std::memory_order_release);  // Bug #1 fix: atomic store
+                m_pressureFeatures.reset(m_baselineClitoral);
                 qDebug() << "Baseline calibrated: Clitoral=" << m_baselineClitoral
                          << "mmHg, AVL=" << m_baselineAVL << "mmHg"
                          << "samples:" << m_calibSamples;
@@ -604,7 +637,7 @@ void OrgasmControlAlgorithm::onUpdateTick()
                     m_tensController->setAmplitude(m_intensity * 50.0);
                 }
             } else {
-                stop(); // Cooldown finished
+                stopInternal(); // Cooldown finished (m_mutex is held)
             }
             break;
         }
@@ -615,6 +648,8 @@ void OrgasmControlAlgorithm::onUpdateTick()
             // Do nothing
             break;
     }
+
+    recordArousal();
 }
 
 void OrgasmControlAlgorithm::onSafetyCheck()
@@ -629,16 +664,13 @@ void OrgasmControlAlgorithm::onSafetyCheck()
 
 void OrgasmControlAlgorithm::updateArousalLevel()
 {
-    // Bug #3 fix: Load index ONCE at cycle start, pass to all functions
-    // This prevents race condition where pressure and arousal histories
-    // could be written with different indices
+    // Bug #3 fix: Load index ONCE at cycle start
     int currentIdx = m_historyIndex.load(std::memory_order_acquire);
 
-    // Pass index to calculateArousalLevel - it will use this for pressure history
-    double newArousal = calculateArousalLevel(currentIdx);
+    double newArousal = calculateArousalLevel();
 
-    // Write arousal history with SAME index used for pressure history
     m_arousalHistory[currentIdx] = newArousal;
+    VC_TRACE(HotPathTrace::CONTROL, HotPathTrace::LEVEL_VERBOSE, "arousal.update", currentIdx, newArousal);
 
     // Advance index ONCE at cycle end
     m_historyIndex.store((currentIdx + 1) % HISTORY_SIZE, std::memory_order_release);
@@ -650,6 +682,8 @@ void OrgasmControlAlgorithm::updateArousalLevel()
     ArousalState newState = m_arousalState.load(std::memory_order_acquire);
 
     if (newState != oldState) {
+        recordTransition(SessionRecording::TransitionRecord::AROUSAL_STATE,
+                         static_cast<int>(oldState), static_cast<int>(newState));
         emit arousalStateChanged(newState);
     }
 
@@ -664,33 +698,119 @@ void OrgasmControlAlgorithm::updateArousalLevel()
     }
 }
 
-double OrgasmControlAlgorithm::calculateArousalLevel(int currentIdx)
+void OrgasmControlAlgorithm::setSampleSource(DataAcquisitionThread* source)
 {
-    if (!m_hardware) return 0.0;
+    QMutexLocker locker(&m_mutex);
 
-    // Bug #12 fix: Read pressure values (units: mmHg, range: 0-75 mmHg for MPX5010DP)
-    // Returns -1.0 on sensor error - must validate before use
-    double currentClitoral = m_hardware->readClitoralPressure();
-    double currentAVL = m_hardware->readAVLPressure();
+    delete m_sampleSubscriber;
+    m_sampleSubscriber = nullptr;
+    m_lastStreamSampleNs.store(0, std::memory_order_relaxed);
 
-    // Bug #12 fix: Validate sensor readings
-    // Negative values indicate sensor error; use previous value or baseline
-    // Use SafetyConstants::MIN_VALID_PRESSURE and PRESSURE_MAX_VALID_CONTROL (stricter limit for control)
-    if (currentClitoral < SafetyConstants::MIN_VALID_PRESSURE || currentClitoral > PRESSURE_MAX_VALID_CONTROL) {
-        qWarning() << "Invalid clitoral pressure reading:" << currentClitoral << "mmHg - using baseline";
-        currentClitoral = m_baselineClitoral > 0.0 ? m_baselineClitoral : 0.0;
+    if (!source) {
+        const double pollHz = 1000.0 / UPDATE_INTERVAL_MS;
+        m_pressureFeatures.configure(pollHz, qRound(VARIANCE_WINDOW_S * pollHz), m_latestClitoral);
+        qDebug() << "Arousal features: no sample stream, polling at" << pollHz << "Hz";
+        return;
     }
-    if (currentAVL < SafetyConstants::MIN_VALID_PRESSURE || currentAVL > PRESSURE_MAX_VALID_CONTROL) {
-        qWarning() << "Invalid AVL pressure reading:" << currentAVL << "mmHg - using baseline";
-        currentAVL = m_baselineAVL > 0.0 ? m_baselineAVL : 0.0;
+
+    const double streamHz = source->getSamplingRate();
+    m_pressureFeatures.configure(streamHz, qRound(VARIANCE_WINDOW_S * streamHz), m_latestClitoral);
+
+    // Deliver in batches of ~STREAM_BATCH_LATENCY_MS worth of samples
+    const int batchSize = qMax(1, source->getSamplingRate() * STREAM_BATCH_LATENCY_MS / 1000);
+    m_sampleSubscriber = new SampleBatchSubscriber(source, batchSize, STREAM_BATCH_LATENCY_MS, this);
+    if (!m_sampleSubscriber->isSubscribed()) {
+        qWarning() << "Arousal features: could not subscribe to acquisition stream - polling instead";
+        delete m_sampleSubscriber;
+        m_sampleSubscriber = nullptr;
+        return;
     }
 
-    // Bug #3 fix: Use passed currentIdx - DO NOT reload m_historyIndex here!
-    // The caller (updateArousalLevel) loads the index once and passes it to ensure
-    // consistent index usage across pressure history, arousal history, and all helper functions
+    m_sampleSubscriber->setHandler([this](const DataAcquisitionThread::SensorData* samples, int count) {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < count; ++i) {
+            const DataAcquisitionThread::SensorData& sample = samples[i];
+
+            // Out-of-range samples are dropped here; the polled fallback
+            // substitutes the baseline instead, which at acquisition rate
+            // would flood the log
+            if (!sample.valid || sample.monotonicNs <= 0 ||
+                sample.clitoralPressure < SafetyConstants::MIN_VALID_PRESSURE ||
+                sample.clitoralPressure > PRESSURE_MAX_VALID_CONTROL ||
+                sample.avlPressure < SafetyConstants::MIN_VALID_PRESSURE ||
+                sample.avlPressure > PRESSURE_MAX_VALID_CONTROL) {
+                continue;
+            }
+            addPressureSample(sample.clitoralPressure, sample.avlPressure, sample.monotonicNs);
+            m_lastStreamSampleNs.store(sample.monotonicNs, std::memory_order_relaxed);
+        }
+    });
 
-    // Store in pressure history (validated values only)
-    m_pressureHistory[currentIdx] = currentClitoral;
+    qDebug() << "Arousal features fed from acquisition stream at" << source->getSamplingRate() << "Hz";
+}
+
+bool OrgasmControlAlgorithm::isStreamFed() const
+{
+    // Cleared whenever the subscriber is replaced, so no need to look at it
+    const qint64 lastSampleNs = m_lastStreamSampleNs.load(std::memory_order_relaxed);
+    if (lastSampleNs <= 0) {
+        return false;
+    }
+    const qint64 ageNs = nowNs() - lastSampleNs;
+    return ageNs < static_cast<qint64>(STREAM_STALE_MS) * 1000000;
+}
+
+void OrgasmControlAlgorithm::addPressureSample(double clitoral, double avl, qint64 monotonicNs)
+{
+    m_pressureFeatures.addSample(clitoral, monotonicNs);
+    m_latestClitoral = clitoral;
+    m_latestAVL = avl;
+
+    // Keep filter coefficients matched to the rate samples actually arrive
+    // at (stream vs. polled fallback, or a changed acquisition rate)
+    const uint64_t count = m_pressureFeatures.sampleCount();
+    if (count >= RATE_CHECK_INTERVAL_SAMPLES && count % RATE_CHECK_INTERVAL_SAMPLES == 0) {
+        const double configuredHz = m_pressureFeatures.sampleRateHz();
+        const double measuredHz = m_pressureFeatures.measuredSampleRateHz();
+        if (measuredHz > 0.0 && qAbs(measuredHz - configuredHz) > RATE_RETUNE_TOLERANCE * configuredHz) {
+            qDebug() << "Arousal features: sample rate" << configuredHz << "->" << measuredHz << "Hz";
+            m_pressureFeatures.configure(measuredHz, qRound(VARIANCE_WINDOW_S * measuredHz), clitoral);
+        }
+    }
+}
+
+double OrgasmControlAlgorithm::calculateArousalLevel()
+{
+    if (!m_hardware) return 0.0;
+
+    if (!isStreamFed()) {
+        // Bug #12 fix: Read pressure values (units: mmHg, range: 0-75 mmHg for MPX5010DP)
+        // Returns -1.0 on sensor error - must validate before use
+        // Both channels come from the same acquisition snapshot so the features
+        // below are computed from one coherent sample.
+        const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+        double polledClitoral = snapshot.clitoralPressure;
+        double polledAVL = snapshot.avlPressure;
+
+        // Bug #12 fix: Validate sensor readings
+        // Negative values indicate sensor error; use previous value or baseline
+        // Use SafetyConstants::MIN_VALID_PRESSURE and PRESSURE_MAX_VALID_CONTROL (stricter limit for control)
+        if (polledClitoral < SafetyConstants::MIN_VALID_PRESSURE || polledClitoral > PRESSURE_MAX_VALID_CONTROL) {
+            qWarning() << "Invalid clitoral pressure reading:" << polledClitoral << "mmHg - using baseline";
+            polledClitoral = m_baselineClitoral > 0.0 ? m_baselineClitoral : 0.0;
+        }
+        if (polledAVL < SafetyConstants::MIN_VALID_PRESSURE || polledAVL > PRESSURE_MAX_VALID_CONTROL) {
+            qWarning() << "Invalid AVL pressure reading:" << polledAVL << "mmHg - using baseline";
+            polledAVL = m_baselineAVL > 0.0 ? m_baselineAVL : 0.0;
+        }
+
+        // On a virtual clock the snapshot's steady_clock stamp means nothing
+        addPressureSample(polledClitoral, polledAVL, m_virtualClock ? nowNs() : snapshot.monotonicNs);
+    }
+
+    // Features below reflect every sample up to the latest one
+    const double currentClitoral = m_latestClitoral;
+    const double currentAVL = m_latestAVL;
 
     // Feature 1: Baseline deviation (tissue engorgement)
     double baselineDeviation = 0.0;
@@ -699,14 +819,13 @@ double OrgasmControlAlgorithm::calculateArousalLevel(int currentIdx)
     }
 
     // Feature 2: Pressure variance (arousal fluctuations)
-    // Bug #3 fix: Use passed currentIdx to ensure consistent index across all calculations
-    double pressureVariance = calculateVariance(m_pressureHistory, VARIANCE_WINDOW_SAMPLES, currentIdx);
+    double pressureVariance = m_pressureFeatures.variance();
 
     // Feature 3: Contraction band power (0.8-1.2 Hz = orgasmic contractions)
-    double contractionPower = calculateBandPower(m_pressureHistory, 0.8, 1.2, currentIdx);
+    double contractionPower = m_pressureFeatures.contractionPower();
 
-    // Feature 4: Rate of change
-    double rateOfChange = calculateDerivative(m_pressureHistory, currentIdx);
+    // Feature 4: Rate of change (mmHg/s)
+    double rateOfChange = m_pressureFeatures.derivativePerSecond();
 
     // Feature 5: Seal integrity (reduces arousal if seal is poor)
     double sealIntegrity = 1.0;
@@ -790,110 +909,10 @@ double OrgasmControlAlgorithm::calculateArousalLevel(int currentIdx)
     return clamp(m_smoothedArousal, 0.0, 1.0);
 }
 
-double OrgasmControlAlgorithm::calculateVariance(const QVector<double>& data, int windowSize, int currentIdx)
-{
-    if (data.isEmpty() || windowSize <= 1) return 0.0;
-
-    // Critical fix: Clamp windowSize to valid range to prevent negative index
-    windowSize = qBound(2, windowSize, HISTORY_SIZE);
-
-    // Bug #1 fix: currentIdx passed from caller to ensure consistent index across all calculations
-    // Critical fix: Use modular arithmetic that handles large negative offsets correctly
-    // Adding 2*HISTORY_SIZE ensures result is always positive before modulo
-    int startIdx = ((currentIdx - windowSize) % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
-    double sum = 0.0;
-    double sumSq = 0.0;
-    int count = qMin(windowSize, data.size());
-
-    for (int i = 0; i < count; ++i) {
-        int idx = (startIdx + i) % HISTORY_SIZE;
-        sum += data[idx];
-        sumSq += data[idx] * data[idx];
-    }
-
-    double mean = sum / count;
-    return (sumSq / count) - (mean * mean);
-}
-
-double OrgasmControlAlgorithm::calculateBandPower(const QVector<double>& data,
-                                                   double freqLow, double freqHigh, int currentIdx)
-{
-    // Simplified band power using autocorrelation at target period
-    // For 0.8-1.2 Hz at 10 Hz sampling, check lags 8-12 samples
-
-    if (data.size() < 20) return 0.0;
-
-    // Bug #4 fix: Validate frequency parameters to prevent division by zero or invalid lags
-    if (freqLow <= 0.0 || freqHigh <= 0.0 || freqHigh < freqLow) {
-        return 0.0;
-    }
-
-    int lagLow = static_cast<int>(10.0 / freqHigh);   // ~8 samples for 1.2 Hz
-    int lagHigh = static_cast<int>(10.0 / freqLow);   // ~12 samples for 0.8 Hz
-
-    // Bug #4 fix: Clamp lag values to valid buffer bounds
-    // Lag must be at least 1 (can't correlate with self) and at most HISTORY_SIZE - 1
-    lagLow = qBound(1, lagLow, HISTORY_SIZE - 1);
-    lagHigh = qBound(1, lagHigh, HISTORY_SIZE - 1);
-
-    // Bug fix: Ensure lagHigh >= lagLow after clamping to prevent empty loop range
-    if (lagHigh < lagLow) {
-        return 0.0;
-    }
-
-    // Bug #1 fix: currentIdx passed from caller to ensure consistent index across all calculations
-    double maxCorrelation = 0.0;
-
-    for (int lag = lagLow; lag <= lagHigh; ++lag) {
-        double correlation = 0.0;
-        int count = 0;
-
-        // Critical fix: Limit loop to prevent (i + lag) from exceeding HISTORY_SIZE
-        // This ensures idx2 calculation never goes negative even with single HISTORY_SIZE addition
-        int maxI = qMin(HISTORY_SIZE - lag, HISTORY_SIZE);
-
-        for (int i = 0; i < maxI; ++i) {
-            // Critical fix: Use double-modulo pattern to handle negative values correctly
-            // ((x % N) + N) % N guarantees positive result for any x
-            int idx1 = ((currentIdx - i) % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
-            int idx2 = ((currentIdx - i - lag) % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
-            correlation += data[idx1] * data[idx2];
-            count++;
-        }
-
-        if (count > 0) {
-            correlation /= count;
-            maxCorrelation = qMax(maxCorrelation, correlation);
-        }
-    }
-
-    return maxCorrelation;
-}
-
-double OrgasmControlAlgorithm::calculateDerivative(const QVector<double>& data, int currentIdx)
-{
-    if (data.size() < 5) return 0.0;
-
-    // Bug #1 fix: currentIdx passed from caller to ensure consistent index across all calculations
-    // Simple 5-point derivative
-    double sum = 0.0;
-    for (int i = 1; i <= 4; ++i) {
-        // Critical fix: Use double-modulo pattern to handle negative values correctly
-        int idx1 = ((currentIdx - i + 1) % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
-        int idx2 = ((currentIdx - i) % HISTORY_SIZE + HISTORY_SIZE) % HISTORY_SIZE;
-        sum += data[idx1] - data[idx2];
-    }
-
-    // Convert to rate per second (10 Hz sampling = 0.1s per sample)
-    return sum / 4.0 * 10.0;
-}
-
 bool OrgasmControlAlgorithm::detectContractions()
 {
     // Check for rhythmic contractions in 0.8-1.2 Hz band
-    // Critical fix: Must pass currentIdx for thread-safe buffer access
-    int currentIdx = m_historyIndex.load(std::memory_order_acquire);
-    double power = calculateBandPower(m_pressureHistory, 0.8, 1.2, currentIdx);
+    double power = m_pressureFeatures.contractionPower();
     return power > MAX_CONTRACTION_POWER * 0.5;  // Threshold at 50% of max
 }
 
@@ -1234,8 +1253,9 @@ void OrgasmControlAlgorithm::performSafetyCheck()
     if (!m_hardware) return;
 
     // Bug #12 fix: Read and validate pressure values (units: mmHg)
-    double avlPressure = m_hardware->readAVLPressure();
-    double clitoralPressure = m_hardware->readClitoralPressure();
+    const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+    double avlPressure = snapshot.avlPressure;
+    double clitoralPressure = snapshot.clitoralPressure;
 
     // Bug #12 fix: Validate sensor readings before safety checks
     // Invalid readings (-1.0) indicate sensor failure - treat as emergency
@@ -1321,13 +1341,11 @@ void OrgasmControlAlgorithm::performSafetyCheck()
         if (criticalPressureLoss) {
             qWarning() << "Critical pressure loss detected:" << avlPressure << "mmHg";
         } else if (rapidSealLeak) {
-            qDebug() << "Rapid seal leak detected - AVL:" << avlPressure
-                     << "fixed threshold:" << fixedThreshold
-                     << "rate:" << rateOfChange << "mmHg/100ms";
+            VC_TRACE(HotPathTrace::CONTROL, HotPathTrace::LEVEL_DEBUG, "seal.rapid_leak",
+                     avlPressure, fixedThreshold, rateOfChange);
         } else {
-            qDebug() << "Gradual seal leak detected - AVL:" << avlPressure
-                     << "adaptive threshold:" << adaptiveThreshold
-                     << "rate:" << rateOfChange << "mmHg/100ms";
+            VC_TRACE(HotPathTrace::CONTROL, HotPathTrace::LEVEL_DEBUG, "seal.gradual_leak",
+                     avlPressure, adaptiveThreshold, rateOfChange);
         }
 
         // Bug #17: Emergency stop on persistent seal loss (SEAL_EMERGENCY_DURATION_MS)
@@ -1372,13 +1390,9 @@ void OrgasmControlAlgorithm::performSafetyCheck()
         // Bug #5 fix: Pressure is low but didn't trigger sealLossDetected
         // This means high arousal (>0.5) is explaining the low pressure via tissue swelling
         // OR clitoral pressure is rising (swelling indicator)
-        // Non-critical fix: Only log in verbose mode (high-frequency path)
-        if (m_verboseLogging) {
-            qDebug() << "Low AVL pressure (" << avlPressure << ") attributed to tissue swelling"
-                     << "(arousal:" << m_arousalLevel
-                     << ", clitoral rising:" << clitoralPressureRising
-                     << ", adaptive threshold:" << adaptiveThreshold << ")";
-        }
+        // High-frequency path: trace only (compiled out in Release)
+        VC_TRACE(HotPathTrace::CONTROL, HotPathTrace::LEVEL_VERBOSE, "seal.swelling_low_avl",
+                 avlPressure, m_arousalLevel, clitoralPressureRising ? 1 : 0, adaptiveThreshold);
         // Bug #10 fix: DON'T reset seal loss counter when pressure is still low!
         // Only decrement gradually to prevent oscillation between leak/swelling states
         // This prevents a real leak from being masked by intermittent high arousal readings
@@ -1475,7 +1489,10 @@ void OrgasmControlAlgorithm::setState(ControlState state)
     ControlState currentState = m_state.load(std::memory_order_acquire);
     if (currentState != state) {
         m_state.store(state, std::memory_order_release);
+        // After the signal: leaving STOPPED is what opens the session recording
         emit stateChanged(state);
+        recordTransition(SessionRecording::TransitionRecord::CONTROL_STATE,
+                         static_cast<int>(currentState), static_cast<int>(state));
         // Non-critical fix: Only log state changes in verbose mode
         if (m_verboseLogging) {
             qDebug() << "State changed to:" << static_cast<int>(state);
@@ -1489,6 +1506,8 @@ void OrgasmControlAlgorithm::setMode(Mode mode)
     Mode currentMode = m_mode.load(std::memory_order_acquire);
     if (currentMode != mode) {
         m_mode.store(mode, std::memory_order_release);
+        recordTransition(SessionRecording::TransitionRecord::MODE,
+                         static_cast<int>(currentMode), static_cast<int>(mode));
         emit modeChanged(mode);
         // Non-critical fix: Only log mode changes in verbose mode
         if (m_verboseLogging) {
@@ -1497,6 +1516,82 @@ void OrgasmControlAlgorithm::setMode(Mode mode)
     }
 }
 
+int64_t OrgasmControlAlgorithm::nowNs() const
+{
+    return m_virtualClock ? m_virtualClock() : SensorSnapshot::monotonicNowNs();
+}
+
+void OrgasmControlAlgorithm::setVirtualClock(std::function<int64_t()> clock)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_state != ControlState::STOPPED) {
+        qWarning() << "Cannot change the algorithm clock while a session is active";
+        return;
+    }
+    m_virtualClock = std::move(clock);
+}
+
+void OrgasmControlAlgorithm::setSessionRecorder(SessionRecorder* recorder)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sessionRecorder = recorder;
+}
+
+void OrgasmControlAlgorithm::recordSessionStart()
+{
+    if (!m_sessionRecorder || !m_sessionRecorder->isOpen()) return;
+
+    using SessionRecording::SessionStartRecord;
+    SessionStartRecord record;
+    record.mode = static_cast<int32_t>(m_mode.load(std::memory_order_acquire));
+    record.targetEdges = m_targetEdges;
+    record.targetOrgasms = m_targetOrgasms;
+    record.milkingFailureMode = m_milkingFailureMode;
+    record.maxDurationMs = m_maxDurationMs;
+    record.edgeThreshold = m_edgeThreshold;
+    record.orgasmThreshold = m_orgasmThreshold;
+    record.recoveryThreshold = m_recoveryThreshold;
+    record.flags = (m_tensEnabled ? SessionStartRecord::TENS_ENABLED : 0)
+                 | (m_antiEscapeEnabled ? SessionStartRecord::ANTI_ESCAPE_ENABLED : 0)
+                 | (m_heartRateEnabled ? SessionStartRecord::HEART_RATE_ENABLED : 0);
+    m_sessionRecorder->append(record);
+}
+
+void OrgasmControlAlgorithm::recordArousal()
+{
+    if (!m_sessionRecorder || !m_sessionRecorder->isOpen()) return;
+
+    SessionRecording::ArousalRecord record;
+    record.arousalLevel = m_arousalLevel;
+    record.smoothedArousal = m_smoothedArousal;
+    record.intensity = m_intensity;
+    record.frequency = m_frequency;
+    record.tensAmplitude = m_tensAmplitude;
+    record.heartRate = m_currentHeartRate;
+    record.controlState = static_cast<uint8_t>(m_state.load(std::memory_order_acquire));
+    record.mode = static_cast<uint8_t>(m_mode.load(std::memory_order_acquire));
+    record.arousalState = static_cast<uint8_t>(m_arousalState.load(std::memory_order_acquire));
+    m_sessionRecorder->append(record);
+
+    // Oscillator and TENS settings are changed on their controllers
+    // directly, bypassing the hardware manager's setters
+    if (m_hardware) {
+        m_hardware->recordActuatorState();
+    }
+}
+
+void OrgasmControlAlgorithm::recordTransition(uint16_t kind, int from, int to)
+{
+    if (!m_sessionRecorder || !m_sessionRecorder->isOpen()) return;
+
+    SessionRecording::TransitionRecord record;
+    record.kind = kind;
+    record.from = from;
+    record.to = to;
+    m_sessionRecorder->append(record);
+}
+
 double OrgasmControlAlgorithm::clamp(double value, double min, double max)
 {
     return qBound(min, value, max);
@@ -3,12 +3,14 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QElapsedTimer>
 #include <QMutex>
 #include <QVector>
 #include <atomic>
 #include <cmath>
+#include <functional>
 #include "../safety/SafetyConstants.h"
+#include "ArousalFeatureExtractor.h"
+#include "../threading/ControlScheduler.h"
 
 class HardwareManager;
 class SensorInterface;
@@ -16,6 +18,9 @@ class ClitoralOscillator;
 class TENSController;
 class HeartRateSensor;
 class FluidSensor;
+class DataAcquisitionThread;
+class SampleBatchSubscriber;
+class SessionRecorder;
 
 /**
  * @brief Adaptive orgasm control algorithm with arousal detection
@@ -93,6 +98,13 @@ public:
     explicit OrgasmControlAlgorithm(HardwareManager* hardware, QObject* parent = nullptr);
     ~OrgasmControlAlgorithm();
 
+    /**
+     * @brief Run the update and safety ticks from a shared control scheduler
+     * @param scheduler Cyclic executive that replaces the private timers
+     * @param offset Cycle within each period the ticks run on
+     */
+    void attachToScheduler(ControlScheduler* scheduler, int offset = 0);
+
     // ========================================================================
     // Control Methods - Bug #20 fix: Added Doxygen documentation
     // ========================================================================
@@ -180,11 +192,33 @@ public:
     void setDangerThreshold(double threshold);
     void setMilkingFailureMode(int mode);
 
+    // Pressure sample stream. With a source attached, arousal features are
+    // updated from every acquisition sample at the acquisition rate; without
+    // one (or while it is stalled) they fall back to one polled sample per tick.
+    void setSampleSource(DataAcquisitionThread* source);
+    bool isStreamFed() const;
+    double getFeatureSampleRateHz() const { return m_pressureFeatures.sampleRateHz(); }
+
     // Heart rate sensor configuration
     void setHeartRateSensor(HeartRateSensor* sensor);
     void setHeartRateEnabled(bool enabled);
     void setHeartRateWeight(double weight);  // Weight in arousal calculation (0.0-0.5)
 
+    /**
+     * @brief Time source for session/state timing and polled sample timestamps
+     * @param clock Monotonic ns; empty restores steady_clock
+     * @note Only while stopped. Lets a recorded session be replayed on
+     *       virtual time, faster than real time (tools/session_replay)
+     */
+    void setVirtualClock(std::function<int64_t()> clock);
+    int64_t nowNs() const;
+
+    /**
+     * @brief Record arousal estimates, transitions and session starts
+     * @param recorder Appended to while open; must outlive the algorithm
+     */
+    void setSessionRecorder(SessionRecorder* recorder);
+
     // Debug/diagnostic configuration
     void setVerboseLogging(bool enabled) { m_verboseLogging = enabled; }
     bool isVerboseLogging() const { return m_verboseLogging; }
@@ -280,12 +314,8 @@ private:
     // Arousal detection methods
     void calibrateBaseline(int durationMs);
     void updateArousalLevel();
-    // Bug #3 fix: Accept currentIdx parameter to prevent multiple atomic loads per cycle
-    double calculateArousalLevel(int currentIdx);
-    // Bug #1 fix: Pass currentIdx to ensure consistent index across all calculations
-    double calculateVariance(const QVector<double>& data, int windowSize, int currentIdx);
-    double calculateBandPower(const QVector<double>& data, double freqLow, double freqHigh, int currentIdx);
-    double calculateDerivative(const QVector<double>& data, int currentIdx);
+    double calculateArousalLevel();
+    void addPressureSample(double clitoral, double avl, qint64 monotonicNs);
     bool detectContractions();
     void updateArousalState();
     
@@ -294,8 +324,9 @@ private:
     void runForcedOrgasm();
     void runMilking();
     void startCoolDown();
-    void startAdaptiveEdgingInternal(int targetCycles);
-    void startMilkingInternal(int durationMs, int failureMode);
+    bool startAdaptiveEdgingInternal(int targetCycles);
+    bool startMilkingInternal(int durationMs, int failureMode);
+    void stopInternal();
     double calculateMilkingIntensityAdjustment();
     void handleMilkingOrgasmFailure();
     
@@ -335,6 +366,31 @@ private:
      */
     void startSessionTimers();
 
+    // Session recording; callers hold m_mutex
+    void recordSessionStart();
+    void recordArousal();
+    void recordTransition(uint16_t kind, int from, int to);
+
+    /**
+     * @brief QElapsedTimer look-alike that runs on the algorithm's clock
+     *
+     * Same start()/elapsed()/invalidate() interface, so the timers follow a
+     * virtual clock during replay. elapsed() is 0 until started.
+     */
+    class ClockTimer
+    {
+    public:
+        explicit ClockTimer(const OrgasmControlAlgorithm* owner) : m_owner(owner), m_startNs(-1) {}
+        void start() { m_startNs = m_owner->nowNs(); }
+        void invalidate() { m_startNs = -1; }
+        bool isValid() const { return m_startNs >= 0; }
+        qint64 elapsed() const { return isValid() ? (m_owner->nowNs() - m_startNs) / 1000000 : 0; }
+
+    private:
+        const OrgasmControlAlgorithm* m_owner;
+        int64_t m_startNs;
+    };
+
     // Hardware interfaces
     HardwareManager* m_hardware;
     SensorInterface* m_sensorInterface;
@@ -344,9 +400,11 @@ private:
     FluidSensor* m_fluidSensor;
 
     // Timers
-    QTimer* m_updateTimer;
-    QTimer* m_safetyTimer;
-    QElapsedTimer m_sessionTimer;
+    ControlTimer* m_updateTimer;
+    ControlTimer* m_safetyTimer;
+    ClockTimer m_sessionTimer{this};
+    std::function<int64_t()> m_virtualClock;   // Empty = steady_clock
+    SessionRecorder* m_sessionRecorder;
 
     // State
     // LOW-3 fix: Made atomic for thread-safe access from UI thread via getters
@@ -364,10 +422,16 @@ private:
     std::atomic<ArousalState> m_arousalState;  // Bug #11 fix: atomic for thread-safe access
     double m_baselineClitoral;
     double m_baselineAVL;
-    QVector<double> m_pressureHistory;
     QVector<double> m_arousalHistory;
     std::atomic<int> m_historyIndex;  // Bug #1 fix: atomic to prevent race condition
 
+    // Pressure feature pipeline (per acquisition sample)
+    ArousalFeatureExtractor m_pressureFeatures;  // O(1) variance / band power / derivative
+    SampleBatchSubscriber* m_sampleSubscriber;
+    double m_latestClitoral;
+    double m_latestAVL;
+    std::atomic<qint64> m_lastStreamSampleNs;   // 0 = no stream; read unlocked by isStreamFed
+
     // Heart rate tracking
     int m_currentHeartRate;
     int m_baselineHeartRate;
@@ -398,7 +462,7 @@ private:
     double m_dangerThreshold;       // Danger zone threshold (default 0.92)
 
     // Internal state for algorithm logic
-    QElapsedTimer m_stateTimer; // General purpose timer for states like HOLDING, BACKING_OFF
+    ClockTimer m_stateTimer{this}; // General purpose timer for states like HOLDING, BACKING_OFF
     double m_previousArousal;
     bool m_inOrgasm;
     bool m_pointOfNoReturnReached;     // Orgasm became inevitable during back-off
@@ -416,7 +480,7 @@ private:
     // Bug #15, #16, #17: Internal state for seal integrity monitoring
     int m_sealLossCount;           // Consecutive seal loss detections
     bool m_resealAttemptInProgress;
-    QElapsedTimer m_resealTimer;   // Tracks duration of re-seal boost
+    ClockTimer m_resealTimer{this};   // Tracks duration of re-seal boost
 
     // Arousal-adaptive seal integrity (differentiates swelling from leak)
     double m_previousAVLPressure;  // For rate of change calculation
@@ -449,8 +513,14 @@ private:
     static const int UPDATE_INTERVAL_MS = 100;
     static const int SAFETY_INTERVAL_MS = 100;
     static const int BASELINE_DURATION_MS = 10000;
-    static const int HISTORY_SIZE = 200;
-    static const int VARIANCE_WINDOW_SAMPLES = 100;
+    static const int HISTORY_SIZE = 200;                   // Arousal updates kept (20 s at UPDATE_INTERVAL_MS)
+    static constexpr double VARIANCE_WINDOW_S = 10.0;      // Pressure variance window
+
+    // Sample stream
+    static const int STREAM_BATCH_LATENCY_MS = 20;         // Max delay before a partial batch is delivered
+    static const int STREAM_STALE_MS = 250;                // No samples for this long: poll instead
+    static const int RATE_CHECK_INTERVAL_SAMPLES = 32;
+    static constexpr double RATE_RETUNE_TOLERANCE = 0.2;   // Reconfigure filters beyond ±20% rate change
 
     // HIGH-5 fix: Minimum calibration samples required for valid baseline
     // At 100ms intervals over 10 seconds, we expect ~100 samples; require at least 50
@@ -478,7 +548,7 @@ private:
     // Normalization maxima
     static constexpr double MAX_DEVIATION = 0.5;
     static constexpr double MAX_VARIANCE = 25.0;
-    static constexpr double MAX_CONTRACTION_POWER = 10.0;
+    static constexpr double MAX_CONTRACTION_POWER = 10.0;      // mmHg² in the 0.8-1.2 Hz band (~4.5 mmHg peak)
     static constexpr double MAX_RATE_OF_CHANGE = 5.0;
 
     // Edging defaults
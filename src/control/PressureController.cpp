@@ -0,0 +1,232 @@
+#include "PressureController.h"
+#include <algorithm>
+#include <cmath>
+
+double PressureController::TrackingMetrics::meanAbsErrorMmHg() const
+{
+    return samples > 0 ? sumAbsErrorMmHg / samples : 0.0;
+}
+
+double PressureController::TrackingMetrics::rmsErrorMmHg() const
+{
+    return samples > 0 ? std::sqrt(sumSquaredErrorMmHg / samples) : 0.0;
+}
+
+double PressureController::TrackingMetrics::inBandFraction() const
+{
+    return samples > 0 ? static_cast<double>(inBandSamples) / samples : 0.0;
+}
+
+PressureController::PressureController()
+    : PressureController(Config())
+{
+}
+
+PressureController::PressureController(const Config& config)
+    : m_config(config)
+    , m_setpointMmHg(0.0)
+    , m_integral(0.0)
+    , m_lastMeasured(-1.0)
+    , m_derivative(0.0)
+    , m_lastError(0.0)
+    , m_lastTimestampNs(0)
+    , m_outputsValid(false)
+    , m_valveState(ValveState::EVACUATE)
+    , m_pumpEnabled(false)
+    , m_pumpPercent(0.0)
+    , m_valveChangedNs(0)
+    , m_settling(false)
+    , m_setpointChangedNs(0)
+{
+}
+
+void PressureController::setConfig(const Config& config)
+{
+    m_config = config;
+    m_integral = std::max(-m_config.integralLimitPercent, std::min(m_config.integralLimitPercent, m_integral));
+}
+
+void PressureController::setSetpoint(double setpointMmHg)
+{
+    // Only steps worth measuring start a settling-time measurement; the
+    // small per-tick moves of a curved keyframe do not
+    if (std::fabs(setpointMmHg - m_setpointMmHg) > m_config.trackingBandMmHg) {
+        m_settling = true;
+        m_setpointChangedNs = 0;
+    }
+    m_setpointMmHg = setpointMmHg;
+}
+
+PressureController::Command PressureController::update(double measuredMmHg, int64_t timestampNs)
+{
+    Command command;
+
+    double dt = 0.0;
+    if (m_lastTimestampNs != 0 && timestampNs > m_lastTimestampNs) {
+        dt = (timestampNs - m_lastTimestampNs) / 1e9;
+        if (dt > MAX_DT_S) {
+            dt = 0.0;
+            m_derivative = 0.0;
+            m_lastMeasured = -1.0;
+        }
+    }
+    m_lastTimestampNs = timestampNs;
+    if (m_settling && m_setpointChangedNs == 0) {
+        m_setpointChangedNs = timestampNs;
+    }
+
+    const double feedForward = std::max(0.0, std::min(m_config.maxPumpPercent,
+        m_config.feedForwardGain * m_setpointMmHg / m_config.pumpVacuumPerPercentMmHg));
+
+    if (measuredMmHg < 0.0) {
+        // No feedback: hold the integral and run on feed-forward alone
+        m_metrics.invalidSamples++;
+        m_lastMeasured = -1.0;
+        const bool release = m_setpointMmHg <= 0.0;
+        finishCommand(command, release ? ValveState::VENT : ValveState::EVACUATE,
+                      release ? 0.0 : feedForward, timestampNs);
+        return command;
+    }
+
+    const double error = m_setpointMmHg - measuredMmHg;
+    m_lastError = error;
+    recordError(error, timestampNs);
+
+    // Derivative on the measurement so setpoint steps do not kick the pump
+    if (m_config.kd > 0.0 && dt > 0.0 && m_lastMeasured >= 0.0) {
+        const double raw = -(measuredMmHg - m_lastMeasured) / dt;
+        const double alpha = dt / (m_config.derivativeFilterS + dt);
+        m_derivative += alpha * (raw - m_derivative);
+    }
+    m_lastMeasured = measuredMmHg;
+
+    const ValveState valveState = nextValveState(error, timestampNs);
+    if (valveState == ValveState::VENT) {
+        finishCommand(command, valveState, 0.0, timestampNs);
+        return command;
+    }
+
+    const double unsaturated = feedForward + m_config.kp * error + m_integral + m_config.kd * m_derivative;
+    const double pumpPercent = std::max(0.0, std::min(m_config.maxPumpPercent, unsaturated));
+    const bool saturatedHigh = unsaturated > m_config.maxPumpPercent;
+    const bool saturatedLow = unsaturated < 0.0;
+    if (saturatedHigh || saturatedLow) {
+        m_metrics.saturatedSamples++;
+    }
+
+    // Conditional integration: never wind further into saturation, and only
+    // while the pump is actually connected to the chamber
+    if (dt > 0.0 && valveState == ValveState::EVACUATE &&
+        !(saturatedHigh && error > 0.0) && !(saturatedLow && error < 0.0)) {
+        m_integral = std::max(-m_config.integralLimitPercent,
+                              std::min(m_config.integralLimitPercent, m_integral + m_config.ki * error * dt));
+    }
+
+    finishCommand(command, valveState, pumpPercent, timestampNs);
+    return command;
+}
+
+PressureController::ValveState PressureController::nextValveState(double error, int64_t timestampNs) const
+{
+    if (m_setpointMmHg <= 0.0) {
+        return ValveState::VENT;
+    }
+
+    ValveState next = m_valveState;
+    switch (m_valveState) {
+        case ValveState::EVACUATE:
+            if (error < -m_config.ventOpenErrorMmHg) {
+                next = ValveState::VENT;
+            } else if (error < -m_config.valveDeadbandMmHg) {
+                next = ValveState::HOLD;
+            }
+            break;
+        case ValveState::HOLD:
+            if (error < -m_config.ventOpenErrorMmHg) {
+                next = ValveState::VENT;
+            } else if (error > m_config.valveDeadbandMmHg) {
+                next = ValveState::EVACUATE;
+            }
+            break;
+        case ValveState::VENT:
+            if (error > m_config.valveDeadbandMmHg) {
+                next = ValveState::EVACUATE;
+            } else if (error > -m_config.ventCloseErrorMmHg) {
+                next = ValveState::HOLD;
+            }
+            break;
+    }
+
+    if (next != m_valveState && m_outputsValid && timestampNs - m_valveChangedNs < m_config.minValveDwellNs) {
+        return m_valveState;
+    }
+    return next;
+}
+
+void PressureController::finishCommand(Command& command, ValveState valveState, double pumpPercent,
+                                       int64_t timestampNs)
+{
+    command.valvesChanged = !m_outputsValid || valveState != m_valveState;
+    if (command.valvesChanged) {
+        if (m_outputsValid) {
+            m_metrics.valveTransitions++;
+        }
+        m_valveState = valveState;
+        m_valveChangedNs = timestampNs;
+    }
+    command.vacuumValveOpen = m_valveState == ValveState::EVACUATE;
+    command.ventValveOpen = m_valveState == ValveState::VENT;
+
+    // Reaching off or full speed always goes through the deadband
+    const bool enabled = pumpPercent > 0.0;
+    const bool atLimit = (pumpPercent == 0.0 || pumpPercent == m_config.maxPumpPercent) && pumpPercent != m_pumpPercent;
+    command.pumpChanged = !m_outputsValid || enabled != m_pumpEnabled || atLimit ||
+                          std::fabs(pumpPercent - m_pumpPercent) >= m_config.pumpDeadbandPercent;
+    if (command.pumpChanged) {
+        m_pumpEnabled = enabled;
+        m_pumpPercent = pumpPercent;
+        m_metrics.pumpUpdates++;
+    }
+    command.pumpEnabled = m_pumpEnabled;
+    command.pumpPercent = m_pumpPercent;
+
+    m_outputsValid = true;
+}
+
+void PressureController::recordError(double error, int64_t timestampNs)
+{
+    const double absError = std::fabs(error);
+    m_metrics.samples++;
+    m_metrics.sumAbsErrorMmHg += absError;
+    m_metrics.sumSquaredErrorMmHg += error * error;
+    m_metrics.maxAbsErrorMmHg = std::max(m_metrics.maxAbsErrorMmHg, absError);
+
+    if (absError <= m_config.trackingBandMmHg) {
+        m_metrics.inBandSamples++;
+        if (m_settling) {
+            m_metrics.lastSettlingTimeMs = (timestampNs - m_setpointChangedNs) / 1e6;
+            m_settling = false;
+        }
+    }
+}
+
+void PressureController::reset()
+{
+    m_integral = 0.0;
+    m_lastMeasured = -1.0;
+    m_derivative = 0.0;
+    m_lastError = 0.0;
+    m_lastTimestampNs = 0;
+    m_outputsValid = false;
+    m_valveState = ValveState::EVACUATE;
+    m_pumpEnabled = false;
+    m_pumpPercent = 0.0;
+    m_valveChangedNs = 0;
+}
+
+void PressureController::resetMetrics()
+{
+    m_metrics = TrackingMetrics();
+    m_settling = false;
+    m_setpointChangedNs = 0;
+}
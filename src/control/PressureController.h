@@ -0,0 +1,130 @@
+#ifndef PRESSURECONTROLLER_H
+#define PRESSURECONTROLLER_H
+
+#include <cstdint>
+
+/**
+ * @brief Closed-loop outer-chamber pressure regulation
+ *
+ * Turns a vacuum setpoint and the measured AVL pressure into pump speed and
+ * SOL1/SOL2 commands:
+ *  - pump: feed-forward (the speed whose dead-head vacuum equals the
+ *    setpoint) plus PI, with an optional derivative on the measurement. Conditional integration is the anti-windup: the integral
+ *    only moves when the output is not saturated in the error's direction.
+ *  - valves: evacuate (SOL1 open), hold (both closed) or vent (SOL2 open).
+ *    The chamber is evacuated until it reaches the setpoint, then isolated
+ *    until it leaks valveDeadbandMmHg below it or overshoots by
+ *    ventOpenErrorMmHg; venting stops within ventCloseErrorMmHg. Every valve
+ *    state is held for at least minValveDwellNs, so noise around the
+ *    setpoint does not chatter the solenoids.
+ *  - pump changes smaller than pumpDeadbandPercent are not sent.
+ *
+ * Commands carry change flags so the caller only touches hardware that
+ * actually changes. Tracking-error statistics accumulate until
+ * resetMetrics(). Qt-free; not thread-safe (owned by the control loop).
+ */
+class PressureController
+{
+public:
+    enum class ValveState : uint8_t {
+        EVACUATE,       // SOL1 open, SOL2 closed
+        HOLD,           // Both closed; chamber isolated
+        VENT            // SOL1 closed, SOL2 open
+    };
+
+    struct Config {
+        double kp = 1.5;                    // Pump % per mmHg of error
+        double ki = 0.3;                    // Pump % per mmHg·s
+        double kd = 0.0;                    // Pump % per mmHg/s (on measurement)
+        double derivativeFilterS = 0.05;    // First-order filter on the derivative
+        double feedForwardGain = 1.0;       // 0 disables feed-forward
+        double pumpVacuumPerPercentMmHg = 6.0;  // Dead-head vacuum per % speed (600 mmHg at 100%)
+        double integralLimitPercent = 50.0;
+        double maxPumpPercent = 100.0;
+        double pumpDeadbandPercent = 1.0;
+        double valveDeadbandMmHg = 1.5;     // Below setpoint by this much: evacuate
+        double ventOpenErrorMmHg = 2.5;     // Above setpoint by this much: vent
+        double ventCloseErrorMmHg = 0.5;    // Back within this: hold
+        int64_t minValveDwellNs = 20000000;
+        double trackingBandMmHg = 2.0;      // "On target" for the metrics
+    };
+
+    struct Command {
+        bool pumpEnabled = false;
+        double pumpPercent = 0.0;
+        bool vacuumValveOpen = false;       // SOL1
+        bool ventValveOpen = false;         // SOL2
+        bool pumpChanged = false;
+        bool valvesChanged = false;
+    };
+
+    struct TrackingMetrics {
+        uint64_t samples = 0;
+        uint64_t invalidSamples = 0;        // Measurement missing; feed-forward only
+        uint64_t inBandSamples = 0;
+        uint64_t saturatedSamples = 0;
+        uint64_t pumpUpdates = 0;
+        uint64_t valveTransitions = 0;
+        double sumAbsErrorMmHg = 0.0;
+        double sumSquaredErrorMmHg = 0.0;
+        double maxAbsErrorMmHg = 0.0;
+        double lastSettlingTimeMs = -1.0;   // Setpoint change to first in-band sample; -1 = none yet
+
+        double meanAbsErrorMmHg() const;
+        double rmsErrorMmHg() const;
+        double inBandFraction() const;
+    };
+
+    PressureController();
+    explicit PressureController(const Config& config);
+
+    void setConfig(const Config& config);
+    const Config& config() const { return m_config; }
+
+    // Setpoint in mmHg of vacuum; <= 0 vents the chamber
+    void setSetpoint(double setpointMmHg);
+    double setpoint() const { return m_setpointMmHg; }
+
+    // One control step; measuredMmHg < 0 means no valid reading
+    Command update(double measuredMmHg, int64_t timestampNs);
+
+    // Clear integrator, filters and output history; the next update()
+    // reports every output as changed
+    void reset();
+
+    double integralPercent() const { return m_integral; }
+    double lastErrorMmHg() const { return m_lastError; }
+    ValveState valveState() const { return m_valveState; }
+
+    const TrackingMetrics& metrics() const { return m_metrics; }
+    void resetMetrics();
+
+    static constexpr double MAX_DT_S = 0.5;    // Longer gaps are treated as a restart
+
+private:
+    ValveState nextValveState(double error, int64_t timestampNs) const;
+    void finishCommand(Command& command, ValveState valveState, double pumpPercent, int64_t timestampNs);
+    void recordError(double error, int64_t timestampNs);
+
+    Config m_config;
+    double m_setpointMmHg;
+
+    double m_integral;
+    double m_lastMeasured;
+    double m_derivative;
+    double m_lastError;
+    int64_t m_lastTimestampNs;      // 0 = no previous update
+
+    // Last command sent
+    bool m_outputsValid;
+    ValveState m_valveState;
+    bool m_pumpEnabled;
+    double m_pumpPercent;
+    int64_t m_valveChangedNs;
+
+    TrackingMetrics m_metrics;
+    bool m_settling;
+    int64_t m_setpointChangedNs;    // 0 = stamp at the next update
+};
+
+#endif // PRESSURECONTROLLER_H
@@ -1,6 +1,7 @@
 #include "CustomPatternEditor.h"
 #include "../VacuumController.h"
 #include "../patterns/PatternDefinitions.h"
+#include "../patterns/PatternValidator.h"
 #include "components/TouchButton.h"
 #include "styles/ModernMedicalStyle.h"
 #include <QDebug>
@@ -22,6 +23,13 @@
 #include <cmath>
 #include <QtCore/qmath.h>
 
+namespace {
+PatternValidator::StepValues toStepValues(const CustomPatternEditor::PatternStep& step)
+{
+    return PatternValidator::StepValues(step.pressurePercent, step.durationMs);
+}
+}
+
 CustomPatternEditor::CustomPatternEditor(VacuumController* controller, QWidget *parent)
     : QWidget(parent)
     , m_controller(controller)
@@ -59,12 +67,15 @@ CustomPatternEditor::CustomPatternEditor(VacuumController* controller, QWidget *
     , m_saveButton(nullptr)
     , m_cancelButton(nullptr)
     , m_currentTab(0)
+    , m_validator(nullptr)
+    , m_incrementalEditPending(false)
     , m_patternModified(false)
 {
     // Set up as a full-screen widget for embedded use
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     setMinimumSize(ModernMedicalStyle::scaleValue(800), ModernMedicalStyle::scaleValue(600));
     
+    m_validator = new PatternValidator(this);
     setupUI();
     connectSignals();
     applyTouchOptimizedStyles();
@@ -1126,6 +1137,9 @@ void CustomPatternEditor::onTabChanged(int index)
 void CustomPatternEditor::onPatternNameChanged()
 {
     m_patternModified = true;
+
+    // Coherence checks depend on the name; resync on the next preview
+    m_validator->endIncremental();
 }
 
 void CustomPatternEditor::onPatternTypeChanged()
@@ -1195,9 +1209,9 @@ void CustomPatternEditor::onStepModified()
         step.action = m_stepActionCombo->currentText();
         step.description = m_stepDescriptionEdit->text();
 
-        updateStepList();
-
-        m_stepsList->setCurrentRow(currentRow);
+        m_stepsList->item(currentRow)->setText(stepListText(currentRow));
+        m_validator->updateStep(currentRow, toStepValues(step));
+        m_incrementalEditPending = true;
 
         m_patternModified = true;
         updatePreview();
@@ -1265,6 +1279,8 @@ void CustomPatternEditor::addPatternStep()
     }
 
     m_patternSteps.insert(insertIndex, newStep);
+    m_validator->insertStep(insertIndex, toStepValues(newStep));
+    m_incrementalEditPending = true;
     updateStepList();
 
     m_stepsList->setCurrentRow(insertIndex);
@@ -1278,6 +1294,8 @@ void CustomPatternEditor::removePatternStep()
     int currentRow = m_stepsList->currentRow();
     if (currentRow >= 0 && currentRow < m_patternSteps.size()) {
         m_patternSteps.removeAt(currentRow);
+        m_validator->removeStep(currentRow);
+        m_incrementalEditPending = true;
         updateStepList();
 
         if (currentRow < m_patternSteps.size()) {
@@ -1296,6 +1314,8 @@ void CustomPatternEditor::moveStepUp()
     int currentRow = m_stepsList->currentRow();
     if (currentRow > 0 && currentRow < m_patternSteps.size()) {
         m_patternSteps.swapItemsAt(currentRow, currentRow - 1);
+        m_validator->moveStep(currentRow, currentRow - 1);
+        m_incrementalEditPending = true;
         updateStepList();
         m_stepsList->setCurrentRow(currentRow - 1);
 
@@ -1309,6 +1329,8 @@ void CustomPatternEditor::moveStepDown()
     int currentRow = m_stepsList->currentRow();
     if (currentRow >= 0 && currentRow < m_patternSteps.size() - 1) {
         m_patternSteps.swapItemsAt(currentRow, currentRow + 1);
+        m_validator->moveStep(currentRow, currentRow + 1);
+        m_incrementalEditPending = true;
         updateStepList();
         m_stepsList->setCurrentRow(currentRow + 1);
 
@@ -1325,6 +1347,8 @@ void CustomPatternEditor::duplicateStep()
         duplicatedStep.description += " (Copy)";
 
         m_patternSteps.insert(currentRow + 1, duplicatedStep);
+        m_validator->insertStep(currentRow + 1, toStepValues(duplicatedStep));
+        m_incrementalEditPending = true;
         updateStepList();
         m_stepsList->setCurrentRow(currentRow + 1);
 
@@ -1533,8 +1557,19 @@ bool CustomPatternEditor::validatePatternData()
         }
     }
 
+    // Safety review from the incremental validator; advisory only
+    syncValidation();
+    QString reviewText;
+    const PatternValidator::ValidationReport review = m_validator->incrementalReport();
+    if (!review.issues.isEmpty()) {
+        reviewText = "\nSafety review:\n";
+        for (const PatternValidator::ValidationIssue& issue : review.issues) {
+            reviewText += "• " + issue.message + "\n";
+        }
+    }
+
     if (errors.isEmpty()) {
-        m_validationResults->setPlainText("✓ Pattern validation passed successfully.");
+        m_validationResults->setPlainText("✓ Pattern validation passed successfully.\n" + reviewText);
         m_validationResults->setStyleSheet(QString("color: %1;").arg(ModernMedicalStyle::Colors::MEDICAL_GREEN.name()));
         return true;
     } else {
@@ -1542,12 +1577,48 @@ bool CustomPatternEditor::validatePatternData()
         for (const QString& error : errors) {
             errorText += "• " + error + "\n";
         }
-        m_validationResults->setPlainText(errorText);
+        m_validationResults->setPlainText(errorText + reviewText);
         m_validationResults->setStyleSheet(QString("color: %1;").arg(ModernMedicalStyle::Colors::MEDICAL_RED.name()));
         return false;
     }
 }
 
+void CustomPatternEditor::syncValidation()
+{
+    // A single step edit has already been applied; anything else rebuilds
+    if (!m_incrementalEditPending || !m_validator->isIncrementalActive() ||
+        m_validator->incrementalStepCount() != m_patternSteps.size()) {
+        QVector<PatternValidator::StepValues> steps;
+        steps.reserve(m_patternSteps.size());
+        for (const PatternStep& step : m_patternSteps) {
+            steps.append(toStepValues(step));
+        }
+        QJsonObject patternInfo;
+        patternInfo["name"] = m_patternNameEdit->text();
+        patternInfo["type"] = m_patternTypeCombo->currentText();
+        m_validator->beginIncremental(patternInfo, steps);
+    }
+    m_incrementalEditPending = false;
+}
+
+void CustomPatternEditor::updateValidationSummary()
+{
+    const int errors = m_validator->incrementalIssueCount(PatternValidator::CRITICAL) +
+                       m_validator->incrementalIssueCount(PatternValidator::ERROR);
+    const int warnings = m_validator->incrementalIssueCount(PatternValidator::WARNING);
+
+    if (errors == 0 && warnings == 0) {
+        m_validationResults->setPlainText("✓ No safety issues found.");
+        m_validationResults->setStyleSheet(QString("color: %1;").arg(ModernMedicalStyle::Colors::MEDICAL_GREEN.name()));
+    } else {
+        m_validationResults->setPlainText(QString("%1 %2 error(s), %3 warning(s). Press Validate Pattern for details.")
+                                          .arg(errors > 0 ? "✗" : "!").arg(errors).arg(warnings));
+        m_validationResults->setStyleSheet(QString("color: %1;").arg(errors > 0
+            ? ModernMedicalStyle::Colors::MEDICAL_RED.name()
+            : ModernMedicalStyle::Colors::MEDICAL_ORANGE.name()));
+    }
+}
+
 void CustomPatternEditor::validatePattern()
 {
     validatePatternData();
@@ -1567,6 +1638,9 @@ bool CustomPatternEditor::savePattern()
 
 void CustomPatternEditor::updatePreview()
 {
+    syncValidation();
+    updateValidationSummary();
+
     int totalDuration = 0;
     double totalPressure = 0.0;
     double maxPressure = 0.0;
@@ -1602,19 +1676,23 @@ void CustomPatternEditor::updateStepList()
     m_stepsList->clear();
 
     for (int i = 0; i < m_patternSteps.size(); ++i) {
-        const PatternStep& step = m_patternSteps[i];
-        QString stepText = QString("Step %1: %2 mmHg for %3 ms (%4)")
-                          .arg(i + 1)
-                          .arg(step.pressurePercent, 0, 'f', 1)
-                          .arg(step.durationMs)
-                          .arg(step.action);
-
-        if (!step.description.isEmpty()) {
-            stepText += QString(" - %1").arg(step.description);
-        }
+        m_stepsList->addItem(stepListText(i));
+    }
+}
+
+QString CustomPatternEditor::stepListText(int index) const
+{
+    const PatternStep& step = m_patternSteps[index];
+    QString stepText = QString("Step %1: %2 mmHg for %3 ms (%4)")
+                      .arg(index + 1)
+                      .arg(step.pressurePercent, 0, 'f', 1)
+                      .arg(step.durationMs)
+                      .arg(step.action);
 
-        m_stepsList->addItem(stepText);
+    if (!step.description.isEmpty()) {
+        stepText += QString(" - %1").arg(step.description);
     }
+    return stepText;
 }
 
 QJsonObject CustomPatternEditor::stepToJson(const PatternStep& step) const
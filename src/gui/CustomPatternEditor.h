@@ -28,6 +28,7 @@
 class VacuumController;
 class TouchButton;
 class PatternEngine;
+class PatternValidator;
 
 class CustomPatternEditor : public QWidget
 {
@@ -138,7 +139,10 @@ private:
     PatternStep jsonToStep(const QJsonObject& json) const;
 
     void updateStepList();
+    QString stepListText(int index) const;
     void updatePreview();
+    void syncValidation();
+    void updateValidationSummary();
     void applyTouchOptimizedStyles();
     void initializeDefaultPattern();
     void addDefaultStep();
@@ -337,6 +341,11 @@ private:
     QList<QPointF> m_designerPoints;
     int m_selectedPoint;
     int m_currentTab;
+
+    // Mirrors m_patternSteps; step edits are applied incrementally, anything
+    // else (templates, imports, generators) resyncs it on the next preview
+    PatternValidator* m_validator;
+    bool m_incrementalEditPending;
     
     static const int DEFAULT_STEP_DURATION = 1000;
     static constexpr double DEFAULT_PRESSURE = 50.0;
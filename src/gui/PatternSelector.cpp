@@ -3,6 +3,7 @@
 #include "components/TouchButton.h"
 #include "styles/ModernMedicalStyle.h"
 #include "../VacuumController.h"
+#include "../patterns/PatternValidationCache.h"
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -280,6 +281,10 @@ void PatternSelector::loadPatternsFromConfig()
         return;
     }
     
+    // Validation results for these patterns persist alongside the config
+    PatternValidationCache::instance()->setCacheFilePath(
+        PatternValidationCache::cacheFilePathFor(m_configFilePath));
+
     QJsonObject root = doc.object();
     QJsonObject vacuumPatterns = root["vacuum_patterns"].toObject();
     
@@ -614,14 +614,15 @@ void SystemDiagnosticsPanel::updateSensorStatus()
     if (!m_hardwareManager) return;
 
     try {
-        double avlPressure = m_hardwareManager->readAVLPressure();
+        const SensorSnapshot snapshot = m_hardwareManager->getSensorSnapshot();
+        double avlPressure = snapshot.avlPressure;
         m_avlReadingLabel->setText(QString("%1 mmHg").arg(avlPressure, 0, 'f', 1));
 
         bool avlOK = (avlPressure >= 0.0 && avlPressure <= 200.0);
         m_avlSensorStatusLabel->setText(avlOK ? "OK" : "Error");
         m_avlSensorStatusLabel->setStyleSheet(avlOK ? "color: green;" : "color: red;");
 
-        double tankPressure = m_hardwareManager->readTankPressure();
+        double tankPressure = snapshot.tankPressure;
         m_tankReadingLabel->setText(QString("%1 mmHg").arg(tankPressure, 0, 'f', 1));
 
         bool tankOK = (tankPressure >= 0.0 && tankPressure <= 200.0);
@@ -929,8 +930,9 @@ bool SystemDiagnosticsPanel::testSPICommunication()
     if (!m_hardwareManager) return false;
 
     try {
-        double avlPressure = m_hardwareManager->readAVLPressure();
-        double tankPressure = m_hardwareManager->readTankPressure();
+        const SensorSnapshot snapshot = m_hardwareManager->getSensorSnapshot();
+        double avlPressure = snapshot.avlPressure;
+        double tankPressure = snapshot.tankPressure;
 
         return (avlPressure >= 0.0 && avlPressure <= 200.0) &&
                (tankPressure >= 0.0 && tankPressure <= 200.0);
@@ -948,8 +950,9 @@ bool SystemDiagnosticsPanel::testSensorReadings()
         QList<double> avlReadings, tankReadings;
 
         for (int i = 0; i < 5; ++i) {
-            avlReadings.append(m_hardwareManager->readAVLPressure());
-            tankReadings.append(m_hardwareManager->readTankPressure());
+            const SensorSnapshot snapshot = m_hardwareManager->getSensorSnapshot();
+            avlReadings.append(snapshot.avlPressure);
+            tankReadings.append(snapshot.tankPressure);
             QThread::msleep(100);
         }
 
@@ -1,6 +1,7 @@
 #include "ActuatorControl.h"
 #include <QDebug>
 #include <QMutexLocker>
+#include "../performance/HotPathTrace.h"
 #include <gpiod.h>
 #include <stdexcept>
 #include <cmath>
@@ -22,9 +23,12 @@ ActuatorControl::ActuatorControl(QObject *parent)
     , m_sol3State(false)
     , m_sol4State(false)
     , m_sol5State(false)
+    , m_softwarePWM(false)
+    , m_softwarePWMCounter(0)
     , m_pwmTimer(new QTimer(this))
+    , m_pwmFrequency(PWM_FREQUENCY)
 {
-    // Set up PWM update timer
+    // Software PWM fallback timer (only started when no PWM backend is available)
     m_pwmTimer->setInterval(20);  // 50Hz PWM update
     connect(m_pwmTimer, &QTimer::timeout, this, &ActuatorControl::updatePWM);
 }
@@ -39,21 +43,23 @@ bool ActuatorControl::initialize()
     try {
         qDebug() << "Initializing Actuator Control...";
         
+        // Initialize PWM first: it decides whether GPIO 18 is claimed as a
+        // plain output (software fallback) or left to the PWM peripheral
+        if (!initializePWM()) {
+            throw std::runtime_error("Failed to initialize PWM");
+        }
+        
         // Initialize GPIO
         if (!initializeGPIO()) {
             throw std::runtime_error("Failed to initialize GPIO");
         }
         
-        // Initialize PWM
-        if (!initializePWM()) {
-            throw std::runtime_error("Failed to initialize PWM");
-        }
-        
         // Set all actuators to safe initial state
         safeShutdownAll();
         
-        // Start PWM timer
-        m_pwmTimer->start();
+        if (m_softwarePWM) {
+            m_pwmTimer->start();
+        }
         
         m_initialized = true;
         qDebug() << "Actuator Control initialized successfully";
@@ -78,6 +84,10 @@ void ActuatorControl::shutdown()
     // Safe shutdown all actuators
     safeShutdownAll();
 
+    if (m_pwmBackend) {
+        m_pwmBackend->close();
+    }
+
     // Release GPIO resources using RAII (automatic cleanup)
     m_outputRequest.reset();
     m_gpioChip.reset();
@@ -106,6 +116,7 @@ void ActuatorControl::setPumpEnabled(bool enabled)
             m_pumpSpeed = 0.0;
             m_pwmValue = 0;
         }
+        applyPumpOutput();
         
         emit pumpStateChanged(m_pumpEnabled, m_pumpSpeed);
         qDebug() << "Pump" << (enabled ? "enabled" : "disabled");
@@ -134,6 +145,7 @@ void ActuatorControl::setPumpSpeed(double speedPercent)
         
         // Convert percentage to PWM value
         m_pwmValue = static_cast<int>((speedPercent / 100.0) * PWM_RANGE);
+        applyPumpOutput();
         
         emit pumpStateChanged(m_pumpEnabled, m_pumpSpeed);
         qDebug() << QString("Pump speed set to %1% (PWM: %2)").arg(speedPercent, 0, 'f', 1).arg(m_pwmValue);
@@ -194,7 +206,8 @@ void ActuatorControl::setSOL4(bool open)
         m_sol4State = open;
         setGPIOOutput(GPIO_SOL4, open);
         emit valveStateChanged(4, open);
-        qDebug() << "SOL4 (Clitoral vacuum)" << (open ? "opened" : "closed");
+        // Toggled up to ~26 times/s by the oscillator sequencer - trace, don't log
+        VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_VERBOSE, "valve.sol4", open);
     }
 }
 
@@ -206,7 +219,7 @@ void ActuatorControl::setSOL5(bool open)
         m_sol5State = open;
         setGPIOOutput(GPIO_SOL5, open);
         emit valveStateChanged(5, open);
-        qDebug() << "SOL5 (Clitoral vent)" << (open ? "opened" : "closed");
+        VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_VERBOSE, "valve.sol5", open);
     }
 }
 
@@ -223,6 +236,7 @@ void ActuatorControl::emergencyStop()
     m_pumpSpeed = 0.0;
     m_pwmValue = 0;
     setGPIOOutput(GPIO_PUMP_ENABLE, false);
+    applyPumpOutput();
     
     // Open vent valves for safety (both chambers)
     m_sol2State = true;  // Outer chamber vent valve open
@@ -299,15 +313,60 @@ bool ActuatorControl::performSelfTest()
     }
 }
 
+void ActuatorControl::setPWMFrequency(int frequency)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (frequency <= 0) {
+        qWarning() << "Invalid PWM frequency:" << frequency;
+        return;
+    }
+
+    m_pwmFrequency = frequency;
+    if (m_pwmBackend && m_pwmBackend->isOpen() && !m_pwmBackend->setFrequency(frequency)) {
+        qWarning() << "Failed to set pump PWM frequency:" << m_pwmBackend->lastError();
+        emit actuatorError("Pump", m_pwmBackend->lastError());
+    }
+}
+
+void ActuatorControl::setPWMBackend(std::unique_ptr<PWMBackend> backend)
+{
+    if (m_initialized) {
+        qWarning() << "PWM backend must be set before initialize()";
+        return;
+    }
+    m_pwmBackend = std::move(backend);
+}
+
+void ActuatorControl::applyPumpOutput()
+{
+    // Called with m_stateMutex held. One duty write per speed change; the
+    // waveform itself is produced by the PWM peripheral.
+    if (!m_pwmBackend || !m_pwmBackend->isOpen()) {
+        return;  // Software fallback reads m_pwmValue from updatePWM()
+    }
+
+    const bool active = m_pumpEnabled && !m_emergencyStop && m_pwmValue > 0;
+    const double duty = active ? static_cast<double>(m_pwmValue) / PWM_RANGE : 0.0;
+
+    if (std::abs(m_pwmBackend->dutyCycle() - duty) > 1e-6 && !m_pwmBackend->setDutyCycle(duty)) {
+        qWarning() << "Pump PWM duty update failed:" << m_pwmBackend->lastError();
+        emit actuatorError("Pump", m_pwmBackend->lastError());
+    }
+    if (m_pwmBackend->isEnabled() != active && !m_pwmBackend->setEnabled(active)) {
+        qWarning() << "Pump PWM enable failed:" << m_pwmBackend->lastError();
+        emit actuatorError("Pump", m_pwmBackend->lastError());
+    }
+}
+
 void ActuatorControl::updatePWM()
 {
-    if (m_initialized && m_pumpEnabled && !m_emergencyStop && m_outputRequest) {
-        // Simple software PWM: toggle GPIO based on PWM value
-        // This is a basic implementation - for production, consider hardware PWM
-        static int pwmCounter = 0;
-        pwmCounter = (pwmCounter + 1) % PWM_RANGE;
+    if (m_softwarePWM && m_initialized && m_pumpEnabled && !m_emergencyStop && m_outputRequest) {
+        // Software PWM fallback: toggle GPIO based on PWM value. Only used
+        // when no hardware PWM channel is available.
+        m_softwarePWMCounter = (m_softwarePWMCounter + 1) % PWM_RANGE;
 
-        bool pwmState = (pwmCounter < m_pwmValue);
+        bool pwmState = (m_softwarePWMCounter < m_pwmValue);
         try {
             gpiod::line::value value = pwmState ? gpiod::line::value::ACTIVE : gpiod::line::value::INACTIVE;
             m_outputRequest->set_value(GPIO_PUMP_PWM, value);
@@ -337,9 +396,15 @@ bool ActuatorControl::initializeGPIO()
         std::vector<gpiod::line::offset> offsets = {
             GPIO_SOL1, GPIO_SOL2, GPIO_SOL3,  // Outer chamber + tank
             GPIO_SOL4, GPIO_SOL5,              // Clitoral cylinder
-            GPIO_PUMP_ENABLE, GPIO_PUMP_PWM    // Pump control
+            GPIO_PUMP_ENABLE                   // Pump control
         };
 
+        // GPIO 18 belongs to the PWM peripheral unless we fall back to
+        // software PWM; requesting it as an output would override its pin mux
+        if (m_softwarePWM) {
+            offsets.push_back(GPIO_PUMP_PWM);
+        }
+
         gpiod::line_settings settings;
         settings.set_direction(gpiod::line::direction::OUTPUT)
                 .set_output_value(gpiod::line::value::INACTIVE);
@@ -351,7 +416,8 @@ bool ActuatorControl::initializeGPIO()
 
         qDebug() << "GPIO pins initialized using libgpiod v2.x C++ API";
         qDebug() << "Configured pins: SOL1-5 =" << GPIO_SOL1 << GPIO_SOL2 << GPIO_SOL3
-                 << GPIO_SOL4 << GPIO_SOL5 << "PUMP =" << GPIO_PUMP_ENABLE << GPIO_PUMP_PWM;
+                 << GPIO_SOL4 << GPIO_SOL5 << "PUMP =" << GPIO_PUMP_ENABLE
+                 << (m_softwarePWM ? GPIO_PUMP_PWM : -1);
         return true;
 
     } catch (const std::exception& e) {
@@ -363,12 +429,22 @@ bool ActuatorControl::initializeGPIO()
 bool ActuatorControl::initializePWM()
 {
     try {
-        // PWM is handled through the GPIO line we already set up
-        // For now, we'll use software PWM via the timer
-        // Hardware PWM could be implemented later using /sys/class/pwm
+        if (!m_pwmBackend) {
+            m_pwmBackend = std::make_unique<SysfsPWMBackend>(PUMP_PWM_CHIP, PUMP_PWM_CHANNEL);
+        }
 
-        qDebug() << QString("PWM initialized on GPIO %1 (software PWM)")
-                    .arg(GPIO_PUMP_PWM);
+        if (m_pwmBackend->open() && m_pwmBackend->setFrequency(m_pwmFrequency)) {
+            m_softwarePWM = false;
+            qDebug() << QString("Pump PWM initialized: %1 at %2 Hz")
+                        .arg(m_pwmBackend->name()).arg(m_pwmFrequency);
+            return true;
+        }
+
+        qWarning() << "Hardware PWM unavailable (" << m_pwmBackend->lastError()
+                   << ") - falling back to software PWM on GPIO" << GPIO_PUMP_PWM;
+        m_pwmBackend->close();
+        m_pwmBackend.reset();
+        m_softwarePWM = true;
         return true;
 
     } catch (const std::exception& e) {
@@ -388,8 +464,7 @@ void ActuatorControl::setGPIOOutput(int pin, bool state)
         gpiod::line::value value = state ? gpiod::line::value::ACTIVE : gpiod::line::value::INACTIVE;
         m_outputRequest->set_value(pin, value);
 
-        // Debug output for verification
-        qDebug() << "GPIO pin" << pin << "set to" << (state ? "HIGH" : "LOW");
+        VC_TRACE(HotPathTrace::GPIO, HotPathTrace::LEVEL_VERBOSE, "gpio.set", pin, state);
 
     } catch (const std::exception& e) {
         qWarning() << "Failed to set GPIO pin" << pin << "to" << state << ":" << e.what();
@@ -431,13 +506,14 @@ void ActuatorControl::safeShutdownAll()
 
     // Apply to hardware
     setGPIOOutput(GPIO_PUMP_ENABLE, false);
+    applyPumpOutput();
     setGPIOOutput(GPIO_SOL1, false);
     setGPIOOutput(GPIO_SOL2, true);
     setGPIOOutput(GPIO_SOL3, true);
     setGPIOOutput(GPIO_SOL4, false);
     setGPIOOutput(GPIO_SOL5, true);
 
-    if (m_initialized) {
+    if (m_initialized && m_softwarePWM) {
         setGPIOOutput(GPIO_PUMP_PWM, false);
     }
 
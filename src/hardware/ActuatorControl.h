@@ -9,6 +9,8 @@
 // libgpiod v2.x C++ API
 #include <gpiod.hpp>
 
+#include "PWMBackend.h"
+
 /**
  * @brief Control interface for vacuum system actuators
  *
@@ -20,6 +22,10 @@
  *   - SOL4/SOL5: Clitoral cylinder (high-frequency oscillation 5-13 Hz)
  *
  * Provides safe control with proper initialization and emergency stop.
+ *
+ * Pump speed is generated by a PWMBackend (hardware PWM via /sys/class/pwm
+ * by default). If no hardware PWM channel is available the legacy software
+ * PWM on GPIO 18 is used as a fallback.
  */
 class ActuatorControl : public QObject
 {
@@ -70,6 +76,12 @@ public:
     void setPWMFrequency(int frequency);
     int getPWMFrequency() const { return m_pwmFrequency; }
 
+    // Pump PWM output stage; must be set before initialize(). Without one,
+    // initialize() tries hardware PWM on pwmchip0/pwm0.
+    void setPWMBackend(std::unique_ptr<PWMBackend> backend);
+    PWMBackend* getPWMBackend() const { return m_pwmBackend.get(); }
+    bool isSoftwarePWM() const { return m_softwarePWM; }
+
 Q_SIGNALS:
     void actuatorError(const QString& actuator, const QString& error);
     void emergencyStopActivated();
@@ -82,6 +94,7 @@ private Q_SLOTS:
 private:
     bool initializeGPIO();
     bool initializePWM();
+    void applyPumpOutput();
     void setGPIOOutput(int pin, bool state);
     bool getGPIOState(int pin);
     void safeShutdownAll();
@@ -104,6 +117,9 @@ private:
     bool m_sol5State;    // SOL5 (GPIO 24): Clitoral cylinder vent
     
     // PWM control
+    std::unique_ptr<PWMBackend> m_pwmBackend;
+    bool m_softwarePWM;          // Fallback: toggle GPIO_PUMP_PWM from m_pwmTimer
+    int m_softwarePWMCounter;
     QTimer* m_pwmTimer;
     int m_pwmFrequency;
 
@@ -129,6 +145,8 @@ private:
     // PWM configuration
     static const int PWM_FREQUENCY = 5000;   // 5kHz as per specification
     static const int PWM_RANGE = 1024;       // PWM range (0-1024)
+    static const int PUMP_PWM_CHIP = 0;      // pwmchip0 (BCM2835 PWM)
+    static const int PUMP_PWM_CHANNEL = 0;   // PWM0 channel 0 = GPIO 18 with dtoverlay=pwm
     
     // Safety limits
     static const double MAX_PUMP_SPEED;      // Maximum allowed pump speed (%)
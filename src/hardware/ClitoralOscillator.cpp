@@ -1,19 +1,23 @@
 #include "ClitoralOscillator.h"
 #include "HardwareManager.h"
+#include "../performance/HotPathTrace.h"
 #include <QDebug>
 #include <QMutexLocker>
+#include <QThread>
 #include <cmath>
 #include <algorithm>
 
 ClitoralOscillator::ClitoralOscillator(HardwareManager* hardware, QObject *parent)
     : QObject(parent)
     , m_hardware(hardware)
-    , m_oscillationTimer(new QTimer(this))
+    , m_sequencerThread(nullptr)
+    , m_scheduleDirty(false)
+    , m_fifoActive(false)
     , m_running(false)
     , m_currentPhase(Phase::IDLE)
     , m_cycleCount(0)
     , m_frequencyHz(DEFAULT_FREQUENCY_HZ)
-    , m_periodMs(static_cast<int>(1000.0 / DEFAULT_FREQUENCY_HZ))
+    , m_periodMs(1000.0 / DEFAULT_FREQUENCY_HZ)
     , m_suctionRatio(DEFAULT_SUCTION_RATIO)
     , m_holdRatio(DEFAULT_HOLD_RATIO)
     , m_ventRatio(DEFAULT_VENT_RATIO)
@@ -23,10 +27,8 @@ ClitoralOscillator::ClitoralOscillator(HardwareManager* hardware, QObject *paren
     , m_measuredPeakPressure(0.0)
     , m_measuredTroughPressure(0.0)
 {
-    // High-precision timer for smooth oscillation
-    m_oscillationTimer->setTimerType(Qt::PreciseTimer);
-    m_oscillationTimer->setInterval(TIMER_RESOLUTION_MS);
-    connect(m_oscillationTimer, &QTimer::timeout, this, &ClitoralOscillator::onTimerTick);
+    // phaseChanged is emitted from the sequencer thread
+    qRegisterMetaType<ClitoralOscillator::Phase>("ClitoralOscillator::Phase");
 
     // Calculate initial phase durations
     calculatePhaseDurations();
@@ -40,79 +42,87 @@ ClitoralOscillator::ClitoralOscillator(HardwareManager* hardware, QObject *paren
 ClitoralOscillator::~ClitoralOscillator()
 {
     stop();
+    joinSequencer();
 }
 
 void ClitoralOscillator::start()
 {
-    QMutexLocker locker(&m_mutex);
+    {
+        QMutexLocker locker(&m_mutex);
 
-    if (m_running) {
-        qWarning() << "ClitoralOscillator already running";
-        return;
-    }
+        if (m_running) {
+            qWarning() << "ClitoralOscillator already running";
+            return;
+        }
 
-    if (!m_hardware || !m_hardware->isReady()) {
-        emit error("Hardware not ready");
-        return;
+        if (!m_hardware || !m_hardware->isReady()) {
+            emit error("Hardware not ready");
+            return;
+        }
     }
 
+    // A previous emergencyStop() may have left the old thread finishing its sleep
+    joinSequencer();
+
     qDebug() << "Starting ClitoralOscillator at" << m_frequencyHz << "Hz";
 
     m_running = true;
     m_cycleCount = 0;
     m_currentPhase = Phase::SUCTION;
-    m_phaseTimer.start();
+    m_scheduleDirty = true;
 
-    // Start with suction phase
-    executePhase(Phase::SUCTION);
+    m_sequencerThread = QThread::create([this]() { runSequencer(); });
+    m_sequencerThread->setObjectName("ClitoralSequencer");
+    m_sequencerThread->start(QThread::TimeCriticalPriority);
 
-    m_oscillationTimer->start();
     emit oscillationStarted();
 }
 
 void ClitoralOscillator::stop()
 {
-    QMutexLocker locker(&m_mutex);
-
-    if (!m_running) {
+    if (!m_running.exchange(false)) {
         return;
     }
 
     qDebug() << "Stopping ClitoralOscillator after" << m_cycleCount << "cycles";
 
-    m_oscillationTimer->stop();
-    m_running = false;
-    m_currentPhase = Phase::IDLE;
-
-    // Safety: vent the clitoral cylinder
-    if (m_hardware) {
-        m_hardware->setSOL4(false);  // Close vacuum
-        m_hardware->setSOL5(true);   // Open vent
+    {
+        // Once we hold the valve lock the sequencer can no longer open SOL4
+        std::lock_guard<std::mutex> valveLock(m_valveMutex);
+        m_currentPhase = Phase::IDLE;
+        applyPhaseValves(Phase::IDLE);  // Safety: vent the clitoral cylinder
     }
 
+    joinSequencer();
     emit oscillationStopped();
 }
 
 void ClitoralOscillator::emergencyStop()
 {
-    QMutexLocker locker(&m_mutex);
-
     qWarning() << "ClitoralOscillator EMERGENCY STOP";
 
-    // Immediately stop the timer
-    m_oscillationTimer->stop();
     m_running = false;
-    m_currentPhase = Phase::IDLE;
 
-    // Safety: Immediately vent the clitoral cylinder to release all pressure
-    if (m_hardware) {
-        m_hardware->setSOL4(false);  // Close vacuum source
-        m_hardware->setSOL5(true);   // Open vent to atmosphere
+    {
+        // Vent immediately; the sequencer exits at its next deadline
+        // without touching the valves again
+        std::lock_guard<std::mutex> valveLock(m_valveMutex);
+        m_currentPhase = Phase::IDLE;
+        applyPhaseValves(Phase::IDLE);
     }
 
     emit oscillationStopped();
 }
 
+void ClitoralOscillator::joinSequencer()
+{
+    if (m_sequencerThread) {
+        m_sequencerThread->wait();
+        delete m_sequencerThread;
+        m_sequencerThread = nullptr;
+    }
+}
+
 void ClitoralOscillator::pulse(double intensity, int durationMs)
 {
     QMutexLocker locker(&m_mutex);
@@ -154,7 +164,7 @@ void ClitoralOscillator::setFrequency(double frequencyHz)
     }
 
     m_frequencyHz = frequencyHz;
-    m_periodMs = static_cast<int>(1000.0 / frequencyHz);
+    m_periodMs = 1000.0 / frequencyHz;
 
     calculatePhaseDurations();
 
@@ -185,7 +195,8 @@ void ClitoralOscillator::setDutyCycle(double dutyCycle)
 
     calculatePhaseDurations();
 
-    qDebug() << "ClitoralOscillator duty cycle set to" << (m_dutyCycle * 100) << "%";
+    // Called from adjustAmplitude() every few cycles - trace, don't log
+    VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_DEBUG, "osc.duty_cycle", m_dutyCycle);
 }
 
 void ClitoralOscillator::setPhaseTiming(double suctionRatio, double holdRatio,
@@ -210,7 +221,8 @@ void ClitoralOscillator::setPhaseTiming(double suctionRatio, double holdRatio,
 double ClitoralOscillator::getCurrentPressure() const
 {
     if (m_hardware) {
-        return m_hardware->readClitoralPressure();
+        // Lock-free when the acquisition thread is publishing snapshots
+        return m_hardware->getSensorSnapshot().clitoralPressure;
     }
     return 0.0;
 }
@@ -257,25 +269,38 @@ void ClitoralOscillator::setPresetAfterGlow()
 
 void ClitoralOscillator::calculatePhaseDurations()
 {
-    // Calculate phase durations based on period and ratios
-    m_suctionDurationMs = static_cast<int>(m_periodMs * m_suctionRatio);
-    m_holdDurationMs = static_cast<int>(m_periodMs * m_holdRatio);
-    m_ventDurationMs = static_cast<int>(m_periodMs * m_ventRatio);
-    m_transitionDurationMs = static_cast<int>(m_periodMs * m_transitionRatio);
-
-    // Ensure minimum 1ms for each phase
-    m_suctionDurationMs = std::max(1, m_suctionDurationMs);
-    m_holdDurationMs = std::max(1, m_holdDurationMs);
-    m_ventDurationMs = std::max(1, m_ventDurationMs);
-    m_transitionDurationMs = std::max(1, m_transitionDurationMs);
-
-    qDebug() << "Phase durations (ms): Suction=" << m_suctionDurationMs
-             << "Hold=" << m_holdDurationMs
-             << "Vent=" << m_ventDurationMs
-             << "Transition=" << m_transitionDurationMs;
+    // Called with m_mutex held. Durations are kept in nanoseconds so e.g.
+    // 11 Hz does not lose 0.9 ms per cycle to integer truncation.
+    const double ratios[PhaseSchedule::EDGE_COUNT] = {
+        m_suctionRatio, m_holdRatio, m_ventRatio, m_transitionRatio
+    };
+
+    PhaseSchedule schedule;
+    int64_t offsetNs = 0;
+    for (int i = 0; i < PhaseSchedule::EDGE_COUNT; ++i) {
+        schedule.edgeOffsetNs[i] = offsetNs;
+        const double durationMs = std::max(MIN_PHASE_DURATION_MS, m_periodMs * ratios[i]);
+        offsetNs += static_cast<int64_t>(durationMs * 1e6);
+    }
+    schedule.periodNs = offsetNs;
+
+    m_schedule = schedule;
+    m_scheduleDirty = true;
+
+    VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_DEBUG, "osc.phase_edges_us",
+             schedule.edgeOffsetNs[1] / 1000, schedule.edgeOffsetNs[2] / 1000,
+             schedule.edgeOffsetNs[3] / 1000, schedule.periodNs / 1000);
 }
 
-void ClitoralOscillator::executePhase(Phase phase)
+ClitoralOscillator::Phase ClitoralOscillator::edgePhase(int edgeIndex)
+{
+    static const Phase phases[PhaseSchedule::EDGE_COUNT] = {
+        Phase::SUCTION, Phase::HOLD, Phase::VENT, Phase::TRANSITION
+    };
+    return phases[edgeIndex];
+}
+
+void ClitoralOscillator::applyPhaseValves(Phase phase)
 {
     if (!m_hardware) return;
 
@@ -314,75 +339,80 @@ void ClitoralOscillator::executePhase(Phase phase)
             m_hardware->setSOL5(true);
             break;
     }
-
-    emit phaseChanged(phase);
 }
 
-void ClitoralOscillator::advancePhase()
+void ClitoralOscillator::runSequencer()
 {
-    Phase nextPhase;
+    m_fifoActive = RealTime::setFifoPriority(SEQUENCER_FIFO_PRIORITY);
+    if (!m_fifoActive) {
+        qWarning() << "ClitoralOscillator: SCHED_FIFO not permitted, valve timing uses normal scheduling";
+    }
 
-    switch (m_currentPhase) {
-        case Phase::SUCTION:
-            nextPhase = Phase::HOLD;
-            break;
-        case Phase::HOLD:
-            nextPhase = Phase::VENT;
-            break;
-        case Phase::VENT:
-            nextPhase = Phase::TRANSITION;
-            break;
-        case Phase::TRANSITION:
-            nextPhase = Phase::SUCTION;
-            m_cycleCount++;
-            emit cycleCompleted(m_cycleCount);
-            // Adjust amplitude every few cycles based on measured pressure
-            if (m_cycleCount % 5 == 0) {
-                adjustAmplitude();
+    PhaseSchedule schedule;
+    int64_t cycleStartNs = RealTime::monotonicNowNs();
+
+    while (m_running) {
+        // Parameter changes are adopted only at a cycle boundary so a cycle
+        // never mixes two schedules. Never block on the GUI-side mutex here.
+        if (schedule.periodNs == 0) {
+            QMutexLocker locker(&m_mutex);  // First cycle: must have a schedule
+            schedule = m_schedule;
+            m_scheduleDirty = false;
+        } else if (m_scheduleDirty && m_mutex.tryLock()) {
+            schedule = m_schedule;
+            m_scheduleDirty = false;
+            m_mutex.unlock();
+        }
+
+        for (int edge = 0; edge < PhaseSchedule::EDGE_COUNT; ++edge) {
+            const int64_t deadlineNs = cycleStartNs + schedule.edgeOffsetNs[edge];
+            RealTime::sleepUntilNs(deadlineNs);
+
+            const Phase phase = edgePhase(edge);
+            {
+                std::lock_guard<std::mutex> valveLock(m_valveMutex);
+                if (!m_running) {
+                    return;  // stop()/emergencyStop() already vented
+                }
+                m_edgeStats.record(RealTime::monotonicNowNs() - deadlineNs);
+                applyPhaseValves(phase);
+                m_currentPhase = phase;
             }
-            break;
-        default:
-            return;
-    }
 
-    m_currentPhase = nextPhase;
-    m_phaseTimer.restart();
-    executePhase(nextPhase);
+            VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_VERBOSE, "osc.phase_edge",
+                     static_cast<int>(phase), m_edgeStats.lastErrorUs(), m_cycleCount.load());
+            emit phaseChanged(phase);
+        }
+
+        cycleStartNs += schedule.periodNs;
+
+        const int cycles = ++m_cycleCount;
+        emit cycleCompleted(cycles);
+
+        // Adjust amplitude every few cycles based on measured pressure. The
+        // adjustment touches m_mutex, so run it on the owning thread.
+        if (cycles % 5 == 0) {
+            const double peak = m_measuredPeakPressure;
+            QMetaObject::invokeMethod(this, [this, peak]() { adjustAmplitude(peak); }, Qt::QueuedConnection);
+        }
+
+        // If a whole cycle was missed (e.g. preempted), restart the cycle now
+        // instead of firing a burst of stale edges
+        const int64_t nowNs = RealTime::monotonicNowNs();
+        if (nowNs - cycleStartNs > schedule.periodNs) {
+            m_edgeStats.recordOverrun();
+            cycleStartNs = nowNs;
+        }
+    }
 }
 
-void ClitoralOscillator::onTimerTick()
+void ClitoralOscillator::adjustAmplitude(double measuredPeak)
 {
     if (!m_running) return;
 
-    qint64 elapsedMs = m_phaseTimer.elapsed();
-    int currentPhaseDuration = 0;
-
-    switch (m_currentPhase) {
-        case Phase::SUCTION:
-            currentPhaseDuration = m_suctionDurationMs;
-            break;
-        case Phase::HOLD:
-            currentPhaseDuration = m_holdDurationMs;
-            break;
-        case Phase::VENT:
-            currentPhaseDuration = m_ventDurationMs;
-            break;
-        case Phase::TRANSITION:
-            currentPhaseDuration = m_transitionDurationMs;
-            break;
-        default:
-            return;
-    }
-
-    if (elapsedMs >= currentPhaseDuration) {
-        advancePhase();
-    }
-}
-
-void ClitoralOscillator::adjustAmplitude()
-{
     // Simple amplitude feedback: adjust duty cycle based on measured peak
-    double peakError = m_targetAmplitude - m_measuredPeakPressure;
+    const double targetAmplitude = m_targetAmplitude.load(std::memory_order_relaxed);
+    double peakError = targetAmplitude - measuredPeak;
 
     if (std::abs(peakError) > 5.0) {  // Only adjust if error > 5 mmHg
         // Increase duty cycle if we need more vacuum, decrease if too much
@@ -392,10 +422,9 @@ void ClitoralOscillator::adjustAmplitude()
         // Apply with clamping (done inside setDutyCycle)
         setDutyCycle(newDutyCycle);
 
-        qDebug() << "Amplitude adjustment: target=" << m_targetAmplitude
-                 << "measured=" << m_measuredPeakPressure
-                 << "new duty cycle=" << (m_dutyCycle * 100) << "%";
+        VC_TRACE(HotPathTrace::OSCILLATOR, HotPathTrace::LEVEL_DEBUG, "osc.amplitude_adjust",
+                 targetAmplitude, measuredPeak, m_dutyCycle);
     }
 
-    emit amplitudeReached(m_measuredPeakPressure);
+    emit amplitudeReached(measuredPeak);
 }
@@ -3,11 +3,15 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QElapsedTimer>
 #include <QMutex>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include "../safety/SafetyConstants.h"
+#include "../threading/RealTimeSupport.h"
 
 class HardwareManager;
+class QThread;
 
 /**
  * @brief High-frequency oscillation controller for clitoral cylinder air-pulse stimulation
@@ -27,6 +31,13 @@ class HardwareManager;
  * 2. HOLD:    Both closed - peak pressure maintained
  * 3. VENT:    SOL4 closed, SOL5 open - rapid pressure release
  * 4. TRANSITION: Both closed - minimum pressure before next cycle
+ *
+ * Phase sequencing runs on a dedicated high-priority thread (SCHED_FIFO
+ * when permitted). The four phase edges of a cycle are precomputed in
+ * nanoseconds from the frequency and phase ratios, and the thread sleeps to
+ * absolute CLOCK_MONOTONIC deadlines, so valve timing no longer depends on
+ * how busy any event loop is. Parameter changes take effect at the next
+ * cycle boundary. Every edge's lateness is recorded for timing statistics.
  */
 class ClitoralOscillator : public QObject
 {
@@ -74,9 +85,18 @@ public:
                        double ventRatio, double transitionRatio);
 
     // Current state
-    Phase getCurrentPhase() const { return m_currentPhase; }
+    Phase getCurrentPhase() const { return m_currentPhase.load(); }
     double getCurrentPressure() const;
-    int getCycleCount() const { return m_cycleCount; }
+    int getCycleCount() const { return m_cycleCount.load(); }
+
+    // Phase-edge timing statistics (lateness of each valve edge vs. schedule)
+    double getPhaseEdgeMeanErrorUs() const { return m_edgeStats.meanAbsErrorUs(); }
+    double getPhaseEdgeMaxErrorUs() const { return m_edgeStats.maxErrorUs(); }
+    double getPhaseEdgeLastErrorUs() const { return m_edgeStats.lastErrorUs(); }
+    quint64 getPhaseEdgeCount() const { return m_edgeStats.count(); }
+    quint64 getMissedCycleCount() const { return m_edgeStats.overruns(); }
+    void resetTimingStatistics() { m_edgeStats.reset(); }
+    bool isRealTimeSchedulingActive() const { return m_fifoActive.load(); }
 
     // Presets based on research
     void setPresetWarmup();    // 5 Hz, low amplitude
@@ -92,32 +112,45 @@ Q_SIGNALS:
     void amplitudeReached(double pressure);
     void error(const QString& message);
 
-private Q_SLOTS:
-    void onTimerTick();
-
 private:
+    /**
+     * @brief Precomputed edge times of one oscillation cycle
+     *
+     * edgeOffsetNs[i] is the start of phase i (SUCTION, HOLD, VENT,
+     * TRANSITION) relative to the cycle start.
+     */
+    struct PhaseSchedule {
+        static const int EDGE_COUNT = 4;
+        int64_t periodNs = 0;
+        int64_t edgeOffsetNs[EDGE_COUNT] = {0, 0, 0, 0};
+    };
+
     void calculatePhaseDurations();
-    void executePhase(Phase phase);
-    void advancePhase();
-    void adjustAmplitude();
+    void applyPhaseValves(Phase phase);
+    void runSequencer();
+    void joinSequencer();
+    void adjustAmplitude(double measuredPeak);
+    static Phase edgePhase(int edgeIndex);
 
     HardwareManager* m_hardware;
-    QTimer* m_oscillationTimer;
-    QElapsedTimer m_phaseTimer;
     mutable QMutex m_mutex;
 
+    // Sequencer thread
+    QThread* m_sequencerThread;
+    std::mutex m_valveMutex;              // Orders sequencer valve writes against stop/emergencyStop
+    std::atomic<bool> m_scheduleDirty;    // Set by parameter changes, consumed at cycle boundary
+    PhaseSchedule m_schedule;             // Guarded by m_mutex
+    RealTime::TimingStats m_edgeStats;
+    std::atomic<bool> m_fifoActive;
+
     // State
-    bool m_running;
-    Phase m_currentPhase;
-    int m_cycleCount;
-
-    // Frequency and timing (in milliseconds)
-    double m_frequencyHz;         // Oscillation frequency (5-13 Hz)
-    int m_periodMs;               // Total period = 1000/frequency
-    int m_suctionDurationMs;      // Duration of suction phase
-    int m_holdDurationMs;         // Duration of hold phase
-    int m_ventDurationMs;         // Duration of vent phase
-    int m_transitionDurationMs;   // Duration of transition phase
+    std::atomic<bool> m_running;
+    std::atomic<Phase> m_currentPhase;
+    std::atomic<int> m_cycleCount;
+
+    // Frequency and timing
+    std::atomic<double> m_frequencyHz;      // Oscillation frequency (5-13 Hz)
+    double m_periodMs;            // Total period = 1000/frequency
 
     // Phase timing ratios (must sum to 1.0)
     double m_suctionRatio;
@@ -126,13 +159,14 @@ private:
     double m_transitionRatio;
 
     // Amplitude control
-    double m_targetAmplitude;     // Target peak pressure (mmHg)
+    std::atomic<double> m_targetAmplitude;  // Target peak pressure (mmHg)
     double m_dutyCycle;           // Suction duty cycle (0.0 - 1.0)
-    double m_measuredPeakPressure;
-    double m_measuredTroughPressure;
+    std::atomic<double> m_measuredPeakPressure;
+    std::atomic<double> m_measuredTroughPressure;
 
-    // Timer resolution
-    static const int TIMER_RESOLUTION_MS = 1;  // 1ms for high-frequency control
+    // Sequencer scheduling
+    static const int SEQUENCER_FIFO_PRIORITY = 85;      // Above acquisition (80)
+    static constexpr double MIN_PHASE_DURATION_MS = 1.0;
 
     // Frequency limits (based on research)
     static constexpr double MIN_FREQUENCY_HZ = 3.0;
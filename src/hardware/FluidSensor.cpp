@@ -25,7 +25,7 @@ FluidSensor::FluidSensor(SensorType type, QObject* parent)
     , m_gpioData(DEFAULT_HX711_DATA_GPIO)
     , m_gpioClock(DEFAULT_HX711_CLOCK_GPIO)
     , m_hx711Gain(128)
-    , m_updateTimer(new QTimer(this))
+    , m_updateTimer(new ControlTimer(this))
     , m_currentVolumeMl(0.0)
     , m_cumulativeVolumeMl(0.0)
     , m_lubricationVolumeMl(0.0)
@@ -54,7 +54,7 @@ FluidSensor::FluidSensor(SensorType type, QObject* parent)
     m_volumeHistory.fill(0.0);
     m_lastEvent = {FluidEventType::LUBRICATION, 0.0, 0.0, 0, -1};
     
-    connect(m_updateTimer, &QTimer::timeout, this, &FluidSensor::onUpdateTick);
+    connect(m_updateTimer, &ControlTimer::timeout, this, &FluidSensor::onUpdateTick);
     
     qDebug() << "FluidSensor created with type:" << static_cast<int>(type);
 }
@@ -64,6 +64,11 @@ FluidSensor::~FluidSensor()
     shutdown();
 }
 
+void FluidSensor::attachToScheduler(ControlScheduler* scheduler, int offset)
+{
+    m_updateTimer->attach(scheduler, ControlScheduler::Stage::SENSE, "FluidSensor.update", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+}
+
 bool FluidSensor::initialize()
 {
     if (m_sensorType == SensorType::LOAD_CELL_HX711) {
@@ -7,6 +7,7 @@
 #include <QMutex>
 #include <QVector>
 #include <memory>
+#include "../threading/ControlScheduler.h"
 
 /**
  * @brief Fluid Collection Sensor for measuring arousal lubrication and orgasmic fluid
@@ -61,6 +62,10 @@ public:
                          QObject* parent = nullptr);
     ~FluidSensor();
 
+    // Drive the periodic tick from the shared control scheduler; offset is
+    // the cycle within each period it runs on
+    void attachToScheduler(ControlScheduler* scheduler, int offset = 0);
+
     // Initialization
     bool initialize();
     bool initializeHX711(int gpioData = 26, int gpioClock = 19);
@@ -161,7 +166,7 @@ private:
     int m_hx711Gain;
 
     // Timing
-    QTimer* m_updateTimer;
+    ControlTimer* m_updateTimer;
     QElapsedTimer m_sessionTimer;
     QElapsedTimer m_flowTimer;
 
@@ -6,9 +6,13 @@
 #include "FluidSensor.h"
 #include "MotionSensor.h"
 #include "ClitoralOscillator.h"
+#include "HeartRateSensor.h"
+#include "../logging/SessionRecording.h"
+#include "../logging/DataLogger.h"
 
 #include <QDebug>
 #include <QMutexLocker>
+#include <QDateTime>
 // Modern GPIO library using libgpiod
 #include <gpiod.h>
 #include <stdexcept>
@@ -24,10 +28,15 @@ HardwareManager::HardwareManager(QObject *parent)
     , m_sol3State(false)
     , m_sol4State(false)
     , m_sol5State(false)
+    , m_snapshotMaxAgeMs(DEFAULT_SNAPSHOT_MAX_AGE_MS)
+    , m_sessionRecorder(nullptr)
+    , m_sensorLogger(nullptr)
+    , m_heartRateSensor(nullptr)
     , m_simulationMode(false)
     , m_simulatedAVLPressure(0.0)
     , m_simulatedTankPressure(0.0)
     , m_simulatedClitoralPressure(0.0)
+    , m_plantTimeNs(0)
 {
 }
 
@@ -103,6 +112,10 @@ bool HardwareManager::initialize()
                     this, [this](const QString& reason) {
                 emit hardwareError(QString("TENS fault: %1").arg(reason));
             });
+            // Soft start/stop ramps move the amplitude on the TENS ramp timer,
+            // outside every setter; record each step as it is applied
+            connect(m_tensController.get(), &TENSController::amplitudeChanged,
+                    this, [this]() { recordActuatorState(); });
             qDebug() << "TENS Controller initialized for clitoral cup electrodes";
         }
 
@@ -192,9 +205,15 @@ void HardwareManager::shutdown()
 
 double HardwareManager::readAVLPressure()
 {
+    SensorSnapshot snapshot;
+    if (readFreshSnapshot(snapshot)) {
+        return snapshot.avlPressure;
+    }
+
     QMutexLocker locker(&m_stateMutex);
 
     if (m_simulationMode) {
+        syncPlantLocked();
         return m_simulatedAVLPressure;
     }
 
@@ -206,9 +225,15 @@ double HardwareManager::readAVLPressure()
 
 double HardwareManager::readTankPressure()
 {
+    SensorSnapshot snapshot;
+    if (readFreshSnapshot(snapshot)) {
+        return snapshot.tankPressure;
+    }
+
     QMutexLocker locker(&m_stateMutex);
 
     if (m_simulationMode) {
+        syncPlantLocked();
         return m_simulatedTankPressure;
     }
 
@@ -220,9 +245,15 @@ double HardwareManager::readTankPressure()
 
 double HardwareManager::readClitoralPressure()
 {
+    SensorSnapshot snapshot;
+    if (readFreshSnapshot(snapshot)) {
+        return snapshot.clitoralPressure;
+    }
+
     QMutexLocker locker(&m_stateMutex);
 
     if (m_simulationMode) {
+        syncPlantLocked();
         return m_simulatedClitoralPressure;
     }
 
@@ -232,6 +263,160 @@ double HardwareManager::readClitoralPressure()
     return m_sensorInterface->getFilteredClitoralPressure();
 }
 
+SensorSnapshot HardwareManager::sampleAllChannelsLocked()
+{
+    // Caller holds m_stateMutex
+    SensorSnapshot snapshot;
+    snapshot.monotonicNs = SensorSnapshot::monotonicNowNs();
+    snapshot.timestampMs = QDateTime::currentMSecsSinceEpoch();
+
+    if (m_simulationMode) {
+        syncPlantLocked();
+        snapshot.avlPressure = m_simulatedAVLPressure;
+        snapshot.tankPressure = m_simulatedTankPressure;
+        snapshot.clitoralPressure = m_simulatedClitoralPressure;
+        snapshot.flags |= SensorSnapshot::SIMULATED;
+    } else {
+        if (!m_sensorInterface) {
+            throw std::runtime_error("Sensor interface not initialized");
+        }
+        snapshot.avlPressure = m_sensorInterface->getFilteredAVLPressure();
+        snapshot.tankPressure = m_sensorInterface->getFilteredTankPressure();
+        snapshot.clitoralPressure = m_sensorInterface->getFilteredClitoralPressure();
+    }
+
+    if (snapshot.avlPressure >= 0.0) snapshot.flags |= SensorSnapshot::AVL_VALID;
+    if (snapshot.tankPressure >= 0.0) snapshot.flags |= SensorSnapshot::TANK_VALID;
+    if (snapshot.clitoralPressure >= 0.0) snapshot.flags |= SensorSnapshot::CLITORAL_VALID;
+
+    if (m_heartRateSensor && m_heartRateSensor->isReady()) {
+        const int bpm = m_heartRateSensor->getCurrentBPM();
+        if (bpm > 0) {
+            snapshot.heartRateBpm = bpm;
+            snapshot.flags |= SensorSnapshot::HEART_RATE_VALID;
+        }
+    }
+    if (m_fluidSensor && m_fluidSensor->isReady()) {
+        snapshot.fluidMl = m_fluidSensor->getCumulativeVolumeMl();
+        snapshot.flags |= SensorSnapshot::FLUID_VALID;
+    }
+    if (m_pumpEnabled) snapshot.flags |= SensorSnapshot::PUMP_ON;
+    if (m_emergencyStop) snapshot.flags |= SensorSnapshot::EMERGENCY_STOP;
+
+    return snapshot;
+}
+
+SensorSnapshot HardwareManager::publishSensorSnapshot()
+{
+    SensorSnapshot snapshot;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        snapshot = sampleAllChannelsLocked();
+    }
+
+    // Publishing happens outside the state mutex; only the acquisition owner
+    // calls this, which satisfies the bus's single-producer requirement.
+    snapshot.sequence = m_snapshotBus.publish(snapshot);
+
+    SessionRecorder* recorder = m_sessionRecorder.load(std::memory_order_acquire);
+    if (recorder && recorder->isOpen()) {
+        SessionRecording::SensorRecord record;
+        record.timestampMs = snapshot.timestampMs;
+        record.avlPressure = snapshot.avlPressure;
+        record.tankPressure = snapshot.tankPressure;
+        record.clitoralPressure = snapshot.clitoralPressure;
+        record.flags = snapshot.flags;
+        recorder->append(record);
+    }
+
+    if (DataLogger* logger = m_sensorLogger.load(std::memory_order_acquire)) {
+        logger->logSensorSnapshot(snapshot);
+    }
+    return snapshot;
+}
+
+bool HardwareManager::readFreshSnapshot(SensorSnapshot& snapshot) const
+{
+    snapshot = m_snapshotBus.read();
+    return snapshot.isPublished() && snapshot.ageMs() <= m_snapshotMaxAgeMs;
+}
+
+SensorSnapshot HardwareManager::getSensorSnapshot()
+{
+    SensorSnapshot snapshot;
+    if (readFreshSnapshot(snapshot)) {
+        return snapshot;
+    }
+
+    // No live acquisition owner - sample directly so callers still get a
+    // coherent set of channels. Not published: this thread is not the producer.
+    QMutexLocker locker(&m_stateMutex);
+    return sampleAllChannelsLocked();
+}
+
+void HardwareManager::setSessionRecorder(SessionRecorder* recorder)
+{
+    m_sessionRecorder.store(recorder, std::memory_order_release);
+    recordActuatorState();      // Outputs in force when recording starts
+}
+
+void HardwareManager::setSensorLogger(DataLogger* logger)
+{
+    m_sensorLogger.store(logger, std::memory_order_release);
+}
+
+void HardwareManager::setHeartRateSensor(HeartRateSensor* sensor)
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_heartRateSensor = sensor;
+
+    // An analog pulse sensor on our ADC is sampled in the pressure scan, so
+    // it reads the cached value instead of issuing its own SPI transfer
+    if (m_sensorInterface) {
+        const bool onOurAdc = sensor && m_adc && sensor->getADC() == m_adc.get();
+        const int channel = onOurAdc ? sensor->getADCChannel() : -1;
+        m_sensorInterface->setAuxiliaryScanChannels(channel >= 0 && channel < 8 ? uint8_t(1u << channel) : 0);
+    }
+}
+
+void HardwareManager::recordActuatorState()
+{
+    QMutexLocker locker(&m_stateMutex);
+    recordActuatorStateLocked();
+}
+
+void HardwareManager::recordActuatorStateLocked()
+{
+    // Caller holds m_stateMutex
+    SessionRecorder* recorder = m_sessionRecorder.load(std::memory_order_acquire);
+    if (!recorder || !recorder->isOpen()) {
+        return;
+    }
+
+    using SessionRecording::ActuatorRecord;
+    ActuatorRecord record;
+    record.outputs = (m_sol1State ? ActuatorRecord::SOL1 : 0)
+                   | (m_sol2State ? ActuatorRecord::SOL2 : 0)
+                   | (m_sol3State ? ActuatorRecord::SOL3 : 0)
+                   | (m_sol4State ? ActuatorRecord::SOL4 : 0)
+                   | (m_sol5State ? ActuatorRecord::SOL5 : 0)
+                   | (m_pumpEnabled ? ActuatorRecord::PUMP_ON : 0)
+                   | (m_emergencyStop ? ActuatorRecord::EMERGENCY_STOP : 0);
+    record.pumpSpeedPercent = m_pumpSpeed;
+    if (m_clitoralOscillator) {
+        if (m_clitoralOscillator->isRunning()) record.outputs |= ActuatorRecord::OSCILLATOR_RUNNING;
+        record.oscillatorFrequencyHz = m_clitoralOscillator->getFrequency();
+        record.oscillatorAmplitudeMmHg = m_clitoralOscillator->getAmplitude();
+    }
+    if (m_tensController) {
+        if (m_tensController->isRunning()) record.outputs |= ActuatorRecord::TENS_RUNNING;
+        record.tensFrequencyHz = m_tensController->getFrequency();
+        record.tensAmplitudePercent = m_tensController->getAmplitude();
+        record.tensPulseWidthUs = m_tensController->getPulseWidth();
+    }
+    recorder->append(record);
+}
+
 double HardwareManager::readFluidVolumeMl()
 {
     QMutexLocker locker(&m_stateMutex);
@@ -280,6 +465,8 @@ void HardwareManager::setPumpSpeed(double speedPercent)
     if (m_actuatorControl && !m_simulationMode) {
         m_actuatorControl->setPumpSpeed(speedPercent);
     }
+    syncPlantLocked();
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setPumpEnabled(bool enabled)
@@ -298,6 +485,8 @@ void HardwareManager::setPumpEnabled(bool enabled)
     if (m_actuatorControl && !m_simulationMode) {
         m_actuatorControl->setPumpEnabled(enabled);
     }
+    syncPlantLocked();
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setSOL1(bool open)
@@ -309,30 +498,43 @@ void HardwareManager::setSOL1(bool open)
         return;
     }
     
-    if (m_actuatorControl) {
+    if (m_simulationMode) {
+        // Track valve state so the plant model sees it
+        m_sol1State = open;
+        syncPlantLocked();
+    } else if (m_actuatorControl) {
         m_actuatorControl->setSOL1(open);
         m_sol1State = open;
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setSOL2(bool open)
 {
     QMutexLocker locker(&m_stateMutex);
     
-    if (m_actuatorControl) {
+    if (m_simulationMode) {
+        m_sol2State = open;
+        syncPlantLocked();
+    } else if (m_actuatorControl) {
         m_actuatorControl->setSOL2(open);
         m_sol2State = open;
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setSOL3(bool open)
 {
     QMutexLocker locker(&m_stateMutex);
 
-    if (m_actuatorControl) {
+    if (m_simulationMode) {
+        m_sol3State = open;
+        syncPlantLocked();
+    } else if (m_actuatorControl) {
         m_actuatorControl->setSOL3(open);
         m_sol3State = open;
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setSOL4(bool open)
@@ -344,20 +546,28 @@ void HardwareManager::setSOL4(bool open)
         return;
     }
 
-    if (m_actuatorControl) {
+    if (m_simulationMode) {
+        m_sol4State = open;
+        syncPlantLocked();
+    } else if (m_actuatorControl) {
         m_actuatorControl->setSOL4(open);
         m_sol4State = open;
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setSOL5(bool open)
 {
     QMutexLocker locker(&m_stateMutex);
 
-    if (m_actuatorControl) {
+    if (m_simulationMode) {
+        m_sol5State = open;
+        syncPlantLocked();
+    } else if (m_actuatorControl) {
         m_actuatorControl->setSOL5(open);
         m_sol5State = open;
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::emergencyStop()
@@ -404,6 +614,8 @@ void HardwareManager::enterSealMaintainedSafeState(const QString& reason)
     m_sol3State = true;
     m_sol4State = false;
     m_sol5State = true;
+    syncPlantLocked();
+    recordActuatorStateLocked();
 
     emit hardwareError("Seal-maintained safe state activated");
 }
@@ -434,6 +646,7 @@ void HardwareManager::enterFullVentState(const QString& reason)
     m_sol3State = true;   // Tank vent open
     m_sol4State = false;  // Clitoral vacuum closed
     m_sol5State = true;   // Clitoral vent open
+    recordActuatorStateLocked();
 
     emit hardwareError("Full-vent emergency state activated");
 }
@@ -449,6 +662,7 @@ bool HardwareManager::resetEmergencyStop()
     if (m_actuatorControl && m_actuatorControl->resetEmergencyStop()) {
         m_emergencyStop = false;
         qDebug() << "Hardware emergency stop reset";
+        recordActuatorStateLocked();
         return true;
     }
     
@@ -548,6 +762,7 @@ void HardwareManager::safeShutdown()
     // Clitoral cylinder: close vacuum, open vent
     m_sol4State = false; // Clitoral cylinder vacuum closed
     m_sol5State = true;  // Clitoral cylinder vent valve open
+    syncPlantLocked();
 }
 
 void HardwareManager::setSimulationMode(bool enabled)
@@ -565,6 +780,7 @@ void HardwareManager::setSimulationMode(bool enabled)
         m_simulatedFailures.clear();
     } else {
         qDebug() << "Hardware simulation mode disabled";
+        m_plant.reset();
     }
 }
 
@@ -573,9 +789,13 @@ void HardwareManager::setSimulatedPressure(double pressure)
     QMutexLocker locker(&m_stateMutex);
 
     if (m_simulationMode) {
+        syncPlantLocked();  // Integrate up to now before overriding the plant
         m_simulatedAVLPressure = pressure;
         m_simulatedTankPressure = pressure * 0.8;     // Tank typically lower
         m_simulatedClitoralPressure = pressure * 0.5; // Clitoral varies during oscillation
+        if (m_plant) {
+            m_plant->setPressures(m_simulatedAVLPressure, m_simulatedTankPressure, m_simulatedClitoralPressure);
+        }
     }
 }
 
@@ -584,8 +804,27 @@ void HardwareManager::setSimulatedSensorValues(double avlPressure, double tankPr
     QMutexLocker locker(&m_stateMutex);
 
     if (m_simulationMode) {
+        syncPlantLocked();
         m_simulatedAVLPressure = avlPressure;
         m_simulatedTankPressure = tankPressure;
+        if (m_plant) {
+            m_plant->setPressures(m_simulatedAVLPressure, m_simulatedTankPressure, m_simulatedClitoralPressure);
+        }
+    }
+}
+
+void HardwareManager::setSimulatedSensorValues(double avlPressure, double tankPressure, double clitoralPressure)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (m_simulationMode) {
+        syncPlantLocked();
+        m_simulatedAVLPressure = avlPressure;
+        m_simulatedTankPressure = tankPressure;
+        m_simulatedClitoralPressure = clitoralPressure;
+        if (m_plant) {
+            m_plant->setPressures(m_simulatedAVLPressure, m_simulatedTankPressure, m_simulatedClitoralPressure);
+        }
     }
 }
 
@@ -621,10 +860,113 @@ void HardwareManager::resetHardwareSimulation()
         m_simulatedTankPressure = 0.0;
         m_simulatedClitoralPressure = 0.0;
         m_simulatedFailures.clear();
+        if (m_plant) {
+            m_plant->reset();
+            m_simulationClock.reset();
+            m_plantTimeNs = 0;
+            syncPlantLocked();
+        }
         qDebug() << "Hardware simulation reset";
     }
 }
 
+void HardwareManager::setPlantSimulationEnabled(bool enabled, const PneumaticPlant::Parameters& parameters)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (!enabled) {
+        m_plant.reset();
+        qDebug() << "Pneumatic plant simulation disabled";
+        return;
+    }
+
+    if (!m_simulationMode) {
+        qWarning() << "Pneumatic plant simulation requires simulation mode";
+        return;
+    }
+
+    m_plant = std::make_unique<PneumaticPlant>(parameters);
+    m_plant->setPressures(m_simulatedAVLPressure, m_simulatedTankPressure, m_simulatedClitoralPressure);
+    m_plantTimeNs = m_simulationClock.nowNs();
+    syncPlantLocked();
+
+    qDebug() << "Pneumatic plant simulation enabled"
+             << (m_simulationClock.isManual() ? "(manual clock)"
+                                              : QString("(x%1 real time)").arg(m_simulationClock.timeScale()));
+}
+
+bool HardwareManager::isPlantSimulationEnabled() const
+{
+    QMutexLocker locker(&m_stateMutex);
+    return m_plant != nullptr;
+}
+
+void HardwareManager::setSimulationTimeScale(double scale)
+{
+    QMutexLocker locker(&m_stateMutex);
+    syncPlantLocked();
+    m_simulationClock.setTimeScale(scale);
+}
+
+void HardwareManager::setSimulationManualClock(bool manual)
+{
+    QMutexLocker locker(&m_stateMutex);
+    syncPlantLocked();
+    m_simulationClock.setManual(manual);
+}
+
+void HardwareManager::advanceSimulation(double ms)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (!m_simulationClock.isManual()) {
+        qWarning() << "advanceSimulation() ignored: simulation clock follows real time";
+        return;
+    }
+    m_simulationClock.advanceNs(static_cast<int64_t>(ms * 1.0e6));
+    syncPlantLocked();
+}
+
+double HardwareManager::getSimulationTimeMs() const
+{
+    QMutexLocker locker(&m_stateMutex);
+    return static_cast<double>(m_simulationClock.nowNs()) / 1.0e6;
+}
+
+PneumaticPlant::State HardwareManager::getPlantState()
+{
+    QMutexLocker locker(&m_stateMutex);
+    syncPlantLocked();
+    return m_plant ? m_plant->state() : PneumaticPlant::State();
+}
+
+void HardwareManager::syncPlantLocked()
+{
+    // Caller holds m_stateMutex. Integrate up to "now" with the inputs that
+    // were in force, then latch the current valve/pump state for what follows.
+    if (!m_plant) {
+        return;
+    }
+
+    const int64_t nowNs = m_simulationClock.nowNs();
+    if (nowNs > m_plantTimeNs) {
+        m_plant->advance(nowNs - m_plantTimeNs);
+        m_plantTimeNs = nowNs;
+    }
+
+    PneumaticPlant::Inputs inputs;
+    inputs.pumpEnabled = m_pumpEnabled;
+    inputs.pumpSpeedPercent = m_pumpSpeed;
+    inputs.sol1 = m_sol1State;
+    inputs.sol2 = m_sol2State;
+    inputs.sol3 = m_sol3State;
+    inputs.sol4 = m_sol4State;
+    inputs.sol5 = m_sol5State;
+    m_plant->setInputs(inputs);
+
+    m_plant->sampleSensors(m_simulatedAVLPressure, m_simulatedTankPressure, m_simulatedClitoralPressure);
+}
+
 // TENS Control Methods (integrated with clitoral cup electrodes)
 
 void HardwareManager::setTENSEnabled(bool enabled)
@@ -646,6 +988,7 @@ void HardwareManager::setTENSEnabled(bool enabled)
     } else {
         m_tensController->stop();
     }
+    recordActuatorStateLocked();
 }
 
 void HardwareManager::setTENSFrequency(double hz)
@@ -653,6 +996,7 @@ void HardwareManager::setTENSFrequency(double hz)
     if (m_tensController) {
         m_tensController->setFrequency(hz);
     }
+    recordActuatorState();
 }
 
 void HardwareManager::setTENSPulseWidth(int microseconds)
@@ -660,6 +1004,7 @@ void HardwareManager::setTENSPulseWidth(int microseconds)
     if (m_tensController) {
         m_tensController->setPulseWidth(microseconds);
     }
+    recordActuatorState();
 }
 
 void HardwareManager::setTENSAmplitude(double percent)
@@ -667,6 +1012,7 @@ void HardwareManager::setTENSAmplitude(double percent)
     if (m_tensController) {
         m_tensController->setAmplitude(percent);
     }
+    recordActuatorState();
 }
 
 bool HardwareManager::isTENSRunning() const
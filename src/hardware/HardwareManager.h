@@ -4,8 +4,13 @@
 #include <QObject>
 #include <QMutex>
 #include <QString>
+#include <atomic>
 #include <memory>
 
+#include "SensorSnapshotBus.h"
+#include "PneumaticPlant.h"
+#include "VirtualClock.h"
+
 // Forward declarations
 class SensorInterface;
 class ActuatorControl;
@@ -14,6 +19,9 @@ class TENSController;
 class FluidSensor;
 class MotionSensor;
 class ClitoralOscillator;
+class SessionRecorder;
+class DataLogger;
+class HeartRateSensor;
 
 /**
  * @brief Hardware abstraction layer for the vacuum controller
@@ -35,11 +43,37 @@ public:
     void shutdown();
     bool isReady() const { return m_initialized; }
 
-    // Sensor readings (pressure in mmHg)
+    // Sensor readings (pressure in mmHg). Served from the latest snapshot
+    // while acquisition is publishing; to read several channels together,
+    // take one getSensorSnapshot() instead.
     double readAVLPressure();         // Outer V-seal chamber pressure (Sensor 1)
     double readTankPressure();        // Tank vacuum pressure (Sensor 2)
     double readClitoralPressure();    // Clitoral cylinder pressure (Sensor 3)
 
+    // Sensor snapshot bus (single acquisition owner, wait-free readers)
+    // The acquisition owner samples every channel under one lock and publishes
+    // the result; periodic consumers read the latest snapshot without locking.
+    SensorSnapshot publishSensorSnapshot();
+    SensorSnapshot getSensorSnapshot();
+    const SensorSnapshotBus& sensorSnapshotBus() const { return m_snapshotBus; }
+    void setSnapshotMaxAgeMs(double ageMs) { m_snapshotMaxAgeMs = ageMs; }
+    double getSnapshotMaxAgeMs() const { return m_snapshotMaxAgeMs; }
+
+    // Session recording: every published snapshot and every actuator output
+    // change is appended while the recorder is open. The recorder must
+    // outlive this manager (or be detached first).
+    void setSessionRecorder(SessionRecorder* recorder);
+    // Record the current outputs, including oscillator/TENS settings changed
+    // directly on those controllers; unchanged outputs are not re-recorded
+    void recordActuatorState();
+
+    // Sensor logging: every published snapshot is also handed to the logger
+    // (from the acquisition thread). Same lifetime rule as the recorder.
+    void setSensorLogger(DataLogger* logger);
+
+    // Heart rate sensor sampled into each snapshot; owned by the caller
+    void setHeartRateSensor(HeartRateSensor* sensor);
+
     // Actuator controls
     void setPumpSpeed(double speedPercent);  // 0-100%
     void setPumpEnabled(bool enabled);
@@ -100,10 +134,22 @@ public:
     bool isSimulationMode() const { return m_simulationMode; }
     void setSimulatedPressure(double pressure);
     void setSimulatedSensorValues(double avlPressure, double tankPressure);
+    void setSimulatedSensorValues(double avlPressure, double tankPressure, double clitoralPressure);
     void simulateHardwareFailure(const QString& component);
     void simulateSensorError(const QString& sensor);
     void resetHardwareSimulation();
 
+    // Pneumatic plant simulation (simulation mode only). When enabled, the
+    // simulated pressures come from a model of the tank, outer chamber and
+    // clitoral cylinder driven by SOL1-SOL5 and the pump, on a virtual clock.
+    void setPlantSimulationEnabled(bool enabled, const PneumaticPlant::Parameters& parameters = PneumaticPlant::Parameters());
+    bool isPlantSimulationEnabled() const;
+    void setSimulationTimeScale(double scale);    // Virtual seconds per real second
+    void setSimulationManualClock(bool manual);   // Time only moves via advanceSimulation()
+    void advanceSimulation(double ms);
+    double getSimulationTimeMs() const;
+    PneumaticPlant::State getPlantState();
+
 Q_SIGNALS:
     void hardwareError(const QString& error);
     void sensorError(const QString& sensor, const QString& error);
@@ -118,6 +164,10 @@ private:
     void initializeSPI();
     bool validateHardware();
     void safeShutdown();
+    SensorSnapshot sampleAllChannelsLocked();
+    bool readFreshSnapshot(SensorSnapshot& snapshot) const;
+    void syncPlantLocked();
+    void recordActuatorStateLocked();
 
     // Hardware interfaces
     std::unique_ptr<SensorInterface> m_sensorInterface;
@@ -144,6 +194,14 @@ private:
     bool m_sol4State;    // SOL4 (GPIO 23): Clitoral cylinder vacuum
     bool m_sol5State;    // SOL5 (GPIO 24): Clitoral cylinder vent valve
 
+    // Latest published sensor snapshot
+    SensorSnapshotBus m_snapshotBus;
+    double m_snapshotMaxAgeMs;
+
+    std::atomic<SessionRecorder*> m_sessionRecorder;
+    std::atomic<DataLogger*> m_sensorLogger;
+    HeartRateSensor* m_heartRateSensor;     // Guarded by m_stateMutex
+
     // Error tracking
     QString m_lastError;
 
@@ -153,6 +211,9 @@ private:
     double m_simulatedTankPressure;
     double m_simulatedClitoralPressure;
     QStringList m_simulatedFailures;
+    std::unique_ptr<PneumaticPlant> m_plant;
+    VirtualClock m_simulationClock;
+    int64_t m_plantTimeNs;      // Virtual time the plant has been integrated to
     
     // GPIO pin definitions (as per specification)
     // Outer V-seal chamber (sustained vacuum for engorgement)
@@ -177,6 +238,10 @@ private:
     static const int ADC_CHANNEL_TANK = 1;      // Channel 1: Tank vacuum sensor
     static const int ADC_CHANNEL_CLITORAL = 2;  // Channel 2: Clitoral cylinder sensor
 
+    // Snapshots older than this are considered stale and consumers fall back
+    // to a direct locked read (acquisition stopped, paused, or not started)
+    static constexpr double DEFAULT_SNAPSHOT_MAX_AGE_MS = 100.0;
+
     // TENS GPIO pin definitions (integrated into clitoral cup)
     static const int GPIO_TENS_ENABLE = 5;   // Master enable for TENS output
     static const int GPIO_TENS_PHASE = 6;    // Polarity control (H=positive, L=negative)
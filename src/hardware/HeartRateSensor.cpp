@@ -338,8 +338,13 @@ void HeartRateSensor::onUpdateTick()
     switch (m_sensorType) {
         case SensorType::ANALOG_PULSE:
             if (m_adc) {
-                int adcValue = m_adc->readRawValue(m_adcChannel);
-                processAnalogPulse(adcValue);
+                // Reuse the value from SensorInterface's batched scan when it
+                // includes our channel; fall back to a dedicated read otherwise.
+                uint16_t rawValue = 0;
+                if (!m_adc->getScannedRawValue(m_adcChannel, UPDATE_INTERVAL_MS, rawValue)) {
+                    rawValue = m_adc->readRawValue(m_adcChannel);
+                }
+                processAnalogPulse(rawValue);
             }
             break;
 
@@ -97,6 +97,10 @@ public:
     void setUpdateRate(int hz);                 // Default 10 Hz
     void setSensorType(SensorType type);
     
+    // Analog pulse sensor wiring (nullptr / -1 unless initialized on an ADC)
+    MCP3008* getADC() const { return m_adc; }
+    int getADCChannel() const { return m_adc ? m_adcChannel : -1; }
+
     // Status
     bool hasPulseSignal() const { return m_hasPulseSignal; }
     int getSignalQuality() const { return m_signalQuality; }  // 0-100%
@@ -1,4 +1,5 @@
 #include "MCP3008.h"
+#include "../performance/HotPathTrace.h"
 #include <QDebug>
 #include <QMutexLocker>
 #include <stdexcept>
@@ -10,6 +11,15 @@
 #include <linux/spi/spidev.h>
 #include <errno.h>
 #include <cstring>
+#include <chrono>
+
+namespace {
+qint64 monotonicMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
 
 // Constants
 const double MCP3008::REFERENCE_VOLTAGE = 3.3;
@@ -33,6 +43,7 @@ MCP3008::MCP3008(QObject *parent)
         m_calibration[i].slope = DEFAULT_SLOPE_MMHG_PER_VOLT;
         m_calibration[i].offset = DEFAULT_OFFSET_MMHG;
         m_calibration[i].calibrated = true;  // Use default calibration
+        m_scanCache[i].store(0, std::memory_order_relaxed);
     }
 }
 
@@ -134,6 +145,76 @@ double MCP3008::readPressure(int channel)
     return convertToPressure(channel, voltage);
 }
 
+bool MCP3008::readChannels(uint8_t channelMask, uint16_t out[8])
+{
+    uint8_t channels[8];
+    int count = 0;
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch) {
+        if (channelMask & (1u << ch)) {
+            channels[count++] = static_cast<uint8_t>(ch);
+        }
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    if (!m_initialized) {
+        m_lastError = "MCP3008 not initialized";
+        for (int i = 0; i < count; ++i) out[channels[i]] = 0xFFFF;
+        emit readingError(channels[0], m_lastError);
+        return false;
+    }
+
+    uint16_t results[8];
+    bool ok;
+    {
+        QMutexLocker locker(&m_spiMutex);
+        ok = spiTransferBatch(channels, count, results);
+    }
+
+    if (!ok) {
+        m_lastError = QString("Batched SPI transfer failed: %1").arg(strerror(errno));
+        for (int i = 0; i < count; ++i) out[channels[i]] = 0xFFFF;
+        emit readingError(channels[0], m_lastError);
+        return false;
+    }
+
+    const uint64_t stamp = static_cast<uint64_t>(monotonicMs()) << 16;
+    for (int i = 0; i < count; ++i) {
+        out[channels[i]] = results[i];
+        m_scanCache[channels[i]].store(stamp | results[i], std::memory_order_release);
+    }
+    return true;
+}
+
+double MCP3008::rawToPressure(int channel, uint16_t rawValue) const
+{
+    if (rawValue == 0xFFFF) {
+        return -1.0;  // Error value
+    }
+    return convertToPressure(channel, convertToVoltage(rawValue));
+}
+
+bool MCP3008::getScannedRawValue(int channel, int maxAgeMs, uint16_t& rawValue) const
+{
+    if (!isValidChannel(channel)) {
+        return false;
+    }
+
+    const uint64_t entry = m_scanCache[channel].load(std::memory_order_acquire);
+    if (entry == 0) {
+        return false;
+    }
+
+    const qint64 stampMs = static_cast<qint64>(entry >> 16);
+    if (monotonicMs() - stampMs > maxAgeMs) {
+        return false;
+    }
+
+    rawValue = static_cast<uint16_t>(entry & 0xFFFF);
+    return rawValue != 0xFFFF;
+}
+
 void MCP3008::calibrateChannel(int channel, double zeroVoltage, double fullScaleVoltage,
                               double zeroPressure, double fullScalePressure)
 {
@@ -247,25 +328,56 @@ uint16_t MCP3008::spiTransfer(uint8_t channel)
     // rx_buffer[2] contains the 8 LSB bits
     uint16_t result = ((rx_buffer[1] & 0x03) << 8) | rx_buffer[2];
 
-    qDebug() << "MCP3008 channel" << channel << "raw SPI:"
-             << QString("TX[%1,%2,%3] RX[%4,%5,%6] Result:%7")
-                .arg(tx_buffer[0], 2, 16, QChar('0'))
-                .arg(tx_buffer[1], 2, 16, QChar('0'))
-                .arg(tx_buffer[2], 2, 16, QChar('0'))
-                .arg(rx_buffer[0], 2, 16, QChar('0'))
-                .arg(rx_buffer[1], 2, 16, QChar('0'))
-                .arg(rx_buffer[2], 2, 16, QChar('0'))
-                .arg(result);
+    VC_TRACE(HotPathTrace::SPI, HotPathTrace::LEVEL_VERBOSE, "mcp3008.transfer",
+             channel, rx_buffer[1], rx_buffer[2], result);
 
     return result;
 }
 
-double MCP3008::convertToVoltage(uint16_t rawValue)
+bool MCP3008::spiTransferBatch(const uint8_t* channels, int count, uint16_t* results)
+{
+    // One 3-byte MCP3008 conversion per transfer, all chained into a single
+    // SPI_IOC_MESSAGE(count) ioctl. cs_change deasserts CS between transfers,
+    // which the MCP3008 requires to start each new conversion.
+    uint8_t txBuffers[8][3];
+    uint8_t rxBuffers[8][3] = {};
+    struct spi_ioc_transfer transfers[8];
+    std::memset(transfers, 0, sizeof(transfers));
+
+    for (int i = 0; i < count; ++i) {
+        txBuffers[i][0] = 0x01;                          // Start bit
+        txBuffers[i][1] = 0x80 | (channels[i] << 4);     // Single-ended + channel
+        txBuffers[i][2] = 0x00;
+
+        transfers[i].tx_buf = (unsigned long)txBuffers[i];
+        transfers[i].rx_buf = (unsigned long)rxBuffers[i];
+        transfers[i].len = 3;
+        transfers[i].speed_hz = m_spiSpeed;
+        transfers[i].bits_per_word = 8;
+        transfers[i].delay_usecs = 0;
+        transfers[i].cs_change = (i < count - 1) ? 1 : 0;
+    }
+
+    // SPI_IOC_MESSAGE(N) needs a constant N; build the same request code
+    // from the runtime transfer count instead.
+    const unsigned long request = _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, SPI_MSGSIZE(count));
+    if (ioctl(m_spiFd, request, transfers) < 0) {
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        results[i] = ((rxBuffers[i][1] & 0x03) << 8) | rxBuffers[i][2];
+        VC_TRACE(HotPathTrace::SPI, HotPathTrace::LEVEL_VERBOSE, "mcp3008.scan", channels[i], results[i]);
+    }
+    return true;
+}
+
+double MCP3008::convertToVoltage(uint16_t rawValue) const
 {
     return (static_cast<double>(rawValue) * REFERENCE_VOLTAGE) / ADC_RESOLUTION;
 }
 
-double MCP3008::convertToPressure(int channel, double voltage)
+double MCP3008::convertToPressure(int channel, double voltage) const
 {
     if (!isValidChannel(channel) || !m_calibration[channel].calibrated) {
         return -1.0;  // Error value
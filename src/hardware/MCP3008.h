@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QMutex>
+#include <atomic>
 #include <cstdint>
 
 /**
@@ -29,6 +30,22 @@ public:
     uint16_t readRawValue(int channel);           // Returns raw 10-bit value (0-1023)
     double readVoltage(int channel);              // Returns voltage (0-3.3V)
     double readPressure(int channel);             // Returns pressure in mmHg
+
+    // Batched scan: reads every channel set in channelMask (bit N = channel N)
+    // in a single SPI_IOC_MESSAGE ioctl. Raw 10-bit results are written to
+    // out[channel]; unselected entries are left untouched. Returns false on
+    // SPI failure (all selected entries are then set to 0xFFFF).
+    bool readChannels(uint8_t channelMask, uint16_t out[8]);
+
+    // Conversion helpers for raw scan results (no SPI access)
+    double rawToVoltage(uint16_t rawValue) const { return convertToVoltage(rawValue); }
+    double rawToPressure(int channel, uint16_t rawValue) const;
+
+    // Most recent raw value captured by readChannels() for a channel, so
+    // other consumers (e.g. HeartRateSensor) can share the scan instead of
+    // issuing their own transfer. Returns false if the cached value is older
+    // than maxAgeMs or the channel has never been scanned.
+    bool getScannedRawValue(int channel, int maxAgeMs, uint16_t& rawValue) const;
     
     // Calibration functions
     void calibrateChannel(int channel, double zeroVoltage, double fullScaleVoltage, 
@@ -55,8 +72,9 @@ private:
 
     bool initializeSPI();
     uint16_t spiTransfer(uint8_t channel);
-    double convertToVoltage(uint16_t rawValue);
-    double convertToPressure(int channel, double voltage);
+    bool spiTransferBatch(const uint8_t* channels, int count, uint16_t* results);
+    double convertToVoltage(uint16_t rawValue) const;
+    double convertToPressure(int channel, double voltage) const;
 
     // SPI communication
     int m_spiFd;         // SPI file descriptor
@@ -67,6 +85,10 @@ private:
     
     // Calibration data for each channel
     ChannelCalibration m_calibration[8];
+
+    // Last batched scan result per channel: raw value in the low 16 bits,
+    // monotonic ms timestamp in the high 48 bits (0 = never scanned)
+    std::atomic<uint64_t> m_scanCache[8];
     
     // Error tracking
     QString m_lastError;
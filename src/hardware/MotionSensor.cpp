@@ -45,8 +45,8 @@ MotionSensor::MotionSensor(SensorType type, QObject* parent)
     , m_sampleRateHz(DEFAULT_SAMPLE_RATE_HZ)
     , m_simulatedMotion(0.0)
 {
-    m_sampleTimer = new QTimer(this);
-    connect(m_sampleTimer, &QTimer::timeout, this, &MotionSensor::onSampleTimer);
+    m_sampleTimer = new ControlTimer(this);
+    connect(m_sampleTimer, &ControlTimer::timeout, this, &MotionSensor::onSampleTimer);
     
     m_calibrationTimer = new QTimer(this);
     connect(m_calibrationTimer, &QTimer::timeout, this, &MotionSensor::onCalibrationTimer);
@@ -59,6 +59,11 @@ MotionSensor::~MotionSensor()
     shutdown();
 }
 
+void MotionSensor::attachToScheduler(ControlScheduler* scheduler)
+{
+    m_sampleTimer->attach(scheduler, ControlScheduler::Stage::SENSE, "MotionSensor.sample");
+}
+
 bool MotionSensor::initialize()
 {
     return initializeI2C(m_i2cBus, m_i2cAddress);
@@ -8,6 +8,7 @@
 #include <QVector>
 #include <QVector3D>
 #include <memory>
+#include "../threading/ControlScheduler.h"
 
 /**
  * @brief Motion Sensor Interface for stillness detection
@@ -60,6 +61,9 @@ public:
                           QObject* parent = nullptr);
     ~MotionSensor();
 
+    // Drive the periodic tick from the shared control scheduler
+    void attachToScheduler(ControlScheduler* scheduler);
+
     // Initialization
     bool initialize();
     bool initializeI2C(int bus = 1, int address = 0x68);
@@ -173,7 +177,7 @@ private:
     int m_calibrationSamplesNeeded;
 
     // Timers
-    QTimer* m_sampleTimer;
+    ControlTimer* m_sampleTimer;
     int m_sampleRateHz;
 
     // Thread safety
@@ -0,0 +1,219 @@
+#include "PWMBackend.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QDebug>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+SysfsPWMBackend::SysfsPWMBackend(int chip, int channel, const QString& sysfsRoot)
+    : m_chip(chip)
+    , m_channel(channel)
+    , m_sysfsRoot(sysfsRoot)
+    , m_exportedByUs(false)
+    , m_dutyFd(-1)
+    , m_frequencyHz(0)
+    , m_periodNs(0)
+    , m_dutyCycle(0.0)
+    , m_enabled(false)
+{
+}
+
+SysfsPWMBackend::~SysfsPWMBackend()
+{
+    close();
+}
+
+QString SysfsPWMBackend::name() const
+{
+    return QString("sysfs pwmchip%1/pwm%2").arg(m_chip).arg(m_channel);
+}
+
+QString SysfsPWMBackend::chipPath() const
+{
+    return QString("%1/pwmchip%2").arg(m_sysfsRoot).arg(m_chip);
+}
+
+QString SysfsPWMBackend::channelPath() const
+{
+    return QString("%1/pwm%2").arg(chipPath()).arg(m_channel);
+}
+
+bool SysfsPWMBackend::open()
+{
+    if (isOpen()) {
+        return true;
+    }
+
+    if (!QFileInfo::exists(chipPath())) {
+        m_lastError = QString("%1 not found (PWM overlay not enabled?)").arg(chipPath());
+        return false;
+    }
+
+    if (!QFileInfo::exists(channelPath())) {
+        QFile exportFile(chipPath() + "/export");
+        if (!exportFile.open(QIODevice::WriteOnly) ||
+            exportFile.write(QByteArray::number(m_channel)) < 0) {
+            m_lastError = QString("Cannot export PWM channel %1: %2").arg(m_channel).arg(exportFile.errorString());
+            return false;
+        }
+        exportFile.close();
+        m_exportedByUs = true;
+    }
+
+    // The channel directory appears asynchronously and udev may still be
+    // fixing permissions when it does
+    const QByteArray dutyPath = (channelPath() + "/duty_cycle").toLocal8Bit();
+    for (int attempt = 0; attempt < EXPORT_SETTLE_ATTEMPTS && m_dutyFd < 0; ++attempt) {
+        m_dutyFd = ::open(dutyPath.constData(), O_WRONLY | O_CLOEXEC);
+        if (m_dutyFd < 0) {
+            QThread::msleep(EXPORT_SETTLE_DELAY_MS);
+        }
+    }
+
+    if (m_dutyFd < 0) {
+        m_lastError = QString("Cannot open %1: %2").arg(QString::fromLocal8Bit(dutyPath)).arg(strerror(errno));
+        close();
+        return false;
+    }
+
+    // Start from a known state: disabled, 0% duty
+    writeAttribute("enable", "0");
+    m_enabled = false;
+    m_dutyCycle = 0.0;
+    return true;
+}
+
+void SysfsPWMBackend::close()
+{
+    if (m_dutyFd >= 0) {
+        writeDuty(0);
+        writeAttribute("enable", "0");
+        ::close(m_dutyFd);
+        m_dutyFd = -1;
+    }
+    m_enabled = false;
+
+    if (m_exportedByUs) {
+        QFile unexportFile(chipPath() + "/unexport");
+        if (unexportFile.open(QIODevice::WriteOnly)) {
+            unexportFile.write(QByteArray::number(m_channel));
+        }
+        m_exportedByUs = false;
+    }
+}
+
+bool SysfsPWMBackend::setFrequency(int frequencyHz)
+{
+    if (frequencyHz <= 0) {
+        m_lastError = QString("Invalid PWM frequency %1 Hz").arg(frequencyHz);
+        return false;
+    }
+
+    const int64_t periodNs = 1000000000LL / frequencyHz;
+
+    // duty_cycle must never exceed period, so shrink duty first when the
+    // period gets shorter
+    const int64_t dutyNs = static_cast<int64_t>(m_dutyCycle * periodNs);
+    if (periodNs < m_periodNs && !writeDuty(dutyNs)) {
+        return false;
+    }
+    if (!writeAttribute("period", QByteArray::number(static_cast<qlonglong>(periodNs)))) {
+        return false;
+    }
+    if (periodNs >= m_periodNs && !writeDuty(dutyNs)) {
+        return false;
+    }
+
+    m_frequencyHz = frequencyHz;
+    m_periodNs = periodNs;
+    return true;
+}
+
+bool SysfsPWMBackend::setDutyCycle(double fraction)
+{
+    fraction = std::max(0.0, std::min(1.0, fraction));
+    if (m_periodNs <= 0) {
+        m_lastError = "PWM period not configured";
+        return false;
+    }
+    if (!writeDuty(static_cast<int64_t>(fraction * m_periodNs))) {
+        return false;
+    }
+    m_dutyCycle = fraction;
+    return true;
+}
+
+bool SysfsPWMBackend::setEnabled(bool enabled)
+{
+    if (enabled == m_enabled) {
+        return true;
+    }
+    if (!writeAttribute("enable", enabled ? "1" : "0")) {
+        return false;
+    }
+    m_enabled = enabled;
+    return true;
+}
+
+bool SysfsPWMBackend::writeDuty(int64_t dutyNs)
+{
+    if (m_dutyFd < 0) {
+        m_lastError = "PWM channel not open";
+        return false;
+    }
+
+    const QByteArray value = QByteArray::number(static_cast<qlonglong>(dutyNs));
+    if (::pwrite(m_dutyFd, value.constData(), value.size(), 0) != value.size()) {
+        m_lastError = QString("duty_cycle write failed: %1").arg(strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool SysfsPWMBackend::writeAttribute(const QString& attribute, const QByteArray& value)
+{
+    QFile file(channelPath() + "/" + attribute);
+    if (!file.open(QIODevice::WriteOnly) || file.write(value) != value.size()) {
+        m_lastError = QString("Cannot write %1 to %2: %3").arg(QString::fromLatin1(value), file.fileName(), file.errorString());
+        return false;
+    }
+    return true;
+}
+
+SimulatedPWMBackend::SimulatedPWMBackend()
+    : m_open(false)
+    , m_frequencyHz(0)
+    , m_dutyCycle(0.0)
+    , m_enabled(false)
+    , m_writeCount(0)
+{
+}
+
+bool SimulatedPWMBackend::setFrequency(int frequencyHz)
+{
+    if (frequencyHz <= 0) {
+        m_lastError = QString("Invalid PWM frequency %1 Hz").arg(frequencyHz);
+        return false;
+    }
+    m_frequencyHz = frequencyHz;
+    m_writeCount++;
+    return true;
+}
+
+bool SimulatedPWMBackend::setDutyCycle(double fraction)
+{
+    m_dutyCycle = std::max(0.0, std::min(1.0, fraction));
+    m_writeCount++;
+    return true;
+}
+
+bool SimulatedPWMBackend::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_writeCount++;
+    return true;
+}
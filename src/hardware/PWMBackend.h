@@ -0,0 +1,125 @@
+#ifndef PWMBACKEND_H
+#define PWMBACKEND_H
+
+#include <QString>
+#include <cstdint>
+
+/**
+ * @brief Output stage for a single PWM channel
+ *
+ * Lets ActuatorControl (pump) and later TENSController (amplitude) drive a
+ * PWM output without knowing whether it is the SoC PWM peripheral or a
+ * simulation. Changing the duty cycle costs one write; the waveform itself
+ * is generated by the backend, never by an application timer.
+ *
+ * Methods return false on failure and leave a description in lastError().
+ */
+class PWMBackend
+{
+public:
+    virtual ~PWMBackend() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    virtual bool setFrequency(int frequencyHz) = 0;
+    virtual bool setDutyCycle(double fraction) = 0;   // 0.0 - 1.0
+    virtual bool setEnabled(bool enabled) = 0;
+
+    virtual int frequency() const = 0;
+    virtual double dutyCycle() const = 0;
+    virtual bool isEnabled() const = 0;
+
+    virtual QString name() const = 0;
+    QString lastError() const { return m_lastError; }
+
+protected:
+    QString m_lastError;
+};
+
+/**
+ * @brief Hardware PWM through the Linux PWM class (/sys/class/pwm)
+ *
+ * On the Raspberry Pi this needs the pwm (or pwm-2chan) overlay, e.g.
+ * dtoverlay=pwm,pin=18,func=2 for GPIO 18 on pwmchip0 channel 0. The channel
+ * is exported on open(); the duty_cycle file is kept open so each speed
+ * change is a single pwrite().
+ */
+class SysfsPWMBackend : public PWMBackend
+{
+public:
+    SysfsPWMBackend(int chip, int channel, const QString& sysfsRoot = QStringLiteral("/sys/class/pwm"));
+    ~SysfsPWMBackend() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return m_dutyFd >= 0; }
+
+    bool setFrequency(int frequencyHz) override;
+    bool setDutyCycle(double fraction) override;
+    bool setEnabled(bool enabled) override;
+
+    int frequency() const override { return m_frequencyHz; }
+    double dutyCycle() const override { return m_dutyCycle; }
+    bool isEnabled() const override { return m_enabled; }
+
+    QString name() const override;
+
+private:
+    QString chipPath() const;
+    QString channelPath() const;
+    bool writeAttribute(const QString& attribute, const QByteArray& value);
+    bool writeDuty(int64_t dutyNs);
+
+    int m_chip;
+    int m_channel;
+    QString m_sysfsRoot;
+    bool m_exportedByUs;
+    int m_dutyFd;
+
+    int m_frequencyHz;
+    int64_t m_periodNs;
+    double m_dutyCycle;
+    bool m_enabled;
+
+    static const int EXPORT_SETTLE_ATTEMPTS = 50;   // udev may take a moment to chmod the new channel
+    static const int EXPORT_SETTLE_DELAY_MS = 2;
+};
+
+/**
+ * @brief In-memory PWM for simulation mode and tests
+ *
+ * Records the last commanded state and how many writes were made, so tests
+ * can assert that a speed change results in exactly one backend update.
+ */
+class SimulatedPWMBackend : public PWMBackend
+{
+public:
+    SimulatedPWMBackend();
+
+    bool open() override { m_open = true; return true; }
+    void close() override { m_open = false; m_enabled = false; }
+    bool isOpen() const override { return m_open; }
+
+    bool setFrequency(int frequencyHz) override;
+    bool setDutyCycle(double fraction) override;
+    bool setEnabled(bool enabled) override;
+
+    int frequency() const override { return m_frequencyHz; }
+    double dutyCycle() const override { return m_dutyCycle; }
+    bool isEnabled() const override { return m_enabled; }
+
+    QString name() const override { return QStringLiteral("simulated"); }
+
+    int writeCount() const { return m_writeCount; }
+
+private:
+    bool m_open;
+    int m_frequencyHz;
+    double m_dutyCycle;
+    bool m_enabled;
+    int m_writeCount;
+};
+
+#endif // PWMBACKEND_H
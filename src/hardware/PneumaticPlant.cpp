@@ -0,0 +1,107 @@
+#include "PneumaticPlant.h"
+#include <algorithm>
+
+PneumaticPlant::PneumaticPlant()
+    : PneumaticPlant(Parameters())
+{
+}
+
+PneumaticPlant::PneumaticPlant(const Parameters& parameters)
+    : m_parameters(parameters)
+    , m_stepCount(0)
+    , m_remainderNs(0)
+    , m_noiseEngine(parameters.noiseSeed)
+    , m_noise(0.0, 1.0)
+{
+}
+
+void PneumaticPlant::setParameters(const Parameters& parameters)
+{
+    m_parameters = parameters;
+    m_noiseEngine.seed(parameters.noiseSeed);
+    m_noise.reset();
+}
+
+void PneumaticPlant::reset()
+{
+    m_inputs = Inputs();
+    m_state = State();
+    m_stepCount = 0;
+    m_remainderNs = 0;
+    m_noiseEngine.seed(m_parameters.noiseSeed);
+    m_noise.reset();
+}
+
+void PneumaticPlant::setPressures(double avlMmHg, double tankMmHg, double clitoralMmHg)
+{
+    m_state.avlVacuumMmHg = std::clamp(avlMmHg, 0.0, ATMOSPHERE_MMHG);
+    m_state.tankVacuumMmHg = std::clamp(tankMmHg, 0.0, ATMOSPHERE_MMHG);
+    m_state.clitoralVacuumMmHg = std::clamp(clitoralMmHg, 0.0, ATMOSPHERE_MMHG);
+}
+
+void PneumaticPlant::advance(int64_t dtNs)
+{
+    if (dtNs <= 0) {
+        return;
+    }
+
+    // Whole sub-steps only; the remainder carries over so a long run of
+    // short advance() calls integrates exactly like one long call
+    int64_t pendingNs = m_remainderNs + dtNs;
+    while (pendingNs >= STEP_NS) {
+        step(STEP_NS * 1e-9);
+        pendingNs -= STEP_NS;
+        m_state.timeNs += STEP_NS;
+    }
+    m_remainderNs = pendingNs;
+}
+
+void PneumaticPlant::step(double dtSec)
+{
+    const Parameters& p = m_parameters;
+    const double tank = m_state.tankVacuumMmHg;
+    const double avl = m_state.avlVacuumMmHg;
+    const double clitoral = m_state.clitoralVacuumMmHg;
+
+    // Pump: flow out of the tank, falling to zero at the dead-head vacuum
+    double pumpFlow = 0.0;
+    if (m_inputs.pumpEnabled && m_inputs.pumpSpeedPercent > 0.0) {
+        const double speed = std::clamp(m_inputs.pumpSpeedPercent / 100.0, 0.0, 1.0);
+        const double maxVacuum = p.pumpMaxVacuumMmHg * speed;
+        pumpFlow = std::max(0.0, p.pumpFreeFlowMlPerSec * speed * (1.0 - tank / maxVacuum));
+    }
+
+    // Air flows from lower vacuum (higher absolute pressure) to higher vacuum
+    const double tankToAvl = m_inputs.sol1 ? p.sol1ConductanceMlPerSecMmHg * (tank - avl) : 0.0;
+    const double tankToClitoral = m_inputs.sol4 ? p.sol4ConductanceMlPerSecMmHg * (tank - clitoral) : 0.0;
+
+    const double tankVent = ((m_inputs.sol3 ? p.sol3ConductanceMlPerSecMmHg : 0.0) + p.tankLeakMlPerSecMmHg) * tank;
+    const double avlVent = ((m_inputs.sol2 ? p.sol2ConductanceMlPerSecMmHg : 0.0) + p.avlLeakMlPerSecMmHg) * avl;
+    const double clitoralVent = ((m_inputs.sol5 ? p.sol5ConductanceMlPerSecMmHg : 0.0) + p.clitoralLeakMlPerSecMmHg) * clitoral;
+
+    // Net outflow (mL/s at ambient) of each volume raises its vacuum
+    const double tankOutflow = pumpFlow - tankToAvl - tankToClitoral - tankVent;
+    const double avlOutflow = tankToAvl - avlVent;
+    const double clitoralOutflow = tankToClitoral - clitoralVent;
+
+    m_state.tankVacuumMmHg = std::clamp(tank + ATMOSPHERE_MMHG / p.tankVolumeMl * tankOutflow * dtSec,
+                                        0.0, ATMOSPHERE_MMHG);
+    m_state.avlVacuumMmHg = std::clamp(avl + ATMOSPHERE_MMHG / p.avlVolumeMl * avlOutflow * dtSec,
+                                       0.0, ATMOSPHERE_MMHG);
+    m_state.clitoralVacuumMmHg = std::clamp(clitoral + ATMOSPHERE_MMHG / p.clitoralVolumeMl * clitoralOutflow * dtSec,
+                                            0.0, ATMOSPHERE_MMHG);
+    m_stepCount++;
+}
+
+void PneumaticPlant::sampleSensors(double& avlMmHg, double& tankMmHg, double& clitoralMmHg)
+{
+    avlMmHg = m_state.avlVacuumMmHg;
+    tankMmHg = m_state.tankVacuumMmHg;
+    clitoralMmHg = m_state.clitoralVacuumMmHg;
+
+    if (m_parameters.sensorNoiseMmHg > 0.0) {
+        avlMmHg = std::max(0.0, avlMmHg + m_parameters.sensorNoiseMmHg * m_noise(m_noiseEngine));
+        tankMmHg = std::max(0.0, tankMmHg + m_parameters.sensorNoiseMmHg * m_noise(m_noiseEngine));
+        clitoralMmHg = std::max(0.0, clitoralMmHg + m_parameters.sensorNoiseMmHg * m_noise(m_noiseEngine));
+    }
+}
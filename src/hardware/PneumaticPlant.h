@@ -0,0 +1,104 @@
+#ifndef PNEUMATICPLANT_H
+#define PNEUMATICPLANT_H
+
+#include <cstdint>
+#include <random>
+
+/**
+ * @brief Lumped-parameter model of the vacuum pneumatics
+ *
+ * Three volumes - vacuum tank, outer V-seal chamber (AVL) and clitoral
+ * cylinder - connected through SOL1-SOL5, evacuated by the pump and
+ * slowly refilled by seal leaks. Pressures are vacuum in mmHg below
+ * atmosphere, matching the sensor readings elsewhere in the code.
+ *
+ * Each volume follows the isothermal ideal-gas relation
+ *     dVacuum/dt = (P_atm / V) * netOutflow
+ * where every path is a linear conductance (mL/s per mmHg of difference)
+ * and the pump delivers a flow that falls off linearly to its dead-head
+ * vacuum. advance() integrates with a fixed sub-step, so results depend
+ * only on the input sequence and the simulated time, never on host timing.
+ *
+ * Qt-free so it can be driven directly by tests and tools.
+ */
+class PneumaticPlant
+{
+public:
+    struct Parameters {
+        double tankVolumeMl = 500.0;
+        double avlVolumeMl = 100.0;
+        double clitoralVolumeMl = 10.0;
+
+        double pumpFreeFlowMlPerSec = 100.0;    // At 100% speed and zero vacuum
+        double pumpMaxVacuumMmHg = 600.0;       // Dead-head vacuum at 100% speed
+
+        double sol1ConductanceMlPerSecMmHg = 2.0;   // Tank -> outer chamber
+        double sol2ConductanceMlPerSecMmHg = 5.0;   // Outer chamber vent
+        double sol3ConductanceMlPerSecMmHg = 5.0;   // Tank vent
+        double sol4ConductanceMlPerSecMmHg = 1.0;   // Tank -> clitoral cylinder
+        double sol5ConductanceMlPerSecMmHg = 1.0;   // Clitoral cylinder vent
+
+        double tankLeakMlPerSecMmHg = 0.0005;
+        double avlLeakMlPerSecMmHg = 0.002;         // V-seal leak
+        double clitoralLeakMlPerSecMmHg = 0.001;
+
+        double sensorNoiseMmHg = 0.0;               // Gaussian sigma added to sensor readings
+        uint32_t noiseSeed = 1;
+    };
+
+    struct Inputs {
+        bool pumpEnabled = false;
+        double pumpSpeedPercent = 0.0;
+        bool sol1 = false;
+        bool sol2 = false;
+        bool sol3 = false;
+        bool sol4 = false;
+        bool sol5 = false;
+    };
+
+    struct State {
+        double tankVacuumMmHg = 0.0;
+        double avlVacuumMmHg = 0.0;
+        double clitoralVacuumMmHg = 0.0;
+        int64_t timeNs = 0;             // Simulated time integrated so far
+    };
+
+    PneumaticPlant();
+    explicit PneumaticPlant(const Parameters& parameters);
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& parameters() const { return m_parameters; }
+
+    // Inputs apply from the current simulated time onward
+    void setInputs(const Inputs& inputs) { m_inputs = inputs; }
+    const Inputs& inputs() const { return m_inputs; }
+
+    void advance(int64_t dtNs);
+    void reset();
+
+    // Force chamber pressures (test setup); simulated time is unchanged
+    void setPressures(double avlMmHg, double tankMmHg, double clitoralMmHg);
+
+    const State& state() const { return m_state; }
+    uint64_t stepCount() const { return m_stepCount; }
+
+    // Pressures as the sensors would report them (with optional noise)
+    void sampleSensors(double& avlMmHg, double& tankMmHg, double& clitoralMmHg);
+
+    static constexpr double ATMOSPHERE_MMHG = 760.0;
+    static constexpr int64_t STEP_NS = 250000;   // 250 μs sub-step, well below the 13 ms clitoral vent time constant
+
+private:
+    void step(double dtSec);
+
+    Parameters m_parameters;
+    Inputs m_inputs;
+    State m_state;
+    uint64_t m_stepCount;
+    int64_t m_remainderNs;          // Time not yet covered by a whole sub-step
+
+    std::mt19937 m_noiseEngine;
+    std::normal_distribution<double> m_noise;
+};
+
+#endif // PNEUMATICPLANT_H
@@ -4,6 +4,7 @@
 #include <QMutexLocker>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 // Constants
 const double SensorInterface::DEFAULT_MIN_VOLTAGE = 0.1;  // Below MPX5010DP range
@@ -30,6 +31,7 @@ SensorInterface::SensorInterface(MCP3008* adc, QObject *parent)
     , m_minVoltage(DEFAULT_MIN_VOLTAGE)
     , m_maxVoltage(DEFAULT_MAX_VOLTAGE)
     , m_updateTimer(new QTimer(this))
+    , m_auxScanMask(0)
 {
     // Set up update timer
     m_updateTimer->setInterval(UPDATE_INTERVAL_MS);
@@ -231,15 +233,29 @@ void SensorInterface::setErrorThresholds(double minVoltage, double maxVoltage)
 
 void SensorInterface::updateReadings()
 {
-    if (!m_initialized) return;
-
-    // Read all three sensors
-    double avlPressure = readAVLPressure();
-    double tankPressure = readTankPressure();
-    double clitoralPressure = readClitoralPressure();
+    if (!m_initialized || !m_adc) return;
+
+    // Scan all three pressure sensors (plus any auxiliary channels) in one
+    // batched SPI transaction instead of one ioctl per channel.
+    const uint8_t mask = static_cast<uint8_t>((1u << AVL_CHANNEL) | (1u << TANK_CHANNEL) |
+                                              (1u << CLITORAL_CHANNEL) | getAuxiliaryScanChannels());
+    uint16_t raw[8];
+    std::fill(std::begin(raw), std::end(raw), uint16_t(0xFFFF));
+    m_adc->readChannels(mask, raw);
+
+    double avlPressure = m_adc->rawToPressure(AVL_CHANNEL, raw[AVL_CHANNEL]);
+    double tankPressure = m_adc->rawToPressure(TANK_CHANNEL, raw[TANK_CHANNEL]);
+    double clitoralPressure = m_adc->rawToPressure(CLITORAL_CHANNEL, raw[CLITORAL_CHANNEL]);
+
+    {
+        QMutexLocker locker(&m_dataMutex);
+        storeReading(avlPressure, m_currentAVL, m_filteredAVL);
+        storeReading(tankPressure, m_currentTank, m_filteredTank);
+        storeReading(clitoralPressure, m_currentClitoral, m_filteredClitoral);
+    }
 
-    // Check sensor health
-    checkSensorHealth();
+    // Check sensor health from the same scan (no additional SPI reads)
+    checkSensorHealth(raw);
 
     // Emit updated readings if valid (AVL and Tank are essential)
     if (avlPressure >= 0 && tankPressure >= 0) {
@@ -248,7 +264,17 @@ void SensorInterface::updateReadings()
 
     // Note: clitoralPressure is read and filtered but not emitted in pressureUpdated
     // The ClitoralOscillator will read it directly via getFilteredClitoralPressure()
-    Q_UNUSED(clitoralPressure);
+}
+
+void SensorInterface::storeReading(double pressure, double& current, double& filtered)
+{
+    // Caller holds m_dataMutex
+    if (pressure < 0) {
+        return;
+    }
+
+    current = pressure;
+    filtered = m_filteringEnabled ? applyFilter(pressure, filtered) : pressure;
 }
 
 void SensorInterface::initializeFiltering()
@@ -282,59 +308,30 @@ bool SensorInterface::validateReading(double voltage, const QString& sensorName)
     return true;
 }
 
-void SensorInterface::checkSensorHealth()
+void SensorInterface::checkSensorHealth(const uint16_t raw[8])
 {
-    // Check AVL / Outer chamber sensor
-    double avlVoltage = m_adc ? m_adc->readVoltage(AVL_CHANNEL) : -1.0;
-    if (avlVoltage < 0 || !validateReading(avlVoltage, "AVL")) {
-        m_avlErrorCount++;
-        if (m_avlErrorCount >= MAX_CONSECUTIVE_ERRORS && m_avlSensorHealthy) {
-            m_avlSensorHealthy = false;
-            emit sensorError("AVL", "Sensor unhealthy - too many consecutive errors");
-        }
-    } else {
-        if (m_avlErrorCount > 0) {
-            m_avlErrorCount = std::max(0, m_avlErrorCount - 1);  // Gradual recovery
-        }
-        if (!m_avlSensorHealthy && m_avlErrorCount == 0) {
-            m_avlSensorHealthy = true;
-            emit sensorRecovered("AVL");
-        }
-    }
-
-    // Check Tank sensor
-    double tankVoltage = m_adc ? m_adc->readVoltage(TANK_CHANNEL) : -1.0;
-    if (tankVoltage < 0 || !validateReading(tankVoltage, "Tank")) {
-        m_tankErrorCount++;
-        if (m_tankErrorCount >= MAX_CONSECUTIVE_ERRORS && m_tankSensorHealthy) {
-            m_tankSensorHealthy = false;
-            emit sensorError("Tank", "Sensor unhealthy - too many consecutive errors");
-        }
-    } else {
-        if (m_tankErrorCount > 0) {
-            m_tankErrorCount = std::max(0, m_tankErrorCount - 1);  // Gradual recovery
-        }
-        if (!m_tankSensorHealthy && m_tankErrorCount == 0) {
-            m_tankSensorHealthy = true;
-            emit sensorRecovered("Tank");
-        }
-    }
+    updateChannelHealth(raw[AVL_CHANNEL], "AVL", m_avlErrorCount, m_avlSensorHealthy);
+    updateChannelHealth(raw[TANK_CHANNEL], "Tank", m_tankErrorCount, m_tankSensorHealthy);
+    updateChannelHealth(raw[CLITORAL_CHANNEL], "Clitoral", m_clitoralErrorCount, m_clitoralSensorHealthy);
+}
 
-    // Check Clitoral cylinder sensor
-    double clitoralVoltage = m_adc ? m_adc->readVoltage(CLITORAL_CHANNEL) : -1.0;
-    if (clitoralVoltage < 0 || !validateReading(clitoralVoltage, "Clitoral")) {
-        m_clitoralErrorCount++;
-        if (m_clitoralErrorCount >= MAX_CONSECUTIVE_ERRORS && m_clitoralSensorHealthy) {
-            m_clitoralSensorHealthy = false;
-            emit sensorError("Clitoral", "Sensor unhealthy - too many consecutive errors");
+void SensorInterface::updateChannelHealth(uint16_t raw, const QString& sensorName,
+                                          int& errorCount, bool& healthy)
+{
+    double voltage = (raw == 0xFFFF) ? -1.0 : m_adc->rawToVoltage(raw);
+    if (voltage < 0 || !validateReading(voltage, sensorName)) {
+        errorCount++;
+        if (errorCount >= MAX_CONSECUTIVE_ERRORS && healthy) {
+            healthy = false;
+            emit sensorError(sensorName, "Sensor unhealthy - too many consecutive errors");
         }
     } else {
-        if (m_clitoralErrorCount > 0) {
-            m_clitoralErrorCount = std::max(0, m_clitoralErrorCount - 1);  // Gradual recovery
+        if (errorCount > 0) {
+            errorCount = std::max(0, errorCount - 1);  // Gradual recovery
         }
-        if (!m_clitoralSensorHealthy && m_clitoralErrorCount == 0) {
-            m_clitoralSensorHealthy = true;
-            emit sensorRecovered("Clitoral");
+        if (!healthy && errorCount == 0) {
+            healthy = true;
+            emit sensorRecovered(sensorName);
         }
     }
 }
@@ -4,7 +4,9 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
+#include <atomic>
 #include <memory>
+#include <cstdint>
 
 class MCP3008;
 
@@ -60,6 +62,12 @@ public:
     
     // Error thresholds
     void setErrorThresholds(double minVoltage, double maxVoltage);
+
+    // Extra ADC channels (bitmask, e.g. heart-rate on channel 3) sampled in
+    // the same batched SPI transaction as the pressure channels. Results are
+    // available through MCP3008::getScannedRawValue().
+    void setAuxiliaryScanChannels(uint8_t channelMask) { m_auxScanMask.store(channelMask, std::memory_order_relaxed); }
+    uint8_t getAuxiliaryScanChannels() const { return m_auxScanMask.load(std::memory_order_relaxed); }
     
     // Diagnostics
     QString getLastError() const { return m_lastError; }
@@ -79,7 +87,9 @@ private:
     void initializeFiltering();
     double applyFilter(double newValue, double& filteredValue);
     bool validateReading(double voltage, const QString& sensorName);
-    void checkSensorHealth();
+    void checkSensorHealth(const uint16_t raw[8]);
+    void updateChannelHealth(uint16_t raw, const QString& sensorName, int& errorCount, bool& healthy);
+    void storeReading(double pressure, double& current, double& filtered);
 
     // Hardware interface
     MCP3008* m_adc;
@@ -115,6 +125,9 @@ private:
     
     // Update timer
     QTimer* m_updateTimer;
+
+    // Additional channels included in each batched scan
+    std::atomic<uint8_t> m_auxScanMask;
     
     // Channel assignments (as per specification)
     static const int AVL_CHANNEL = 0;       // MCP3008 channel 0: Outer V-seal chamber
@@ -0,0 +1,161 @@
+#ifndef SENSORSNAPSHOTBUS_H
+#define SENSORSNAPSHOTBUS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief One coherent, timestamped sample of every sensor channel
+ *
+ * Produced once per acquisition tick by the acquisition owner
+ * (DataAcquisitionThread via HardwareManager::publishSensorSnapshot) and
+ * shared by every consumer in that tick, so all of them see the same values
+ * instead of readings skewed by a few milliseconds. The flags also carry the
+ * pump and emergency stop state at the time of sampling.
+ */
+struct SensorSnapshot {
+    enum ChannelFlag : uint32_t {
+        AVL_VALID        = 1u << 0,
+        TANK_VALID       = 1u << 1,
+        CLITORAL_VALID   = 1u << 2,
+        HEART_RATE_VALID = 1u << 3,
+        FLUID_VALID      = 1u << 4,
+        PUMP_ON          = 1u << 8,
+        EMERGENCY_STOP   = 1u << 10,
+        SIMULATED        = 1u << 31
+    };
+
+    uint64_t sequence = 0;        // Monotonic publish counter (0 = never published)
+    int64_t monotonicNs = 0;      // steady_clock time of acquisition
+    int64_t timestampMs = 0;      // Wall-clock ms since epoch (for logging/UI)
+    double avlPressure = -1.0;    // Outer V-seal chamber (mmHg, -1 = error)
+    double tankPressure = -1.0;   // Vacuum tank (mmHg, -1 = error)
+    double clitoralPressure = -1.0; // Clitoral cylinder (mmHg, -1 = error)
+    double heartRateBpm = -1.0;   // -1 = no sensor or no signal
+    double fluidMl = -1.0;        // Cumulative session fluid (ml, -1 = no sensor)
+    uint32_t flags = 0;
+
+    bool isPublished() const { return sequence != 0; }
+    bool hasAVL() const { return (flags & AVL_VALID) != 0; }
+    bool hasTank() const { return (flags & TANK_VALID) != 0; }
+    bool hasClitoral() const { return (flags & CLITORAL_VALID) != 0; }
+    bool hasHeartRate() const { return (flags & HEART_RATE_VALID) != 0; }
+    bool hasFluid() const { return (flags & FLUID_VALID) != 0; }
+
+    static int64_t monotonicNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double ageMs(int64_t nowNs = monotonicNowNs()) const
+    {
+        return static_cast<double>(nowNs - monotonicNs) / 1.0e6;
+    }
+};
+
+/**
+ * @brief Single-producer, multi-reader seqlock for SensorSnapshot
+ *
+ * The writer never blocks and never allocates. Readers never take a lock:
+ * they copy the payload and retry only if the writer was mid-publish, which
+ * at 50-1000 Hz and a ~60 byte payload happens vanishingly rarely.
+ *
+ * The payload is stored as relaxed atomic words so concurrent copies are
+ * well-defined under the C++ memory model; ordering comes from the sequence
+ * counter and the fences around it.
+ *
+ * Only one thread may call publish() at a time. Any number of threads may
+ * call read()/tryRead() concurrently.
+ */
+class SensorSnapshotBus
+{
+public:
+    SensorSnapshotBus() = default;
+    SensorSnapshotBus(const SensorSnapshotBus&) = delete;
+    SensorSnapshotBus& operator=(const SensorSnapshotBus&) = delete;
+
+    /**
+     * @brief Publish a new snapshot (producer only)
+     * @return The sequence number assigned to the snapshot
+     */
+    uint64_t publish(SensorSnapshot snapshot)
+    {
+        const uint64_t published = m_published.load(std::memory_order_relaxed) + 1;
+        snapshot.sequence = published;
+
+        Words words;
+        std::memcpy(words.data, &snapshot, sizeof(SensorSnapshot));
+
+        const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);   // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            m_words[i].store(words.data[i], std::memory_order_relaxed);
+        }
+
+        m_seq.store(seq + 2, std::memory_order_release);   // even: stable
+        m_published.store(published, std::memory_order_release);
+        return published;
+    }
+
+    /**
+     * @brief Single read attempt; fails if it raced with the producer
+     */
+    bool tryRead(SensorSnapshot& out) const
+    {
+        const uint32_t before = m_seq.load(std::memory_order_acquire);
+        if (before & 1u) {
+            return false;
+        }
+
+        Words words;
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            words.data[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+
+        std::memcpy(&out, words.data, sizeof(SensorSnapshot));
+        return true;
+    }
+
+    /**
+     * @brief Read the latest snapshot, retrying while the producer is mid-write
+     *
+     * Returns a default (unpublished) snapshot if nothing has been published.
+     */
+    SensorSnapshot read() const
+    {
+        SensorSnapshot snapshot;
+        while (!tryRead(snapshot)) {
+            // Producer holds the odd sequence for a few dozen stores at most
+        }
+        return snapshot;
+    }
+
+    uint64_t publishedCount() const { return m_published.load(std::memory_order_acquire); }
+
+private:
+    static_assert(std::is_trivially_copyable<SensorSnapshot>::value,
+                  "SensorSnapshot must be trivially copyable for the seqlock");
+
+    static constexpr size_t WORD_COUNT = (sizeof(SensorSnapshot) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Words {
+        uint64_t data[WORD_COUNT] = {};
+    };
+
+    alignas(64) std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint64_t> m_published{0};
+    alignas(64) std::atomic<uint64_t> m_words[WORD_COUNT] = {};
+};
+
+#endif // SENSORSNAPSHOTBUS_H
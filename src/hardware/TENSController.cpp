@@ -1,14 +1,18 @@
 #include "TENSController.h"
 #include "HardwareManager.h"
+#include "../performance/HotPathTrace.h"
 #include <QDebug>
+#include <QThread>
 #include <QtMath>
 #include <algorithm>
 
 TENSController::TENSController(HardwareManager* hardware, QObject *parent)
     : QObject(parent)
     , m_hardware(hardware)
-    , m_waveformTimer(new QTimer(this))
     , m_rampTimer(new QTimer(this))
+    , m_sequencerThread(nullptr)
+    , m_programDirty(false)
+    , m_syncGate(true)
     , m_initialized(false)
     , m_running(false)
     , m_enabled(false)
@@ -20,13 +24,8 @@ TENSController::TENSController(HardwareManager* hardware, QObject *parent)
     , m_targetAmplitude(0.0)
     , m_waveformType(Waveform::BIPHASIC_SYMMETRIC)
     , m_phaseSync(PhaseSync::CONTINUOUS)
-    , m_periodUs(static_cast<int>(1000000.0 / DEFAULT_FREQUENCY_HZ))
-    , m_positiveDurationUs(DEFAULT_PULSE_WIDTH_US)
-    , m_negativeDurationUs(DEFAULT_PULSE_WIDTH_US)
-    , m_interPulseUs(0)
     , m_pulsesPerBurst(5)
     , m_burstFrequencyHz(2)
-    , m_currentBurstPulse(0)
     , m_vacuumSuctionPhase(false)
     , m_syncEnabled(false)
     , m_faultDetected(false)
@@ -34,9 +33,8 @@ TENSController::TENSController(HardwareManager* hardware, QObject *parent)
     , m_minSealPressure(MIN_SEAL_PRESSURE_MMHG)
     , m_rampStep(0.0)
 {
-    // High-precision timer for waveform generation
-    m_waveformTimer->setTimerType(Qt::PreciseTimer);
-    connect(m_waveformTimer, &QTimer::timeout, this, &TENSController::onTimerTick);
+    // Signals are emitted from the sequencer thread
+    qRegisterMetaType<TENSController::OutputPhase>("TENSController::OutputPhase");
 
     // Ramp timer for soft start/stop
     m_rampTimer->setTimerType(Qt::PreciseTimer);
@@ -49,6 +47,7 @@ TENSController::TENSController(HardwareManager* hardware, QObject *parent)
 TENSController::~TENSController()
 {
     shutdown();
+    joinSequencer();
 }
 
 bool TENSController::initialize()
@@ -68,6 +67,25 @@ bool TENSController::initialize()
         return false;
     }
 
+    // Amplitude PWM: hardware channel, simulated only in simulation mode
+    if (!m_amplitudePWM) {
+        if (m_hardware->isSimulationMode()) {
+            m_amplitudePWM = std::make_unique<SimulatedPWMBackend>();
+        } else {
+            m_amplitudePWM = std::make_unique<SysfsPWMBackend>(TENS_PWM_CHIP, TENS_PWM_CHANNEL);
+        }
+    }
+    if (!m_amplitudePWM->open() || !m_amplitudePWM->setFrequency(TENS_PWM_FREQUENCY_HZ)) {
+        // Without an amplitude output TENS would "run" with nothing delivered
+        const QString message = QString("TENS amplitude PWM unavailable: %1").arg(m_amplitudePWM->lastError());
+        qCritical() << message;
+        m_amplitudePWM.reset();
+        locker.unlock();
+        emit error(message);
+        return false;
+    }
+    m_amplitudePWM->setDutyCycle(0.0);
+
     // Set initial GPIO states (all disabled)
     // Note: Actual GPIO control would go through HardwareManager
     m_enabled = false;
@@ -93,10 +111,15 @@ void TENSController::shutdown()
         locker.relock();
     }
 
-    m_waveformTimer->stop();
+    // Cuts any stop ramp short
     m_rampTimer->stop();
     m_enabled = false;
     m_outputPhase = OutputPhase::IDLE;
+    m_amplitudePercent = 0.0;
+    disableAmplitudeOutput();
+    if (m_amplitudePWM) {
+        m_amplitudePWM->close();
+    }
     m_initialized = false;
 
     qDebug() << "TENS Controller shutdown complete";
@@ -159,6 +182,7 @@ void TENSController::setPhaseSync(PhaseSync sync)
     QMutexLocker locker(&m_mutex);
     m_phaseSync = sync;
     m_syncEnabled = (sync != PhaseSync::CONTINUOUS);
+    updateSyncGate();
     qDebug() << "TENS phase sync set to" << static_cast<int>(sync);
 }
 
@@ -167,12 +191,16 @@ void TENSController::setBurstParameters(int pulsesPerBurst, int burstFrequencyHz
     QMutexLocker locker(&m_mutex);
     m_pulsesPerBurst = std::clamp(pulsesPerBurst, 1, 20);
     m_burstFrequencyHz = std::clamp(burstFrequencyHz, 1, 10);
+    calculateTiming();
     qDebug() << "TENS burst parameters:" << m_pulsesPerBurst << "pulses at"
              << m_burstFrequencyHz << "Hz burst rate";
 }
 
 void TENSController::start()
 {
+    // A previous emergencyStop() may have left the old thread finishing its frame
+    joinSequencer();
+
     QMutexLocker locker(&m_mutex);
 
     if (m_running) {
@@ -200,7 +228,6 @@ void TENSController::start()
 
     m_running = true;
     m_pulseCount = 0;
-    m_currentBurstPulse = 0;
 
     // Start with soft start (amplitude at 0, ramp up)
     m_amplitudePercent = 0.0;
@@ -209,15 +236,17 @@ void TENSController::start()
     // Enable hardware
     m_enabled = true;
     // TODO: Set GPIO_TENS_ENABLE HIGH via HardwareManager
+    if (m_amplitudePWM) {
+        m_amplitudePWM->setEnabled(true);
+    }
 
-    // Start timers
-    m_phaseTimer.start();
     m_rampTimer->start();
 
-    // Calculate timer interval based on pulse width (need at least 2 ticks per pulse phase)
-    int timerIntervalMs = std::max(1, m_pulseWidthUs / 1000);
-    m_waveformTimer->setInterval(timerIntervalMs);
-    m_waveformTimer->start();
+    // Pulse edges are played back by the sequencer thread
+    m_programDirty = true;
+    m_sequencerThread = QThread::create([this]() { runSequencer(); });
+    m_sequencerThread->setObjectName("TENSSequencer");
+    m_sequencerThread->start(QThread::TimeCriticalPriority);
 
     locker.unlock();
     emit stimulationStarted();
@@ -233,23 +262,25 @@ void TENSController::stop()
 
     qDebug() << "Stopping TENS stimulation...";
 
-    // Soft stop - ramp amplitude down
+    // Soft stop - ramp amplitude down; onRampTimer() switches the amplitude
+    // PWM off once it reaches zero. The pulse sequencer stops now.
     m_targetAmplitude = 0.0;
     m_rampStep = -m_amplitudePercent / (RAMP_TIME_MS / RAMP_INTERVAL_MS);
-
-    // Will complete stop when amplitude reaches 0
-    // For now, just stop the waveform timer
-    m_waveformTimer->stop();
+    m_rampTimer->start();
     m_running = false;
 
-    // Set to idle phase
-    setOutputPhase(OutputPhase::IDLE);
+    {
+        // Once we hold the output lock the sequencer cannot start another edge
+        std::lock_guard<std::mutex> outputLock(m_outputMutex);
+        setOutputPhase(OutputPhase::IDLE);
+    }
 
     // Disable hardware
     m_enabled = false;
     // TODO: Set GPIO_TENS_ENABLE LOW via HardwareManager
 
     locker.unlock();
+    joinSequencer();
     emit stimulationStopped();
 
     qDebug() << "TENS stimulation stopped. Total pulses:" << m_pulseCount;
@@ -262,15 +293,18 @@ void TENSController::emergencyStop()
     qWarning() << "TENS EMERGENCY STOP";
 
     // Immediate stop - no soft ramp
-    m_waveformTimer->stop();
     m_rampTimer->stop();
     m_running = false;
     m_enabled = false;
     m_amplitudePercent = 0.0;
     m_targetAmplitude = 0.0;
 
-    // Set to idle immediately
-    setOutputPhase(OutputPhase::IDLE);
+    // Set to idle immediately; the sequencer exits at its next edge
+    {
+        std::lock_guard<std::mutex> outputLock(m_outputMutex);
+        setOutputPhase(OutputPhase::IDLE);
+    }
+    disableAmplitudeOutput();
 
     // TODO: Set GPIO_TENS_ENABLE LOW immediately via HardwareManager
 
@@ -344,7 +378,7 @@ bool TENSController::canEnable() const
     }
 
     // Check vacuum seal integrity (clitoral cup must be sealed)
-    double clitoralPressure = m_hardware->readClitoralPressure();
+    double clitoralPressure = m_hardware->getSensorSnapshot().clitoralPressure;
     if (clitoralPressure < m_minSealPressure) {
         qWarning() << "TENS: Cannot enable - seal pressure too low:"
                    << clitoralPressure << "mmHg (min:" << m_minSealPressure << ")";
@@ -391,27 +425,15 @@ void TENSController::onVacuumPhaseChanged(bool isSuctionPhase)
         default:
             break;
     }
+
+    updateSyncGate();
 }
 
-void TENSController::onTimerTick()
+void TENSController::updateSyncGate()
 {
-    QMutexLocker locker(&m_mutex);
-
-    if (!m_running || !m_enabled) {
-        return;
-    }
-
-    // Check fault status periodically
-    checkFaultStatus();
-    if (m_faultDetected) {
-        locker.unlock();
-        emergencyStop();
-        return;
-    }
-
-    // Check sync conditions
+    // Called with m_mutex held; the sequencer reads the result lock-free
+    bool shouldOutput = true;
     if (m_syncEnabled) {
-        bool shouldOutput = false;
         switch (m_phaseSync) {
             case PhaseSync::SYNC_SUCTION:
                 shouldOutput = m_vacuumSuctionPhase;
@@ -425,15 +447,8 @@ void TENSController::onTimerTick()
                 shouldOutput = true;
                 break;
         }
-
-        if (!shouldOutput) {
-            setOutputPhase(OutputPhase::IDLE);
-            return;
-        }
     }
-
-    // Generate waveform based on type
-    generatePulse();
+    m_syncGate = shouldOutput;
 }
 
 void TENSController::onRampTimer()
@@ -441,59 +456,28 @@ void TENSController::onRampTimer()
     QMutexLocker locker(&m_mutex);
 
     // Ramp amplitude toward target
-    if (qAbs(m_amplitudePercent - m_targetAmplitude) < qAbs(m_rampStep)) {
+    const double amplitude = m_amplitudePercent.load(std::memory_order_relaxed);
+    if (qAbs(amplitude - m_targetAmplitude) <= qAbs(m_rampStep)) {
         m_amplitudePercent = m_targetAmplitude;
         m_rampTimer->stop();
     } else {
-        m_amplitudePercent += m_rampStep;
-        m_amplitudePercent = std::clamp(m_amplitudePercent, 0.0, 100.0);
+        m_amplitudePercent = std::clamp(amplitude + m_rampStep, 0.0, 100.0);
     }
 
-    updatePWMAmplitude();
+    if (!m_running && !m_rampTimer->isActive()) {
+        // Stop ramp finished
+        disableAmplitudeOutput();
+    } else {
+        updatePWMAmplitude();
+    }
 
     locker.unlock();
     emit amplitudeChanged(m_amplitudePercent);
 }
 
-void TENSController::generatePulse()
-{
-    qint64 elapsedUs = m_phaseTimer.nsecsElapsed() / 1000;
-
-    // State machine for biphasic waveform
-    switch (m_outputPhase) {
-        case OutputPhase::IDLE:
-            setOutputPhase(OutputPhase::POSITIVE);
-            m_phaseTimer.restart();
-            break;
-
-        case OutputPhase::POSITIVE:
-            if (elapsedUs >= m_positiveDurationUs) {
-                setOutputPhase(OutputPhase::NEGATIVE);
-                m_phaseTimer.restart();
-            }
-            break;
-
-        case OutputPhase::NEGATIVE:
-            if (elapsedUs >= m_negativeDurationUs) {
-                setOutputPhase(OutputPhase::INTER_PULSE);
-                m_phaseTimer.restart();
-                m_pulseCount++;
-                emit pulseCompleted(m_pulseCount);
-            }
-            break;
-
-        case OutputPhase::INTER_PULSE:
-            if (elapsedUs >= m_interPulseUs) {
-                // Start next pulse
-                setOutputPhase(OutputPhase::POSITIVE);
-                m_phaseTimer.restart();
-            }
-            break;
-    }
-}
-
 void TENSController::setOutputPhase(OutputPhase phase)
 {
+    // Called with m_outputMutex held (sequencer edges, stop, emergencyStop)
     if (m_outputPhase == phase) return;
 
     m_outputPhase = phase;
@@ -503,11 +487,11 @@ void TENSController::setOutputPhase(OutputPhase phase)
     switch (phase) {
         case OutputPhase::POSITIVE:
             // GPIO_TENS_PHASE = HIGH, GPIO_TENS_ENABLE = HIGH
-            qDebug() << "TENS: Positive phase";
+            VC_TRACE(HotPathTrace::TENS, HotPathTrace::LEVEL_VERBOSE, "tens.positive");
             break;
         case OutputPhase::NEGATIVE:
             // GPIO_TENS_PHASE = LOW, GPIO_TENS_ENABLE = HIGH
-            qDebug() << "TENS: Negative phase";
+            VC_TRACE(HotPathTrace::TENS, HotPathTrace::LEVEL_VERBOSE, "tens.negative");
             break;
         case OutputPhase::INTER_PULSE:
         case OutputPhase::IDLE:
@@ -521,19 +505,32 @@ void TENSController::setOutputPhase(OutputPhase phase)
 
 void TENSController::updatePWMAmplitude()
 {
-    // Convert amplitude percentage to PWM duty cycle
-    // TODO: Implement via HardwareManager PWM control
-    int pwmValue = static_cast<int>(m_amplitudePercent * 10.24);  // 0-1024 range
-    Q_UNUSED(pwmValue);
-    // m_hardware->setTENSPWM(pwmValue);
+    // Convert amplitude percentage to PWM duty cycle (one write per ramp step)
+    if (m_amplitudePWM && m_amplitudePWM->isOpen() &&
+        !m_amplitudePWM->setDutyCycle(m_amplitudePercent / 100.0)) {
+        qWarning() << "TENS amplitude update failed:" << m_amplitudePWM->lastError();
+    }
 }
 
-void TENSController::checkFaultStatus()
+void TENSController::disableAmplitudeOutput()
+{
+    if (m_amplitudePWM && m_amplitudePWM->isOpen()) {
+        m_amplitudePWM->setDutyCycle(0.0);
+        m_amplitudePWM->setEnabled(false);
+    }
+}
+
+bool TENSController::readFaultInput() const
 {
     // TODO: Read GPIO_TENS_FAULT input via HardwareManager
     // For now, assume no fault
-    // bool faultPin = m_hardware->readTENSFault();
-    bool faultPin = false;
+    // return m_hardware->readTENSFault();
+    return false;
+}
+
+void TENSController::checkFaultStatus()
+{
+    bool faultPin = readFaultInput();
 
     if (faultPin && !m_faultDetected) {
         m_faultDetected = true;
@@ -551,7 +548,7 @@ void TENSController::checkElectrodeContact()
     // Electrode impedance measurement would require dedicated circuitry
     // For now, estimate based on seal pressure
     if (m_hardware) {
-        double pressure = m_hardware->readClitoralPressure();
+        double pressure = m_hardware->getSensorSnapshot().clitoralPressure;
         // Good seal = likely good electrode contact
         bool goodContact = (pressure >= m_minSealPressure);
         emit electrodeContact(goodContact);
@@ -560,30 +557,158 @@ void TENSController::checkElectrodeContact()
 
 void TENSController::calculateTiming()
 {
-    // Period in microseconds
-    m_periodUs = static_cast<int>(1000000.0 / m_frequencyHz);
-
-    // For biphasic symmetric: equal positive and negative phases
-    m_positiveDurationUs = m_pulseWidthUs;
-    m_negativeDurationUs = m_pulseWidthUs;
+    // Called with m_mutex held (or from the constructor)
+    TENSWaveform::Spec spec;
+    spec.frequencyHz = m_frequencyHz;
+    spec.pulseWidthUs = m_pulseWidthUs;
+    spec.pulsesPerBurst = m_pulsesPerBurst;
+    spec.burstFrequencyHz = m_burstFrequencyHz;
+    switch (m_waveformType) {
+        case Waveform::BIPHASIC_ASYMMETRIC:
+            spec.shape = TENSWaveform::Shape::BIPHASIC_ASYMMETRIC;
+            break;
+        case Waveform::BURST:
+            spec.shape = TENSWaveform::Shape::BURST;
+            break;
+        case Waveform::BIPHASIC_SYMMETRIC:
+        default:
+            spec.shape = TENSWaveform::Shape::BIPHASIC_SYMMETRIC;
+            break;
+    }
 
-    // Inter-pulse gap is the remainder of the period
-    m_interPulseUs = m_periodUs - m_positiveDurationUs - m_negativeDurationUs;
+    auto program = std::make_shared<const TENSWaveform::Program>(TENSWaveform::compile(spec));
 
-    // Ensure inter-pulse is never negative
-    if (m_interPulseUs < 0) {
-        // Reduce pulse width proportionally
-        int maxPulseWidth = m_periodUs / 2;
-        m_positiveDurationUs = maxPulseWidth;
-        m_negativeDurationUs = maxPulseWidth;
-        m_interPulseUs = 0;
-        qWarning() << "TENS: Pulse width adjusted to" << maxPulseWidth
+    if (program->pulseWidthClamped) {
+        qWarning() << "TENS: Pulse width adjusted to" << program->phaseNs / 1000
                    << "μs to fit frequency";
     }
 
     qDebug() << "TENS timing calculated:";
-    qDebug() << "  Period:" << m_periodUs << "μs (" << m_frequencyHz << "Hz)";
-    qDebug() << "  Positive phase:" << m_positiveDurationUs << "μs";
-    qDebug() << "  Negative phase:" << m_negativeDurationUs << "μs";
-    qDebug() << "  Inter-pulse:" << m_interPulseUs << "μs";
+    qDebug() << "  Period:" << program->pulsePeriodNs / 1000 << "μs (" << m_frequencyHz << "Hz)";
+    qDebug() << "  Phase width:" << program->phaseNs / 1000 << "μs";
+    qDebug() << "  Frame:" << program->frameNs / 1000 << "μs," << program->pulsesPerFrame << "pulse(s)";
+
+    // The sequencer adopts the new program at its next frame boundary
+    m_program = std::move(program);
+    m_programDirty = true;
+}
+
+void TENSController::setAmplitudeBackend(std::unique_ptr<PWMBackend> backend)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_initialized) {
+        qWarning() << "TENS: amplitude backend must be set before initialize()";
+        return;
+    }
+    m_amplitudePWM = std::move(backend);
+}
+
+void TENSController::resetTimingStatistics()
+{
+    m_edgeStats.reset();
+    m_pulseStartStats.reset();
+    m_pulseWidthStats.reset();
+}
+
+void TENSController::joinSequencer()
+{
+    if (m_sequencerThread) {
+        m_sequencerThread->wait();
+        delete m_sequencerThread;
+        m_sequencerThread = nullptr;
+    }
+}
+
+void TENSController::runSequencer()
+{
+    if (!RealTime::setFifoPriority(SEQUENCER_FIFO_PRIORITY)) {
+        qWarning() << "TENSController: SCHED_FIFO not permitted, pulse timing uses normal scheduling";
+    }
+
+    std::shared_ptr<const TENSWaveform::Program> program;
+    int64_t frameStartNs = RealTime::monotonicNowNs();
+
+    while (m_running) {
+        // Settings changes are adopted only at a frame boundary so a pulse
+        // never mixes two programs. Never block on the GUI-side mutex here.
+        if (!program) {
+            QMutexLocker locker(&m_mutex);  // First frame: must have a program
+            program = m_program;
+            m_programDirty = false;
+        } else if (m_programDirty && m_mutex.tryLock()) {
+            program = m_program;
+            m_programDirty = false;
+            m_mutex.unlock();
+        }
+
+        bool pulseGated = false;
+        bool frameOutput = false;
+        int64_t pulseStartNs = 0;
+
+        for (const TENSWaveform::Edge& edge : program->edges) {
+            const int64_t deadlineNs = frameStartNs + edge.offsetNs;
+
+            // Vacuum phase sync and ALTERNATING mode decide per pulse
+            if (edge.pulseStart) {
+                pulseGated = !(m_enabled && m_syncGate);
+                if (pulseGated) {
+                    // No output, but still wait out the pulse slot: keeps the
+                    // thread off the CPU and the frame timeline on real time
+                    RealTime::sleepUntilNs(deadlineNs);
+                }
+            }
+            if (pulseGated) {
+                continue;
+            }
+
+            RealTime::sleepUntilPreciseNs(deadlineNs, EDGE_SPIN_WINDOW_NS);
+            frameOutput = true;
+
+            const OutputPhase phase = edge.level == TENSWaveform::Level::POSITIVE ? OutputPhase::POSITIVE
+                                    : edge.level == TENSWaveform::Level::NEGATIVE ? OutputPhase::NEGATIVE
+                                    : OutputPhase::INTER_PULSE;
+            int64_t edgeNs;
+            {
+                std::lock_guard<std::mutex> outputLock(m_outputMutex);
+                if (!m_running) {
+                    return;  // stop()/emergencyStop() already idled the output
+                }
+                setOutputPhase(phase);
+                edgeNs = RealTime::monotonicNowNs();
+            }
+
+            m_edgeStats.record(edgeNs - deadlineNs);
+            if (edge.pulseStart) {
+                m_pulseStartStats.record(edgeNs - deadlineNs);
+                pulseStartNs = edgeNs;
+            }
+            if (edge.pulseEnd) {
+                m_pulseWidthStats.record((edgeNs - pulseStartNs) - 2 * program->phaseNs);
+                emit pulseCompleted(++m_pulseCount);
+            }
+        }
+
+        frameStartNs += program->frameNs;
+
+        // Fault input is polled once per frame, outside the edge path
+        if (readFaultInput()) {
+            QMetaObject::invokeMethod(this, [this]() {
+                checkFaultStatus();
+                emergencyStop();
+            }, Qt::QueuedConnection);
+            return;
+        }
+
+        // If a whole frame was missed (e.g. preempted), restart the frame now
+        // instead of firing a burst of stale pulses. A gap while every pulse
+        // was gated is not an overrun, but still resyncs.
+        const int64_t nowNs = RealTime::monotonicNowNs();
+        if (nowNs - frameStartNs > program->frameNs) {
+            if (frameOutput) {
+                m_edgeStats.recordOverrun();
+            }
+            frameStartNs = nowNs;
+        }
+    }
 }
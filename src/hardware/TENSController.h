@@ -4,10 +4,16 @@
 #include <QObject>
 #include <QTimer>
 #include <QMutex>
-#include <QElapsedTimer>
+#include <atomic>
 #include <memory>
+#include <mutex>
+
+#include "PWMBackend.h"
+#include "TENSWaveform.h"
+#include "../threading/RealTimeSupport.h"
 
 class HardwareManager;
+class QThread;
 
 /**
  * @brief TENS (Transcutaneous Electrical Nerve Stimulation) Controller
@@ -20,6 +26,11 @@ class HardwareManager;
  *
  * Integrated with V-Contour clitoral cup electrodes for combined
  * vacuum oscillation + electrical stimulation therapy.
+ *
+ * Settings are compiled into a frame of output edges (TENSWaveform) that a
+ * dedicated sequencer thread replays against absolute CLOCK_MONOTONIC
+ * deadlines. Per-edge, per-pulse-start and pulse-width timing errors are
+ * recorded. Amplitude is set through a PWMBackend.
  */
 class TENSController : public QObject
 {
@@ -97,12 +108,28 @@ public:
     void setPresetClimax();     // 30 Hz, 300 μs, higher amplitude
     void setPresetAfterGlow();  // 10 Hz, 500 μs, low amplitude
 
+    // Amplitude PWM output stage; must be set before initialize(). Without
+    // one, initialize() opens the hardware PWM channel (a simulated backend
+    // in simulation mode) and fails if that channel cannot be opened.
+    void setAmplitudeBackend(std::unique_ptr<PWMBackend> backend);
+    PWMBackend* getAmplitudeBackend() const { return m_amplitudePWM.get(); }
+
+    // Pulse timing telemetry (sequencer lateness vs. compiled schedule)
+    double getEdgeMeanErrorUs() const { return m_edgeStats.meanAbsErrorUs(); }
+    double getEdgeMaxErrorUs() const { return m_edgeStats.maxErrorUs(); }
+    double getPulseStartMeanErrorUs() const { return m_pulseStartStats.meanAbsErrorUs(); }
+    double getPulseStartMaxErrorUs() const { return m_pulseStartStats.maxErrorUs(); }
+    double getPulseWidthMeanErrorUs() const { return m_pulseWidthStats.meanErrorUs(); }
+    double getPulseWidthMaxErrorUs() const { return m_pulseWidthStats.maxErrorUs(); }
+    quint64 getMissedFrameCount() const { return m_edgeStats.overruns(); }
+    void resetTimingStatistics();
+
     // Status and diagnostics
-    OutputPhase getCurrentPhase() const { return m_outputPhase; }
+    OutputPhase getCurrentPhase() const { return m_outputPhase.load(); }
     double getElectrodeImpedance() const { return m_electrodeImpedance; }
     bool isFaultDetected() const { return m_faultDetected; }
     QString getFaultReason() const { return m_faultReason; }
-    int getPulseCount() const { return m_pulseCount; }
+    int getPulseCount() const { return m_pulseCount.load(); }
 
     // Safety
     bool canEnable() const;
@@ -125,50 +152,58 @@ Q_SIGNALS:
     void error(const QString& message);
 
 private Q_SLOTS:
-    void onTimerTick();
     void onRampTimer();
 
 private:
-    void generatePulse();
     void setOutputPhase(OutputPhase phase);
     void updatePWMAmplitude();
+    void disableAmplitudeOutput();
     void checkFaultStatus();
+    bool readFaultInput() const;
     void checkElectrodeContact();
     void softStart();
     void softStop();
     void calculateTiming();
+    void updateSyncGate();
+    void runSequencer();
+    void joinSequencer();
 
     HardwareManager* m_hardware;
-    QTimer* m_waveformTimer;
     QTimer* m_rampTimer;
-    QElapsedTimer m_phaseTimer;
     mutable QMutex m_mutex;
 
+    // Sequencer thread
+    QThread* m_sequencerThread;
+    std::mutex m_outputMutex;             // Orders sequencer edges against stop/emergencyStop
+    std::shared_ptr<const TENSWaveform::Program> m_program;   // Guarded by m_mutex
+    std::atomic<bool> m_programDirty;     // Consumed at frame boundary
+    std::atomic<bool> m_syncGate;         // Vacuum phase sync allows output
+    RealTime::TimingStats m_edgeStats;
+    RealTime::TimingStats m_pulseStartStats;
+    RealTime::TimingStats m_pulseWidthStats;
+
+    // Amplitude output
+    std::unique_ptr<PWMBackend> m_amplitudePWM;
+
     // State
     bool m_initialized;
-    bool m_running;
-    bool m_enabled;           // Hardware enable state
-    OutputPhase m_outputPhase;
-    int m_pulseCount;
-
-    // Waveform parameters
-    double m_frequencyHz;
-    int m_pulseWidthUs;
-    double m_amplitudePercent;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_enabled;          // Hardware enable state
+    std::atomic<OutputPhase> m_outputPhase;
+    std::atomic<int> m_pulseCount;
+
+    // Waveform parameters; written under m_mutex, atomic so recorders and
+    // getters can read them from any thread
+    std::atomic<double> m_frequencyHz;
+    std::atomic<int> m_pulseWidthUs;
+    std::atomic<double> m_amplitudePercent;
     double m_targetAmplitude;  // For soft start/stop ramping
     Waveform m_waveformType;
     PhaseSync m_phaseSync;
 
-    // Timing (microseconds)
-    int m_periodUs;           // Total period = 1/frequency
-    int m_positiveDurationUs;
-    int m_negativeDurationUs;
-    int m_interPulseUs;
-
     // Burst mode
     int m_pulsesPerBurst;
     int m_burstFrequencyHz;
-    int m_currentBurstPulse;
 
     // Vacuum synchronization
     bool m_vacuumSuctionPhase;
@@ -189,6 +224,9 @@ private:
     static const int GPIO_TENS_ENABLE = 5;   // Master enable
     static const int GPIO_TENS_PHASE = 6;    // Polarity control
     static const int GPIO_TENS_PWM = 12;     // Amplitude PWM (hardware PWM1)
+    static const int TENS_PWM_CHIP = 0;
+    static const int TENS_PWM_CHANNEL = 1;   // Hardware PWM1
+    static const int TENS_PWM_FREQUENCY_HZ = 20000;  // Filtered to a DC amplitude reference
     static const int GPIO_TENS_FAULT = 16;   // Fault input
 
     // Limits
@@ -202,8 +240,9 @@ private:
     static constexpr double MIN_SEAL_PRESSURE_MMHG = 10.0;
     static constexpr double MAX_IMPEDANCE_OHMS = 10000.0;
 
-    // Timer resolution
-    static constexpr int TIMER_RESOLUTION_US = 50;  // 50μs resolution
+    // Sequencer timing
+    static const int SEQUENCER_FIFO_PRIORITY = 90;             // Above valve sequencer (85)
+    static constexpr int64_t EDGE_SPIN_WINDOW_NS = 100000;     // Busy-wait the last 100 μs before an edge
 };
 
 #endif // TENSCONTROLLER_H
@@ -0,0 +1,53 @@
+#include "TENSWaveform.h"
+#include <algorithm>
+
+namespace TENSWaveform {
+
+namespace {
+
+void appendPulse(Program& program, int64_t startNs, int64_t phaseNs)
+{
+    // Charge-balanced biphasic pulse: equal positive and negative phases.
+    // The asymmetric variant uses the same timing; with a single amplitude
+    // DAC the phases cannot differ in current, so widths must match.
+    program.edges.push_back({startNs, Level::POSITIVE, true, false});
+    program.edges.push_back({startNs + phaseNs, Level::NEGATIVE, false, false});
+    program.edges.push_back({startNs + 2 * phaseNs, Level::OFF, false, true});
+}
+
+} // namespace
+
+Program compile(const Spec& spec)
+{
+    Program program;
+
+    const double frequencyHz = spec.frequencyHz > 0.0 ? spec.frequencyHz : 1.0;
+    program.pulsePeriodNs = static_cast<int64_t>(1e9 / frequencyHz);
+
+    program.phaseNs = static_cast<int64_t>(spec.pulseWidthUs) * 1000;
+    if (2 * program.phaseNs > program.pulsePeriodNs) {
+        program.phaseNs = program.pulsePeriodNs / 2;
+        program.pulseWidthClamped = true;
+    }
+
+    if (spec.shape == Shape::BURST) {
+        const int burstHz = std::max(1, spec.burstFrequencyHz);
+        program.frameNs = 1000000000LL / burstHz;
+
+        // As many pulses as fit in the burst frame, up to the requested count
+        const int64_t fit = std::max<int64_t>(1, program.frameNs / program.pulsePeriodNs);
+        program.pulsesPerFrame = static_cast<int>(std::min<int64_t>(std::max(1, spec.pulsesPerBurst), fit));
+    } else {
+        program.frameNs = program.pulsePeriodNs;
+        program.pulsesPerFrame = 1;
+    }
+
+    program.edges.reserve(static_cast<size_t>(program.pulsesPerFrame) * 3);
+    for (int pulse = 0; pulse < program.pulsesPerFrame; ++pulse) {
+        appendPulse(program, pulse * program.pulsePeriodNs, program.phaseNs);
+    }
+
+    return program;
+}
+
+} // namespace TENSWaveform
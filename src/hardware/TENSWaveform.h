@@ -0,0 +1,61 @@
+#ifndef TENSWAVEFORM_H
+#define TENSWAVEFORM_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Waveform compiler for TENS pulse trains
+ *
+ * Turns frequency / pulse width / waveform / burst settings into a frame of
+ * precomputed output edges with nanosecond offsets. The TENS sequencer
+ * thread replays the frame against absolute CLOCK_MONOTONIC deadlines, so
+ * nothing is computed between edges and 50-500 us phases are representable.
+ *
+ * Vacuum phase synchronization is not compiled in: it depends on the live
+ * oscillator phase and is applied by the sequencer as a gate at each pulse
+ * start.
+ */
+namespace TENSWaveform {
+
+enum class Shape {
+    BIPHASIC_SYMMETRIC,
+    BIPHASIC_ASYMMETRIC,
+    BURST
+};
+
+enum class Level : uint8_t {
+    OFF,
+    POSITIVE,
+    NEGATIVE
+};
+
+struct Edge {
+    int64_t offsetNs;       // From frame start
+    Level level;
+    bool pulseStart;        // First edge of a pulse (gating point)
+    bool pulseEnd;          // Last edge of a pulse (back to OFF)
+};
+
+struct Spec {
+    double frequencyHz = 20.0;
+    int pulseWidthUs = 400;           // Per phase
+    Shape shape = Shape::BIPHASIC_SYMMETRIC;
+    int pulsesPerBurst = 5;
+    int burstFrequencyHz = 2;
+};
+
+struct Program {
+    std::vector<Edge> edges;
+    int64_t frameNs = 0;              // Frame repeats with this period
+    int64_t pulsePeriodNs = 0;
+    int64_t phaseNs = 0;              // Effective per-phase width
+    int pulsesPerFrame = 0;
+    bool pulseWidthClamped = false;   // Pulse width reduced to fit the period
+};
+
+Program compile(const Spec& spec);
+
+} // namespace TENSWaveform
+
+#endif // TENSWAVEFORM_H
@@ -0,0 +1,87 @@
+#ifndef VIRTUALCLOCK_H
+#define VIRTUALCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Time base for the simulated plant
+ *
+ * Two modes:
+ *  - scaled real time: virtual time runs timeScale() times faster than
+ *    steady_clock (1.0 = wall speed, 100.0 = a minute of plant time in 0.6 s)
+ *  - manual: virtual time only moves when advanceNs() is called, which makes
+ *    simulation runs fully deterministic and independent of host load
+ *
+ * Not thread-safe; HardwareManager serializes access under its state mutex.
+ */
+class VirtualClock
+{
+public:
+    VirtualClock()
+        : m_manual(false)
+        , m_timeScale(1.0)
+        , m_anchorRealNs(realNowNs())
+        , m_anchorVirtualNs(0)
+    {
+    }
+
+    int64_t nowNs() const
+    {
+        if (m_manual) {
+            return m_anchorVirtualNs;
+        }
+        const int64_t realElapsedNs = realNowNs() - m_anchorRealNs;
+        return m_anchorVirtualNs + static_cast<int64_t>(static_cast<double>(realElapsedNs) * m_timeScale);
+    }
+
+    bool isManual() const { return m_manual; }
+    double timeScale() const { return m_timeScale; }
+
+    void setManual(bool manual)
+    {
+        rebase();
+        m_manual = manual;
+    }
+
+    void setTimeScale(double scale)
+    {
+        rebase();
+        m_timeScale = scale > 0.0 ? scale : 1.0;
+    }
+
+    // Manual mode only; ignored while following real time
+    void advanceNs(int64_t ns)
+    {
+        if (m_manual && ns > 0) {
+            m_anchorVirtualNs += ns;
+        }
+    }
+
+    void reset()
+    {
+        m_anchorRealNs = realNowNs();
+        m_anchorVirtualNs = 0;
+    }
+
+private:
+    // Re-anchor so mode/scale changes never make virtual time jump
+    void rebase()
+    {
+        m_anchorVirtualNs = nowNs();
+        m_anchorRealNs = realNowNs();
+    }
+
+    static int64_t realNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool m_manual;
+    double m_timeScale;
+    int64_t m_anchorRealNs;
+    int64_t m_anchorVirtualNs;
+};
+
+#endif // VIRTUALCLOCK_H
@@ -0,0 +1,408 @@
+#include "BinarySensorLog.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+const uint32_t FILE_MAGIC = 0x4C534356;     // "VCSL"
+const uint32_t BLOCK_MAGIC = 0x42534356;    // "VCSB"
+const uint32_t INDEX_MAGIC = 0x49534356;    // "VCSI"
+const uint32_t FOOTER_MAGIC = 0x45534356;   // "VCSE"
+
+template<typename T>
+void put(char*& out, T value)
+{
+    qToLittleEndian(value, out);
+    out += sizeof(T);
+}
+
+void putFloat(char*& out, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put(out, bits);
+}
+
+template<typename T>
+T get(const char*& in)
+{
+    const T value = qFromLittleEndian<T>(in);
+    in += sizeof(T);
+    return value;
+}
+
+float getFloat(const char*& in)
+{
+    const uint32_t bits = get<uint32_t>(in);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+}
+
+BinarySensorLog::BinarySensorLog()
+    : m_pendingCount(0)
+    , m_blockCapacity(DEFAULT_BLOCK_RECORDS)
+    , m_bytesWritten(0)
+{
+}
+
+BinarySensorLog::~BinarySensorLog()
+{
+    close();
+}
+
+bool BinarySensorLog::open(const QString& filePath, int blockCapacity)
+{
+    close();
+
+    m_blockCapacity = qBound(1, blockCapacity, MAX_BLOCK_RECORDS);
+    m_pending.resize(m_blockCapacity);
+    m_pendingCount = 0;
+    m_blockBuffer.resize(BLOCK_HEADER_BYTES + m_blockCapacity * RECORD_BYTES);
+    m_blocks.clear();
+    m_bytesWritten = 0;
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = m_file.errorString();
+        return false;
+    }
+
+    char header[FILE_HEADER_BYTES] = {};
+    char* out = header;
+    put<uint32_t>(out, FILE_MAGIC);
+    put<uint16_t>(out, FORMAT_VERSION);
+    put<uint16_t>(out, CHANNEL_COUNT);
+    put<uint32_t>(out, static_cast<uint32_t>(m_blockCapacity));
+    put<uint32_t>(out, FILE_HEADER_BYTES);
+    put<int64_t>(out, wallClockNowUs());
+    if (!writeRaw(header, FILE_HEADER_BYTES)) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void BinarySensorLog::close()
+{
+    if (!m_file.isOpen()) return;
+
+    flush();
+
+    // Index and footer; without them readers fall back to a block scan
+    const uint64_t indexOffset = static_cast<uint64_t>(m_bytesWritten);
+    QByteArray index(8 + m_blocks.size() * INDEX_ENTRY_BYTES + FOOTER_BYTES, 0);
+    char* out = index.data();
+    put<uint32_t>(out, INDEX_MAGIC);
+    put<uint32_t>(out, static_cast<uint32_t>(m_blocks.size()));
+    for (const BlockInfo& block : m_blocks) {
+        put<int64_t>(out, block.firstUs);
+        put<int64_t>(out, block.lastUs);
+        put<uint64_t>(out, block.offset);
+        put<uint32_t>(out, block.count);
+        put<uint32_t>(out, 0);
+    }
+    put<uint64_t>(out, indexOffset);
+    put<uint32_t>(out, FOOTER_MAGIC);
+    put<uint32_t>(out, 0);
+    writeRaw(index.constData(), index.size());
+
+    m_file.close();
+}
+
+bool BinarySensorLog::append(const Sample& sample)
+{
+    if (!m_file.isOpen()) return false;
+
+    // Deltas are 32-bit microseconds from the block's first sample; a gap
+    // that does not fit (or time going backwards) starts a new block
+    if (m_pendingCount > 0) {
+        const int64_t deltaUs = sample.timestampUs - m_pending[0].timestampUs;
+        if (deltaUs < 0 || deltaUs > static_cast<int64_t>(UINT32_MAX)) {
+            if (!writeBlock()) return false;
+        }
+    }
+
+    m_pending[m_pendingCount++] = sample;
+    if (m_pendingCount == m_blockCapacity) {
+        return writeBlock();
+    }
+    return true;
+}
+
+bool BinarySensorLog::flush()
+{
+    if (!m_file.isOpen()) return false;
+    if (m_pendingCount > 0 && !writeBlock()) return false;
+    return m_file.flush();
+}
+
+bool BinarySensorLog::writeBlock()
+{
+    const int count = m_pendingCount;
+    const uint32_t payloadBytes = static_cast<uint32_t>(count * RECORD_BYTES);
+    char* const block = m_blockBuffer.data();
+    const int64_t firstUs = m_pending[0].timestampUs;
+
+    // Columns: deltas, each channel, flags
+    char* out = block + BLOCK_HEADER_BYTES;
+    for (int i = 0; i < count; ++i) {
+        put<uint32_t>(out, static_cast<uint32_t>(m_pending[i].timestampUs - firstUs));
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        for (int i = 0; i < count; ++i) {
+            putFloat(out, m_pending[i].values[channel]);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        put<uint16_t>(out, m_pending[i].flags);
+    }
+
+    BlockInfo info;
+    info.firstUs = firstUs;
+    info.lastUs = m_pending[count - 1].timestampUs;
+    info.offset = static_cast<uint64_t>(m_bytesWritten);
+    info.count = static_cast<uint32_t>(count);
+
+    out = block;
+    put<uint32_t>(out, BLOCK_MAGIC);
+    put<uint32_t>(out, info.count);
+    put<int64_t>(out, info.firstUs);
+    put<int64_t>(out, info.lastUs);
+    put<uint32_t>(out, payloadBytes);
+    put<uint32_t>(out, checksum(block + BLOCK_HEADER_BYTES, payloadBytes));
+
+    m_pendingCount = 0;
+    if (!writeRaw(block, BLOCK_HEADER_BYTES + payloadBytes)) {
+        return false;
+    }
+    m_blocks.append(info);
+    return true;
+}
+
+bool BinarySensorLog::writeRaw(const char* data, qint64 size)
+{
+    if (m_file.write(data, size) != size) {
+        m_lastError = m_file.errorString();
+        qWarning() << "Binary sensor log write failed:" << m_file.fileName() << m_lastError;
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+bool BinarySensorLog::readIndex(QFile& file, QVector<BlockInfo>& blocks, bool verifyPayloads)
+{
+    blocks.clear();
+    if (!file.seek(0)) return false;
+
+    char header[FILE_HEADER_BYTES];
+    if (file.read(header, FILE_HEADER_BYTES) != FILE_HEADER_BYTES) return false;
+    const char* in = header;
+    if (get<uint32_t>(in) != FILE_MAGIC) return false;
+    if (get<uint16_t>(in) != FORMAT_VERSION) return false;
+    if (get<uint16_t>(in) != CHANNEL_COUNT) return false;
+
+    // Cleanly closed: the footer points at the index
+    const qint64 fileSize = file.size();
+    if (fileSize >= FILE_HEADER_BYTES + 8 + FOOTER_BYTES && file.seek(fileSize - FOOTER_BYTES)) {
+        char footer[FOOTER_BYTES];
+        if (file.read(footer, FOOTER_BYTES) == FOOTER_BYTES) {
+            in = footer;
+            const uint64_t indexOffset = get<uint64_t>(in);
+            if (get<uint32_t>(in) == FOOTER_MAGIC && indexOffset >= uint64_t(FILE_HEADER_BYTES)
+                && file.seek(static_cast<qint64>(indexOffset))) {
+                const QByteArray index = file.read(fileSize - FOOTER_BYTES - static_cast<qint64>(indexOffset));
+                in = index.constData();
+                if (index.size() >= 8 && get<uint32_t>(in) == INDEX_MAGIC) {
+                    const uint32_t count = get<uint32_t>(in);
+                    if (index.size() == 8 + static_cast<qint64>(count) * INDEX_ENTRY_BYTES) {
+                        blocks.reserve(count);
+                        for (uint32_t i = 0; i < count; ++i) {
+                            BlockInfo block;
+                            block.firstUs = get<int64_t>(in);
+                            block.lastUs = get<int64_t>(in);
+                            block.offset = get<uint64_t>(in);
+                            block.count = get<uint32_t>(in);
+                            get<uint32_t>(in);
+                            blocks.append(block);
+                        }
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Otherwise scan block headers, keeping every block that is complete
+    // and intact
+    qint64 offset = FILE_HEADER_BYTES;
+    QByteArray payload;
+    while (offset + BLOCK_HEADER_BYTES <= fileSize && file.seek(offset)) {
+        char blockHeader[BLOCK_HEADER_BYTES];
+        if (file.read(blockHeader, BLOCK_HEADER_BYTES) != BLOCK_HEADER_BYTES) break;
+
+        BlockInfo block;
+        uint32_t payloadBytes = 0;
+        uint32_t expected = 0;
+        if (!parseBlockHeader(blockHeader, block, payloadBytes, expected)) break;
+        if (offset + BLOCK_HEADER_BYTES + payloadBytes > fileSize) break;
+
+        if (verifyPayloads) {
+            payload = file.read(payloadBytes);
+            if (payload.size() != static_cast<int>(payloadBytes)
+                || checksum(payload.constData(), payloadBytes) != expected) {
+                break;
+            }
+        }
+        block.offset = static_cast<uint64_t>(offset);
+        blocks.append(block);
+        offset += BLOCK_HEADER_BYTES + payloadBytes;
+    }
+    if (offset < fileSize) {
+        qWarning() << "Binary sensor log" << file.fileName() << "recovered" << blocks.size()
+                   << "blocks; ignoring" << (fileSize - offset) << "trailing bytes";
+    }
+    return true;
+}
+
+bool BinarySensorLog::readBlock(QFile& file, const BlockInfo& block, QVector<Sample>& samples)
+{
+    if (!file.seek(static_cast<qint64>(block.offset))) return false;
+
+    char header[BLOCK_HEADER_BYTES];
+    if (file.read(header, BLOCK_HEADER_BYTES) != BLOCK_HEADER_BYTES) return false;
+
+    BlockInfo parsed;
+    uint32_t payloadBytes = 0;
+    uint32_t expected = 0;
+    if (!parseBlockHeader(header, parsed, payloadBytes, expected)) return false;
+
+    const QByteArray payload = file.read(payloadBytes);
+    if (payload.size() != static_cast<int>(payloadBytes)
+        || checksum(payload.constData(), payloadBytes) != expected) {
+        return false;
+    }
+    return decodeBlock(header, payload.constData(), payloadBytes, samples);
+}
+
+bool BinarySensorLog::readAll(const QString& filePath, QVector<Sample>& samples)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QVector<BlockInfo> blocks;
+    if (!readIndex(file, blocks)) return false;
+    for (const BlockInfo& block : blocks) {
+        if (!readBlock(file, block, samples)) return false;
+    }
+    return true;
+}
+
+bool BinarySensorLog::readRange(const QString& filePath, int64_t fromUs, int64_t toUs, QVector<Sample>& samples)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QVector<BlockInfo> blocks;
+    if (!readIndex(file, blocks, false)) return false;
+
+    // Blocks are in time order unless the wall clock stepped back; then
+    // every block's range has to be checked
+    bool ordered = true;
+    for (int i = 1; i < blocks.size() && ordered; ++i) {
+        ordered = blocks[i - 1].firstUs <= blocks[i].firstUs && blocks[i - 1].lastUs <= blocks[i].lastUs;
+    }
+
+    auto first = blocks.constBegin();
+    if (ordered) {
+        first = std::lower_bound(blocks.constBegin(), blocks.constEnd(), fromUs,
+                                 [](const BlockInfo& block, int64_t us) { return block.lastUs < us; });
+    }
+
+    QVector<Sample> blockSamples;
+    for (auto it = first; it != blocks.constEnd(); ++it) {
+        if (it->firstUs > toUs) {
+            if (ordered) break;
+            continue;
+        }
+        if (it->lastUs < fromUs) continue;
+
+        blockSamples.clear();
+        if (!readBlock(file, *it, blockSamples)) {
+            // Unverified scan: the first damaged block ends the readable data
+            qWarning() << "Binary sensor log" << filePath << "unreadable block at offset" << it->offset;
+            break;
+        }
+        for (const Sample& sample : blockSamples) {
+            if (sample.timestampUs >= fromUs && sample.timestampUs <= toUs) {
+                samples.append(sample);
+            }
+        }
+    }
+    return true;
+}
+
+bool BinarySensorLog::parseBlockHeader(const char* header, BlockInfo& block, uint32_t& payloadBytes,
+                                       uint32_t& expectedChecksum)
+{
+    const char* in = header;
+    if (get<uint32_t>(in) != BLOCK_MAGIC) return false;
+    block.count = get<uint32_t>(in);
+    block.firstUs = get<int64_t>(in);
+    block.lastUs = get<int64_t>(in);
+    payloadBytes = get<uint32_t>(in);
+    expectedChecksum = get<uint32_t>(in);
+    return block.count > 0 && block.count <= uint32_t(MAX_BLOCK_RECORDS)
+        && payloadBytes == block.count * uint32_t(RECORD_BYTES);
+}
+
+bool BinarySensorLog::decodeBlock(const char* header, const char* payload, uint32_t payloadBytes,
+                                  QVector<Sample>& samples)
+{
+    BlockInfo block;
+    uint32_t expectedBytes = 0;
+    uint32_t expectedChecksum = 0;
+    if (!parseBlockHeader(header, block, expectedBytes, expectedChecksum) || expectedBytes != payloadBytes) {
+        return false;
+    }
+
+    const int count = static_cast<int>(block.count);
+    const int base = samples.size();
+    samples.resize(base + count);
+    Sample* out = samples.data() + base;
+
+    const char* in = payload;
+    for (int i = 0; i < count; ++i) {
+        out[i].timestampUs = block.firstUs + get<uint32_t>(in);
+    }
+    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+        for (int i = 0; i < count; ++i) {
+            out[i].values[channel] = getFloat(in);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i].flags = get<uint16_t>(in);
+    }
+    return true;
+}
+
+uint32_t BinarySensorLog::checksum(const char* data, uint32_t size)
+{
+    // FNV-1a; catches blocks torn by a crash, not tampering
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int64_t BinarySensorLog::wallClockNowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
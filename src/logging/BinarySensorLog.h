@@ -0,0 +1,136 @@
+#ifndef BINARYSENSORLOG_H
+#define BINARYSENSORLOG_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @brief Fixed-record binary sensor log, written in columnar blocks
+ *
+ * The BINARY_FORMAT backend of DataLogger for high-rate sensor data. A file
+ * holds a header, a sequence of self-describing blocks and, once closed
+ * cleanly, a block index:
+ *
+ *   header   magic "VCSL", version, channel count, block capacity, creation time
+ *   block    header (magic, record count, first/last timestamp, payload size,
+ *            checksum), then the payload as columns: uint32 timestamp delta
+ *            from the block's first sample (us), one float32 column per
+ *            channel, one uint16 flags column
+ *   index    per block: first/last timestamp, file offset, record count
+ *   footer   index offset, magic "VCSE"
+ *
+ * All integers and floats are little-endian. A record costs 26 bytes, and
+ * appending one only copies it into the pending block; encoding and the
+ * file write happen once per block. A file cut short by a crash has no
+ * footer: readers then scan the blocks and stop at the first one that is
+ * truncated or fails its checksum.
+ *
+ * Not thread-safe; DataLogger's writer thread owns the open log.
+ */
+class BinarySensorLog
+{
+public:
+    enum Channel {
+        AVL = 0,            // Outer chamber vacuum (mmHg)
+        TANK,               // Tank vacuum (mmHg)
+        CLITORAL,           // Clitoral cylinder vacuum (mmHg)
+        HEART_RATE,         // bpm
+        FLUID,              // Accumulated fluid (ml)
+        CHANNEL_COUNT
+    };
+
+    enum SampleFlag : uint16_t {
+        AVL_VALID        = 1u << 0,
+        TANK_VALID       = 1u << 1,
+        CLITORAL_VALID   = 1u << 2,
+        HEART_RATE_VALID = 1u << 3,
+        FLUID_VALID      = 1u << 4,
+        PATTERN_RUNNING  = 1u << 8,
+        PUMP_ON          = 1u << 9,
+        EMERGENCY_STOP   = 1u << 10,
+        SIMULATED        = 1u << 15
+    };
+
+    struct Sample {
+        int64_t timestampUs = 0;            // Wall clock, us since epoch
+        float values[CHANNEL_COUNT] = {};
+        uint16_t flags = 0;
+
+        bool has(SampleFlag flag) const { return (flags & flag) != 0; }
+    };
+
+    struct BlockInfo {
+        int64_t firstUs = 0;
+        int64_t lastUs = 0;
+        uint64_t offset = 0;                // Of the block header
+        uint32_t count = 0;
+    };
+
+    BinarySensorLog();
+    ~BinarySensorLog();
+
+    BinarySensorLog(const BinarySensorLog&) = delete;
+    BinarySensorLog& operator=(const BinarySensorLog&) = delete;
+
+    // Create (truncating) filePath and write the header
+    bool open(const QString& filePath, int blockCapacity = DEFAULT_BLOCK_RECORDS);
+    // Write the pending block, the index and the footer
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Buffer one sample; a full block is written out
+    bool append(const Sample& sample);
+    // Write the pending samples as a (short) block
+    bool flush();
+
+    QString filePath() const { return m_file.fileName(); }
+    int handle() const { return m_file.handle(); }
+    qint64 bytesWritten() const { return m_bytesWritten; }
+    int pendingCount() const { return m_pendingCount; }
+    const QVector<BlockInfo>& blocks() const { return m_blocks; }
+    QString lastError() const { return m_lastError; }
+
+    // Reading. The index comes from the footer, or from a block scan when
+    // the file was not closed cleanly; verifyPayloads = false makes that
+    // scan read block headers only (readBlock still checks each payload).
+    static bool readIndex(QFile& file, QVector<BlockInfo>& blocks, bool verifyPayloads = true);
+    static bool readBlock(QFile& file, const BlockInfo& block, QVector<Sample>& samples);
+    static bool readAll(const QString& filePath, QVector<Sample>& samples);
+    // Samples with fromUs <= timestamp <= toUs, reading only the blocks
+    // whose time range overlaps
+    static bool readRange(const QString& filePath, int64_t fromUs, int64_t toUs, QVector<Sample>& samples);
+
+    static int64_t wallClockNowUs();
+
+    static const int DEFAULT_BLOCK_RECORDS = 256;
+    static const int MAX_BLOCK_RECORDS = 65535;
+    static const uint16_t FORMAT_VERSION = 1;
+    static const int FILE_HEADER_BYTES = 32;
+    static const int BLOCK_HEADER_BYTES = 32;
+    static const int INDEX_ENTRY_BYTES = 32;
+    static const int FOOTER_BYTES = 16;
+    static const int RECORD_BYTES = 4 + 4 * CHANNEL_COUNT + 2;
+    static constexpr const char* FILE_SUFFIX = "vcsl";
+
+private:
+    bool writeBlock();
+    bool writeRaw(const char* data, qint64 size);
+    static bool decodeBlock(const char* header, const char* payload, uint32_t payloadBytes,
+                            QVector<Sample>& samples);
+    static bool parseBlockHeader(const char* header, BlockInfo& block, uint32_t& payloadBytes,
+                                 uint32_t& checksum);
+    static uint32_t checksum(const char* data, uint32_t size);
+
+    QFile m_file;
+    QVector<Sample> m_pending;
+    int m_pendingCount;
+    int m_blockCapacity;
+    QByteArray m_blockBuffer;               // Encoded block, sized once at open
+    QVector<BlockInfo> m_blocks;
+    qint64 m_bytesWritten;
+    QString m_lastError;
+};
+
+#endif // BINARYSENSORLOG_H
@@ -1,12 +1,20 @@
 #include "DataLogger.h"
+#include "LogWriterThread.h"
+#include "LogSegmentIndex.h"
+#include "LogCompressor.h"
 #include "../VacuumController.h"
+#include "../hardware/HardwareManager.h"
 #include <QDir>
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QDebug>
 #include <QApplication>
-#include <QProcess>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <algorithm>
+#include <limits>
+#include <zlib.h>
 
 DataLogger::DataLogger(VacuumController* controller, QObject *parent)
     : QObject(parent)
@@ -14,11 +22,13 @@ DataLogger::DataLogger(VacuumController* controller, QObject *parent)
     , m_loggingActive(false)
     , m_loggingPaused(false)
     , m_logFormat(CSV_FORMAT)
+    , m_patternRunning(false)
+    , m_writer(new LogWriterThread(this))
+    , m_compressor(new LogCompressor(this))
     , m_maxFileSizeMB(DEFAULT_MAX_FILE_SIZE_MB)
     , m_maxFiles(DEFAULT_MAX_FILES)
     , m_compressionEnabled(true)
     , m_loggingInterval(DEFAULT_LOGGING_INTERVAL)
-    , m_maxBufferSize(DEFAULT_MAX_BUFFER_SIZE)
     , m_loggingTimer(new QTimer(this))
     , m_rotationCheckTimer(new QTimer(this))
     , m_totalLogEntries(0)
@@ -28,17 +38,13 @@ DataLogger::DataLogger(VacuumController* controller, QObject *parent)
     m_logDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/logs";
     
     // Initialize all log types as enabled by default
-    m_enabledLogTypes[PRESSURE_DATA] = true;
-    m_enabledLogTypes[PATTERN_EXECUTION] = true;
-    m_enabledLogTypes[SAFETY_EVENTS] = true;
-    m_enabledLogTypes[USER_ACTIONS] = true;
-    m_enabledLogTypes[SYSTEM_PERFORMANCE] = true;
-    m_enabledLogTypes[CALIBRATION_DATA] = true;
-    m_enabledLogTypes[ERROR_EVENTS] = true;
+    for (auto& enabled : m_enabledLogTypes) {
+        enabled.store(true, std::memory_order_relaxed);
+    }
     
     // Initialize log counts
-    for (auto type : m_enabledLogTypes.keys()) {
-        m_logCounts[type] = 0;
+    for (auto& count : m_logCounts) {
+        count.store(0, std::memory_order_relaxed);
     }
     
     // Setup timers
@@ -47,6 +53,11 @@ DataLogger::DataLogger(VacuumController* controller, QObject *parent)
     
     connect(m_loggingTimer, &QTimer::timeout, this, &DataLogger::performPeriodicLogging);
     connect(m_rotationCheckTimer, &QTimer::timeout, this, &DataLogger::checkLogRotation);
+    connect(m_writer, &LogWriterThread::writeError, this, &DataLogger::logError);
+    connect(m_writer, &LogWriterThread::fileClosed, this, &DataLogger::onLogFileClosed);
+
+    m_writer->start(QThread::LowPriority);
+    m_compressor->start(QThread::IdlePriority);     // SCHED_IDLE on Linux
     
     initializeLogger();
     connectToController();
@@ -56,22 +67,15 @@ DataLogger::DataLogger(VacuumController* controller, QObject *parent)
 
 DataLogger::~DataLogger()
 {
-    stopLogging();
-    
-    // Close all log files
-    for (auto stream : m_logStreams.values()) {
-        if (stream) {
-            stream->flush();
-            delete stream;
-        }
+    if (m_controller && m_controller->getHardwareManager()) {
+        m_controller->getHardwareManager()->setSensorLogger(nullptr);
     }
+    stopLogging();
     
-    for (auto file : m_logFiles.values()) {
-        if (file) {
-            file->close();
-            delete file;
-        }
-    }
+    // Drains the queues and closes all log files
+    m_writer->stopWriter();
+    // Unfinished segments stay in the manifest for the next start
+    m_compressor->stopCompressor();
 }
 
 void DataLogger::initializeLogger()
@@ -86,6 +90,7 @@ void DataLogger::initializeLogger()
     }
     
     setupLogFiles();
+    compressOldLogs();
     
     qDebug() << "DataLogger initialized successfully";
 }
@@ -93,26 +98,13 @@ void DataLogger::initializeLogger()
 void DataLogger::setupLogFiles()
 {
     // Close existing files
-    for (auto stream : m_logStreams.values()) {
-        if (stream) {
-            stream->flush();
-            delete stream;
-        }
-    }
-    m_logStreams.clear();
-    
-    for (auto file : m_logFiles.values()) {
-        if (file) {
-            file->close();
-            delete file;
-        }
-    }
-    m_logFiles.clear();
+    m_writer->closeAll();
+    m_currentLogFiles.clear();
     
     // Create new log files for each enabled type
-    for (auto it = m_enabledLogTypes.begin(); it != m_enabledLogTypes.end(); ++it) {
-        if (it.value()) {
-            openLogFile(it.key());
+    for (int type = 0; type < LOG_TYPE_COUNT; ++type) {
+        if (m_enabledLogTypes[type].load(std::memory_order_relaxed)) {
+            openLogFile(static_cast<LogType>(type));
         }
     }
 }
@@ -124,6 +116,9 @@ void DataLogger::connectToController()
     // Connect to controller signals for automatic logging
     connect(m_controller, &VacuumController::pressureUpdated,
             this, &DataLogger::onPressureUpdated);
+    if (HardwareManager* hardware = m_controller->getHardwareManager()) {
+        hardware->setSensorLogger(this);
+    }
     connect(m_controller, &VacuumController::patternStarted,
             this, &DataLogger::onPatternStarted);
     connect(m_controller, &VacuumController::patternStopped,
@@ -149,7 +144,7 @@ void DataLogger::startLogging()
         {"event", "logging_started"},
         {"timestamp", m_loggingStartTime},
         {"log_directory", m_logDirectory},
-        {"log_format", static_cast<int>(m_logFormat)}
+        {"log_format", static_cast<int>(m_logFormat.load())}
     });
     
     emit loggingStarted();
@@ -165,23 +160,16 @@ void DataLogger::stopLogging()
     m_loggingTimer->stop();
     m_rotationCheckTimer->stop();
     
-    // Flush all buffers
-    flushBuffers();
-    
     // Log the stop event
     logSystemPerformance(QJsonObject{
         {"event", "logging_stopped"},
         {"timestamp", QDateTime::currentMSecsSinceEpoch()},
-        {"total_entries", static_cast<qint64>(m_totalLogEntries)},
+        {"total_entries", m_totalLogEntries.load(std::memory_order_relaxed)},
         {"duration_ms", QDateTime::currentMSecsSinceEpoch() - m_loggingStartTime}
     });
     
-    // Flush streams
-    for (auto stream : m_logStreams.values()) {
-        if (stream) {
-            stream->flush();
-        }
-    }
+    // Commit everything queued so far
+    flushBuffers();
     
     m_loggingActive = false;
     m_loggingPaused = false;
@@ -223,8 +211,8 @@ void DataLogger::resumeLogging()
 
 void DataLogger::setLogType(LogType type, bool enabled)
 {
-    bool wasEnabled = m_enabledLogTypes.value(type, false);
-    m_enabledLogTypes[type] = enabled;
+    if (type < 0 || type >= LOG_TYPE_COUNT) return;
+    const bool wasEnabled = m_enabledLogTypes[type].exchange(enabled);
 
     if (enabled && !wasEnabled) {
         // Create log file for this type if logging is active
@@ -232,26 +220,14 @@ void DataLogger::setLogType(LogType type, bool enabled)
             openLogFile(type);
         }
     } else if (!enabled && wasEnabled) {
-        // Close log file for this type
-        if (m_logStreams.contains(type)) {
-            m_logStreams[type]->flush();
-            delete m_logStreams[type];
-            m_logStreams.remove(type);
-        }
-
-        if (m_logFiles.contains(type)) {
-            m_logFiles[type]->close();
-            delete m_logFiles[type];
-            m_logFiles.remove(type);
-        }
-
-        m_currentLogFiles.remove(type);
+        closeLogFile(type);
     }
 }
 
 bool DataLogger::isLogTypeEnabled(LogType type) const
 {
-    return m_enabledLogTypes.value(type, false);
+    if (type < 0 || type >= LOG_TYPE_COUNT) return false;
+    return m_enabledLogTypes[type].load(std::memory_order_relaxed);
 }
 
 void DataLogger::setLogFormat(LogFormat format)
@@ -259,10 +235,9 @@ void DataLogger::setLogFormat(LogFormat format)
     if (m_logFormat != format) {
         m_logFormat = format;
         
-        // Recreate log files with new format if logging is active
-        if (m_loggingActive) {
-            setupLogFiles();
-        }
+        // Log files are opened at construction, so recreate them whether or
+        // not logging is active
+        setupLogFiles();
     }
 }
 
@@ -284,6 +259,7 @@ void DataLogger::setLogDirectory(const QString& directory)
         }
         
         setupLogFiles();
+        compressOldLogs();
         
         if (wasLogging) {
             startLogging();
@@ -303,7 +279,11 @@ void DataLogger::setMaxFiles(int maxFiles)
 
 void DataLogger::setCompressionEnabled(bool enabled)
 {
+    const bool wasEnabled = m_compressionEnabled;
     m_compressionEnabled = enabled;
+    if (enabled && !wasEnabled) {
+        compressOldLogs();      // Catch up on segments closed meanwhile
+    }
 }
 
 // Manual logging methods
@@ -311,6 +291,17 @@ void DataLogger::logPressureData(double avlPressure, double tankPressure)
 {
     if (!isLogTypeEnabled(PRESSURE_DATA)) return;
 
+    if (m_logFormat == BINARY_FORMAT) {
+        BinarySensorLog::Sample sample;
+        sample.timestampUs = BinarySensorLog::wallClockNowUs();
+        sample.values[BinarySensorLog::AVL] = static_cast<float>(avlPressure);
+        sample.values[BinarySensorLog::TANK] = static_cast<float>(tankPressure);
+        sample.flags = (avlPressure >= 0.0 ? BinarySensorLog::AVL_VALID : 0)
+                     | (tankPressure >= 0.0 ? BinarySensorLog::TANK_VALID : 0);
+        logSensorSample(sample);
+        return;
+    }
+
     QJsonObject data;
     data["avl_pressure"] = avlPressure;
     data["tank_pressure"] = tankPressure;
@@ -319,6 +310,69 @@ void DataLogger::logPressureData(double avlPressure, double tankPressure)
     writeLogEntry(entry);
 }
 
+void DataLogger::logSensorSample(const BinarySensorLog::Sample& sample)
+{
+    if (!isLogTypeEnabled(PRESSURE_DATA)) return;
+    if (!m_loggingActive || m_loggingPaused) return;
+
+    if (m_logFormat != BINARY_FORMAT) {
+        writeLogEntry(sampleToLogEntry(sample));
+        return;
+    }
+
+    // Hot path: one queue slot, no formatting, no I/O
+    if (!m_writer->submitSample(sample)) return;     // Dropped; counted by the writer
+    m_totalLogEntries.fetch_add(1, std::memory_order_relaxed);
+    m_logCounts[PRESSURE_DATA].fetch_add(1, std::memory_order_relaxed);
+}
+
+void DataLogger::logSensorSnapshot(const SensorSnapshot& snapshot)
+{
+    // Called on the acquisition thread for every sample. Text formats would
+    // format JSON here at the sampling rate; they log from onPressureUpdated.
+    if (m_logFormat != BINARY_FORMAT) return;
+
+    logSensorSample(snapshotToSample(snapshot, m_patternRunning.load(std::memory_order_relaxed)));
+}
+
+BinarySensorLog::Sample DataLogger::snapshotToSample(const SensorSnapshot& snapshot, bool patternRunning)
+{
+    BinarySensorLog::Sample sample;
+    sample.timestampUs = snapshot.timestampMs * 1000;
+    sample.values[BinarySensorLog::AVL] = static_cast<float>(snapshot.avlPressure);
+    sample.values[BinarySensorLog::TANK] = static_cast<float>(snapshot.tankPressure);
+    sample.values[BinarySensorLog::CLITORAL] = static_cast<float>(snapshot.clitoralPressure);
+    sample.values[BinarySensorLog::HEART_RATE] = static_cast<float>(snapshot.heartRateBpm);
+    sample.values[BinarySensorLog::FLUID] = static_cast<float>(snapshot.fluidMl);
+
+    uint16_t flags = 0;
+    if (snapshot.hasAVL()) flags |= BinarySensorLog::AVL_VALID;
+    if (snapshot.hasTank()) flags |= BinarySensorLog::TANK_VALID;
+    if (snapshot.hasClitoral()) flags |= BinarySensorLog::CLITORAL_VALID;
+    if (snapshot.hasHeartRate()) flags |= BinarySensorLog::HEART_RATE_VALID;
+    if (snapshot.hasFluid()) flags |= BinarySensorLog::FLUID_VALID;
+    if (snapshot.flags & SensorSnapshot::PUMP_ON) flags |= BinarySensorLog::PUMP_ON;
+    if (snapshot.flags & SensorSnapshot::EMERGENCY_STOP) flags |= BinarySensorLog::EMERGENCY_STOP;
+    if (snapshot.flags & SensorSnapshot::SIMULATED) flags |= BinarySensorLog::SIMULATED;
+    if (patternRunning) flags |= BinarySensorLog::PATTERN_RUNNING;
+    sample.flags = flags;
+    return sample;
+}
+
+DataLogger::LogEntry DataLogger::sampleToLogEntry(const BinarySensorLog::Sample& sample)
+{
+    QJsonObject data;
+    if (sample.has(BinarySensorLog::AVL_VALID)) data["avl_pressure"] = sample.values[BinarySensorLog::AVL];
+    if (sample.has(BinarySensorLog::TANK_VALID)) data["tank_pressure"] = sample.values[BinarySensorLog::TANK];
+    if (sample.has(BinarySensorLog::CLITORAL_VALID)) data["clitoral_pressure"] = sample.values[BinarySensorLog::CLITORAL];
+    if (sample.has(BinarySensorLog::HEART_RATE_VALID)) data["heart_rate"] = sample.values[BinarySensorLog::HEART_RATE];
+    if (sample.has(BinarySensorLog::FLUID_VALID)) data["fluid_ml"] = sample.values[BinarySensorLog::FLUID];
+
+    LogEntry entry(PRESSURE_DATA, "SensorInterface", "pressure_reading", data);
+    entry.timestamp = sample.timestampUs / 1000;
+    return entry;
+}
+
 void DataLogger::logPatternEvent(const QString& patternName, const QString& event, const QJsonObject& parameters)
 {
     if (!isLogTypeEnabled(PATTERN_EXECUTION)) return;
@@ -387,16 +441,31 @@ void DataLogger::logErrorEvent(const QString& component, const QString& error, c
 // Slot implementations
 void DataLogger::onPressureUpdated(double avlPressure, double tankPressure)
 {
+    // While acquisition publishes snapshots, binary logs already have every
+    // sample from logSensorSnapshot; text logs take the latest snapshot here,
+    // at the GUI update rate, so they still carry every channel
+    HardwareManager* hardware = m_controller ? m_controller->getHardwareManager() : nullptr;
+    if (hardware) {
+        const SensorSnapshot latest = hardware->sensorSnapshotBus().read();
+        if (latest.isPublished() && latest.ageMs() <= hardware->getSnapshotMaxAgeMs()) {
+            if (m_logFormat != BINARY_FORMAT) {
+                logSensorSample(snapshotToSample(latest, m_patternRunning.load(std::memory_order_relaxed)));
+            }
+            return;
+        }
+    }
     logPressureData(avlPressure, tankPressure);
 }
 
 void DataLogger::onPatternStarted(const QString& patternName)
 {
+    m_patternRunning.store(true, std::memory_order_relaxed);
     logPatternEvent(patternName, "pattern_started");
 }
 
 void DataLogger::onPatternStopped()
 {
+    m_patternRunning.store(false, std::memory_order_relaxed);
     logPatternEvent("", "pattern_stopped");
 }
 
@@ -417,8 +486,8 @@ void DataLogger::performPeriodicLogging()
     // Log system performance metrics
     QJsonObject metrics;
     metrics["timestamp"] = QDateTime::currentMSecsSinceEpoch();
-    metrics["total_log_entries"] = static_cast<qint64>(m_totalLogEntries);
-    metrics["buffer_size"] = m_logBuffer.size();
+    metrics["total_log_entries"] = m_totalLogEntries.load(std::memory_order_relaxed);
+    metrics["buffer_size"] = m_writer->queuedCount();
     metrics["memory_usage"] = QApplication::applicationPid(); // Placeholder for actual memory usage
 
     logSystemPerformance(metrics);
@@ -429,10 +498,9 @@ void DataLogger::performPeriodicLogging()
 
 void DataLogger::checkLogRotation()
 {
-    for (auto it = m_logFiles.begin(); it != m_logFiles.end(); ++it) {
-        QFile* file = it.value();
-        if (file && file->size() > m_maxFileSizeMB * 1024 * 1024) {
-            LogType type = it.key();
+    // Sizes as of the writer's last commit
+    for (auto it = m_currentLogFiles.begin(); it != m_currentLogFiles.end(); ++it) {
+        if (m_writer->fileSize(it.key()) > qint64(m_maxFileSizeMB) * 1024 * 1024) {
             rotateLogFile();
             break; // Rotate one file at a time
         }
@@ -443,35 +511,18 @@ void DataLogger::writeLogEntry(const LogEntry& entry)
 {
     if (!m_loggingActive || m_loggingPaused) return;
 
-    // Add to buffer for thread safety
-    QMutexLocker locker(&m_bufferMutex);
-    m_logBuffer.enqueue(entry);
-
-    // Flush buffer if it's getting full
-    if (m_logBuffer.size() >= m_maxBufferSize) {
-        flushBuffers();
-    }
+    // The writer thread formats and writes; a full queue drops the entry
+    LogEntry queued(entry);
+    if (!m_writer->submitEntry(std::move(queued))) return;
 
-    m_totalLogEntries++;
-    m_logCounts[entry.type]++;
+    m_totalLogEntries.fetch_add(1, std::memory_order_relaxed);
+    m_logCounts[entry.type].fetch_add(1, std::memory_order_relaxed);
 }
 
 void DataLogger::flushBuffers()
 {
-    QMutexLocker locker(&m_bufferMutex);
-
-    while (!m_logBuffer.isEmpty()) {
-        LogEntry entry = m_logBuffer.dequeue();
-
-        if (m_logStreams.contains(entry.type)) {
-            QTextStream* stream = m_logStreams[entry.type];
-            if (stream) {
-                QString formattedEntry = formatLogEntry(entry);
-                *stream << formattedEntry << "\n";
-                stream->flush();
-            }
-        }
-    }
+    // Group commit now rather than at the next interval
+    m_writer->requestCommit();
 }
 
 bool DataLogger::openLogFile(LogType type)
@@ -479,36 +530,38 @@ bool DataLogger::openLogFile(LogType type)
     QString fileName = generateLogFileName(type);
     QString filePath = m_logDirectory + "/" + fileName;
 
-    QFile* logFile = new QFile(filePath);
-    if (logFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
-        QTextStream* stream = new QTextStream(logFile);
-        stream->setCodec("UTF-8");
+    m_writer->openFile(type, filePath, m_logFormat);
+    m_currentLogFiles[type] = fileName;
+    if (LogCompressor::isCompressible(fileName)) {
+        m_compressor->trackSegment(filePath);
+    }
+    return true;
+}
 
-        m_logFiles[type] = logFile;
-        m_logStreams[type] = stream;
-        m_currentLogFiles[type] = fileName;
+void DataLogger::closeLogFile(LogType type)
+{
+    m_writer->closeFile(type);
+    m_currentLogFiles.remove(type);
+}
 
-        // Write header for CSV format
-        if (m_logFormat == CSV_FORMAT) {
-            *stream << "Timestamp,Component,Event,Data\n";
-            stream->flush();
-        }
+void DataLogger::onLogFileClosed(const QString& filePath)
+{
+    if (!m_compressionEnabled || !LogCompressor::isCompressible(filePath)) return;
 
-        qDebug() << "Created log file:" << filePath;
-        return true;
-    } else {
-        qCritical() << "Failed to create log file:" << filePath;
-        delete logFile;
-        return false;
+    // Reopened for append (same name within one second): compress it when
+    // it is finally closed
+    for (const QString& fileName : m_currentLogFiles) {
+        if (filePath == m_logDirectory + "/" + fileName) return;
     }
+    m_compressor->enqueue(filePath);
 }
 
-QString DataLogger::formatLogEntry(const LogEntry& entry)
+QString DataLogger::formatLogEntry(const LogEntry& entry, LogFormat format)
 {
     QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(entry.timestamp);
     QString timeStr = timestamp.toString("yyyy-MM-dd hh:mm:ss.zzz");
 
-    if (m_logFormat == CSV_FORMAT) {
+    if (format == CSV_FORMAT) {
         QString dataStr = QJsonDocument(entry.data).toJson(QJsonDocument::Compact);
         dataStr.replace("\"", "\"\""); // Escape quotes for CSV
         return QString("%1,%2,%3,\"%4\"")
@@ -516,7 +569,9 @@ QString DataLogger::formatLogEntry(const LogEntry& entry)
                .arg(entry.component)
                .arg(entry.event)
                .arg(dataStr);
-    } else if (m_logFormat == JSON_FORMAT) {
+    } else {
+        // JSON, and the event types of BINARY_FORMAT (only sensor samples
+        // have a binary record)
         QJsonObject jsonEntry;
         jsonEntry["timestamp"] = timeStr;
         jsonEntry["type"] = logTypeToString(entry.type);
@@ -526,8 +581,6 @@ QString DataLogger::formatLogEntry(const LogEntry& entry)
 
         return QJsonDocument(jsonEntry).toJson(QJsonDocument::Compact);
     }
-
-    return QString(); // Binary format would be handled differently
 }
 
 QString DataLogger::logTypeToString(LogType type)
@@ -548,7 +601,13 @@ QString DataLogger::generateLogFileName(LogType type)
 {
     QString typeStr = logTypeToString(type);
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
-    QString extension = (m_logFormat == JSON_FORMAT) ? "json" : "csv";
+    QString extension = (m_logFormat == CSV_FORMAT) ? "csv" : "json";
+
+    if (type == PRESSURE_DATA && m_logFormat == BINARY_FORMAT) {
+        // Binary files are truncated on open, so never reuse a name
+        timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
+        extension = BinarySensorLog::FILE_SUFFIX;
+    }
 
     return QString("%1_%2.%3").arg(typeStr).arg(timestamp).arg(extension);
 }
@@ -649,31 +708,211 @@ QList<DataLogger::LogEntry> DataLogger::getLogEntries(const QDateTime& startTime
                                                       const QDateTime& endTime, LogType type)
 {
     QList<LogEntry> entries;
+    if (type < 0 || type >= LOG_TYPE_COUNT) return entries;
+
+    // An invalid bound leaves that side of the range open
+    const qint64 fromMs = startTime.isValid() ? startTime.toMSecsSinceEpoch() : 0;
+    const qint64 toMs = endTime.isValid() ? endTime.toMSecsSinceEpoch()
+                                          : std::numeric_limits<qint64>::max() / 1000;
+    if (fromMs > toMs) return entries;
+
+    // Make everything logged so far visible to the reader
+    if (m_loggingActive) {
+        m_writer->waitForCommit();
+    }
+
+    // A segment holds entries from its start time until the next segment
+    // starts; only segments overlapping the range are opened
+    const QStringList segments = segmentFiles(type);
+    for (int i = 0; i < segments.size(); ++i) {
+        const QDateTime segmentStart = segmentStartTime(segments[i]);
+        if (segmentStart.isValid() && segmentStart.toMSecsSinceEpoch() - SEGMENT_SLACK_MS > toMs) break;
+        if (i + 1 < segments.size()) {
+            const QDateTime nextStart = segmentStartTime(segments[i + 1]);
+            if (nextStart.isValid() && nextStart.toMSecsSinceEpoch() + SEGMENT_SLACK_MS < fromMs) continue;
+        }
+        readSegment(m_logDirectory + "/" + segments[i], type, fromMs, toMs, entries);
+    }
 
-    // For now, return empty list - full implementation would read from log files
-    // This would involve parsing existing log files and filtering by time/type
-    qDebug() << "getLogEntries called - full implementation needed";
-
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const LogEntry& a, const LogEntry& b) { return a.timestamp < b.timestamp; });
     return entries;
 }
 
+QStringList DataLogger::segmentFiles(LogType type) const
+{
+    const QString prefix = logTypeToString(type) + "_";
+    QStringList filters;
+    filters << prefix + "*.csv" << prefix + "*.json" << prefix + QString("*.%1").arg(BinarySensorLog::FILE_SUFFIX)
+            << prefix + "*.csv.gz" << prefix + "*.json.gz";
+
+    // File names embed the start time, so name order is time order
+    QStringList segments = QDir(m_logDirectory).entryList(filters, QDir::Files, QDir::Name);
+
+    // While a compressed copy is being finalized both files exist
+    for (int i = segments.size() - 1; i >= 0; --i) {
+        if (segments[i].endsWith(".gz") && segments.contains(segments[i].left(segments[i].size() - 3))) {
+            segments.removeAt(i);
+        }
+    }
+    return segments;
+}
+
+QDateTime DataLogger::segmentStartTime(const QString& fileName)
+{
+    // "<type>_yyyyMMdd_hhmmss[_zzz].<ext>"; the type itself contains '_'
+    const QString stem = fileName.left(fileName.indexOf('.'));
+    QRegularExpressionMatch match = QRegularExpression("(\\d{8}_\\d{6})(_\\d{3})?$").match(stem);
+    if (!match.hasMatch()) return QDateTime();
+
+    QDateTime start = QDateTime::fromString(match.captured(1), "yyyyMMdd_hhmmss");
+    if (start.isValid() && !match.captured(2).isEmpty()) {
+        start = start.addMSecs(match.captured(2).mid(1).toInt());
+    }
+    return start;
+}
+
+void DataLogger::readSegment(const QString& filePath, LogType type, qint64 fromMs, qint64 toMs,
+                             QList<LogEntry>& entries)
+{
+    if (filePath.endsWith(QString(".%1").arg(BinarySensorLog::FILE_SUFFIX))) {
+        QVector<BinarySensorLog::Sample> samples;
+        if (!BinarySensorLog::readRange(filePath, fromMs * 1000, toMs * 1000 + 999, samples)) {
+            qWarning() << "Failed to read binary sensor log:" << filePath;
+            return;
+        }
+        for (const BinarySensorLog::Sample& sample : samples) {
+            entries.append(sampleToLogEntry(sample));
+        }
+        return;
+    }
+
+    LogEntry entry;
+    if (filePath.endsWith(".gz")) {
+        // Compressed segments have no index: inflate and filter every line
+        gzFile compressed = gzopen(QFile::encodeName(filePath).constData(), "rb");
+        if (!compressed) {
+            qWarning() << "Failed to open log file:" << filePath;
+            return;
+        }
+        char buffer[4096];
+        QByteArray line;
+        while (gzgets(compressed, buffer, sizeof(buffer))) {
+            line.append(buffer);
+            if (!line.endsWith('\n') && !gzeof(compressed)) continue;     // Longer than the buffer
+            if (parseLogLine(line, type, entry) && entry.timestamp >= fromMs && entry.timestamp <= toMs) {
+                entries.append(entry);
+            }
+            line.clear();
+        }
+        gzclose(compressed);
+        return;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open log file:" << filePath;
+        return;
+    }
+
+    // Stream only the chunks the sidecar index says may overlap the range
+    const QVector<LogSegmentIndex::Chunk> chunks = LogSegmentIndex::chunksFor(filePath, file.size(), fromMs, toMs);
+    for (const LogSegmentIndex::Chunk& chunk : chunks) {
+        if (!file.seek(chunk.offset)) break;
+        while (file.pos() < chunk.endOffset && !file.atEnd()) {
+            const QByteArray line = file.readLine();
+            if (parseLogLine(line, type, entry) && entry.timestamp >= fromMs && entry.timestamp <= toMs) {
+                entries.append(entry);
+            }
+        }
+    }
+}
+
+bool DataLogger::parseLogLine(const QByteArray& line, LogType type, LogEntry& entry)
+{
+    const QByteArray trimmed = line.trimmed();
+    if (trimmed.isEmpty()) return false;
+
+    QString timeStr;
+    if (trimmed.startsWith('{')) {
+        // JSON line, as written by formatLogEntry
+        const QJsonObject object = QJsonDocument::fromJson(trimmed).object();
+        if (object.isEmpty()) return false;
+        timeStr = object.value("timestamp").toString();
+        entry.component = object.value("component").toString();
+        entry.event = object.value("event").toString();
+        entry.data = object.value("data").toObject();
+    } else {
+        // CSV: timestamp,component,event,"data with "" escapes"
+        const int first = trimmed.indexOf(',');
+        const int second = trimmed.indexOf(',', first + 1);
+        const int third = trimmed.indexOf(',', second + 1);
+        if (first < 0 || second < 0 || third < 0) return false;
+
+        timeStr = QString::fromUtf8(trimmed.left(first));
+        entry.component = QString::fromUtf8(trimmed.mid(first + 1, second - first - 1));
+        entry.event = QString::fromUtf8(trimmed.mid(second + 1, third - second - 1));
+        QByteArray dataStr = trimmed.mid(third + 1);
+        if (dataStr.size() >= 2 && dataStr.startsWith('"') && dataStr.endsWith('"')) {
+            dataStr = dataStr.mid(1, dataStr.size() - 2);
+        }
+        dataStr.replace("\"\"", "\"");
+        entry.data = QJsonDocument::fromJson(dataStr).object();
+    }
+
+    // Also rejects the CSV header line
+    const QDateTime timestamp = QDateTime::fromString(timeStr, "yyyy-MM-dd hh:mm:ss.zzz");
+    if (!timestamp.isValid()) return false;
+
+    entry.timestamp = timestamp.toMSecsSinceEpoch();
+    entry.type = type;
+    return true;
+}
+
 QJsonObject DataLogger::getLogStatistics()
 {
     QJsonObject stats;
 
-    stats["total_entries"] = static_cast<qint64>(m_totalLogEntries);
-    stats["logging_active"] = m_loggingActive;
-    stats["logging_paused"] = m_loggingPaused;
+    stats["total_entries"] = m_totalLogEntries.load(std::memory_order_relaxed);
+    stats["logging_active"] = m_loggingActive.load();
+    stats["logging_paused"] = m_loggingPaused.load();
     stats["log_directory"] = m_logDirectory;
-    stats["log_format"] = static_cast<int>(m_logFormat);
+    stats["log_format"] = static_cast<int>(m_logFormat.load());
 
     // Add counts for each log type
     QJsonObject typeCounts;
-    for (auto it = m_logCounts.begin(); it != m_logCounts.end(); ++it) {
-        typeCounts[logTypeToString(it.key())] = it.value();
+    for (int type = 0; type < LOG_TYPE_COUNT; ++type) {
+        typeCounts[logTypeToString(static_cast<LogType>(type))] = m_logCounts[type].load(std::memory_order_relaxed);
     }
     stats["type_counts"] = typeCounts;
 
+    // Writer thread: group commits and backpressure
+    const LogWriterThread::Statistics writerStats = m_writer->statistics();
+    QJsonObject writer;
+    writer["queued"] = m_writer->queuedCount();
+    writer["entries_written"] = static_cast<qint64>(writerStats.entriesWritten);
+    writer["samples_written"] = static_cast<qint64>(writerStats.samplesWritten);
+    writer["entries_dropped"] = static_cast<qint64>(writerStats.entriesDropped);
+    writer["samples_dropped"] = static_cast<qint64>(writerStats.samplesDropped);
+    writer["unrouted"] = static_cast<qint64>(writerStats.unrouted);
+    writer["commits"] = static_cast<qint64>(writerStats.commits);
+    writer["bytes_written"] = static_cast<qint64>(writerStats.bytesWritten);
+    writer["write_errors"] = static_cast<qint64>(writerStats.writeErrors);
+    writer["last_commit_ms"] = writerStats.lastCommitMs;
+    writer["max_commit_ms"] = writerStats.maxCommitMs;
+    stats["writer"] = writer;
+
+    const LogCompressor::Statistics compressorStats = m_compressor->statistics();
+    QJsonObject compression;
+    compression["enabled"] = m_compressionEnabled;
+    compression["pending"] = m_compressor->pendingCount();
+    compression["files_compressed"] = static_cast<qint64>(compressorStats.filesCompressed);
+    compression["failures"] = static_cast<qint64>(compressorStats.failures);
+    compression["bytes_in"] = static_cast<qint64>(compressorStats.bytesIn);
+    compression["bytes_out"] = static_cast<qint64>(compressorStats.bytesOut);
+    compression["last_file_ms"] = compressorStats.lastFileMs;
+    stats["compression"] = compression;
+
     // Add file information
     QJsonObject fileInfo;
     for (auto it = m_currentLogFiles.begin(); it != m_currentLogFiles.end(); ++it) {
@@ -703,7 +942,7 @@ QStringList DataLogger::getAvailableLogFiles()
     QDir logDir(m_logDirectory);
     if (logDir.exists()) {
         QStringList filters;
-        filters << "*.csv" << "*.json" << "*.log";
+        filters << "*.csv" << "*.json" << "*.log" << QString("*.%1").arg(BinarySensorLog::FILE_SUFFIX);
 
         QFileInfoList fileList = logDir.entryInfoList(filters, QDir::Files, QDir::Time);
         for (const QFileInfo& fileInfo : fileList) {
@@ -745,31 +984,21 @@ void DataLogger::compressOldLogs()
 {
     if (!m_compressionEnabled) return;
 
-    QDir logDir(m_logDirectory);
-    QStringList filters;
-    filters << "*.csv" << "*.json";
-
-    QFileInfoList fileList = logDir.entryInfoList(filters, QDir::Files);
-    for (const QFileInfo& fileInfo : fileList) {
-        QString filePath = fileInfo.absoluteFilePath();
-        QString compressedPath = filePath + ".gz";
-
-        // Use gzip to compress the file
-        QProcess gzip;
-        gzip.start("gzip", QStringList() << filePath);
-        if (gzip.waitForFinished(30000)) { // 30 second timeout
-            qDebug() << "Compressed log file:" << compressedPath;
-        } else {
-            qWarning() << "Failed to compress log file:" << filePath;
-        }
+    // Only queues the request: the compressor resumes the segments its
+    // manifest lists as not yet compressed. Files still being written are
+    // compressed when the writer closes them.
+    QStringList openFiles;
+    for (const QString& fileName : m_currentLogFiles) {
+        openFiles.append(m_logDirectory + "/" + fileName);
     }
+    m_compressor->resume(m_logDirectory, openFiles);
 }
 
 void DataLogger::cleanupOldLogs(int daysToKeep)
 {
     QDir logDir(m_logDirectory);
     QStringList filters;
-    filters << "*.csv" << "*.json" << "*.gz" << "*.log";
+    filters << "*.csv" << "*.json" << "*.gz" << "*.log" << "*.idx" << QString("*.%1").arg(BinarySensorLog::FILE_SUFFIX);
 
     QDateTime cutoffTime = QDateTime::currentDateTime().addDays(-daysToKeep);
 
@@ -3,15 +3,17 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QMutex>
-#include <QQueue>
-#include <QFile>
-#include <QTextStream>
 #include <QJsonObject>
 #include <QDateTime>
+#include <atomic>
+
+#include "BinarySensorLog.h"
+#include "../hardware/SensorSnapshotBus.h"
 
 // Forward declarations
 class VacuumController;
+class LogWriterThread;
+class LogCompressor;
 
 /**
  * @brief Comprehensive data logging system
@@ -22,13 +24,32 @@ class VacuumController;
  * - Safety event logging
  * - System performance logging
  * - User action logging
- * - Configurable log formats (CSV, JSON)
+ * - Configurable log formats (CSV, JSON, binary)
  * - Automatic log rotation
  * - Data export capabilities
+ *
+ * In BINARY_FORMAT, pressure/sensor samples go to a BinarySensorLog
+ * (fixed-size records, no JSON or QString per sample); the low-rate event
+ * types are still written as JSON lines.
+ *
+ * Sensor samples come from the controller's HardwareManager snapshots (all
+ * pressure channels, heart rate, fluid, pump/pattern/emergency stop state).
+ * In BINARY_FORMAT every published acquisition snapshot is logged from the
+ * acquisition thread. CSV/JSON log the latest snapshot on each
+ * pressureUpdated signal instead, so no text is formatted on the
+ * acquisition thread and the text volume stays at the GUI update rate. The
+ * AVL/tank-only pressureUpdated readings are logged only while no
+ * acquisition thread is publishing.
+ *
+ * All file I/O happens on a LogWriterThread. The log* methods may be called
+ * from any thread: they only push onto a lock-free queue. Closed CSV/JSON
+ * segments are gzip-compressed in-process by a LogCompressor running at idle
+ * priority.
  */
 class DataLogger : public QObject
 {
     Q_OBJECT
+    friend class LogWriterThread;
 
 public:
     enum LogType {
@@ -41,6 +62,7 @@ public:
         ERROR_EVENTS        // Error and warning events
     };
     Q_ENUM(LogType)
+    static const int LOG_TYPE_COUNT = ERROR_EVENTS + 1;
 
     enum LogFormat {
         CSV_FORMAT,         // Comma-separated values
@@ -83,9 +105,15 @@ public:
     void setMaxFileSize(int sizeMB);
     void setMaxFiles(int maxFiles);
     void setCompressionEnabled(bool enabled);
+
+    // Group commit, sync policy and queue statistics
+    LogWriterThread* writer() const { return m_writer; }
+    LogCompressor* compressor() const { return m_compressor; }
     
     // Manual logging
     void logPressureData(double avlPressure, double tankPressure);
+    void logSensorSample(const BinarySensorLog::Sample& sample);
+    void logSensorSnapshot(const SensorSnapshot& snapshot);
     void logPatternEvent(const QString& patternName, const QString& event, const QJsonObject& parameters = QJsonObject());
     void logSafetyEvent(const QString& event, const QString& details, const QJsonObject& context = QJsonObject());
     void logUserAction(const QString& action, const QString& details, const QJsonObject& context = QJsonObject());
@@ -125,6 +153,7 @@ Q_SIGNALS:
 private Q_SLOTS:
     void performPeriodicLogging();
     void checkLogRotation();
+    void onLogFileClosed(const QString& filePath);
 
 private:
     void initializeLogger();
@@ -132,36 +161,48 @@ private:
     void writeLogEntry(const LogEntry& entry);
     void rotateLogFile();
     QString generateLogFileName(LogType type);
-    QString formatLogEntry(const LogEntry& entry);
-    QString logTypeToString(LogType type);
+    static QString formatLogEntry(const LogEntry& entry, LogFormat format);
+    static QString logTypeToString(LogType type);
+    static LogEntry sampleToLogEntry(const BinarySensorLog::Sample& sample);
+    static BinarySensorLog::Sample snapshotToSample(const SensorSnapshot& snapshot, bool patternRunning);
     void connectToController();
     void flushBuffers();
 
     /**
-     * @brief Open a log file for a specific log type and write header
+     * @brief Open a log file for a specific log type
      *
-     * Consolidates file opening and header writing logic used by
-     * setupLogFiles and setLogType.
+     * Used by setupLogFiles and setLogType. The writer thread opens the file
+     * and writes the CSV header; failures are reported through logError.
      *
      * @param type The log type to create a file for
-     * @return true if file was opened successfully, false otherwise
+     * @return true if the open was queued
      */
     bool openLogFile(LogType type);
+    void closeLogFile(LogType type);
+
+    // History queries: segments of one type are "<type>_<start time>.<ext>"
+    QStringList segmentFiles(LogType type) const;
+    static QDateTime segmentStartTime(const QString& fileName);
+    static void readSegment(const QString& filePath, LogType type, qint64 fromMs, qint64 toMs,
+                            QList<LogEntry>& entries);
+    static bool parseLogLine(const QByteArray& line, LogType type, LogEntry& entry);
     
     // Controller interface
     VacuumController* m_controller;
     
     // Logging state
-    bool m_loggingActive;
-    bool m_loggingPaused;
-    QMap<LogType, bool> m_enabledLogTypes;
-    LogFormat m_logFormat;
+    // Read by the acquisition thread through logSensorSnapshot
+    std::atomic<bool> m_loggingActive;
+    std::atomic<bool> m_loggingPaused;
+    std::atomic<bool> m_enabledLogTypes[LOG_TYPE_COUNT];
+    std::atomic<LogFormat> m_logFormat;
+    std::atomic<bool> m_patternRunning;
     
     // File management
     QString m_logDirectory;
-    QMap<LogType, QFile*> m_logFiles;
-    QMap<LogType, QTextStream*> m_logStreams;
     QMap<LogType, QString> m_currentLogFiles;
+    LogWriterThread* m_writer;          // Owns every open log file
+    LogCompressor* m_compressor;        // Compresses closed segments
     
     // Configuration
     int m_maxFileSizeMB;
@@ -169,26 +210,21 @@ private:
     bool m_compressionEnabled;
     int m_loggingInterval;
     
-    // Buffering
-    QQueue<LogEntry> m_logBuffer;
-    QMutex m_bufferMutex;
-    int m_maxBufferSize;
-    
     // Timers
     QTimer* m_loggingTimer;
     QTimer* m_rotationCheckTimer;
     
     // Statistics
-    QMap<LogType, int> m_logCounts;
-    qint64 m_totalLogEntries;
+    std::atomic<qint64> m_logCounts[LOG_TYPE_COUNT];
+    std::atomic<qint64> m_totalLogEntries;
     qint64 m_loggingStartTime;
     
     // Constants
     static const int DEFAULT_MAX_FILE_SIZE_MB = 100;
     static const int DEFAULT_MAX_FILES = 10;
     static const int DEFAULT_LOGGING_INTERVAL = 1000;  // 1 second
-    static const int DEFAULT_MAX_BUFFER_SIZE = 1000;
     static const int ROTATION_CHECK_INTERVAL = 60000;  // 1 minute
+    static const int SEGMENT_SLACK_MS = 60000;         // Entries queued across a rotation
 };
 
 #endif // DATALOGGER_H
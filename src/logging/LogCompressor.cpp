@@ -0,0 +1,358 @@
+#include "LogCompressor.h"
+#include "LogSegmentIndex.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTextStream>
+#include <unistd.h>
+#include <zlib.h>
+
+LogCompressor::LogCompressor(QObject *parent)
+    : QThread(parent)
+    , m_level(DEFAULT_LEVEL)
+    , m_pendingCount(0)
+    , m_stopRequested(false)
+{
+}
+
+LogCompressor::~LogCompressor()
+{
+    stopCompressor();
+}
+
+void LogCompressor::setLevel(int level)
+{
+    QMutexLocker locker(&m_mutex);
+    m_level = qBound(1, level, 9);
+}
+
+void LogCompressor::trackSegment(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requests.enqueue(Request{Request::TRACK, filePath, QStringList()});
+    m_wake.wakeOne();
+}
+
+void LogCompressor::enqueue(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requests.enqueue(Request{Request::COMPRESS, filePath, QStringList()});
+    m_wake.wakeOne();
+}
+
+void LogCompressor::resume(const QString& directory, const QStringList& openFiles)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requests.enqueue(Request{Request::RESUME, directory, openFiles});
+    m_wake.wakeOne();
+}
+
+void LogCompressor::stopCompressor()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!isRunning()) return;
+        m_stopRequested.store(true, std::memory_order_relaxed);
+        m_wake.wakeOne();
+    }
+    wait();
+    m_stopRequested.store(false, std::memory_order_relaxed);
+}
+
+int LogCompressor::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pendingCount + m_requests.size();
+}
+
+LogCompressor::Statistics LogCompressor::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+bool LogCompressor::isCompressible(const QString& fileName)
+{
+    return fileName.endsWith(".csv") || fileName.endsWith(".json");
+}
+
+void LogCompressor::run()
+{
+    for (;;) {
+        QQueue<Request> requests;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_requests.isEmpty() && m_pending.isEmpty() && !m_stopRequested.load(std::memory_order_relaxed)) {
+                m_wake.wait(&m_mutex);
+            }
+            requests.swap(m_requests);
+        }
+
+        // Record every request in its manifest before compressing anything,
+        // so even requests made while stopping are resumed on restart
+        for (const Request& request : requests) {
+            const QString path = QFileInfo(request.path).absoluteFilePath();
+            switch (request.kind) {
+            case Request::TRACK:
+                appendManifest(path, "open");
+                break;
+            case Request::COMPRESS:
+                if (!m_pending.contains(path) && QFile::exists(path)) {
+                    appendManifest(path, "pending");
+                    m_pending.append(path);
+                }
+                break;
+            case Request::RESUME:
+                loadManifest(path, request.openFiles);
+                break;
+            }
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pendingCount = m_pending.size();
+        }
+        if (m_stopRequested.load(std::memory_order_relaxed)) break;
+
+        // One file per pass, so new requests are recorded promptly
+        if (!m_pending.isEmpty()) {
+            compressNext();
+        }
+    }
+}
+
+void LogCompressor::loadManifest(const QString& directory, const QStringList& openFiles)
+{
+    QDir dir(directory);
+    QFile manifest(dir.filePath(MANIFEST_NAME));
+    QStringList names;
+    bool scanned = false;
+
+    if (manifest.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream stream(&manifest);
+        while (!stream.atEnd()) {
+            const QStringList fields = stream.readLine().split('\t');
+            if (fields[0] == MANIFEST_SCANNED) {
+                scanned = true;
+                continue;
+            }
+            if (fields.size() < 2) continue;
+            if (fields[0] == "done") {
+                names.removeAll(fields[1]);
+            } else if (!names.contains(fields[1])) {
+                names.append(fields[1]);
+            }
+        }
+        manifest.close();
+    }
+    if (!scanned) {
+        // First resume in this directory: one scan for segments left
+        // uncompressed, including those older than the manifest
+        const QStringList found = dir.entryList(QStringList() << "*.csv" << "*.json", QDir::Files, QDir::Name);
+        for (const QString& name : found) {
+            if (!names.contains(name)) {
+                names.append(name);
+            }
+        }
+    }
+
+    QStringList openPaths;
+    for (const QString& openFile : openFiles) {
+        openPaths.append(QFileInfo(openFile).absoluteFilePath());
+    }
+
+    // Compact to the segments that still exist and are not done
+    QSaveFile compacted(dir.filePath(MANIFEST_NAME));
+    if (compacted.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream stream(&compacted);
+        stream << MANIFEST_SCANNED << '\n';
+        for (const QString& name : names) {
+            const QString path = dir.absoluteFilePath(name);
+            if (!QFile::exists(path)) continue;
+            const bool isOpen = openPaths.contains(path);
+            stream << (isOpen ? "open" : "pending") << '\t' << name << '\n';
+            if (!isOpen && !m_pending.contains(path)) {
+                m_pending.append(path);
+            }
+        }
+        stream.flush();
+        if (!compacted.commit()) {
+            qWarning() << "Failed to write compression manifest:" << compacted.fileName();
+        }
+    } else {
+        qWarning() << "Failed to open compression manifest:" << compacted.fileName() << compacted.errorString();
+    }
+}
+
+void LogCompressor::appendManifest(const QString& filePath, const QString& state, const QString& detail)
+{
+    const QFileInfo info(filePath);
+    QFile manifest(info.dir().filePath(MANIFEST_NAME));
+    if (!manifest.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Failed to open compression manifest:" << manifest.fileName() << manifest.errorString();
+        return;
+    }
+
+    QString line = state + '\t' + info.fileName();
+    if (!detail.isEmpty()) {
+        line += '\t' + detail;
+    }
+    manifest.write(line.toUtf8() + '\n');
+}
+
+void LogCompressor::compressNext()
+{
+    const QString path = m_pending.takeFirst();
+    const QString compressedPath = path + ".gz";
+    const QString partPath = compressedPath + ".part";
+
+    if (!QFile::exists(path)) {
+        appendManifest(path, "done", "0\t0");       // Deleted meanwhile
+        return;
+    }
+
+    int level;
+    {
+        QMutexLocker locker(&m_mutex);
+        level = m_level;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytesIn = 0;
+    qint64 bytesOut = 0;
+    QString error;
+    bool ok = compressFile(path, partPath, level, bytesIn, bytesOut, error, &m_stopRequested);
+
+    if (ok) {
+        ok = QFile::exists(compressedPath) ? appendMember(partPath, compressedPath, error)
+                                           : QFile::rename(partPath, compressedPath);
+        if (!ok && error.isEmpty()) {
+            error = QString("cannot rename %1").arg(partPath);
+        }
+    }
+    if (!ok) {
+        QFile::remove(partPath);
+        if (m_stopRequested.load(std::memory_order_relaxed)) {
+            m_pending.prepend(path);        // Still pending in the manifest
+            return;
+        }
+        {
+            QMutexLocker locker(&m_mutex);
+            m_statistics.failures++;
+        }
+        qWarning() << "Failed to compress log file:" << path << error;
+        emit compressionFailed(path, error);
+        return;
+    }
+
+    // The time index addresses the uncompressed segment
+    QFile::remove(path);
+    QFile::remove(LogSegmentIndex::indexPathFor(path));
+    appendManifest(path, "done", QString("%1\t%2").arg(bytesIn).arg(bytesOut));
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_statistics.filesCompressed++;
+        m_statistics.bytesIn += static_cast<quint64>(bytesIn);
+        m_statistics.bytesOut += static_cast<quint64>(bytesOut);
+        m_statistics.lastFileMs = timer.nsecsElapsed() / 1.0e6;
+    }
+    qDebug() << "Compressed log file:" << compressedPath << bytesIn << "->" << bytesOut << "bytes";
+    emit fileCompressed(path, compressedPath);
+}
+
+bool LogCompressor::appendMember(const QString& partPath, const QString& compressedPath, QString& error)
+{
+    // A segment name reused after its first part was compressed: gzip
+    // readers treat concatenated members as one stream
+    QFile part(partPath);
+    QFile out(compressedPath);
+    if (!part.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        error = QString("cannot append to %1").arg(compressedPath);
+        return false;
+    }
+    const QByteArray member = part.readAll();
+    if (out.write(member) != member.size() || !out.flush() || ::fdatasync(out.handle()) != 0) {
+        error = out.errorString();
+        return false;
+    }
+    part.close();
+    QFile::remove(partPath);
+    return true;
+}
+
+bool LogCompressor::compressFile(const QString& filePath, const QString& compressedPath, int level,
+                                 qint64& bytesIn, qint64& bytesOut, QString& error,
+                                 const std::atomic<bool>* cancel)
+{
+    bytesIn = 0;
+    bytesOut = 0;
+
+    QFile in(filePath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        error = in.errorString();
+        return false;
+    }
+    QFile out(compressedPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = out.errorString();
+        return false;
+    }
+
+    // windowBits 15 + 16: gzip wrapper, readable by gzip/zcat
+    z_stream stream = {};
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        error = "deflateInit2 failed";
+        return false;
+    }
+
+    QByteArray input(CHUNK_BYTES, Qt::Uninitialized);
+    QByteArray output(CHUNK_BYTES, Qt::Uninitialized);
+    bool ok = true;
+    int flush = Z_NO_FLUSH;
+    do {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            error = "cancelled";
+            ok = false;
+            break;
+        }
+
+        const qint64 read = in.read(input.data(), CHUNK_BYTES);
+        if (read < 0) {
+            error = in.errorString();
+            ok = false;
+            break;
+        }
+        bytesIn += read;
+        flush = (read < CHUNK_BYTES || in.atEnd()) ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef*>(input.data());
+        stream.avail_in = static_cast<uInt>(read);
+
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = CHUNK_BYTES;
+            deflate(&stream, flush);
+            const qint64 produced = CHUNK_BYTES - stream.avail_out;
+            if (out.write(output.constData(), produced) != produced) {
+                error = out.errorString();
+                ok = false;
+                break;
+            }
+            bytesOut += produced;
+        } while (stream.avail_out == 0);
+    } while (ok && flush != Z_FINISH);
+    deflateEnd(&stream);
+
+    // Durable before the caller deletes the original
+    if (ok && (!out.flush() || ::fdatasync(out.handle()) != 0)) {
+        error = out.errorString();
+        ok = false;
+    }
+    out.close();
+    return ok;
+}
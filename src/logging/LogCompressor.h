@@ -0,0 +1,109 @@
+#ifndef LOGCOMPRESSOR_H
+#define LOGCOMPRESSOR_H
+
+#include <QThread>
+#include <QMutex>
+#include <QQueue>
+#include <QStringList>
+#include <QWaitCondition>
+#include <atomic>
+
+/**
+ * @brief Background gzip compression of closed log segments
+ *
+ * Replaces spawning an external gzip per file. Segments are compressed
+ * in-process with zlib, streamed in CHUNK_BYTES pieces, on a thread
+ * started at QThread::IdlePriority (SCHED_IDLE on Linux), so it only uses
+ * CPU the logger and control threads leave over. A segment is written to
+ * "<segment>.gz.part", synced and renamed; the original and its time index
+ * are deleted only after the rename.
+ *
+ * Each log directory keeps a manifest ("compression.manifest") of its
+ * segments not yet compressed. Segments are recorded there when opened and
+ * again when queued, so a restart resumes them without rescanning the
+ * directory; the directory is scanned once, on the first resume() of a
+ * manifest without the "scanned" marker (segments may already have been
+ * tracked into a new manifest by then).
+ *
+ * Manifest lines: "scanned" (directory scan done), "open\t<file name>"
+ * (segment created), "pending\t<file name>" (closed, queued) and
+ * "done\t<file name>\t<bytes in>\t<bytes out>". Loading compacts it to
+ * the marker and the entries not yet done.
+ */
+class LogCompressor : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Statistics {
+        quint64 filesCompressed = 0;
+        quint64 failures = 0;
+        quint64 bytesIn = 0;
+        quint64 bytesOut = 0;
+        double lastFileMs = 0.0;
+    };
+
+    explicit LogCompressor(QObject *parent = nullptr);
+    ~LogCompressor();
+
+    // zlib level, 1 (fastest) to 9 (smallest)
+    void setLevel(int level);
+
+    // Any thread; these only queue a request, never touch a file.
+    // trackSegment records a segment the writer has just opened, so it is
+    // found again after a crash or shutdown; enqueue queues a closed one.
+    void trackSegment(const QString& filePath);
+    void enqueue(const QString& filePath);
+    // Load the directory's manifest (scanning it once if there is none) and
+    // queue its segments not yet compressed, except the ones still open
+    void resume(const QString& directory, const QStringList& openFiles = QStringList());
+
+    // Abandon the file in progress (it stays pending) and join the thread
+    void stopCompressor();
+
+    int pendingCount() const;
+    Statistics statistics() const;
+
+    static bool isCompressible(const QString& fileName);
+    static bool compressFile(const QString& filePath, const QString& compressedPath, int level,
+                             qint64& bytesIn, qint64& bytesOut, QString& error,
+                             const std::atomic<bool>* cancel = nullptr);
+
+    static constexpr const char* MANIFEST_NAME = "compression.manifest";
+    static constexpr const char* MANIFEST_SCANNED = "scanned";
+    static const int CHUNK_BYTES = 64 * 1024;
+    static const int DEFAULT_LEVEL = 6;
+
+Q_SIGNALS:
+    void fileCompressed(const QString& filePath, const QString& compressedPath);
+    void compressionFailed(const QString& filePath, const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    struct Request {
+        enum Kind { TRACK, COMPRESS, RESUME } kind;
+        QString path;
+        QStringList openFiles;
+    };
+
+    void loadManifest(const QString& directory, const QStringList& openFiles);
+    void appendManifest(const QString& filePath, const QString& state, const QString& detail = QString());
+    void compressNext();
+    static bool appendMember(const QString& partPath, const QString& compressedPath, QString& error);
+
+    // Requests, guarded by m_mutex
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QQueue<Request> m_requests;
+    int m_level;
+    Statistics m_statistics;
+    int m_pendingCount;
+    std::atomic<bool> m_stopRequested;
+
+    // Compressor thread only
+    QStringList m_pending;          // Absolute paths, recorded in their manifest
+};
+
+#endif // LOGCOMPRESSOR_H
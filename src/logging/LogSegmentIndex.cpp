@@ -0,0 +1,217 @@
+#include "LogSegmentIndex.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const uint32_t INDEX_MAGIC = 0x494C4356;    // "VCLI"
+const int64_t UNKNOWN_MIN_MS = std::numeric_limits<int64_t>::min();
+const int64_t UNKNOWN_MAX_MS = std::numeric_limits<int64_t>::max();
+
+void encodeChunk(const LogSegmentIndex::Chunk& chunk, char* out)
+{
+    qToLittleEndian<qint64>(chunk.minMs, out);
+    qToLittleEndian<qint64>(chunk.maxMs, out + 8);
+    qToLittleEndian<qint64>(chunk.offset, out + 16);
+    qToLittleEndian<qint64>(chunk.endOffset, out + 24);
+}
+}
+
+LogSegmentIndex::LogSegmentIndex()
+    : m_chunkOffset(0)
+    , m_chunkMinMs(0)
+    , m_chunkMaxMs(0)
+    , m_chunkHasEntries(false)
+{
+}
+
+LogSegmentIndex::~LogSegmentIndex()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+QString LogSegmentIndex::indexPathFor(const QString& segmentPath)
+{
+    return segmentPath + ".idx";
+}
+
+bool LogSegmentIndex::open(const QString& segmentPath, qint64 segmentSize)
+{
+    QVector<Chunk> existing;
+    load(segmentPath, existing);
+
+    m_file.setFileName(indexPathFor(segmentPath));
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open log index:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    // Start over if the sidecar is missing, foreign or damaged
+    const qint64 validBytes = HEADER_BYTES + qint64(existing.size()) * ENTRY_BYTES;
+    if (existing.isEmpty() || m_file.size() < validBytes) {
+        char header[HEADER_BYTES];
+        qToLittleEndian<quint32>(INDEX_MAGIC, header);
+        qToLittleEndian<quint32>(FORMAT_VERSION, header + 4);
+        m_file.resize(0);
+        m_file.write(header, HEADER_BYTES);
+        existing.clear();
+    } else {
+        m_file.resize(validBytes);
+    }
+    m_file.seek(m_file.size());
+
+    // Bytes written since the last indexed chunk (a crash, or a segment
+    // from before indexing) become one chunk of unknown range
+    const int64_t indexedEnd = existing.isEmpty() ? 0 : existing.last().endOffset;
+    if (segmentSize > indexedEnd) {
+        Chunk gap;
+        gap.minMs = UNKNOWN_MIN_MS;
+        gap.maxMs = UNKNOWN_MAX_MS;
+        gap.offset = indexedEnd;
+        gap.endOffset = segmentSize;
+        char entry[ENTRY_BYTES];
+        encodeChunk(gap, entry);
+        m_file.write(entry, ENTRY_BYTES);
+    }
+
+    m_chunkOffset = segmentSize;
+    m_chunkHasEntries = false;
+    return true;
+}
+
+void LogSegmentIndex::noteEntry(int64_t timestampMs)
+{
+    if (!m_chunkHasEntries) {
+        m_chunkMinMs = timestampMs;
+        m_chunkMaxMs = timestampMs;
+        m_chunkHasEntries = true;
+        return;
+    }
+    m_chunkMinMs = std::min(m_chunkMinMs, timestampMs);
+    m_chunkMaxMs = std::max(m_chunkMaxMs, timestampMs);
+}
+
+void LogSegmentIndex::noteCommitted(qint64 segmentSize)
+{
+    if (m_file.isOpen() && segmentSize - m_chunkOffset >= CHUNK_BYTES) {
+        finishChunk(segmentSize);
+    }
+}
+
+void LogSegmentIndex::close(qint64 segmentSize)
+{
+    if (!m_file.isOpen()) return;
+    if (segmentSize > m_chunkOffset) {
+        finishChunk(segmentSize);
+    }
+    m_file.close();
+}
+
+void LogSegmentIndex::finishChunk(qint64 endOffset)
+{
+    Chunk chunk;
+    chunk.offset = m_chunkOffset;
+    chunk.endOffset = endOffset;
+    // A chunk holding only a header line matches no time range
+    chunk.minMs = m_chunkHasEntries ? m_chunkMinMs : UNKNOWN_MAX_MS;
+    chunk.maxMs = m_chunkHasEntries ? m_chunkMaxMs : UNKNOWN_MIN_MS;
+
+    char entry[ENTRY_BYTES];
+    encodeChunk(chunk, entry);
+    if (m_file.write(entry, ENTRY_BYTES) != ENTRY_BYTES || !m_file.flush()) {
+        qWarning() << "Failed to write log index:" << m_file.fileName();
+    }
+
+    m_chunkOffset = endOffset;
+    m_chunkHasEntries = false;
+}
+
+bool LogSegmentIndex::load(const QString& segmentPath, QVector<Chunk>& chunks)
+{
+    chunks.clear();
+
+    QFile file(indexPathFor(segmentPath));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const QByteArray data = file.readAll();
+    if (data.size() < HEADER_BYTES
+        || qFromLittleEndian<quint32>(data.constData()) != INDEX_MAGIC
+        || qFromLittleEndian<quint32>(data.constData() + 4) != FORMAT_VERSION) {
+        return false;
+    }
+
+    // A torn final entry (crash mid-write) is ignored
+    const int count = (data.size() - HEADER_BYTES) / ENTRY_BYTES;
+    chunks.reserve(count);
+    int64_t previousEnd = 0;
+    for (int i = 0; i < count; ++i) {
+        const char* in = data.constData() + HEADER_BYTES + i * ENTRY_BYTES;
+        Chunk chunk;
+        chunk.minMs = qFromLittleEndian<qint64>(in);
+        chunk.maxMs = qFromLittleEndian<qint64>(in + 8);
+        chunk.offset = qFromLittleEndian<qint64>(in + 16);
+        chunk.endOffset = qFromLittleEndian<qint64>(in + 24);
+        if (chunk.offset != previousEnd || chunk.endOffset < chunk.offset) break;
+        previousEnd = chunk.endOffset;
+        chunks.append(chunk);
+    }
+    return true;
+}
+
+QVector<LogSegmentIndex::Chunk> LogSegmentIndex::chunksFor(const QString& segmentPath, qint64 segmentSize,
+                                                           int64_t fromMs, int64_t toMs)
+{
+    QVector<Chunk> chunks;
+    load(segmentPath, chunks);
+    while (!chunks.isEmpty() && chunks.last().endOffset > segmentSize) {
+        chunks.removeLast();        // Index ahead of a truncated segment
+    }
+
+    // Time ranges follow file order unless the clock stepped back or a
+    // chunk's range is unknown; then fall back to checking every chunk
+    bool ordered = true;
+    for (int i = 1; i < chunks.size() && ordered; ++i) {
+        ordered = chunks[i - 1].minMs <= chunks[i].minMs && chunks[i - 1].maxMs <= chunks[i].maxMs;
+    }
+
+    auto first = chunks.constBegin();
+    if (ordered) {
+        first = std::lower_bound(chunks.constBegin(), chunks.constEnd(), fromMs,
+                                 [](const Chunk& chunk, int64_t ms) { return chunk.maxMs < ms; });
+    }
+
+    QVector<Chunk> selected;
+    for (auto it = first; it != chunks.constEnd(); ++it) {
+        if (it->maxMs < fromMs || it->minMs > toMs) {
+            if (ordered && it->minMs > toMs) break;
+            continue;
+        }
+        if (!selected.isEmpty() && selected.last().endOffset == it->offset) {
+            selected.last().endOffset = it->endOffset;
+            selected.last().minMs = std::min(selected.last().minMs, it->minMs);
+            selected.last().maxMs = std::max(selected.last().maxMs, it->maxMs);
+        } else {
+            selected.append(*it);
+        }
+    }
+
+    const int64_t indexedEnd = chunks.isEmpty() ? 0 : chunks.last().endOffset;
+    if (segmentSize > indexedEnd) {
+        Chunk tail;
+        tail.minMs = UNKNOWN_MIN_MS;
+        tail.maxMs = UNKNOWN_MAX_MS;
+        tail.offset = indexedEnd;
+        tail.endOffset = segmentSize;
+        tail.indexed = false;
+        if (!selected.isEmpty() && selected.last().endOffset == tail.offset) {
+            selected.last().endOffset = tail.endOffset;
+            selected.last().indexed = false;
+        } else {
+            selected.append(tail);
+        }
+    }
+    return selected;
+}
@@ -0,0 +1,75 @@
+#ifndef LOGSEGMENTINDEX_H
+#define LOGSEGMENTINDEX_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @brief Sparse time index for a text log segment
+ *
+ * Each CSV/JSON segment file gets a sidecar "<segment>.idx" listing its
+ * chunks: byte ranges of about CHUNK_BYTES with the earliest and latest
+ * entry timestamp written in them. A time-range query then reads only the
+ * chunks that overlap the range instead of parsing the whole segment.
+ *
+ * The writer notes each entry's timestamp as it buffers it and closes a
+ * chunk at the first commit past CHUNK_BYTES, so chunk boundaries always
+ * fall between lines. The chunk still being filled is not in the sidecar;
+ * readers treat everything past the last indexed chunk as one chunk of
+ * unknown range. Losing the sidecar therefore only costs speed.
+ *
+ * Sidecar layout (little-endian): magic "VCLI", uint32 version, then
+ * 32-byte entries {int64 minMs, int64 maxMs, int64 offset, int64 endOffset}.
+ */
+class LogSegmentIndex
+{
+public:
+    struct Chunk {
+        int64_t minMs = 0;
+        int64_t maxMs = 0;
+        int64_t offset = 0;
+        int64_t endOffset = 0;
+        bool indexed = true;        // false: unindexed tail, range unknown
+    };
+
+    LogSegmentIndex();
+    ~LogSegmentIndex();
+
+    LogSegmentIndex(const LogSegmentIndex&) = delete;
+    LogSegmentIndex& operator=(const LogSegmentIndex&) = delete;
+
+    // Writer side. segmentSize is the segment's size when it was opened
+    // (segments are appended to) or after the latest commit.
+    bool open(const QString& segmentPath, qint64 segmentSize);
+    void noteEntry(int64_t timestampMs);
+    void noteCommitted(qint64 segmentSize);
+    void close(qint64 segmentSize);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Reader side
+    static QString indexPathFor(const QString& segmentPath);
+    static bool load(const QString& segmentPath, QVector<Chunk>& chunks);
+
+    // Byte ranges of the segment that may hold entries in [fromMs, toMs],
+    // in file order, adjacent ranges merged
+    static QVector<Chunk> chunksFor(const QString& segmentPath, qint64 segmentSize,
+                                    int64_t fromMs, int64_t toMs);
+
+    static const int CHUNK_BYTES = 64 * 1024;
+    static const int HEADER_BYTES = 8;
+    static const int ENTRY_BYTES = 32;
+    static const uint32_t FORMAT_VERSION = 1;
+
+private:
+    void finishChunk(qint64 endOffset);
+
+    QFile m_file;
+    int64_t m_chunkOffset;
+    int64_t m_chunkMinMs;
+    int64_t m_chunkMaxMs;
+    bool m_chunkHasEntries;
+};
+
+#endif // LOGSEGMENTINDEX_H
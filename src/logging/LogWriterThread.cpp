@@ -0,0 +1,397 @@
+#include "LogWriterThread.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <unistd.h>
+
+LogWriterThread::LogWriterThread(QObject *parent)
+    : QThread(parent)
+    , m_entryQueue(ENTRY_QUEUE_CAPACITY)
+    , m_sampleQueue(SAMPLE_QUEUE_CAPACITY)
+    , m_commitTicket(0)
+    , m_committedTicket(0)
+    , m_stopRequested(false)
+    , m_sensorSyncedBytes(0)
+    , m_pendingBytes(0)
+    , m_dirty(false)
+{
+    for (auto& size : m_fileSizes) {
+        size.store(0, std::memory_order_relaxed);
+    }
+}
+
+LogWriterThread::~LogWriterThread()
+{
+    stopWriter();
+}
+
+void LogWriterThread::setConfig(const Config& config)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_config = config;
+    m_config.commitIntervalMs = qMax(1, config.commitIntervalMs);
+    m_config.commitBytes = qMax(1, config.commitBytes);
+    m_wake.wakeOne();
+}
+
+LogWriterThread::Config LogWriterThread::config() const
+{
+    QMutexLocker locker(&m_controlMutex);
+    return m_config;
+}
+
+bool LogWriterThread::submitEntry(DataLogger::LogEntry&& entry)
+{
+    if (!m_entryQueue.tryPush(std::move(entry))) {
+        m_entriesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool LogWriterThread::submitSample(const BinarySensorLog::Sample& sample)
+{
+    if (!m_sampleQueue.tryPush(sample)) {
+        m_samplesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void LogWriterThread::openFile(DataLogger::LogType type, const QString& filePath, DataLogger::LogFormat format)
+{
+    enqueueCommand(Command{Command::OPEN, type, filePath, format});
+}
+
+void LogWriterThread::closeFile(DataLogger::LogType type)
+{
+    enqueueCommand(Command{Command::CLOSE, type, QString(), DataLogger::CSV_FORMAT});
+}
+
+void LogWriterThread::closeAll()
+{
+    enqueueCommand(Command{Command::CLOSE_ALL, DataLogger::PRESSURE_DATA, QString(), DataLogger::CSV_FORMAT});
+}
+
+void LogWriterThread::enqueueCommand(const Command& command)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_commands.enqueue(command);
+    m_wake.wakeOne();
+}
+
+void LogWriterThread::requestCommit()
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_commitTicket++;
+    m_wake.wakeOne();
+}
+
+bool LogWriterThread::waitForCommit(int timeoutMs)
+{
+    QMutexLocker locker(&m_controlMutex);
+    if (!isRunning()) return false;
+
+    const quint64 ticket = ++m_commitTicket;
+    m_wake.wakeOne();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (m_committedTicket < ticket) {
+        const qint64 remainingMs = timeoutMs - timer.elapsed();
+        if (remainingMs <= 0 || !m_committed.wait(&m_controlMutex, static_cast<unsigned long>(remainingMs))) {
+            return m_committedTicket >= ticket;
+        }
+    }
+    return true;
+}
+
+void LogWriterThread::stopWriter()
+{
+    {
+        QMutexLocker locker(&m_controlMutex);
+        if (!isRunning()) return;
+        m_stopRequested = true;
+        m_wake.wakeOne();
+    }
+    wait();
+}
+
+qint64 LogWriterThread::fileSize(DataLogger::LogType type) const
+{
+    if (type < 0 || type >= DataLogger::LOG_TYPE_COUNT) return 0;
+    return m_fileSizes[type].load(std::memory_order_relaxed);
+}
+
+int LogWriterThread::queuedCount() const
+{
+    return static_cast<int>(m_entryQueue.sizeApprox() + m_sampleQueue.sizeApprox());
+}
+
+LogWriterThread::Statistics LogWriterThread::statistics() const
+{
+    Statistics statistics;
+    {
+        QMutexLocker locker(&m_controlMutex);
+        statistics = m_statistics;
+    }
+    statistics.entriesDropped = m_entriesDropped.load(std::memory_order_relaxed);
+    statistics.samplesDropped = m_samplesDropped.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void LogWriterThread::run()
+{
+    QElapsedTimer sinceCommit;
+    sinceCommit.start();
+
+    for (;;) {
+        QQueue<Command> commands;
+        Config config;
+        quint64 ticket;
+        bool stop;
+        {
+            QMutexLocker locker(&m_controlMutex);
+            // Producers never signal; poll the queues at a short interval
+            if (m_commands.isEmpty() && !m_stopRequested && m_commitTicket == m_committedTicket) {
+                m_wake.wait(&m_controlMutex, POLL_INTERVAL_MS);
+            }
+            commands.swap(m_commands);
+            config = m_config;
+            ticket = m_commitTicket;
+            stop = m_stopRequested;
+        }
+
+        // Buffer until the size threshold; a size-triggered commit ends the
+        // pass so commands are not starved under sustained load. On stop the
+        // queues are drained completely before the files are closed.
+        while (drainQueues()) {
+            if (m_pendingBytes >= config.commitBytes) {
+                commit();
+                sinceCommit.restart();
+                if (!stop) {
+                    break;
+                }
+            }
+        }
+
+        // Commands apply to what is already queued, so commit first
+        const bool commitDue = ticket != m_committedTicket || stop || !commands.isEmpty()
+                            || m_pendingBytes >= config.commitBytes
+                            || sinceCommit.elapsed() >= config.commitIntervalMs;
+        if (commitDue) {
+            if (m_dirty) {
+                commit();
+            }
+            sinceCommit.restart();
+        }
+
+        for (const Command& command : commands) {
+            applyCommand(command);
+        }
+        if (stop) {
+            applyCommand(Command{Command::CLOSE_ALL, DataLogger::PRESSURE_DATA, QString(), DataLogger::CSV_FORMAT});
+        }
+
+        {
+            QMutexLocker locker(&m_controlMutex);
+            m_statistics = m_writerStatistics;
+            if (commitDue) {
+                m_committedTicket = ticket;
+                m_committed.wakeAll();
+            }
+            if (stop) {
+                m_stopRequested = false;
+                m_committedTicket = m_commitTicket;
+                m_committed.wakeAll();
+                break;
+            }
+        }
+    }
+}
+
+bool LogWriterThread::drainQueues()
+{
+    // Bounded per pass so commands and commits stay responsive under load
+    static const int MAX_BATCH = 1024;
+    int drained = 0;
+
+    DataLogger::LogEntry entry;
+    while (drained < MAX_BATCH && m_entryQueue.tryPop(entry)) {
+        drained++;
+        TextFile* textFile = (entry.type >= 0 && entry.type < DataLogger::LOG_TYPE_COUNT)
+                           ? m_textFiles[entry.type].get() : nullptr;
+        if (!textFile) {
+            m_writerStatistics.unrouted++;
+            continue;
+        }
+        const QByteArray line = DataLogger::formatLogEntry(entry, textFile->format).toUtf8();
+        textFile->pending.append(line).append('\n');
+        textFile->index.noteEntry(entry.timestamp);
+        m_pendingBytes += line.size() + 1;
+        m_writerStatistics.entriesWritten++;
+        m_dirty = true;
+    }
+
+    BinarySensorLog::Sample sample;
+    while (drained < 2 * MAX_BATCH && m_sampleQueue.tryPop(sample)) {
+        drained++;
+        if (!m_sensorLog.isOpen()) {
+            m_writerStatistics.unrouted++;
+            continue;
+        }
+        if (!m_sensorLog.append(sample)) {
+            reportError(QString("Sensor log write failed: %1").arg(m_sensorLog.lastError()));
+            continue;
+        }
+        m_pendingBytes += BinarySensorLog::RECORD_BYTES;
+        m_writerStatistics.samplesWritten++;
+        m_dirty = true;
+    }
+
+    return drained > 0;
+}
+
+void LogWriterThread::commit()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SyncPolicy policy;
+    {
+        QMutexLocker locker(&m_controlMutex);
+        policy = m_config.syncPolicy;
+    }
+
+    for (int type = 0; type < DataLogger::LOG_TYPE_COUNT; ++type) {
+        TextFile* textFile = m_textFiles[type].get();
+        if (!textFile || textFile->pending.isEmpty()) continue;
+
+        const qint64 size = textFile->pending.size();
+        if (textFile->file.write(textFile->pending) != size || !textFile->file.flush()) {
+            reportError(QString("Log write failed: %1: %2").arg(textFile->file.fileName(), textFile->file.errorString()));
+        } else {
+            m_writerStatistics.bytesWritten += static_cast<quint64>(size);
+        }
+        textFile->pending.clear();
+        if (policy != SyncPolicy::NONE) {
+            syncFile(textFile->file.handle(), textFile->file.fileName(), policy);
+        }
+        // Index only what is on disk, so chunk ends are line boundaries
+        textFile->index.noteCommitted(textFile->file.size());
+        m_fileSizes[type].store(textFile->file.size(), std::memory_order_relaxed);
+    }
+
+    if (m_sensorLog.isOpen()) {
+        const qint64 before = m_sensorLog.bytesWritten();
+        if (!m_sensorLog.flush()) {
+            reportError(QString("Sensor log write failed: %1").arg(m_sensorLog.lastError()));
+        }
+        m_writerStatistics.bytesWritten += static_cast<quint64>(m_sensorLog.bytesWritten() - before);
+        // Full blocks are written as they fill; sync whatever is new
+        if (policy != SyncPolicy::NONE && m_sensorLog.bytesWritten() != m_sensorSyncedBytes) {
+            syncFile(m_sensorLog.handle(), m_sensorLog.filePath(), policy);
+        }
+        m_sensorSyncedBytes = m_sensorLog.bytesWritten();
+        m_fileSizes[DataLogger::PRESSURE_DATA].store(m_sensorLog.bytesWritten(), std::memory_order_relaxed);
+    }
+
+    m_pendingBytes = 0;
+    m_dirty = false;
+    m_writerStatistics.commits++;
+    m_writerStatistics.lastCommitMs = timer.nsecsElapsed() / 1.0e6;
+    m_writerStatistics.maxCommitMs = qMax(m_writerStatistics.maxCommitMs, m_writerStatistics.lastCommitMs);
+}
+
+void LogWriterThread::syncFile(int handle, const QString& fileName, SyncPolicy policy)
+{
+    if (handle < 0) return;
+
+    const int result = (policy == SyncPolicy::FSYNC) ? ::fsync(handle) : ::fdatasync(handle);
+    if (result != 0) {
+        reportError(QString("Log sync failed: %1").arg(fileName));
+    }
+}
+
+void LogWriterThread::applyCommand(const Command& command)
+{
+    switch (command.kind) {
+    case Command::OPEN:
+        if (command.type == DataLogger::PRESSURE_DATA && command.format == DataLogger::BINARY_FORMAT) {
+            closeText(command.type);
+            closeSensorLog();
+            if (!m_sensorLog.open(command.filePath)) {
+                reportError(QString("Failed to create log file: %1: %2").arg(command.filePath, m_sensorLog.lastError()));
+                return;
+            }
+            m_sensorSyncedBytes = 0;
+            m_fileSizes[command.type].store(m_sensorLog.bytesWritten(), std::memory_order_relaxed);
+        } else {
+            closeText(command.type);
+            if (command.type == DataLogger::PRESSURE_DATA) {
+                closeSensorLog();
+            }
+            std::unique_ptr<TextFile> textFile(new TextFile);
+            textFile->format = command.format;
+            textFile->file.setFileName(command.filePath);
+            if (!textFile->file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+                reportError(QString("Failed to create log file: %1: %2").arg(command.filePath, textFile->file.errorString()));
+                return;
+            }
+            textFile->index.open(command.filePath, textFile->file.size());
+            if (command.format == DataLogger::CSV_FORMAT && textFile->file.size() == 0) {
+                textFile->pending.append("Timestamp,Component,Event,Data\n");
+                m_dirty = true;
+            }
+            m_fileSizes[command.type].store(textFile->file.size(), std::memory_order_relaxed);
+            m_textFiles[command.type] = std::move(textFile);
+        }
+        qDebug() << "Created log file:" << command.filePath;
+        break;
+
+    case Command::CLOSE:
+        closeText(command.type);
+        if (command.type == DataLogger::PRESSURE_DATA) {
+            closeSensorLog();
+        }
+        break;
+
+    case Command::CLOSE_ALL:
+        for (int type = 0; type < DataLogger::LOG_TYPE_COUNT; ++type) {
+            closeText(type);
+        }
+        closeSensorLog();
+        break;
+    }
+}
+
+void LogWriterThread::closeText(int type)
+{
+    std::unique_ptr<TextFile>& textFile = m_textFiles[type];
+    if (!textFile) return;
+
+    if (!textFile->pending.isEmpty()) {
+        textFile->file.write(textFile->pending);
+        textFile->file.flush();
+    }
+    textFile->index.close(textFile->file.size());
+    textFile->file.close();
+    const QString filePath = textFile->file.fileName();
+    textFile.reset();
+    m_fileSizes[type].store(0, std::memory_order_relaxed);
+    emit fileClosed(filePath);
+}
+
+void LogWriterThread::closeSensorLog()
+{
+    if (!m_sensorLog.isOpen()) return;
+    m_sensorLog.close();
+    m_fileSizes[DataLogger::PRESSURE_DATA].store(0, std::memory_order_relaxed);
+}
+
+void LogWriterThread::reportError(const QString& error)
+{
+    m_writerStatistics.writeErrors++;
+    qWarning() << error;
+    emit writeError(error);
+}
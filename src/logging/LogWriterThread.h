@@ -0,0 +1,153 @@
+#ifndef LOGWRITERTHREAD_H
+#define LOGWRITERTHREAD_H
+
+#include <QThread>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+
+#include "DataLogger.h"
+#include "BinarySensorLog.h"
+#include "LogSegmentIndex.h"
+#include "../threading/MpscQueue.h"
+
+/**
+ * @brief Dedicated writer thread behind DataLogger
+ *
+ * Producers (acquisition, safety, GUI) hand entries and sensor samples to
+ * lock-free MPSC queues and return immediately; they never format, lock
+ * or touch a file. When a queue is full the entry is dropped and counted.
+ *
+ * The writer owns every log file. It drains the queues into per-file
+ * buffers and commits them as a group: one large write per file, then
+ * the configured sync. A commit happens every commitIntervalMs, as soon as
+ * commitBytes are buffered, or on request. Opening, closing and rotating
+ * files are commands applied by the writer after the data already queued
+ * has been committed to the old files. Text segments get a sparse time
+ * index (LogSegmentIndex) maintained alongside each commit.
+ */
+class LogWriterThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum class SyncPolicy {
+        NONE,           // Leave it to the kernel's writeback
+        FDATASYNC,      // Data (and size) durable at each commit
+        FSYNC           // Data and all metadata durable at each commit
+    };
+
+    struct Config {
+        int commitIntervalMs = 500;
+        int commitBytes = 64 * 1024;
+        SyncPolicy syncPolicy = SyncPolicy::FDATASYNC;
+    };
+
+    struct Statistics {
+        quint64 entriesWritten = 0;
+        quint64 samplesWritten = 0;
+        quint64 entriesDropped = 0;     // Queue full
+        quint64 samplesDropped = 0;
+        quint64 unrouted = 0;           // No file open for the entry's type
+        quint64 commits = 0;
+        quint64 bytesWritten = 0;
+        quint64 writeErrors = 0;
+        double lastCommitMs = 0.0;
+        double maxCommitMs = 0.0;
+    };
+
+    explicit LogWriterThread(QObject *parent = nullptr);
+    ~LogWriterThread();
+
+    void setConfig(const Config& config);
+    Config config() const;
+
+    // Producers: any thread, lock-free; false = queue full, entry dropped
+    bool submitEntry(DataLogger::LogEntry&& entry);
+    bool submitSample(const BinarySensorLog::Sample& sample);
+
+    // Control: applied by the writer in order, after committing queued data
+    void openFile(DataLogger::LogType type, const QString& filePath, DataLogger::LogFormat format);
+    void closeFile(DataLogger::LogType type);
+    void closeAll();
+
+    // Commit as soon as possible; waitForCommit() blocks until that commit
+    // (and any command queued before it) is done
+    void requestCommit();
+    bool waitForCommit(int timeoutMs = DEFAULT_WAIT_TIMEOUT_MS);
+
+    // Drain the queues, commit, close every file and join the thread
+    void stopWriter();
+
+    qint64 fileSize(DataLogger::LogType type) const;
+    int queuedCount() const;
+    Statistics statistics() const;
+
+    static const int ENTRY_QUEUE_CAPACITY = 4096;
+    static const int SAMPLE_QUEUE_CAPACITY = 16384;
+    static const int POLL_INTERVAL_MS = 20;
+    static const int DEFAULT_WAIT_TIMEOUT_MS = 5000;
+
+Q_SIGNALS:
+    void writeError(const QString& error);
+    // A text segment was closed and will not be written again
+    void fileClosed(const QString& filePath);
+
+protected:
+    void run() override;
+
+private:
+    struct Command {
+        enum Kind { OPEN, CLOSE, CLOSE_ALL } kind;
+        DataLogger::LogType type;
+        QString filePath;
+        DataLogger::LogFormat format;
+    };
+
+    struct TextFile {
+        QFile file;
+        DataLogger::LogFormat format;
+        QByteArray pending;
+        LogSegmentIndex index;
+    };
+
+    void enqueueCommand(const Command& command);
+    bool drainQueues();
+    void commit();
+    void syncFile(int handle, const QString& fileName, SyncPolicy policy);
+    void applyCommand(const Command& command);
+    void closeText(int type);
+    void closeSensorLog();
+    void reportError(const QString& error);
+
+    // Producer side
+    MpscQueue<DataLogger::LogEntry> m_entryQueue;
+    MpscQueue<BinarySensorLog::Sample> m_sampleQueue;
+    std::atomic<quint64> m_entriesDropped{0};
+    std::atomic<quint64> m_samplesDropped{0};
+
+    // Control, guarded by m_controlMutex
+    mutable QMutex m_controlMutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_committed;
+    QQueue<Command> m_commands;
+    Config m_config;
+    quint64 m_commitTicket;         // Last requested
+    quint64 m_committedTicket;      // Last completed
+    bool m_stopRequested;
+    Statistics m_statistics;        // Writer-side counters, published per commit
+
+    // Writer thread only
+    std::unique_ptr<TextFile> m_textFiles[DataLogger::LOG_TYPE_COUNT];
+    BinarySensorLog m_sensorLog;
+    qint64 m_sensorSyncedBytes;
+    qint64 m_pendingBytes;
+    bool m_dirty;
+    Statistics m_writerStatistics;
+    std::atomic<qint64> m_fileSizes[DataLogger::LOG_TYPE_COUNT];
+};
+
+#endif // LOGWRITERTHREAD_H
@@ -0,0 +1,487 @@
+#include "SessionRecording.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SessionRecording;
+
+namespace {
+qint64 alignedPayloadBytes(uint16_t payloadBytes)
+{
+    return (payloadBytes + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+qint64 roundToPages(qint64 bytes)
+{
+    const qint64 page = ::sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+// ============================================================================
+// SessionRecorder
+// ============================================================================
+
+SessionRecorder::SessionRecorder()
+    : m_queue(QUEUE_CAPACITY)
+    , m_open(false)
+    , m_dropped(0)
+    , m_flushTicket(0)
+    , m_flushedTicket(0)
+    , m_stopRequested(false)
+    , m_writerThread(nullptr)
+    , m_fd(-1)
+    , m_base(nullptr)
+    , m_capacity(0)
+    , m_writeOffset(0)
+    , m_sequence(0)
+    , m_failed(false)
+    , m_hasActuators(false)
+    , m_recordCount(0)
+    , m_committedBytes(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+bool SessionRecorder::open(const QString& filePath, qint64 initialBytes)
+{
+    QMutexLocker lifecycle(&m_lifecycleMutex);
+    stopWriter();
+    closeFile();
+
+    // Appends that raced the previous close belong to no recording
+    PendingRecord stale;
+    while (m_queue.tryPop(stale)) {
+    }
+
+    {
+        QMutexLocker locker(&m_controlMutex);
+        m_filePath = filePath;
+        m_lastError.clear();
+    }
+    m_fd = ::open(QFile::encodeName(filePath).constData(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        QMutexLocker locker(&m_controlMutex);
+        m_lastError = QString("cannot create %1: %2").arg(filePath, QString::fromLocal8Bit(strerror(errno)));
+        qWarning() << "Session recording:" << m_lastError;
+        return false;
+    }
+    if (!mapFile(roundToPages(qMax<qint64>(initialBytes, FILE_HEADER_BYTES + 64 * RECORD_HEADER_BYTES)))) {
+        qWarning() << "Session recording:" << lastError();
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    FileHeader* fileHeader = new (m_base) FileHeader();
+    fileHeader->magic = FILE_MAGIC;
+    fileHeader->version = FORMAT_VERSION;
+    fileHeader->headerBytes = FILE_HEADER_BYTES;
+    fileHeader->startMonotonicNs = nowNs();
+    fileHeader->startWallMs = QDateTime::currentMSecsSinceEpoch();
+    fileHeader->recordCount.store(0, std::memory_order_relaxed);
+    fileHeader->flags.store(0, std::memory_order_relaxed);
+    fileHeader->committedBytes.store(FILE_HEADER_BYTES, std::memory_order_release);
+
+    m_writeOffset = FILE_HEADER_BYTES;
+    m_sequence = 0;
+    m_failed = false;
+    m_hasActuators = false;
+    m_recordCount.store(0, std::memory_order_release);
+    m_committedBytes.store(FILE_HEADER_BYTES, std::memory_order_release);
+    m_dropped.store(0, std::memory_order_relaxed);
+
+    {
+        QMutexLocker locker(&m_controlMutex);
+        m_stopRequested = false;
+        m_flushTicket = 0;
+        m_flushedTicket = 0;
+    }
+    m_writerThread = QThread::create([this]() { runWriter(); });
+    m_writerThread->setObjectName("SessionRecorder");
+    m_writerThread->start(QThread::LowPriority);
+    m_open.store(true, std::memory_order_release);
+
+    qDebug() << "Session recording started:" << filePath;
+    return true;
+}
+
+void SessionRecorder::close()
+{
+    QMutexLocker lifecycle(&m_lifecycleMutex);
+    stopWriter();
+    closeFile();
+}
+
+void SessionRecorder::stopWriter()
+{
+    // Caller holds m_lifecycleMutex
+    m_open.store(false, std::memory_order_release);
+    if (!m_writerThread) return;
+
+    {
+        QMutexLocker locker(&m_controlMutex);
+        m_stopRequested = true;
+        m_wake.wakeOne();
+    }
+    m_writerThread->wait();
+    delete m_writerThread;
+    m_writerThread = nullptr;
+}
+
+void SessionRecorder::closeFile()
+{
+    // Caller holds m_lifecycleMutex; the writer has stopped
+    if (!m_base) return;
+
+    header()->flags.fetch_or(FileHeader::COMPLETE, std::memory_order_release);
+    ::msync(m_base, m_capacity, MS_SYNC);
+    ::munmap(m_base, m_capacity);
+    m_base = nullptr;
+
+    // Drop the unused reservation
+    if (::ftruncate(m_fd, m_writeOffset) != 0) {
+        qWarning() << "Session recording: cannot truncate" << filePath();
+    }
+    ::close(m_fd);
+    m_fd = -1;
+
+    qDebug() << "Session recording closed:" << filePath() << recordCount() << "records,"
+             << m_writeOffset << "bytes," << droppedCount() << "dropped";
+}
+
+void SessionRecorder::setClock(std::function<int64_t()> clock)
+{
+    QMutexLocker lifecycle(&m_lifecycleMutex);
+    if (m_base) {
+        qWarning() << "Cannot change the session recording clock while recording";
+        return;
+    }
+    m_clock = std::move(clock);
+}
+
+int64_t SessionRecorder::nowNs() const
+{
+    return m_clock ? m_clock() : steadyNowNs();
+}
+
+bool SessionRecorder::append(uint16_t type, const void* payload, uint16_t payloadBytes)
+{
+    if (!m_open.load(std::memory_order_acquire) || payloadBytes > MAX_PAYLOAD_BYTES) return false;
+
+    PendingRecord record;
+    record.type = type;
+    record.payloadBytes = payloadBytes;
+    record.monotonicNs = nowNs();
+    std::memcpy(record.payload, payload, payloadBytes);
+    if (!m_queue.tryPush(std::move(record))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool SessionRecorder::flush(int timeoutMs)
+{
+    QMutexLocker locker(&m_controlMutex);
+    if (!m_writerThread) return true;
+
+    const quint64 ticket = ++m_flushTicket;
+    m_wake.wakeOne();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (m_flushedTicket < ticket) {
+        const qint64 remainingMs = timeoutMs - timer.elapsed();
+        if (remainingMs <= 0 || !m_flushed.wait(&m_controlMutex, static_cast<unsigned long>(remainingMs))) {
+            return m_flushedTicket >= ticket;
+        }
+    }
+    return true;
+}
+
+void SessionRecorder::runWriter()
+{
+    for (;;) {
+        quint64 ticket;
+        bool stop;
+        {
+            QMutexLocker locker(&m_controlMutex);
+            // Producers never signal; poll the queue at a short interval
+            if (!m_stopRequested && m_flushTicket == m_flushedTicket) {
+                m_wake.wait(&m_controlMutex, POLL_INTERVAL_MS);
+            }
+            ticket = m_flushTicket;
+            stop = m_stopRequested;
+        }
+
+        PendingRecord record;
+        while (m_queue.tryPop(record)) {
+            writeRecord(record);
+        }
+
+        {
+            QMutexLocker locker(&m_controlMutex);
+            m_flushedTicket = ticket;
+            m_flushed.wakeAll();
+        }
+        if (stop) {
+            return;
+        }
+    }
+}
+
+void SessionRecorder::writeRecord(const PendingRecord& record)
+{
+    // Writer thread only
+    if (m_failed) return;
+
+    if (record.type == ActuatorRecord::TYPE && record.payloadBytes == sizeof(ActuatorRecord)) {
+        if (m_hasActuators && std::memcmp(&m_lastActuators, record.payload, sizeof(ActuatorRecord)) == 0) {
+            return;
+        }
+        std::memcpy(&m_lastActuators, record.payload, sizeof(ActuatorRecord));
+        m_hasActuators = true;
+    }
+
+    const qint64 recordBytes = RECORD_HEADER_BYTES + alignedPayloadBytes(record.payloadBytes);
+    if (m_writeOffset + recordBytes > m_capacity && !mapFile(m_capacity * 2)) {
+        // The records already committed stay readable; close() finishes the file
+        qWarning() << "Session recording stopped:" << lastError();
+        m_failed = true;
+        m_open.store(false, std::memory_order_release);
+        return;
+    }
+
+    // Fill the record, then publish it by moving the committed length; a
+    // reader never sees a partly written record
+    char* out = m_base + m_writeOffset;
+    RecordHeader recordHeader;
+    recordHeader.type = record.type;
+    recordHeader.payloadBytes = record.payloadBytes;
+    recordHeader.sequence = m_sequence++;
+    recordHeader.monotonicNs = record.monotonicNs;
+    std::memcpy(out, &recordHeader, RECORD_HEADER_BYTES);
+    std::memcpy(out + RECORD_HEADER_BYTES, record.payload, record.payloadBytes);
+    std::memset(out + RECORD_HEADER_BYTES + record.payloadBytes, 0,
+                recordBytes - RECORD_HEADER_BYTES - record.payloadBytes);
+
+    m_writeOffset += recordBytes;
+    const quint64 count = m_recordCount.load(std::memory_order_relaxed) + 1;
+    FileHeader* fileHeader = header();
+    fileHeader->recordCount.store(count, std::memory_order_relaxed);
+    fileHeader->committedBytes.store(static_cast<uint64_t>(m_writeOffset), std::memory_order_release);
+    m_recordCount.store(count, std::memory_order_release);
+    m_committedBytes.store(m_writeOffset, std::memory_order_release);
+}
+
+bool SessionRecorder::mapFile(qint64 capacity)
+{
+    // Reserve the blocks first: writing to a mapped hole on a full disk
+    // would fault the writer instead of failing here
+    const int error = ::posix_fallocate(m_fd, 0, capacity);
+    if (error != 0) {
+        QMutexLocker locker(&m_controlMutex);
+        m_lastError = QString("cannot reserve %1 bytes for %2: %3")
+                          .arg(capacity).arg(m_filePath, QString::fromLocal8Bit(strerror(error)));
+        return false;
+    }
+
+    void* mapped = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        QMutexLocker locker(&m_controlMutex);
+        m_lastError = QString("cannot map %1: %2").arg(m_filePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (m_base) {
+        ::munmap(m_base, m_capacity);
+    }
+    m_base = static_cast<char*>(mapped);
+    m_capacity = capacity;
+    return true;
+}
+
+FileHeader* SessionRecorder::header() const
+{
+    return reinterpret_cast<FileHeader*>(m_base);
+}
+
+QString SessionRecorder::filePath() const
+{
+    QMutexLocker locker(&m_controlMutex);
+    return m_filePath;
+}
+
+QString SessionRecorder::lastError() const
+{
+    QMutexLocker locker(&m_controlMutex);
+    return m_lastError;
+}
+
+QString SessionRecorder::defaultFileName()
+{
+    return QString("session_%1.%2")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"), FILE_SUFFIX);
+}
+
+// ============================================================================
+// SessionRecordingReader
+// ============================================================================
+
+SessionRecordingReader::SessionRecordingReader()
+    : m_fd(-1)
+    , m_base(nullptr)
+    , m_mappedBytes(0)
+    , m_committedBytes(0)
+    , m_recordCount(0)
+{
+}
+
+SessionRecordingReader::~SessionRecordingReader()
+{
+    close();
+}
+
+bool SessionRecordingReader::open(const QString& filePath)
+{
+    close();
+    m_lastError.clear();
+
+    m_fd = ::open(QFile::encodeName(filePath).constData(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        m_lastError = QString("cannot open %1: %2").arg(filePath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (!mapFile()) {
+        close();
+        return false;
+    }
+
+    const FileHeader* fileHeader = header();
+    if (fileHeader->magic != FILE_MAGIC || fileHeader->version != FORMAT_VERSION
+        || fileHeader->headerBytes != FILE_HEADER_BYTES) {
+        m_lastError = QString("%1 is not a version %2 session recording").arg(filePath).arg(FORMAT_VERSION);
+        close();
+        return false;
+    }
+    return refresh();
+}
+
+void SessionRecordingReader::close()
+{
+    if (m_base) {
+        ::munmap(const_cast<char*>(m_base), m_mappedBytes);
+        m_base = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_mappedBytes = 0;
+    m_committedBytes = 0;
+    m_recordCount = 0;
+}
+
+bool SessionRecordingReader::mapFile()
+{
+    struct stat info;
+    if (::fstat(m_fd, &info) != 0 || info.st_size < FILE_HEADER_BYTES) {
+        m_lastError = "file too short for a session recording";
+        return false;
+    }
+
+    void* mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        m_lastError = QString("cannot map: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (m_base) {
+        ::munmap(const_cast<char*>(m_base), m_mappedBytes);
+    }
+    m_base = static_cast<const char*>(mapped);
+    m_mappedBytes = info.st_size;
+    return true;
+}
+
+bool SessionRecordingReader::refresh()
+{
+    if (!m_base) return false;
+
+    const qint64 committed = static_cast<qint64>(header()->committedBytes.load(std::memory_order_acquire));
+    // The writer has grown the file past this mapping
+    if (committed > m_mappedBytes && !mapFile()) {
+        return false;
+    }
+    // Committed bytes beyond the file can only come from a damaged header
+    m_committedBytes = qBound<qint64>(FILE_HEADER_BYTES, committed, m_mappedBytes);
+    m_recordCount = header()->recordCount.load(std::memory_order_relaxed);
+    return true;
+}
+
+SessionRecordingReader::Record SessionRecordingReader::first() const
+{
+    return recordAt(FILE_HEADER_BYTES);
+}
+
+SessionRecordingReader::Record SessionRecordingReader::next(const Record& record) const
+{
+    if (!record.isValid()) return Record();
+    const qint64 offset = reinterpret_cast<const char*>(record.header) - m_base;
+    return recordAt(offset + RECORD_HEADER_BYTES + alignedPayloadBytes(record.header->payloadBytes));
+}
+
+SessionRecordingReader::Record SessionRecordingReader::recordAt(qint64 offset) const
+{
+    Record record;
+    if (!m_base || offset + RECORD_HEADER_BYTES > m_committedBytes) {
+        return record;
+    }
+    const RecordHeader* recordHeader = reinterpret_cast<const RecordHeader*>(m_base + offset);
+    if (offset + RECORD_HEADER_BYTES + alignedPayloadBytes(recordHeader->payloadBytes) > m_committedBytes) {
+        return record;
+    }
+    record.header = recordHeader;
+    record.payload = m_base + offset + RECORD_HEADER_BYTES;
+    return record;
+}
+
+const FileHeader* SessionRecordingReader::header() const
+{
+    return reinterpret_cast<const FileHeader*>(m_base);
+}
+
+bool SessionRecordingReader::isComplete() const
+{
+    return m_base && (header()->flags.load(std::memory_order_acquire) & FileHeader::COMPLETE) != 0;
+}
+
+int64_t SessionRecordingReader::startMonotonicNs() const
+{
+    return m_base ? header()->startMonotonicNs : 0;
+}
+
+int64_t SessionRecordingReader::startWallMs() const
+{
+    return m_base ? header()->startWallMs : 0;
+}
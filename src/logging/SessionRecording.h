@@ -0,0 +1,360 @@
+#ifndef SESSIONRECORDING_H
+#define SESSIONRECORDING_H
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "../threading/MpscQueue.h"
+
+class QThread;
+
+/**
+ * @brief Append-only, memory-mapped recording of one control session
+ *
+ * One file per session holds every sensor snapshot, actuator output change,
+ * arousal estimate and state transition, in the order they happened:
+ *
+ *   header   magic "VCSR", version, session start (monotonic ns, wall ms),
+ *            committed length, record count, flags (64 bytes)
+ *   records  16-byte record header (type, payload size, sequence, monotonic
+ *            ns), then a fixed-layout payload padded to 8 bytes
+ *
+ * The writer appends into a shared mapping and publishes each record by
+ * advancing the header's committed length (release store); readers map the
+ * file read-only, load the committed length (acquire) and use the payloads
+ * in place, without copying or parsing. A recording that is still being
+ * written can be tailed by calling refresh(). After a crash the committed
+ * length still marks the last complete record.
+ *
+ * Numbers are stored in native (little-endian on every supported target)
+ * byte order; the layouts below are part of the format and must only grow
+ * by adding record types or bumping FORMAT_VERSION.
+ */
+namespace SessionRecording {
+
+static const uint32_t FILE_MAGIC = 0x52534356;     // "VCSR" little-endian
+static const uint16_t FORMAT_VERSION = 1;
+static const int FILE_HEADER_BYTES = 64;
+static const int RECORD_HEADER_BYTES = 16;
+static const int RECORD_ALIGNMENT = 8;
+static constexpr const char* FILE_SUFFIX = "vcsr";
+
+enum RecordType : uint16_t {
+    SENSOR = 1,
+    ACTUATORS,
+    AROUSAL,
+    TRANSITION,
+    SESSION_START
+};
+
+struct FileHeader {
+    enum Flag : uint32_t {
+        COMPLETE = 1u << 0          // Closed cleanly; no more records will follow
+    };
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerBytes;
+    int64_t startMonotonicNs;
+    int64_t startWallMs;
+    std::atomic<uint64_t> committedBytes;   // End of the last complete record
+    std::atomic<uint64_t> recordCount;
+    std::atomic<uint32_t> flags;
+    uint32_t reserved[5];
+};
+
+struct RecordHeader {
+    uint16_t type;
+    uint16_t payloadBytes;
+    uint32_t sequence;
+    int64_t monotonicNs;
+};
+
+// One acquisition snapshot (HardwareManager::publishSensorSnapshot)
+struct SensorRecord {
+    static const uint16_t TYPE = SENSOR;
+    int64_t timestampMs = 0;            // Wall clock
+    double avlPressure = -1.0;          // mmHg, -1 = error
+    double tankPressure = -1.0;
+    double clitoralPressure = -1.0;
+    uint32_t flags = 0;                 // SensorSnapshot::ChannelFlag
+    uint32_t reserved = 0;
+};
+
+// Every actuator output; recorded only when one of them changes
+struct ActuatorRecord {
+    static const uint16_t TYPE = ACTUATORS;
+    enum Output : uint32_t {
+        SOL1 = 1u << 0,
+        SOL2 = 1u << 1,
+        SOL3 = 1u << 2,
+        SOL4 = 1u << 3,
+        SOL5 = 1u << 4,
+        PUMP_ON = 1u << 8,
+        OSCILLATOR_RUNNING = 1u << 9,
+        TENS_RUNNING = 1u << 10,
+        EMERGENCY_STOP = 1u << 15
+    };
+
+    uint32_t outputs = 0;
+    uint32_t reserved = 0;
+    double pumpSpeedPercent = 0.0;
+    double oscillatorFrequencyHz = 0.0;
+    double oscillatorAmplitudeMmHg = 0.0;
+    double tensFrequencyHz = 0.0;
+    double tensAmplitudePercent = 0.0;
+    int32_t tensPulseWidthUs = 0;
+    int32_t reserved2 = 0;
+
+    bool has(Output output) const { return (outputs & output) != 0; }
+};
+
+// One OrgasmControlAlgorithm update tick
+struct ArousalRecord {
+    static const uint16_t TYPE = AROUSAL;
+    double arousalLevel = 0.0;
+    double smoothedArousal = 0.0;
+    double intensity = 0.0;
+    double frequency = 0.0;
+    double tensAmplitude = 0.0;
+    int32_t heartRate = 0;
+    uint8_t controlState = 0;           // OrgasmControlAlgorithm::ControlState
+    uint8_t mode = 0;                   // OrgasmControlAlgorithm::Mode
+    uint8_t arousalState = 0;           // OrgasmControlAlgorithm::ArousalState
+    uint8_t reserved = 0;
+};
+
+struct TransitionRecord {
+    static const uint16_t TYPE = TRANSITION;
+    enum Kind : uint16_t {
+        CONTROL_STATE = 1,
+        MODE,
+        AROUSAL_STATE
+    };
+
+    uint16_t kind = 0;
+    uint16_t reserved = 0;
+    int32_t from = 0;
+    int32_t to = 0;
+    int32_t reserved2 = 0;
+};
+
+// Everything needed to start the same session again on replay
+struct SessionStartRecord {
+    static const uint16_t TYPE = SESSION_START;
+    enum Flag : uint32_t {
+        TENS_ENABLED = 1u << 0,
+        ANTI_ESCAPE_ENABLED = 1u << 1,
+        HEART_RATE_ENABLED = 1u << 2
+    };
+
+    int32_t mode = 0;                   // OrgasmControlAlgorithm::Mode
+    int32_t targetEdges = 0;
+    int32_t targetOrgasms = 0;
+    int32_t milkingFailureMode = 0;
+    int64_t maxDurationMs = 0;
+    double edgeThreshold = 0.0;
+    double orgasmThreshold = 0.0;
+    double recoveryThreshold = 0.0;
+    uint32_t flags = 0;
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(FileHeader) == FILE_HEADER_BYTES, "FileHeader layout");
+static_assert(sizeof(RecordHeader) == RECORD_HEADER_BYTES, "RecordHeader layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed length must be lock-free across processes");
+static_assert(sizeof(SensorRecord) == 40, "SensorRecord layout");
+static_assert(sizeof(ActuatorRecord) == 56, "ActuatorRecord layout");
+static_assert(sizeof(ArousalRecord) == 48, "ArousalRecord layout");
+static_assert(sizeof(TransitionRecord) == 16, "TransitionRecord layout");
+static_assert(sizeof(SessionStartRecord) == 56, "SessionStartRecord layout");
+
+} // namespace SessionRecording
+
+/**
+ * @brief Writer side of a session recording
+ *
+ * Producers (the acquisition thread, the control loop, the hardware
+ * setters) never lock or make a syscall: append() stamps the record with
+ * the clock and hands it to a bounded lock-free MPSC queue. A writer thread
+ * owned by the recorder drains the queue into the mapping, grows the file
+ * when it fills and publishes each record. When the queue is full the
+ * record is dropped and counted. Appends while no recording is open return
+ * false immediately, so producers can stay attached permanently.
+ *
+ * Records appear in hand-off order. Actuator records identical to the last
+ * one written are dropped by the writer, so producers can record the full
+ * output state on every change without checking what it was.
+ *
+ * The file is reserved with posix_fallocate before it is mapped, so a full
+ * disk ends the recording instead of faulting the writer.
+ */
+class SessionRecorder
+{
+public:
+    SessionRecorder();
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Create (truncating) filePath, reserving initialBytes up front
+    bool open(const QString& filePath, qint64 initialBytes = DEFAULT_INITIAL_BYTES);
+    // Write what is queued, mark the recording complete and cut the file
+    // to its committed length
+    void close();
+    bool isOpen() const { return m_open.load(std::memory_order_acquire); }
+
+    // Time source for record timestamps; steady_clock unless set (replay).
+    // Only while closed.
+    void setClock(std::function<int64_t()> clock);
+    int64_t nowNs() const;
+
+    // Any thread, lock-free; false = not recording or queue full
+    bool append(uint16_t type, const void* payload, uint16_t payloadBytes);
+    template<typename T>
+    bool append(const T& record)
+    {
+        static_assert(sizeof(T) <= MAX_PAYLOAD_BYTES, "record payload too large for the queue");
+        return append(T::TYPE, &record, sizeof(T));
+    }
+
+    // Block until everything appended before the call is committed
+    bool flush(int timeoutMs = DEFAULT_FLUSH_TIMEOUT_MS);
+
+    QString filePath() const;
+    QString lastError() const;
+    quint64 recordCount() const { return m_recordCount.load(std::memory_order_acquire); }
+    qint64 committedBytes() const { return m_committedBytes.load(std::memory_order_acquire); }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // "session_yyyyMMdd_HHmmss.vcsr"
+    static QString defaultFileName();
+
+    static const qint64 DEFAULT_INITIAL_BYTES = 4 * 1024 * 1024;    // ~20 min at 50 Hz sensing
+    static const int QUEUE_CAPACITY = 4096;
+    static const int MAX_PAYLOAD_BYTES = 64;
+    static const int POLL_INTERVAL_MS = 10;
+    static const int DEFAULT_FLUSH_TIMEOUT_MS = 5000;
+
+private:
+    struct PendingRecord {
+        uint16_t type = 0;
+        uint16_t payloadBytes = 0;
+        int64_t monotonicNs = 0;
+        alignas(8) char payload[MAX_PAYLOAD_BYTES];
+    };
+
+    void runWriter();
+    void writeRecord(const PendingRecord& record);
+    bool mapFile(qint64 capacity);
+    void stopWriter();
+    void closeFile();
+    SessionRecording::FileHeader* header() const;
+
+    // Producer side
+    MpscQueue<PendingRecord> m_queue;
+    std::atomic<bool> m_open;
+    std::atomic<quint64> m_dropped;
+    std::function<int64_t()> m_clock;
+
+    // Serializes open/close; never taken by the writer
+    QMutex m_lifecycleMutex;
+
+    // Writer coordination, guarded by m_controlMutex
+    mutable QMutex m_controlMutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_flushed;
+    quint64 m_flushTicket;          // Last requested
+    quint64 m_flushedTicket;        // Last completed
+    bool m_stopRequested;
+    QString m_filePath;
+    QString m_lastError;
+    QThread* m_writerThread;
+
+    // Writer thread while it runs, then the closing thread
+    int m_fd;
+    char* m_base;
+    qint64 m_capacity;
+    qint64 m_writeOffset;
+    uint32_t m_sequence;
+    bool m_failed;
+    SessionRecording::ActuatorRecord m_lastActuators;
+    bool m_hasActuators;
+
+    // Published by the writer
+    std::atomic<quint64> m_recordCount;
+    std::atomic<qint64> m_committedBytes;
+};
+
+/**
+ * @brief Zero-copy reader of a session recording
+ *
+ * Maps the file read-only; records are returned as pointers into the
+ * mapping, valid until close() or a refresh() that remaps. Not thread-safe;
+ * give each reading thread its own reader.
+ */
+class SessionRecordingReader
+{
+public:
+    struct Record {
+        const SessionRecording::RecordHeader* header = nullptr;
+        const char* payload = nullptr;
+
+        bool isValid() const { return header != nullptr; }
+        uint16_t type() const { return header->type; }
+        int64_t monotonicNs() const { return header->monotonicNs; }
+
+        // nullptr unless the record is a T
+        template<typename T>
+        const T* as() const
+        {
+            return header && header->type == T::TYPE && header->payloadBytes >= sizeof(T)
+                ? reinterpret_cast<const T*>(payload) : nullptr;
+        }
+    };
+
+    SessionRecordingReader();
+    ~SessionRecordingReader();
+
+    SessionRecordingReader(const SessionRecordingReader&) = delete;
+    SessionRecordingReader& operator=(const SessionRecordingReader&) = delete;
+
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return m_base != nullptr; }
+
+    // Pick up records committed since open() or the last refresh(), for a
+    // recording still being written. Invalidates earlier Record pointers
+    // when the file had to be remapped.
+    bool refresh();
+
+    Record first() const;
+    Record next(const Record& record) const;
+
+    // Closed cleanly by the writer: no more records will appear
+    bool isComplete() const;
+    quint64 recordCount() const { return m_recordCount; }
+    qint64 committedBytes() const { return m_committedBytes; }
+    int64_t startMonotonicNs() const;
+    int64_t startWallMs() const;
+    QString lastError() const { return m_lastError; }
+
+private:
+    Record recordAt(qint64 offset) const;
+    const SessionRecording::FileHeader* header() const;
+    bool mapFile();
+
+    int m_fd;
+    const char* m_base;
+    qint64 m_mappedBytes;
+    qint64 m_committedBytes;
+    quint64 m_recordCount;
+    QString m_lastError;
+};
+
+#endif // SESSIONRECORDING_H
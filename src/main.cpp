@@ -8,16 +8,20 @@
 #include <QCommandLineOption>
 #include <iostream>
 #include <cstdlib>
+#include <memory>
 
 #include "VacuumController.h"
 #include "gui/MainWindow.h"
 #include "gui/styles/ModernMedicalStyle.h"
 #include "safety/SafetyManager.h"
 #include "testing/HardwareTester.h"
+#include "threading/ThreadManager.h"
+#include "performance/HotPathTrace.h"
 
 // Forward declarations
 int runHardwareTests(QApplication& app, const QCommandLineParser& parser);
 int runGUIApplication(QApplication& app);
+void configureDataAcquisition(ThreadManager* threadManager, const QCommandLineParser& parser);
 
 int main(int argc, char *argv[])
 {
@@ -87,9 +91,36 @@ int main(int argc, char *argv[])
     QCommandLineOption continueOnFailureOption("continue-on-failure", "Continue testing after failures");
     parser.addOption(continueOnFailureOption);
 
+    QCommandLineOption traceOption("trace", "Write hot-path trace records to file (Debug/trace-enabled builds)", "filename");
+    parser.addOption(traceOption);
+
+    // Real-time data acquisition
+    QCommandLineOption sampleRateOption("sample-rate", "Sensor sampling rate in Hz, 1-1000 (default: 50)", "hz");
+    parser.addOption(sampleRateOption);
+
+    QCommandLineOption realTimeOption("realtime", "Sample sensors on an absolute-deadline clock_nanosleep loop instead of a QTimer");
+    parser.addOption(realTimeOption);
+
+    QCommandLineOption realTimePriorityOption("rt-priority", "SCHED_FIFO priority for real-time sampling, 0 keeps normal scheduling (default: 80)", "priority");
+    parser.addOption(realTimePriorityOption);
+
+    QCommandLineOption realTimeCpuOption("rt-cpu", "Pin the real-time sampling thread to this CPU", "cpu");
+    parser.addOption(realTimeCpuOption);
+
+    QCommandLineOption lockMemoryOption("lock-memory", "mlockall() process memory while real-time sampling runs");
+    parser.addOption(lockMemoryOption);
+
     // Parse command line arguments
     parser.process(a);
 
+    // Drain VC_TRACE records off-thread; a no-op when tracing is compiled out
+    std::unique_ptr<HotPathTraceCollector> traceCollector;
+    if (parser.isSet(traceOption)) {
+        traceCollector = std::make_unique<HotPathTraceCollector>();
+        traceCollector->setOutputFile(parser.value(traceOption));
+        traceCollector->start();
+    }
+
     // Check if running in test mode
     if (parser.isSet(testSensorsOption) || parser.isSet(testActuatorsOption) || parser.isSet(testAllOption)) {
         return runHardwareTests(a, parser);
@@ -169,6 +200,10 @@ int main(int argc, char *argv[])
             std::cout << "Controller initialization completed successfully!" << std::endl;
         }
 
+        if (controller.getThreadManager()) {
+            configureDataAcquisition(controller.getThreadManager(), parser);
+        }
+
         // Create and show main window
         std::cout << "Creating MainWindow..." << std::endl;
         MainWindow window(&controller);
@@ -210,6 +245,48 @@ int runGUIApplication(QApplication& app)
     return app.exec();
 }
 
+void configureDataAcquisition(ThreadManager* threadManager, const QCommandLineParser& parser)
+{
+    if (parser.isSet("sample-rate")) {
+        bool ok;
+        int hz = parser.value("sample-rate").toInt(&ok);
+        if (ok && hz > 0 && hz <= 1000) {
+            threadManager->setDataAcquisitionRate(hz);
+        } else {
+            std::cerr << "Warning: Invalid sample rate, keeping default" << std::endl;
+        }
+    }
+
+    if (!parser.isSet("realtime")) {
+        return;
+    }
+
+    int priority = threadManager->getDataAcquisitionRealTimePriority();
+    if (parser.isSet("rt-priority")) {
+        bool ok;
+        int value = parser.value("rt-priority").toInt(&ok);
+        if (ok && value >= 0 && value <= 99) {
+            priority = value;
+        } else {
+            std::cerr << "Warning: Invalid real-time priority, using " << priority << std::endl;
+        }
+    }
+
+    int cpu = -1;
+    if (parser.isSet("rt-cpu")) {
+        bool ok;
+        int value = parser.value("rt-cpu").toInt(&ok);
+        if (ok && value >= 0) {
+            cpu = value;
+        } else {
+            std::cerr << "Warning: Invalid CPU for real-time sampling, not pinning" << std::endl;
+        }
+    }
+
+    threadManager->setDataAcquisitionRealTime(true, priority, cpu, parser.isSet("lock-memory"));
+    std::cout << "Real-time data acquisition enabled (SCHED_FIFO priority " << priority << ")" << std::endl;
+}
+
 int runHardwareTests(QApplication& app, const QCommandLineParser& parser)
 {
     std::cout << "=== Vacuum Controller Hardware Testing ===" << std::endl;
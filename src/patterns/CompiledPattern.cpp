@@ -0,0 +1,147 @@
+#include "CompiledPattern.h"
+#include <QHash>
+#include <cmath>
+
+void CompiledPattern::clear()
+{
+    m_steps.clear();
+    m_actionNames.clear();
+    m_totalDurationMs = 0;
+}
+
+void CompiledPattern::append(Step step, const QString& actionName)
+{
+    int nameIndex = m_actionNames.indexOf(actionName);
+    if (nameIndex < 0) {
+        nameIndex = m_actionNames.size();
+        m_actionNames.append(actionName);
+    }
+    step.nameIndex = static_cast<uint16_t>(nameIndex);
+
+    const uint8_t keep = OSCILLATE | TENS_ON;
+    step.flags &= keep;
+
+    if (m_steps.isEmpty()) {
+        // Nothing is known about the outputs when the pattern is entered
+        step.flags |= OSC_RETUNE | TENS_RECONFIGURE | PHASE_CHANGED;
+        if (step.sealProfile != SealProfile::UNCHANGED) {
+            step.flags |= SEAL_CHANGED;
+        }
+    } else {
+        const Step& previous = m_steps.last();
+
+        if (step.has(OSCILLATE) &&
+            (!previous.has(OSCILLATE) ||
+             std::fabs(step.oscFrequencyHz - previous.oscFrequencyHz) > OSC_FREQUENCY_TOLERANCE_HZ ||
+             std::fabs(step.oscAmplitudeMmHg - previous.oscAmplitudeMmHg) > OSC_AMPLITUDE_TOLERANCE_MMHG)) {
+            step.flags |= OSC_RETUNE;
+        }
+
+        if (step.has(TENS_ON) &&
+            (!previous.has(TENS_ON) ||
+             step.tensFrequencyHz != previous.tensFrequencyHz ||
+             step.tensPulseWidthUs != previous.tensPulseWidthUs ||
+             step.tensAmplitudePercent != previous.tensAmplitudePercent ||
+             step.tensSync != previous.tensSync)) {
+            step.flags |= TENS_RECONFIGURE;
+        }
+
+        if (step.sealProfile != SealProfile::UNCHANGED && step.sealProfile != previous.sealProfile) {
+            step.flags |= SEAL_CHANGED;
+        }
+
+        if (step.nameIndex != previous.nameIndex) {
+            step.flags |= PHASE_CHANGED;
+        }
+    }
+
+    m_totalDurationMs += step.durationMs;
+    m_steps.append(step);
+}
+
+double CompiledPattern::interpolate(Curve curve, double from, double to, double t)
+{
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+
+    double shaped;
+    switch (curve) {
+        case Curve::HOLD:
+            return from;
+        case Curve::LINEAR:
+            shaped = t;
+            break;
+        case Curve::CUBIC:
+            shaped = t * t * (3.0 - 2.0 * t);
+            break;
+        case Curve::SINE:
+            shaped = 0.5 - 0.5 * std::cos(M_PI * t);
+            break;
+        case Curve::EASE_IN:
+            shaped = t * t;
+            break;
+        case Curve::EASE_OUT:
+            shaped = 1.0 - (1.0 - t) * (1.0 - t);
+            break;
+        default:
+            return from;
+    }
+    return from + (to - from) * shaped;
+}
+
+CompiledPattern::Action CompiledPattern::actionFromName(const QString& name)
+{
+    static const QHash<QString, Action> actions = {
+        {"vacuum", Action::VACUUM},
+        {"release", Action::RELEASE},
+        {"hold", Action::HOLD},
+        {"air_pulse_run", Action::AIR_PULSE_RUN},
+        {"gentle_ramp", Action::GENTLE_RAMP},
+        {"steady_moderate", Action::STEADY_MODERATE},
+        {"adaptation_steady", Action::ADAPTATION_STEADY},
+        {"arousal_buildup", Action::AROUSAL_BUILDUP},
+        {"arousal_intensify", Action::AROUSAL_INTENSIFY},
+        {"climax_maintain", Action::CLIMAX_MAINTAIN},
+        {"post_climax_recovery", Action::POST_CLIMAX_RECOVERY},
+        {"final_recovery", Action::FINAL_RECOVERY},
+        {"continuous_gentle_ramp", Action::CONTINUOUS_GENTLE_RAMP},
+        {"continuous_steady_moderate", Action::CONTINUOUS_STEADY_MODERATE},
+        {"continuous_adaptation", Action::CONTINUOUS_ADAPTATION},
+        {"continuous_arousal_buildup", Action::CONTINUOUS_AROUSAL_BUILDUP},
+        {"continuous_arousal_intensify", Action::CONTINUOUS_AROUSAL_INTENSIFY},
+        {"continuous_climax_maintain", Action::CONTINUOUS_CLIMAX_MAINTAIN},
+        {"continuous_brief_recovery", Action::CONTINUOUS_BRIEF_RECOVERY},
+        {"therapeutic_warmup", Action::THERAPEUTIC_WARMUP},
+        {"therapeutic_main", Action::THERAPEUTIC_MAIN},
+        {"therapeutic_cooldown", Action::THERAPEUTIC_COOLDOWN},
+        {"maintain_baseline", Action::MAINTAIN_BASELINE},
+        {"engorgement", Action::ENGORGEMENT},
+        {"dual_stimulation", Action::DUAL_STIMULATION},
+        {"cooldown", Action::COOLDOWN},
+        {"clitoral_warmup", Action::CLITORAL_WARMUP},
+        {"clitoral_buildup", Action::CLITORAL_BUILDUP},
+        {"clitoral_climax", Action::CLITORAL_CLIMAX},
+        {"clitoral_afterglow", Action::CLITORAL_AFTERGLOW},
+        {"tens_warmup", Action::TENS_WARMUP},
+        {"tens_buildup", Action::TENS_BUILDUP},
+        {"tens_climax", Action::TENS_CLIMAX},
+        {"tens_afterglow", Action::TENS_AFTERGLOW}
+    };
+    return actions.value(name, Action::CUSTOM);
+}
+
+CompiledPattern::SealProfile CompiledPattern::sealProfileFor(Action action)
+{
+    switch (action) {
+        case Action::CLIMAX_MAINTAIN:
+        case Action::AROUSAL_INTENSIFY:
+        case Action::CONTINUOUS_CLIMAX_MAINTAIN:
+        case Action::CONTINUOUS_AROUSAL_INTENSIFY:
+            return SealProfile::CRITICAL;
+        case Action::POST_CLIMAX_RECOVERY:
+        case Action::FINAL_RECOVERY:
+        case Action::CONTINUOUS_BRIEF_RECOVERY:
+            return SealProfile::RECOVERY;
+        default:
+            return SealProfile::UNCHANGED;
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef COMPILEDPATTERN_H
+#define COMPILEDPATTERN_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @brief Execution form of a pattern: a flat array of POD steps
+ *
+ * Pattern builders author steps with a QString action and a QJsonObject of
+ * parameters. PatternEngine compiles those once at pattern start into this
+ * form, so executing a step (including every step of an endlessly looping
+ * pattern) performs no string comparison, hashing or JSON lookup.
+ *
+ * Besides the typed parameters each step carries change flags computed
+ * against the step before it: the oscillator, TENS stage and anti-detachment
+ * monitor are only reconfigured when the pattern actually changes them.
+ * The first step always carries every flag, so entering the pattern (or
+ * wrapping around a loop) fully re-establishes the outputs.
+ *
+ * Steps are keyframes: the pressure starts at pressurePercent and follows
+ * the step's curve to endPressurePercent over the step. HOLD keeps the
+ * classic step-wise behavior; the other curves are evaluated per control
+ * tick by PatternEngine's setpoint generator.
+ */
+class CompiledPattern
+{
+public:
+    enum class Action : uint8_t {
+        VACUUM,
+        RELEASE,
+        HOLD,
+        AIR_PULSE_RUN,
+        GENTLE_RAMP,
+        STEADY_MODERATE,
+        ADAPTATION_STEADY,
+        AROUSAL_BUILDUP,
+        AROUSAL_INTENSIFY,
+        CLIMAX_MAINTAIN,
+        POST_CLIMAX_RECOVERY,
+        FINAL_RECOVERY,
+        CONTINUOUS_GENTLE_RAMP,
+        CONTINUOUS_STEADY_MODERATE,
+        CONTINUOUS_ADAPTATION,
+        CONTINUOUS_AROUSAL_BUILDUP,
+        CONTINUOUS_AROUSAL_INTENSIFY,
+        CONTINUOUS_CLIMAX_MAINTAIN,
+        CONTINUOUS_BRIEF_RECOVERY,
+        THERAPEUTIC_WARMUP,
+        THERAPEUTIC_MAIN,
+        THERAPEUTIC_COOLDOWN,
+        MAINTAIN_BASELINE,
+        ENGORGEMENT,
+        DUAL_STIMULATION,
+        COOLDOWN,
+        CLITORAL_WARMUP,
+        CLITORAL_BUILDUP,
+        CLITORAL_CLIMAX,
+        CLITORAL_AFTERGLOW,
+        TENS_WARMUP,
+        TENS_BUILDUP,
+        TENS_CLIMAX,
+        TENS_AFTERGLOW,
+        CUSTOM              // Unrecognized action name; see actionName()
+    };
+
+    // Pressure trajectory across a step, t in [0, 1]
+    enum class Curve : uint8_t {
+        HOLD,               // Constant at the start value
+        LINEAR,
+        CUBIC,              // Smoothstep: zero slope at both ends
+        SINE,               // Half-cosine; chains of SINE steps trace a sinusoid
+        EASE_IN,            // Quadratic, slow start
+        EASE_OUT            // Quadratic, slow finish
+    };
+
+    // Anti-detachment response profile requested by a step
+    enum class SealProfile : uint8_t {
+        UNCHANGED,          // Leave the monitor as configured
+        CRITICAL,           // Fast, strong correction (climax/intensify)
+        RECOVERY            // Slow, gentle correction
+    };
+
+    enum StepFlag : uint8_t {
+        OSCILLATE = 0x01,           // Clitoral oscillator runs during this step
+        OSC_RETUNE = 0x02,          // Oscillator frequency/amplitude differ from the previous step
+        TENS_ON = 0x04,             // TENS stage runs during this step
+        TENS_RECONFIGURE = 0x08,    // TENS settings differ from the previous step
+        SEAL_CHANGED = 0x10,        // Seal profile differs from the previous step
+        PHASE_CHANGED = 0x20        // Action name differs from the previous step
+    };
+
+    struct Step {
+        double pressurePercent;     // Before intensity/offset adjustment
+        double endPressurePercent;  // Curve target at the end of the step
+        int32_t durationMs;         // Before speed adjustment
+        Curve curve;
+        Action action;
+        SealProfile sealProfile;
+        uint8_t flags;
+        uint8_t tensSync;           // TENSController::PhaseSync
+        uint16_t nameIndex;         // Into actionName()
+        int16_t tensPulseWidthUs;
+        float oscFrequencyHz;
+        float oscAmplitudeMmHg;
+        float tensFrequencyHz;
+        float tensAmplitudePercent;
+
+        bool has(StepFlag flag) const { return (flags & flag) != 0; }
+    };
+
+    void clear();
+    void reserve(int steps) { m_steps.reserve(steps); }
+
+    // Append a step; flags for OSC_RETUNE, TENS_RECONFIGURE, SEAL_CHANGED and
+    // PHASE_CHANGED are derived here from the previous step
+    void append(Step step, const QString& actionName);
+
+    int size() const { return m_steps.size(); }
+    bool isEmpty() const { return m_steps.isEmpty(); }
+    const Step& operator[](int index) const { return m_steps[index]; }
+    const Step* data() const { return m_steps.constData(); }
+
+    const QString& actionName(const Step& step) const { return m_actionNames[step.nameIndex]; }
+    qint64 totalDurationMs() const { return m_totalDurationMs; }
+
+    // Pressure at fraction t of the step
+    static double interpolate(Curve curve, double from, double to, double t);
+    static double pressureAt(const Step& step, double t)
+    {
+        return interpolate(step.curve, step.pressurePercent, step.endPressurePercent, t);
+    }
+
+    static Action actionFromName(const QString& name);
+    static SealProfile sealProfileFor(Action action);
+
+    static constexpr float OSC_FREQUENCY_TOLERANCE_HZ = 0.1f;
+    static constexpr float OSC_AMPLITUDE_TOLERANCE_MMHG = 1.0f;
+
+private:
+    QVector<Step> m_steps;
+    QStringList m_actionNames;
+    qint64 m_totalDurationMs = 0;
+};
+
+#endif // COMPILEDPATTERN_H
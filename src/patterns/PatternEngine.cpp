@@ -5,9 +5,9 @@
 #include "../hardware/TENSController.h"
 #include "../safety/AntiDetachmentMonitor.h"
 #include "../safety/SafetyConstants.h"
+#include "../performance/HotPathTrace.h"
 #include <QDebug>
 #include <QMutexLocker>
-#include <QDateTime>
 #include <QJsonDocument>
 #include <QFile>
 #include <cmath>
@@ -22,6 +22,17 @@ const double PatternEngine::MAX_PRESSURE_PERCENT = 90.0;
 const int PatternEngine::MIN_STEP_DURATION_MS = 100;
 const int PatternEngine::MAX_STEP_DURATION_MS = 60000;
 
+namespace {
+
+// Period of the legacy sampled variation sin(i * radiansPerStep) with one
+// sample every stepMs
+int sinePeriodMs(double radiansPerStep, int stepMs)
+{
+    return static_cast<int>(2.0 * M_PI / radiansPerStep * stepMs);
+}
+
+} // namespace
+
 PatternEngine::PatternEngine(HardwareManager* hardware, QObject *parent)
     : QObject(parent)
     , m_hardware(hardware)
@@ -31,14 +42,26 @@ PatternEngine::PatternEngine(HardwareManager* hardware, QObject *parent)
     , m_state(STOPPED)
     , m_currentPatternType(PULSE)
     , m_currentStep(0)
-    , m_patternStartTime(0)
-    , m_stepStartTime(0)
-    , m_pausedTime(0)
-    , m_totalPausedTime(0)
+    , m_patternStartNs(0)
+    , m_stepStartNs(0)
+    , m_stepDeadlineNs(0)
+    , m_pausedAtNs(0)
+    , m_totalPausedNs(0)
+    , m_cycleStartNs(0)
+    , m_lastCycleDriftNs(0)
+    , m_timelineSlipNs(0)
     , m_stepTimer(new QTimer(this))
-    , m_safetyTimer(new QTimer(this))
+    , m_safetyTimer(new ControlTimer(this))
+    , m_setpointTimer(new ControlTimer(this))
+    , m_lastAppliedPressure(0.0)
+    , m_pressureLoopTimer(new ControlTimer(this))
+    , m_closedLoopPressure(true)
+    , m_pressureLoopActive(false)
+    , m_lastPressureSequence(0)
+    , m_pressureLoopYielded(false)
     , m_emergencyStop(false)
     , m_infiniteLoop(false)
+    , m_pendingReapply(0)
     , m_completedCycles(0)
     , m_intensity(DEFAULT_INTENSITY)
     , m_speedMultiplier(DEFAULT_SPEED_MULTIPLIER)
@@ -49,10 +72,19 @@ PatternEngine::PatternEngine(HardwareManager* hardware, QObject *parent)
 {
     // Set up timers
     m_stepTimer->setSingleShot(true);
+    m_stepTimer->setTimerType(Qt::PreciseTimer);
     connect(m_stepTimer, &QTimer::timeout, this, &PatternEngine::onStepTimer);
 
     m_safetyTimer->setInterval(SAFETY_CHECK_INTERVAL_MS);
-    connect(m_safetyTimer, &QTimer::timeout, this, &PatternEngine::onSafetyCheck);
+    connect(m_safetyTimer, &ControlTimer::timeout, this, &PatternEngine::onSafetyCheck);
+
+    m_setpointTimer->setInterval(SETPOINT_INTERVAL_MS);
+    m_setpointTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_setpointTimer, &ControlTimer::timeout, this, &PatternEngine::onSetpointTick);
+
+    m_pressureLoopTimer->setInterval(PRESSURE_LOOP_INTERVAL_MS);
+    m_pressureLoopTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_pressureLoopTimer, &ControlTimer::timeout, this, &PatternEngine::onPressureLoopTick);
 
     // Initialize clitoral oscillator for dual-chamber patterns
     m_clitoralOscillator = new ClitoralOscillator(hardware, this);
@@ -99,6 +131,15 @@ PatternEngine::~PatternEngine()
     stopPattern();
 }
 
+void PatternEngine::attachToScheduler(ControlScheduler* scheduler, int offset)
+{
+    // Step timing stays on m_stepTimer: steps have per-step durations, not a fixed rate
+    m_safetyTimer->attach(scheduler, ControlScheduler::Stage::CONTROL, "PatternEngine.safety", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+    // Setpoint first, then the loop that tracks it (every cycle), within the same cycle
+    m_setpointTimer->attach(scheduler, ControlScheduler::Stage::CONTROL, "PatternEngine.setpoint", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+    m_pressureLoopTimer->attach(scheduler, ControlScheduler::Stage::ACTUATE, "PatternEngine.pressure");
+}
+
 bool PatternEngine::startPattern(const QString& patternName, const QJsonObject& parameters)
 {
     QMutexLocker locker(&m_stateMutex);
@@ -123,12 +164,25 @@ bool PatternEngine::startPattern(const QString& patternName, const QJsonObject&
         
         m_currentPatternName = patternName;
         m_currentStep = 0;
-        m_patternStartTime = QDateTime::currentMSecsSinceEpoch();
-        m_totalPausedTime = 0;
         m_emergencyStop = false;
+
+        // Every step deadline is an offset on this monotonic timeline
+        m_patternStartNs = nowNs();
+        m_stepDeadlineNs = m_patternStartNs;
+        m_cycleStartNs = m_patternStartNs;
+        m_totalPausedNs = 0;
+        m_lastCycleDriftNs = 0;
+        m_timelineSlipNs = 0;
+        m_pendingReapply = 0;
+        m_stepTiming.reset();
+        m_lastAppliedPressure = 0.0;
+        m_pressureLoopActive = false;
+        m_pressureController.resetMetrics();
         
-        // Start safety monitoring
+        // Start safety monitoring, the setpoint generator and the pressure loop
         m_safetyTimer->start();
+        m_setpointTimer->start();
+        m_pressureLoopTimer->start();
 
         // Start anti-detachment monitoring if available
         if (m_antiDetachmentMonitor && !m_antiDetachmentMonitor->isActive()) {
@@ -169,6 +223,9 @@ void PatternEngine::stopPattern()
     // Stop timers
     m_stepTimer->stop();
     m_safetyTimer->stop();
+    m_setpointTimer->stop();
+    m_pressureLoopTimer->stop();
+    m_pressureLoopActive = false;
 
     // Stop anti-detachment monitoring
     if (m_antiDetachmentMonitor && m_antiDetachmentMonitor->isActive()) {
@@ -202,6 +259,7 @@ void PatternEngine::stopPattern()
     
     // Clear pattern data
     m_patternSteps.clear();
+    m_compiledPattern.clear();
     m_currentStep = 0;
     m_currentPatternName.clear();
     
@@ -217,13 +275,17 @@ void PatternEngine::pausePattern()
     
     if (m_state != RUNNING) return;
     
-    m_pausedTime = QDateTime::currentMSecsSinceEpoch();
+    m_pausedAtNs = nowNs();
     m_stepTimer->stop();
+    m_setpointTimer->stop();
+    m_pressureLoopTimer->stop();
+    m_pressureLoopActive = false;
     
     // Set hardware to hold state
     if (m_hardware) {
         m_hardware->setPumpSpeed(0.0);
     }
+    m_lastAppliedPressure = 0.0;
     
     setState(PAUSED);
     emit patternPaused();
@@ -237,14 +299,22 @@ void PatternEngine::resumePattern()
     
     if (m_state != PAUSED) return;
     
-    // Calculate paused duration
-    qint64 pauseDuration = QDateTime::currentMSecsSinceEpoch() - m_pausedTime;
-    m_totalPausedTime += pauseDuration;
-    
-    // Resume step timer with remaining time
-    if (m_currentStep < m_patternSteps.size()) {
-        executeNextStep();
+    // Shift the remaining timeline by the pause so the current step gets
+    // back exactly the time it had left
+    const int64_t pauseNs = nowNs() - m_pausedAtNs;
+    m_totalPausedNs += pauseNs;
+    m_stepStartNs += pauseNs;
+    m_stepDeadlineNs += pauseNs;
+    m_cycleStartNs += pauseNs;
+    m_pausedAtNs = 0;
+
+    // Restore the step's outputs (pause dropped the pump) and its deadline
+    if (m_currentStep < m_compiledPattern.size()) {
+        executeStep(m_compiledPattern[m_currentStep]);
+        armStepTimer();
     }
+    m_setpointTimer->start();
+    m_pressureLoopTimer->start();
     
     setState(RUNNING);
     emit patternResumed();
@@ -252,6 +322,12 @@ void PatternEngine::resumePattern()
     qDebug() << "Pattern resumed";
 }
 
+void PatternEngine::invalidateAppliedOutputs()
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_pendingReapply = OUTPUT_CHANGE_FLAGS;
+}
+
 void PatternEngine::emergencyStop()
 {
     QMutexLocker locker(&m_stateMutex);
@@ -263,6 +339,9 @@ void PatternEngine::emergencyStop()
     // Immediately stop all timers
     m_stepTimer->stop();
     m_safetyTimer->stop();
+    m_setpointTimer->stop();
+    m_pressureLoopTimer->stop();
+    m_pressureLoopActive = false;
 
     // Stop clitoral oscillator immediately
     if (m_clitoralOscillator && m_clitoralOscillator->isRunning()) {
@@ -314,6 +393,8 @@ bool PatternEngine::initializePattern(const QString& patternName, const QJsonObj
     else if (typeStr == "continuous orgasm") m_currentPatternType = CONTINUOUS_ORGASM;
     else if (typeStr == "edging") m_currentPatternType = EDGING;
     else m_currentPatternType = CUSTOM;
+
+    compilePatternSteps();
     
     return true;
 }
@@ -321,6 +402,7 @@ bool PatternEngine::initializePattern(const QString& patternName, const QJsonObj
 void PatternEngine::buildPatternSteps(const QJsonObject& patternData)
 {
     m_patternSteps.clear();
+    m_infiniteLoop = false;     // Only looping builders set it
     
     QString type = patternData["type"].toString().toLower();
     
@@ -373,13 +455,10 @@ void PatternEngine::buildWavePattern(const QJsonObject& params)
     double minPressure = params["min_pressure_percent"].toDouble(30.0);
     double maxPressure = params["max_pressure_percent"].toDouble(70.0);
     
-    // Create wave pattern with 20 steps per cycle
-    int stepDuration = period / 20;
-    for (int i = 0; i < 20; ++i) {
-        double angle = (i * 2.0 * M_PI) / 20.0;
-        double pressure = minPressure + (maxPressure - minPressure) * (sin(angle) + 1.0) / 2.0;
-        m_patternSteps.append(PatternStep(pressure, stepDuration, "vacuum"));
-    }
+    // One sine period between the limits, traced by the setpoint generator
+    double midPressure = (minPressure + maxPressure) / 2.0;
+    appendSineKeyframes("vacuum", midPressure, midPressure, (maxPressure - minPressure) / 2.0,
+                        period, period);
 }
 
 void PatternEngine::buildAirPulsePattern(const QJsonObject& params)
@@ -462,15 +541,9 @@ void PatternEngine::buildConstantPattern(const QJsonObject& params)
 {
     double basePressure = params["base_pressure_percent"].toDouble(70.0);
     double variation = params["variation_percent"].toDouble(15.0);
-    int variationPeriod = params["variation_period_ms"].toInt(3000);
     
-    // Create constant pattern with variations (30 seconds total)
-    int steps = 30000 / variationPeriod;
-    for (int i = 0; i < steps; ++i) {
-        double variationAmount = variation * sin(i * 2.0 * M_PI / steps);
-        double pressure = basePressure + variationAmount;
-        m_patternSteps.append(PatternStep(pressure, variationPeriod, "vacuum"));
-    }
+    // Create constant pattern with one slow variation (30 seconds total)
+    appendSineKeyframes("vacuum", basePressure, basePressure, variation, 30000, 30000);
 }
 
 void PatternEngine::buildEdgingPattern(const QJsonObject& params)
@@ -483,13 +556,9 @@ void PatternEngine::buildEdgingPattern(const QJsonObject& params)
     
     // Create edging pattern
     for (int cycle = 0; cycle < cycles; ++cycle) {
-        // Buildup phase
-        int buildupSteps = buildupDuration / 1000;  // 1 second per step
-        for (int i = 0; i < buildupSteps; ++i) {
-            double progress = static_cast<double>(i) / buildupSteps;
-            double pressure = peakPressure * progress;
-            m_patternSteps.append(PatternStep(pressure, 1000, "vacuum"));
-        }
+        // Buildup phase: linear ramp to the peak
+        m_patternSteps.append(PatternStep(0.0, buildupDuration, "vacuum",
+                                          CompiledPattern::Curve::LINEAR, peakPressure));
         
         // Release phase
         m_patternSteps.append(PatternStep(0.0, releaseDuration, "release"));
@@ -561,80 +630,52 @@ void PatternEngine::buildAutomatedOrgasmPattern(const QJsonObject& params)
         // 10 seconds gentle start
         double startPressure = initialIntensity;
         double rampTarget = 55.0 + (cycle * 5.0);
-        int rampSteps = 5;  // 2-second steps
-        for (int i = 0; i < rampSteps; ++i) {
-            double progress = static_cast<double>(i) / rampSteps;
-            double pressure = startPressure + (rampTarget - startPressure) * progress;
-            m_patternSteps.append(PatternStep(pressure, 2000, "gentle_ramp"));
-        }
+        m_patternSteps.append(PatternStep(startPressure, 10000, "gentle_ramp",
+                                          CompiledPattern::Curve::LINEAR, rampTarget));
 
         // 20 seconds moderate steady
         double moderatePressure = rampTarget;
-        for (int i = 0; i < 10; ++i) {  // 2-second steps
-            double variation = 5.0 * sin(i * 0.6);  // Gentle variation
-            m_patternSteps.append(PatternStep(moderatePressure + variation, 2000, "steady_moderate"));
-        }
+        appendSineKeyframes("steady_moderate", moderatePressure, moderatePressure,
+                            5.0, sinePeriodMs(0.6, 2000), 20000);  // Gentle variation
 
         // Phase 2: Adaptation Period (30 seconds - 2 minutes) - Consistent moderate
         double adaptationPressure = 60.0 + (cycle * 5.0);
-        int adaptationSteps = 45;  // 2-second steps for 90 seconds
-        for (int i = 0; i < adaptationSteps; ++i) {
-            double variation = 8.0 * sin(i * 0.4);  // Slow variation
-            m_patternSteps.append(PatternStep(adaptationPressure + variation, 2000, "adaptation_steady"));
-        }
+        appendSineKeyframes("adaptation_steady", adaptationPressure, adaptationPressure,
+                            8.0, sinePeriodMs(0.4, 2000), 90000);  // Slow variation
 
         // Phase 3: Arousal Build-up (2-4 minutes) - Gradual intensity increase
         // Phase 3a: Early buildup (60 seconds)
         double buildupStart = 60.0 + (cycle * 5.0);
         double buildupMid = 75.0 + (cycle * 5.0);
-        int buildup1Steps = 30;  // 2-second steps
-        for (int i = 0; i < buildup1Steps; ++i) {
-            double progress = static_cast<double>(i) / buildup1Steps;
-            double pressure = buildupStart + (buildupMid - buildupStart) * progress;
-            double variation = 10.0 * sin(i * 0.5);
-            m_patternSteps.append(PatternStep(pressure + variation, 2000, "arousal_buildup"));
-        }
+        appendSineKeyframes("arousal_buildup", buildupStart, buildupMid,
+                            10.0, sinePeriodMs(0.5, 2000), 60000);
 
         // Phase 3b: Intensifying buildup (60 seconds)
         double buildupEnd = 85.0 + (cycle * 3.0);  // Cap at reasonable level
-        int buildup2Steps = 30;  // 2-second steps
-        for (int i = 0; i < buildup2Steps; ++i) {
-            double progress = static_cast<double>(i) / buildup2Steps;
-            double pressure = buildupMid + (buildupEnd - buildupMid) * progress;
-            double variation = 12.0 * sin(i * 0.6);
-            m_patternSteps.append(PatternStep(pressure + variation, 2000, "arousal_intensify"));
-        }
+        appendSineKeyframes("arousal_intensify", buildupMid, buildupEnd,
+                            12.0, sinePeriodMs(0.6, 2000), 60000);
 
         // Phase 4: Pre-climax Tension (4-5 minutes) - Maintain precise stimulation
         double climaxPressure = std::min(85.0 + (cycle * 3.0), 90.0);  // Cap at 90%
         int climaxDuration = (cycle == cycles - 1) ? 75000 : 60000;  // Longer final climax
-        int climaxSteps = climaxDuration / 1500;  // 1.5-second steps for precision
-        for (int i = 0; i < climaxSteps; ++i) {
-            double variation = 8.0 * sin(i * 0.8);  // Faster variation for climax
-            m_patternSteps.append(PatternStep(climaxPressure + variation, 1500, "climax_maintain"));
-        }
+        appendSineKeyframes("climax_maintain", climaxPressure, climaxPressure,
+                            8.0, sinePeriodMs(0.8, 1500), climaxDuration);  // Faster variation for climax
 
         // Recovery period between cycles (except after last cycle)
         if (cycle < cycles - 1) {
             double recoveryPressure = 30.0 - (cycle * 5.0);  // Gentler each time
             recoveryPressure = std::max(recoveryPressure, 20.0);  // Minimum 20%
             int recoveryDuration = (cycle == 0) ? 45000 : 60000;  // Longer recovery after first
-            int recoverySteps = recoveryDuration / 5000;  // 5-second steps
-            for (int i = 0; i < recoverySteps; ++i) {
-                double variation = 3.0 * sin(i * 0.3);  // Very gentle variation
-                m_patternSteps.append(PatternStep(recoveryPressure + variation, 5000, "post_climax_recovery"));
-            }
+            appendSineKeyframes("post_climax_recovery", recoveryPressure, recoveryPressure,
+                                3.0, sinePeriodMs(0.3, 5000), recoveryDuration);  // Very gentle variation
         }
     }
 
     // Final cooldown for multi-cycle patterns
     if (isMultiCycle) {
         double cooldownPressure = 20.0;
-        int cooldownSteps = 18;  // 90 seconds / 5 seconds per step
-        for (int i = 0; i < cooldownSteps; ++i) {
-            double variation = 2.0 * sin(i * 0.2);  // Minimal variation
-            m_patternSteps.append(PatternStep(cooldownPressure + variation, 5000, "final_recovery"));
-        }
+        appendSineKeyframes("final_recovery", cooldownPressure, cooldownPressure,
+                            2.0, sinePeriodMs(0.2, 5000), 90000);  // Minimal variation
     }
 }
 
@@ -650,92 +691,102 @@ void PatternEngine::buildContinuousOrgasmPattern(const QJsonObject& params)
     // 5 seconds quick ramp
     double startPressure = 40.0;  // Higher start for continuous mode
     double rampTarget = 60.0;
-    int rampSteps = 3;  // Faster ramp for continuous operation
-    for (int i = 0; i < rampSteps; ++i) {
-        double progress = static_cast<double>(i) / rampSteps;
-        double pressure = startPressure + (rampTarget - startPressure) * progress;
-        m_patternSteps.append(PatternStep(pressure, 1500, "continuous_gentle_ramp"));
-    }
+    m_patternSteps.append(PatternStep(startPressure, 4500, "continuous_gentle_ramp",
+                                      CompiledPattern::Curve::LINEAR, rampTarget));
 
     // 10 seconds quick settling
-    for (int i = 0; i < 5; ++i) {  // 2-second steps
-        double variation = 6.0 * sin(i * 0.8);
-        m_patternSteps.append(PatternStep(60.0 + variation, 2000, "continuous_steady_moderate"));
-    }
+    appendSineKeyframes("continuous_steady_moderate", rampTarget, rampTarget,
+                        6.0, sinePeriodMs(0.8, 2000), 10000);
 
     // Phase 2: Rapid Adaptation (15-45 seconds) - 30 seconds total
     double adaptationPressure = 65.0;  // Higher for continuous mode
-    int adaptationSteps = 15;  // 2-second steps for 30 seconds
-    for (int i = 0; i < adaptationSteps; ++i) {
-        double variation = 10.0 * sin(i * 0.5);
-        m_patternSteps.append(PatternStep(adaptationPressure + variation, 2000, "continuous_adaptation"));
-    }
+    appendSineKeyframes("continuous_adaptation", adaptationPressure, adaptationPressure,
+                        10.0, sinePeriodMs(0.5, 2000), 30000);
 
     // Phase 3: Accelerated Buildup (45 seconds - 2 minutes) - 75 seconds total
     // Phase 3a: Rapid buildup (30 seconds)
     double buildupStart = 65.0;
     double buildupMid = 80.0;
-    int buildup1Steps = 15;  // 2-second steps
-    for (int i = 0; i < buildup1Steps; ++i) {
-        double progress = static_cast<double>(i) / buildup1Steps;
-        double pressure = buildupStart + (buildupMid - buildupStart) * progress;
-        double variation = 12.0 * sin(i * 0.6);
-        m_patternSteps.append(PatternStep(pressure + variation, 2000, "continuous_arousal_buildup"));
-    }
+    appendSineKeyframes("continuous_arousal_buildup", buildupStart, buildupMid,
+                        12.0, sinePeriodMs(0.6, 2000), 30000);
 
     // Phase 3b: Rapid intensification (45 seconds)
     double buildupEnd = 88.0;  // Higher peak for continuous mode
-    int buildup2Steps = 23;  // ~2-second steps
-    for (int i = 0; i < buildup2Steps; ++i) {
-        double progress = static_cast<double>(i) / buildup2Steps;
-        double pressure = buildupMid + (buildupEnd - buildupMid) * progress;
-        double variation = 15.0 * sin(i * 0.7);
-        m_patternSteps.append(PatternStep(pressure + variation, 2000, "continuous_arousal_intensify"));
-    }
+    appendSineKeyframes("continuous_arousal_intensify", buildupMid, buildupEnd,
+                        15.0, sinePeriodMs(0.7, 2000), 46000);
 
     // Phase 4: Extended Climax (2-3.5 minutes) - 90 seconds
     double climaxPressure = 88.0;
-    int climaxSteps = 75;  // 1.2-second steps for precision during extended climax
-    for (int i = 0; i < climaxSteps; ++i) {
-        double variation = 10.0 * sin(i * 0.9);  // Faster variation for continuous climax
-        m_patternSteps.append(PatternStep(climaxPressure + variation, 1200, "continuous_climax_maintain"));
-    }
+    appendSineKeyframes("continuous_climax_maintain", climaxPressure, climaxPressure,
+                        10.0, sinePeriodMs(0.9, 1200), 90000);  // Faster variation for continuous climax
 
     // Brief Recovery/Transition (3.5-4 minutes) - 30 seconds
     double recoveryPressure = 45.0;  // Higher than normal recovery for continuous flow
-    int recoverySteps = 6;  // 5-second steps
-    for (int i = 0; i < recoverySteps; ++i) {
-        double variation = 8.0 * sin(i * 0.4);
-        m_patternSteps.append(PatternStep(recoveryPressure + variation, 5000, "continuous_brief_recovery"));
-    }
+    appendSineKeyframes("continuous_brief_recovery", recoveryPressure, recoveryPressure,
+                        8.0, sinePeriodMs(0.4, 5000), 30000);
 
     qDebug() << QString("Continuous orgasm pattern built: %1 steps, %2 minute cycles")
                 .arg(m_patternSteps.size()).arg(4.0);
 }
 
+void PatternEngine::appendSineKeyframes(const QString& action, double startBase, double endBase,
+                                        double amplitude, int periodMs, int durationMs)
+{
+    // One keyframe at the start and one at every extreme of the sinusoid;
+    // the SINE curve between extremes is the half-cosine that joins them, so
+    // the setpoint generator reproduces the waveform from a handful of steps.
+    // A short closing keyframe on the midline ends the phase, so a final
+    // phase settles at endBase instead of holding the last extreme; it runs
+    // into whatever keyframe follows the phase.
+    const int quarterMs = std::max(MIN_STEP_DURATION_MS, periodMs / 4);
+    const int closingMs = (durationMs >= 2 * MIN_STEP_DURATION_MS) ? MIN_STEP_DURATION_MS : 0;
+    const int bodyMs = durationMs - closingMs;
+    int timeMs = 0;
+    int extreme = 0;
+
+    while (timeMs < bodyMs) {
+        const double base = startBase + (endBase - startBase) * timeMs / durationMs;
+        const double offset = (extreme == 0) ? 0.0 : ((extreme % 2) ? amplitude : -amplitude);
+
+        int segmentMs = std::min((extreme == 0) ? quarterMs : 2 * quarterMs, MAX_STEP_DURATION_MS);
+        if (bodyMs - (timeMs + segmentMs) < MIN_STEP_DURATION_MS) {
+            segmentMs = bodyMs - timeMs;        // Fold a too-short remainder into this segment
+        }
+
+        m_patternSteps.append(PatternStep(base + offset, segmentMs, action, CompiledPattern::Curve::SINE));
+        timeMs += segmentMs;
+        extreme++;
+    }
+
+    if (closingMs > 0) {
+        m_patternSteps.append(PatternStep(endBase, closingMs, action, CompiledPattern::Curve::SINE));
+    }
+}
+
 void PatternEngine::executeNextStep()
 {
-    if (m_currentStep >= m_patternSteps.size()) {
+    const int64_t currentNs = nowNs();
+
+    if (m_currentStep >= m_compiledPattern.size()) {
         // Check if this is an infinite loop pattern (continuous orgasm)
         if (m_infiniteLoop && m_currentPatternType == CONTINUOUS_ORGASM) {
             // Reset to beginning for continuous cycling
             m_currentStep = 0;
             m_completedCycles++;
 
-            qDebug() << QString("Continuous Orgasm: Starting cycle %1").arg(m_completedCycles + 1);
+            // The boundary is scheduled on the absolute timeline, so its
+            // lateness plus what stalls re-anchored away is the total drift
+            // accumulated since the pattern began
+            m_lastCycleDriftNs = currentNs - m_stepDeadlineNs + m_timelineSlipNs;
+            const double cycleMs = (currentNs - m_cycleStartNs) / 1e6;    // Measured, pauses excluded
+            m_cycleStartNs = currentNs;
+
+            qDebug() << QString("Continuous Orgasm: Starting cycle %1 (cycle %2 ms, drift %3 ms)")
+                        .arg(m_completedCycles + 1)
+                        .arg(cycleMs, 0, 'f', 1)
+                        .arg(m_lastCycleDriftNs / 1e6, 0, 'f', 3);
             emit cycleCompleted(m_completedCycles);
-
-            // Continue with first step of next cycle
-            const PatternStep& step = m_patternSteps[m_currentStep];
-            executeStep(step);
-
-            int adjustedDuration = applySpeedMultiplier(step.durationMs);
-            m_stepTimer->start(adjustedDuration);
-            m_stepStartTime = QDateTime::currentMSecsSinceEpoch();
-
-            emit stepChanged(m_currentStep, m_patternSteps.size());
-            emit progressUpdated(getProgress());
-            return;
+            emit cycleTimingReport(m_completedCycles, cycleMs, m_lastCycleDriftNs / 1e6);
         } else {
             // Pattern completed normally
             setState(STOPPED);
@@ -744,19 +795,40 @@ void PatternEngine::executeNextStep()
         }
     }
     
-    const PatternStep& step = m_patternSteps[m_currentStep];
+    const CompiledPattern::Step& step = m_compiledPattern[m_currentStep];
+    const int64_t durationNs = static_cast<int64_t>(applySpeedMultiplier(step.durationMs)) * 1000000;
+
+    // This step starts where the previous one was scheduled to end, not when
+    // we got here. A stall longer than a whole step re-anchors the timeline
+    // instead of bursting through the missed steps; the slip still counts
+    // toward the cycle drift.
+    m_stepStartNs = m_stepDeadlineNs;
+    if (currentNs - m_stepStartNs > durationNs) {
+        m_stepTiming.recordOverrun();
+        m_timelineSlipNs += currentNs - m_stepStartNs;
+        m_stepStartNs = currentNs;
+    }
+    m_stepDeadlineNs = m_stepStartNs + durationNs;
+
     executeStep(step);
+    armStepTimer();
     
-    // Set timer for next step
-    int adjustedDuration = applySpeedMultiplier(step.durationMs);
-    m_stepTimer->start(adjustedDuration);
-    m_stepStartTime = QDateTime::currentMSecsSinceEpoch();
-    
-    emit stepChanged(m_currentStep, m_patternSteps.size());
+    emit stepChanged(m_currentStep, m_compiledPattern.size());
     emit progressUpdated(getProgress());
 }
 
-void PatternEngine::executeStep(const PatternStep& step)
+void PatternEngine::armStepTimer()
+{
+    if (m_virtualClock) return;     // Driven by runDueSteps()
+
+    // Wake slightly early; onStepTimer() finishes the wait precisely. Round
+    // up, so a sub-millisecond lead never becomes start(0) and spins
+    // through the event loop.
+    const int64_t leadNs = m_stepDeadlineNs - nowNs() - STEP_TIMER_LEAD_NS;
+    m_stepTimer->start(leadNs > 0 ? static_cast<int>((leadNs + 999999) / 1000000) : 0);
+}
+
+void PatternEngine::executeStep(const CompiledPattern::Step& step)
 {
     // === DUAL-CHAMBER CONTROL ARCHITECTURE ===
     // This function coordinates two independent control loops:
@@ -779,27 +851,34 @@ void PatternEngine::executeStep(const PatternStep& step)
 
     if (!m_hardware) return;
 
+    // Change flags only describe the step against the previous one; after
+    // a hardware reset or a failed apply the outputs are re-established in
+    // full. A bit stays pending until its apply succeeds.
+    const uint8_t reapply = m_pendingReapply;
+    m_pendingReapply = 0;
+    auto needs = [&step, reapply](CompiledPattern::StepFlag flag) {
+        return step.has(flag) || (reapply & flag) != 0;
+    };
+
     try {
-        double adjustedPressure = applyIntensityAndOffset(step.pressurePercent);
+        // Normally t = 0; after a resume the keyframe picks up mid-curve
+        double adjustedPressure = applyIntensityAndOffset(CompiledPattern::pressureAt(step, stepProgress()));
 
         // Enhanced anti-detachment handling for automated orgasm patterns
-        if (m_currentPatternType == AUTOMATED_ORGASM || m_currentPatternType == MULTI_CYCLE_ORGASM ||
-            m_currentPatternType == CONTINUOUS_ORGASM) {
-            // Set anti-detachment sensitivity based on phase
-            if (step.action == "climax_maintain" || step.action == "arousal_intensify" ||
-                step.action == "continuous_climax_maintain" || step.action == "continuous_arousal_intensify") {
+        if ((m_currentPatternType == AUTOMATED_ORGASM || m_currentPatternType == MULTI_CYCLE_ORGASM ||
+             m_currentPatternType == CONTINUOUS_ORGASM) &&
+            needs(CompiledPattern::SEAL_CHANGED)) {
+            if (!m_antiDetachmentMonitor || step.sealProfile == CompiledPattern::SealProfile::UNCHANGED) {
+                // Nothing applied; the next step with a profile applies it
+                m_pendingReapply |= CompiledPattern::SEAL_CHANGED;
+            } else if (step.sealProfile == CompiledPattern::SealProfile::CRITICAL) {
                 // Maximum anti-detachment sensitivity during critical phases
-                if (m_antiDetachmentMonitor) {
-                    m_antiDetachmentMonitor->setResponseDelay(25);  // Faster response (25ms)
-                    m_antiDetachmentMonitor->setMaxVacuumIncrease(30.0);  // Higher correction (30%)
-                }
-            } else if (step.action == "post_climax_recovery" || step.action == "final_recovery" ||
-                       step.action == "continuous_brief_recovery") {
+                m_antiDetachmentMonitor->setResponseDelay(25);  // Faster response (25ms)
+                m_antiDetachmentMonitor->setMaxVacuumIncrease(30.0);  // Higher correction (30%)
+            } else if (step.sealProfile == CompiledPattern::SealProfile::RECOVERY) {
                 // Gentle anti-detachment during recovery
-                if (m_antiDetachmentMonitor) {
-                    m_antiDetachmentMonitor->setResponseDelay(150);  // Slower response (150ms)
-                    m_antiDetachmentMonitor->setMaxVacuumIncrease(15.0);  // Gentler correction (15%)
-                }
+                m_antiDetachmentMonitor->setResponseDelay(150);  // Slower response (150ms)
+                m_antiDetachmentMonitor->setMaxVacuumIncrease(15.0);  // Gentler correction (15%)
             }
         }
 
@@ -807,72 +886,67 @@ void PatternEngine::executeStep(const PatternStep& step)
         if (m_currentPatternType == DUAL_CHAMBER || m_currentPatternType == CLITORAL_ONLY ||
             m_currentPatternType == TENS_VACUUM || m_currentPatternType == AIR_PULSE) {
 
-            bool enableOscillation = step.parameters.value("clitoral_oscillation").toBool(false);
+            bool enableOscillation = step.has(CompiledPattern::OSCILLATE);
 
             if (enableOscillation && m_clitoralOscillator) {
-                // Configure oscillator from step parameters
-                double freq = step.parameters.value("clitoral_frequency").toDouble(8.0);
-                double amp = step.parameters.value("clitoral_amplitude").toDouble(40.0);
-
-                // Real-time parameter updates: Only update if values changed significantly
-                // This prevents unnecessary valve reconfiguration during running oscillation
-                if (m_clitoralOscillator->isRunning()) {
-                    // Update frequency if changed by more than 0.1 Hz
-                    if (std::abs(m_clitoralOscillator->getFrequency() - freq) > 0.1) {
-                        m_clitoralOscillator->setFrequency(freq);
-                        qDebug() << "Clitoral frequency updated to" << freq << "Hz";
-                    }
-                    // Update amplitude if changed by more than 1.0 mmHg
-                    if (std::abs(m_clitoralOscillator->getAmplitude() - amp) > 1.0) {
-                        m_clitoralOscillator->setAmplitude(amp);
-                        qDebug() << "Clitoral amplitude updated to" << amp << "mmHg";
-                    }
-                } else {
+                double freq = step.oscFrequencyHz;
+                double amp = step.oscAmplitudeMmHg;
+
+                if (!m_clitoralOscillator->isRunning()) {
                     // First time starting - set parameters and start
                     m_clitoralOscillator->setFrequency(freq);
                     m_clitoralOscillator->setAmplitude(amp);
                     m_clitoralOscillator->start();
-                    qDebug() << "Clitoral oscillation started:" << freq << "Hz," << amp << "mmHg";
+                    if (!m_clitoralOscillator->isRunning()) {
+                        m_pendingReapply |= CompiledPattern::OSC_RETUNE;
+                    }
+                    VC_TRACE(HotPathTrace::PATTERN, HotPathTrace::LEVEL_INFO, "pattern.osc.start", m_currentStep, freq, amp);
+                } else if (needs(CompiledPattern::OSC_RETUNE)) {
+                    // Only reconfigure valves when the compiled pattern changes the
+                    // settings, or unconditionally when they must be re-established
+                    const bool force = (reapply & CompiledPattern::OSC_RETUNE) != 0;
+                    if (force || std::abs(m_clitoralOscillator->getFrequency() - freq) > CompiledPattern::OSC_FREQUENCY_TOLERANCE_HZ) {
+                        m_clitoralOscillator->setFrequency(freq);
+                        VC_TRACE(HotPathTrace::PATTERN, HotPathTrace::LEVEL_DEBUG, "pattern.osc.frequency", m_currentStep, freq);
+                    }
+                    if (force || std::abs(m_clitoralOscillator->getAmplitude() - amp) > CompiledPattern::OSC_AMPLITUDE_TOLERANCE_MMHG) {
+                        m_clitoralOscillator->setAmplitude(amp);
+                        VC_TRACE(HotPathTrace::PATTERN, HotPathTrace::LEVEL_DEBUG, "pattern.osc.amplitude", m_currentStep, amp);
+                    }
                 }
             } else if (!enableOscillation && m_clitoralOscillator && m_clitoralOscillator->isRunning()) {
                 m_clitoralOscillator->stop();
-                qDebug() << "Clitoral oscillation stopped for phase:" << step.action;
+                VC_TRACE(HotPathTrace::PATTERN, HotPathTrace::LEVEL_INFO, "pattern.osc.stop", m_currentStep);
             }
         }
 
         // Handle TENS stimulation for TENS+Vacuum patterns
         if (m_currentPatternType == TENS_VACUUM && m_tensController) {
-            bool enableTENS = step.parameters.value("tens_enabled").toBool(false);
+            bool enableTENS = step.has(CompiledPattern::TENS_ON);
 
             if (enableTENS) {
-                // Configure TENS from step parameters
-                double tensFreq = step.parameters.value("tens_frequency").toDouble(20.0);
-                int pulseWidth = step.parameters.value("tens_pulse_width").toInt(400);
-                double tensAmp = step.parameters.value("tens_amplitude").toDouble(40.0);
-                QString syncMode = step.parameters.value("tens_sync").toString("continuous");
-
-                m_tensController->setFrequency(tensFreq);
-                m_tensController->setPulseWidth(pulseWidth);
-                m_tensController->setAmplitude(tensAmp);
-
-                // Set phase synchronization mode
-                if (syncMode == "sync_suction") {
-                    m_tensController->setPhaseSync(TENSController::PhaseSync::SYNC_SUCTION);
-                } else if (syncMode == "sync_vent") {
-                    m_tensController->setPhaseSync(TENSController::PhaseSync::SYNC_VENT);
-                } else if (syncMode == "alternating") {
-                    m_tensController->setPhaseSync(TENSController::PhaseSync::ALTERNATING);
-                } else {
-                    m_tensController->setPhaseSync(TENSController::PhaseSync::CONTINUOUS);
+                // A stopped stage may have been emergency-stopped (amplitude
+                // zeroed) since the settings were last sent, so every start
+                // sends them again
+                if (needs(CompiledPattern::TENS_RECONFIGURE) || !m_tensController->isRunning()) {
+                    m_tensController->setFrequency(step.tensFrequencyHz);
+                    m_tensController->setPulseWidth(step.tensPulseWidthUs);
+                    m_tensController->setAmplitude(step.tensAmplitudePercent);
+                    m_tensController->setPhaseSync(static_cast<TENSController::PhaseSync>(step.tensSync));
                 }
 
                 if (!m_tensController->isRunning()) {
                     m_tensController->start();
-                    qDebug() << "TENS started:" << tensFreq << "Hz," << pulseWidth << "μs," << tensAmp << "%";
+                    if (m_tensController->isRunning()) {
+                        qDebug() << "TENS started:" << step.tensFrequencyHz << "Hz," << step.tensPulseWidthUs
+                                 << "μs," << step.tensAmplitudePercent << "%";
+                    } else {
+                        m_pendingReapply |= CompiledPattern::TENS_RECONFIGURE;
+                    }
                 }
-            } else if (!enableTENS && m_tensController->isRunning()) {
+            } else if (m_tensController->isRunning()) {
                 m_tensController->stop();
-                qDebug() << "TENS stopped for phase:" << step.action;
+                qDebug() << "TENS stopped for phase:" << m_compiledPattern.actionName(step);
             }
         }
 
@@ -881,49 +955,116 @@ void PatternEngine::executeStep(const PatternStep& step)
 
         emit pressureTargetChanged(adjustedPressure);
 
-        // Log phase transitions for automated orgasm patterns
-        if (m_currentPatternType == AUTOMATED_ORGASM || m_currentPatternType == MULTI_CYCLE_ORGASM ||
-            m_currentPatternType == CONTINUOUS_ORGASM) {
-            static QString lastAction;
-            if (step.action != lastAction) {
+        // Log phase transitions
+        if (step.has(CompiledPattern::PHASE_CHANGED)) {
+            if (m_currentPatternType == AUTOMATED_ORGASM || m_currentPatternType == MULTI_CYCLE_ORGASM ||
+                m_currentPatternType == CONTINUOUS_ORGASM) {
                 qDebug() << QString("Automated Orgasm Phase: %1 - Pressure: %2%")
-                            .arg(step.action).arg(adjustedPressure, 0, 'f', 1);
-                lastAction = step.action;
-            }
-        }
-
-        // Log phase transitions for dual-chamber and TENS patterns
-        if (m_currentPatternType == DUAL_CHAMBER || m_currentPatternType == CLITORAL_ONLY ||
-            m_currentPatternType == TENS_VACUUM) {
-            static QString lastDualAction;
-            if (step.action != lastDualAction) {
+                            .arg(m_compiledPattern.actionName(step)).arg(adjustedPressure, 0, 'f', 1);
+            } else if (m_currentPatternType == DUAL_CHAMBER || m_currentPatternType == CLITORAL_ONLY ||
+                       m_currentPatternType == TENS_VACUUM) {
                 bool oscillating = m_clitoralOscillator && m_clitoralOscillator->isRunning();
                 bool tensActive = m_tensController && m_tensController->isRunning();
                 if (m_currentPatternType == TENS_VACUUM) {
                     qDebug() << QString("TENS+Vacuum Phase: %1 - Outer: %2% - Clitoral: %3 - TENS: %4")
-                                .arg(step.action)
+                                .arg(m_compiledPattern.actionName(step))
                                 .arg(adjustedPressure, 0, 'f', 1)
                                 .arg(oscillating ? "oscillating" : "off")
                                 .arg(tensActive ? "active" : "off");
                 } else {
                     qDebug() << QString("Dual-Chamber Phase: %1 - Outer: %2% - Clitoral: %3")
-                                .arg(step.action)
+                                .arg(m_compiledPattern.actionName(step))
                                 .arg(adjustedPressure, 0, 'f', 1)
                                 .arg(oscillating ? "oscillating" : "off");
                 }
-                lastDualAction = step.action;
             }
         }
 
     } catch (const std::exception& e) {
         qWarning() << "Error executing step:" << e.what();
+        m_pendingReapply |= OUTPUT_CHANGE_FLAGS;
+    }
+}
+
+void PatternEngine::compilePatternSteps()
+{
+    // Resolve every string and JSON lookup once; execution only reads PODs
+    m_compiledPattern.clear();
+    m_compiledPattern.reserve(m_patternSteps.size());
+
+    for (int i = 0; i < m_patternSteps.size(); ++i) {
+        const PatternStep& source = m_patternSteps[i];
+        CompiledPattern::Step step = {};
+        step.pressurePercent = source.pressurePercent;
+        step.durationMs = source.durationMs;
+        step.curve = source.curve;
+
+        // Curves end at an explicit value or run into the next keyframe; the
+        // last keyframe wraps to the first when the pattern loops
+        if (source.curve == CompiledPattern::Curve::HOLD) {
+            step.endPressurePercent = source.pressurePercent;
+        } else if (source.endPressurePercent >= 0.0) {
+            step.endPressurePercent = source.endPressurePercent;
+        } else if (i + 1 < m_patternSteps.size()) {
+            step.endPressurePercent = m_patternSteps[i + 1].pressurePercent;
+        } else {
+            step.endPressurePercent = m_infiniteLoop ? m_patternSteps.first().pressurePercent
+                                                     : source.pressurePercent;
+        }
+        step.action = CompiledPattern::actionFromName(source.action);
+        step.sealProfile = CompiledPattern::sealProfileFor(step.action);
+
+        if (source.parameters.value("clitoral_oscillation").toBool(false)) {
+            step.flags |= CompiledPattern::OSCILLATE;
+            step.oscFrequencyHz = static_cast<float>(source.parameters.value("clitoral_frequency").toDouble(8.0));
+            step.oscAmplitudeMmHg = static_cast<float>(source.parameters.value("clitoral_amplitude").toDouble(40.0));
+        }
+
+        if (source.parameters.value("tens_enabled").toBool(false)) {
+            step.flags |= CompiledPattern::TENS_ON;
+            step.tensFrequencyHz = static_cast<float>(source.parameters.value("tens_frequency").toDouble(20.0));
+            step.tensPulseWidthUs = static_cast<int16_t>(source.parameters.value("tens_pulse_width").toInt(400));
+            step.tensAmplitudePercent = static_cast<float>(source.parameters.value("tens_amplitude").toDouble(40.0));
+
+            const QString syncMode = source.parameters.value("tens_sync").toString("continuous");
+            TENSController::PhaseSync sync = TENSController::PhaseSync::CONTINUOUS;
+            if (syncMode == "sync_suction") {
+                sync = TENSController::PhaseSync::SYNC_SUCTION;
+            } else if (syncMode == "sync_vent") {
+                sync = TENSController::PhaseSync::SYNC_VENT;
+            } else if (syncMode == "alternating") {
+                sync = TENSController::PhaseSync::ALTERNATING;
+            }
+            step.tensSync = static_cast<uint8_t>(sync);
+        }
+
+        m_compiledPattern.append(step, source.action);
     }
+
+    // The authoring form is only needed to compile
+    m_patternSteps.clear();
 }
 
 void PatternEngine::applyPressureTarget(double targetPressure)
 {
     if (!m_hardware) return;
 
+    m_lastAppliedPressure = targetPressure;
+
+    if (m_closedLoopPressure && targetPressure > 0.0) {
+        // The pressure loop owns pump and valves; only the setpoint moves here
+        m_pressureController.setSetpoint(targetPressure / 100.0 * SafetyConstants::MAX_PRESSURE_STIMULATION_MMHG);
+        if (!m_pressureLoopActive) {
+            m_pressureController.reset();
+            m_lastPressureSequence = 0;
+            m_pressureLoopYielded = false;
+            m_pressureLoopActive = true;
+            onPressureLoopTick();   // Establish outputs now, not on the next tick
+        }
+        return;
+    }
+    m_pressureLoopActive = false;
+
     // Check if anti-detachment is currently active
     bool antiDetachmentActive = isAntiDetachmentActive();
 
@@ -969,12 +1110,144 @@ void PatternEngine::applyPressureTarget(double targetPressure)
     }
 }
 
+int64_t PatternEngine::nowNs() const
+{
+    return m_virtualClock ? m_virtualClock() : RealTime::monotonicNowNs();
+}
+
+void PatternEngine::setVirtualClock(std::function<int64_t()> clock)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (m_state != STOPPED) {
+        qWarning() << "Cannot change the pattern clock while a pattern is active";
+        return;
+    }
+    m_virtualClock = std::move(clock);
+}
+
+int PatternEngine::runDueSteps()
+{
+    int entered = 0;
+    while (m_virtualClock && m_state == RUNNING && !m_emergencyStop && nowNs() >= m_stepDeadlineNs) {
+        m_stepTiming.record(nowNs() - m_stepDeadlineNs);
+        m_currentStep++;
+        executeNextStep();
+        entered++;
+    }
+    return entered;
+}
+
 void PatternEngine::onStepTimer()
 {
+    const int64_t remainingNs = m_stepDeadlineNs - nowNs();
+    if (remainingNs > STEP_REARM_MIN_NS) {
+        // Woke far too early (coarse timer); re-arm rather than block
+        armStepTimer();
+        return;
+    }
+    if (remainingNs > 0) {
+        RealTime::sleepUntilPreciseNs(m_stepDeadlineNs, STEP_SPIN_WINDOW_NS);
+    }
+    m_stepTiming.record(nowNs() - m_stepDeadlineNs);
+
     m_currentStep++;
     executeNextStep();
 }
 
+double PatternEngine::stepProgress() const
+{
+    const int64_t spanNs = m_stepDeadlineNs - m_stepStartNs;
+    if (spanNs <= 0) return 0.0;
+    const double t = static_cast<double>(nowNs() - m_stepStartNs) / spanNs;
+    return std::max(0.0, std::min(1.0, t));
+}
+
+void PatternEngine::onSetpointTick()
+{
+    if (m_state != RUNNING || m_emergencyStop || m_currentStep >= m_compiledPattern.size()) return;
+
+    const CompiledPattern::Step& step = m_compiledPattern[m_currentStep];
+    if (step.curve == CompiledPattern::Curve::HOLD) return;
+
+    const double target = applyIntensityAndOffset(CompiledPattern::pressureAt(step, stepProgress()));
+    if (std::abs(target - m_lastAppliedPressure) < SETPOINT_DEADBAND_PERCENT) return;
+
+    applySetpoint(target);
+}
+
+void PatternEngine::applySetpoint(double targetPressure)
+{
+    if (!m_hardware) return;
+
+    if (!m_pressureLoopActive && m_lastAppliedPressure > 0.0 && targetPressure > 0.0) {
+        // Valves are already set for vacuum; only the pump speed moves
+        m_hardware->setPumpSpeed(std::min(100.0, targetPressure));
+        m_lastAppliedPressure = targetPressure;
+    } else {
+        applyPressureTarget(targetPressure);
+    }
+
+    emit pressureTargetChanged(targetPressure);
+}
+
+void PatternEngine::onPressureLoopTick()
+{
+    if (!m_pressureLoopActive || m_emergencyStop || !m_hardware) return;
+
+    try {
+        // One controller step per acquisition sample
+        const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+        if (snapshot.isPublished() && snapshot.sequence == m_lastPressureSequence) return;
+        m_lastPressureSequence = snapshot.sequence;
+
+        const double measured = snapshot.hasAVL() ? snapshot.avlPressure : -1.0;
+        const int64_t timestampNs = snapshot.isPublished() ? snapshot.monotonicNs : nowNs();
+        const PressureController::Command command = m_pressureController.update(measured, timestampNs);
+
+        // Anti-detachment takes priority and holds SOL1 open. Venting then
+        // would only fight that vacuum, so VENT becomes HOLD until it lets go,
+        // and the controller's valve state is reapplied when it does.
+        const bool antiDetachmentActive = isAntiDetachmentActive();
+        if (command.valvesChanged || antiDetachmentActive != m_pressureLoopYielded) {
+            m_pressureLoopYielded = antiDetachmentActive;
+            if (antiDetachmentActive) {
+                m_hardware->setSOL2(false);
+            } else {
+                m_hardware->setSOL1(command.vacuumValveOpen);
+                m_hardware->setSOL2(command.ventValveOpen);
+            }
+        }
+        if (command.pumpChanged) {
+            m_hardware->setPumpEnabled(command.pumpEnabled);
+            m_hardware->setPumpSpeed(command.pumpPercent);
+        }
+    } catch (const std::exception& e) {
+        qWarning() << "Pressure loop error:" << e.what();
+    }
+}
+
+void PatternEngine::setClosedLoopPressureEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_stateMutex);
+
+    if (m_closedLoopPressure == enabled) return;
+    m_closedLoopPressure = enabled;
+    m_pressureLoopActive = false;
+
+    // Hand the current target to whichever path now owns the outputs
+    if (m_state == RUNNING && m_lastAppliedPressure > 0.0) {
+        applyPressureTarget(m_lastAppliedPressure);
+    }
+    qDebug() << "Closed-loop pressure control" << (enabled ? "enabled" : "disabled");
+}
+
+void PatternEngine::setPressureControllerConfig(const PressureController::Config& config)
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_pressureController.setConfig(config);
+}
+
 void PatternEngine::onSafetyCheck()
 {
     performSafetyCheck();
@@ -985,9 +1258,10 @@ void PatternEngine::performSafetyCheck()
     if (!m_hardware || m_emergencyStop) return;
     
     try {
-        // Check pressure limits
-        double avlPressure = m_hardware->readAVLPressure();
-        double tankPressure = m_hardware->readTankPressure();
+        // Check pressure limits against the shared acquisition snapshot
+        const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+        double avlPressure = snapshot.avlPressure;
+        double tankPressure = snapshot.tankPressure;
 
         // Convert mmHg to percentage for comparison (sensor FS = 75 mmHg)
         double avlPercent = (avlPressure / SafetyConstants::MAX_PRESSURE_STIMULATION_MMHG) * 100.0;
@@ -1015,7 +1289,7 @@ double PatternEngine::applyIntensityAndOffset(double basePressure)
     return std::max(m_minPressure, std::min(m_maxPressure, adjustedPressure));
 }
 
-int PatternEngine::applySpeedMultiplier(int baseDuration)
+int PatternEngine::applySpeedMultiplier(int baseDuration) const
 {
     int adjustedDuration = static_cast<int>(baseDuration / m_speedMultiplier);
     return std::max(MIN_STEP_DURATION_MS, std::min(MAX_STEP_DURATION_MS, adjustedDuration));
@@ -1023,14 +1297,31 @@ int PatternEngine::applySpeedMultiplier(int baseDuration)
 
 double PatternEngine::getProgress() const
 {
-    if (m_patternSteps.isEmpty()) return 0.0;
-    return static_cast<double>(m_currentStep) / m_patternSteps.size() * 100.0;
+    if (m_compiledPattern.isEmpty()) return 0.0;
+    return static_cast<double>(m_currentStep) / m_compiledPattern.size() * 100.0;
 }
 
 qint64 PatternEngine::getElapsedTime() const
 {
-    if (m_patternStartTime == 0) return 0;
-    return QDateTime::currentMSecsSinceEpoch() - m_patternStartTime - m_totalPausedTime;
+    if (m_patternStartNs == 0) return 0;
+
+    // Monotonic, so wall-clock changes cannot distort it
+    const int64_t endNs = (m_state == PAUSED && m_pausedAtNs > 0) ? m_pausedAtNs : nowNs();
+    return (endNs - m_patternStartNs - m_totalPausedNs) / 1000000;
+}
+
+qint64 PatternEngine::getRemainingTime() const
+{
+    if (m_compiledPattern.isEmpty() || m_currentStep >= m_compiledPattern.size()) return 0;
+
+    // Rest of the current step, then the remaining steps of this pass (or
+    // cycle, for looping patterns) at the current speed
+    const int64_t currentNs = (m_state == PAUSED && m_pausedAtNs > 0) ? m_pausedAtNs : nowNs();
+    qint64 remainingMs = std::max<int64_t>(0, m_stepDeadlineNs - currentNs) / 1000000;
+    for (int i = m_currentStep + 1; i < m_compiledPattern.size(); ++i) {
+        remainingMs += applySpeedMultiplier(m_compiledPattern[i].durationMs);
+    }
+    return remainingMs;
 }
 
 void PatternEngine::setState(PatternState newState)
@@ -1083,6 +1374,7 @@ void PatternEngine::setAntiDetachmentMonitor(AntiDetachmentMonitor* monitor)
     }
 
     m_antiDetachmentMonitor = monitor;
+    m_pendingReapply |= CompiledPattern::SEAL_CHANGED;     // New monitor: configure it on the next step
 
     if (m_antiDetachmentMonitor) {
         // Connect anti-detachment signals
@@ -10,6 +10,11 @@
 #include <QState>
 #include <QFinalState>
 #include <memory>
+#include <functional>
+#include "../threading/ControlScheduler.h"
+#include "CompiledPattern.h"
+#include "../threading/RealTimeSupport.h"
+#include "../control/PressureController.h"
 
 // Forward declarations
 class HardwareManager;
@@ -70,15 +75,28 @@ public:
     };
     Q_ENUM(PatternType)
 
+    // Authoring form used by the pattern builders; compiled to
+    // CompiledPattern::Step before execution. A step is a keyframe: with a
+    // curve other than HOLD the pressure moves to endPressurePercent (or, if
+    // unset, the next step's pressure) over the step.
     struct PatternStep {
         double pressurePercent;
         int durationMs;
         QString action;  // "vacuum", "release", "hold"
         QJsonObject parameters;
+        CompiledPattern::Curve curve;
+        double endPressurePercent;
+
+        static constexpr double NEXT_KEYFRAME = -1.0;
         
-        PatternStep() : pressurePercent(0.0), durationMs(0) {}
-        PatternStep(double pressure, int duration, const QString& act = "vacuum")
-            : pressurePercent(pressure), durationMs(duration), action(act) {}
+        PatternStep()
+            : pressurePercent(0.0), durationMs(0),
+              curve(CompiledPattern::Curve::HOLD), endPressurePercent(NEXT_KEYFRAME) {}
+        PatternStep(double pressure, int duration, const QString& act = "vacuum",
+                    CompiledPattern::Curve stepCurve = CompiledPattern::Curve::HOLD,
+                    double endPressure = NEXT_KEYFRAME)
+            : pressurePercent(pressure), durationMs(duration), action(act),
+              curve(stepCurve), endPressurePercent(endPressure) {}
     };
 
     explicit PatternEngine(HardwareManager* hardware, QObject *parent = nullptr);
@@ -88,12 +106,28 @@ public:
     bool isAntiDetachmentActive() const;
     ~PatternEngine();
 
+    // Drive the periodic tick from the shared control scheduler; offset is
+    // the cycle within each period it runs on
+    void attachToScheduler(ControlScheduler* scheduler, int offset = 0);
+
+    // Offline rendering: read time from clock instead of the monotonic
+    // clock. The step timer is then never armed; whoever advances the clock
+    // calls runDueSteps() to enter every step whose deadline has passed.
+    void setVirtualClock(std::function<int64_t()> clock);
+    bool hasVirtualClock() const { return static_cast<bool>(m_virtualClock); }
+    int runDueSteps();
+
     // Pattern control
     bool startPattern(const QString& patternName, const QJsonObject& parameters);
     void stopPattern();
     void pausePattern();
     void resumePattern();
     void emergencyStop();
+
+    // Forget what the running step applied: the next step reconfigures the
+    // oscillator, TENS stage and seal monitor in full, whatever its change
+    // flags say. Call after the hardware has been reset under the pattern.
+    void invalidateAppliedOutputs();
     
     // Pattern management
     bool loadPattern(const QString& patternName, const QJsonObject& patternData);
@@ -107,10 +141,15 @@ public:
     
     // Execution status
     int getCurrentStep() const { return m_currentStep; }
-    int getTotalSteps() const { return m_patternSteps.size(); }
+    int getTotalSteps() const { return m_compiledPattern.size(); }
+    const CompiledPattern& getCompiledPattern() const { return m_compiledPattern; }
     double getProgress() const;
     qint64 getElapsedTime() const;
     qint64 getRemainingTime() const;
+
+    // Step timing against the absolute pattern timeline
+    const RealTime::TimingStats& getStepTimingStats() const { return m_stepTiming; }
+    double getLastCycleDriftMs() const { return m_lastCycleDriftNs / 1e6; }
     
     // Real-time parameter adjustment
     void setIntensity(double intensityPercent);  // 0-100%
@@ -121,6 +160,14 @@ public:
     double getSpeed() const { return m_speedMultiplier; }
     double getPressureOffset() const { return m_pressureOffset; }
     
+    // Closed-loop outer-chamber pressure regulation (on by default). When
+    // off, targets map straight to pump speed as before.
+    void setClosedLoopPressureEnabled(bool enabled);
+    bool isClosedLoopPressureEnabled() const { return m_closedLoopPressure; }
+    void setPressureControllerConfig(const PressureController::Config& config);
+    const PressureController::TrackingMetrics& getPressureTrackingMetrics() const { return m_pressureController.metrics(); }
+    void resetPressureTrackingMetrics() { m_pressureController.resetMetrics(); }
+    
     // Safety limits
     void setMaxPressure(double maxPressure);
     void setSafetyLimits(double minPressure, double maxPressure);
@@ -159,6 +206,7 @@ Q_SIGNALS:
     void patternResumed();
     void patternCompleted();
     void cycleCompleted(int cycleNumber);
+    void cycleTimingReport(int cycleNumber, double cycleDurationMs, double cumulativeDriftMs);
     void patternError(const QString& error);
     void stateChanged(PatternState newState);
     void stepChanged(int currentStep, int totalSteps);
@@ -182,6 +230,8 @@ Q_SIGNALS:
 private Q_SLOTS:
     void executeNextStep();
     void onStepTimer();
+    void onSetpointTick();
+    void onPressureLoopTick();
     void onSafetyCheck();
     void onClitoralCycleCompleted(int cycleCount);
 
@@ -189,7 +239,12 @@ private:
     void setState(PatternState newState);
     bool initializePattern(const QString& patternName, const QJsonObject& parameters);
     void buildPatternSteps(const QJsonObject& patternData);
-    void executeStep(const PatternStep& step);
+    void compilePatternSteps();
+    void armStepTimer();
+    int64_t nowNs() const;
+    void executeStep(const CompiledPattern::Step& step);
+    double stepProgress() const;
+    void applySetpoint(double targetPressure);
     void applyPressureTarget(double targetPressure);
     void performSafetyCheck();
     
@@ -206,11 +261,16 @@ private:
     void buildClitoralOnlyPattern(const QJsonObject& params);
     void buildTENSVacuumPattern(const QJsonObject& params);
     void buildTherapeuticPulsePattern(const QJsonObject& params);
+
+    // Keyframes for a sinusoid of the given amplitude around a base that
+    // ramps linearly from startBase to endBase over durationMs, ending on
+    // the midline
+    void appendSineKeyframes(const QString& action, double startBase, double endBase,
+                             double amplitude, int periodMs, int durationMs);
     
     // Utility functions
     double applyIntensityAndOffset(double basePressure);
-    int applySpeedMultiplier(int baseDuration);
-    double interpolatePressure(double startPressure, double endPressure, double progress);
+    int applySpeedMultiplier(int baseDuration) const;
     bool validatePatternData(const QJsonObject& patternData);
     
     // Hardware interface
@@ -223,18 +283,39 @@ private:
     PatternState m_state;
     QString m_currentPatternName;
     PatternType m_currentPatternType;
-    QList<PatternStep> m_patternSteps;
+    QList<PatternStep> m_patternSteps;         // Authoring form, filled by the builders
+    CompiledPattern m_compiledPattern;         // Execution form
     int m_currentStep;
-    qint64 m_patternStartTime;
-    qint64 m_stepStartTime;
-    qint64 m_pausedTime;
-    qint64 m_totalPausedTime;
+
+    // Monotonic step timeline (ns). Each step is scheduled from the previous
+    // step's deadline, so execution latency never accumulates.
+    int64_t m_patternStartNs;
+    int64_t m_stepStartNs;
+    int64_t m_stepDeadlineNs;
+    int64_t m_pausedAtNs;
+    int64_t m_totalPausedNs;
+    int64_t m_cycleStartNs;                 // When the current cycle actually began
+    int64_t m_lastCycleDriftNs;
+    int64_t m_timelineSlipNs;               // Moved forward by stall re-anchors
+    RealTime::TimingStats m_stepTiming;     // Step-boundary lateness
+    std::function<int64_t()> m_virtualClock;    // Empty: RealTime::monotonicNowNs
     
     // Execution control
     QTimer* m_stepTimer;
-    QTimer* m_safetyTimer;
+    ControlTimer* m_safetyTimer;
+    ControlTimer* m_setpointTimer;     // Evaluates curved keyframes
+    double m_lastAppliedPressure;      // Last setpoint sent to the hardware
+
+    // Closed-loop pressure stage: one controller step per acquisition sample
+    PressureController m_pressureController;
+    ControlTimer* m_pressureLoopTimer;
+    bool m_closedLoopPressure;
+    bool m_pressureLoopActive;         // Controller currently owns pump, SOL1 and SOL2
+    quint64 m_lastPressureSequence;    // Last snapshot fed to the controller
+    bool m_pressureLoopYielded;        // Anti-detachment owns the valves; loop drives the pump only
     bool m_emergencyStop;
     bool m_infiniteLoop;
+    uint8_t m_pendingReapply;                   // CompiledPattern change flags to force on the next step
     int m_completedCycles;
     
     // Real-time adjustments
@@ -255,6 +336,14 @@ private:
     
     // Constants
     static const int SAFETY_CHECK_INTERVAL_MS = 100;  // 10Hz safety checks
+    static const int SETPOINT_INTERVAL_MS = 20;       // 50Hz setpoint generator
+    static constexpr double SETPOINT_DEADBAND_PERCENT = 0.25;  // Smaller changes are not sent
+    static const int PRESSURE_LOOP_INTERVAL_MS = 10;  // Polls for new snapshots; runs at the acquisition rate
+    static constexpr int64_t STEP_TIMER_LEAD_NS = 1000000;   // Timer wakes this early...
+    static constexpr int64_t STEP_SPIN_WINDOW_NS = 200000;   // ...then sleeps/spins to the deadline
+    static constexpr int64_t STEP_REARM_MIN_NS = 2000000;    // Early wake-ups closer than this just wait
+    static constexpr uint8_t OUTPUT_CHANGE_FLAGS =            // Flags that reconfigure an output
+        CompiledPattern::OSC_RETUNE | CompiledPattern::TENS_RECONFIGURE | CompiledPattern::SEAL_CHANGED;
     static const double DEFAULT_INTENSITY;            // 100%
     static const double DEFAULT_SPEED_MULTIPLIER;     // 1.0
     static const double DEFAULT_PRESSURE_OFFSET;      // 0%
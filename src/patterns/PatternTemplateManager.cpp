@@ -1,4 +1,5 @@
 #include "PatternTemplateManager.h"
+#include "PatternValidationCache.h"
 #include "../core/JsonFileHelper.h"
 #include <QDebug>
 #include <QJsonDocument>
@@ -256,6 +257,37 @@ bool PatternTemplateManager::validateTemplateParameters(const QJsonObject& param
 }
 
 bool PatternTemplateManager::validateTemplateSteps(const QJsonArray& steps) const
+{
+    // The rules below and their limits, as for PatternValidator::cacheContext
+    static const QString cacheContext = PatternValidationCache::contextFor("template-steps", QStringList()
+        << QString::number(VALIDATION_RULES_VERSION) << VALID_ACTIONS.join(',')
+        << QString::number(MIN_DURATION_MS) << QString::number(MAX_DURATION_MS)
+        << QString::number(MIN_PRESSURE_PERCENT, 'g', 17) << QString::number(MAX_PRESSURE_PERCENT, 'g', 17));
+    PatternValidationCache* cache = PatternValidationCache::instance();
+    const QByteArray cacheKey = PatternValidationCache::contentKey(steps);
+
+    PatternValidator::ValidationReport cached;
+    if (cache->findReport(cacheKey, cacheContext, cached)) {
+        if (!cached.isSafeForExecution && !cached.issues.isEmpty()) {
+            m_lastValidationError = cached.issues.first().message;
+        }
+        return cached.isSafeForExecution;
+    }
+
+    const bool valid = checkTemplateSteps(steps);
+
+    PatternValidator::ValidationReport report;
+    if (!valid) {
+        report.overallResult = PatternValidator::ERROR;
+        report.isSafeForExecution = false;
+        report.issues.append(PatternValidator::ValidationIssue(PatternValidator::ERROR, "Template Steps",
+                                                               m_lastValidationError));
+    }
+    cache->storeReport(cacheKey, cacheContext, report);
+    return valid;
+}
+
+bool PatternTemplateManager::checkTemplateSteps(const QJsonArray& steps) const
 {
     if (steps.isEmpty()) {
         m_lastValidationError = "Template must have at least one step";
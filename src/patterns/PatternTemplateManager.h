@@ -93,6 +93,7 @@ private:
     void initializeTemplateManager();
     bool validateTemplateParameters(const QJsonObject& parameters) const;
     bool validateTemplateSteps(const QJsonArray& steps) const;
+    bool checkTemplateSteps(const QJsonArray& steps) const;
     QJsonObject mergeParameters(const QJsonObject& templateParams, const QJsonObject& customParams) const;
     
     // Built-in template creators
@@ -123,6 +124,7 @@ private:
     static const double MAX_PRESSURE_PERCENT;
     static const int MIN_DURATION_MS;
     static const int MAX_DURATION_MS;
+    static const int VALIDATION_RULES_VERSION = 1;   // Bump whenever validateTemplateSteps() rules change
 };
 
 #endif // PATTERNTEMPLATEMANAGER_H
@@ -0,0 +1,270 @@
+#include "PatternValidationCache.h"
+#include "../core/JsonFileHelper.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QMutexLocker>
+
+PatternValidationCache* PatternValidationCache::instance()
+{
+    // Function-local static: initialized exactly once, even under concurrent first calls
+    static PatternValidationCache* cache = new PatternValidationCache();
+    return cache;
+}
+
+PatternValidationCache::PatternValidationCache(QObject* parent)
+    : QObject(parent)
+    , m_useCounter(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_dirty(false)
+    , m_saveTimer(new QTimer(this))
+{
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, [this]() { save(); });
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() { save(); });
+    }
+}
+
+QByteArray PatternValidationCache::canonicalJson(const QJsonObject& pattern)
+{
+    // QJsonObject keeps its keys sorted, so the compact form is canonical
+    return QJsonDocument(pattern).toJson(QJsonDocument::Compact);
+}
+
+QByteArray PatternValidationCache::contentKey(const QJsonObject& pattern)
+{
+    return QCryptographicHash::hash(canonicalJson(pattern), QCryptographicHash::Sha256).toHex();
+}
+
+QByteArray PatternValidationCache::contentKey(const QJsonArray& steps)
+{
+    return contentKey(QJsonObject{{"steps", steps}});
+}
+
+QString PatternValidationCache::contextFor(const QString& validator, const QStringList& inputs)
+{
+    const QByteArray fingerprint = QCryptographicHash::hash(inputs.join(QChar(0x1f)).toUtf8(),
+                                                            QCryptographicHash::Sha256).toHex();
+    return validator + '/' + QString::fromLatin1(fingerprint.left(16));
+}
+
+bool PatternValidationCache::findReport(const QByteArray& key, const QString& context,
+                                        PatternValidator::ValidationReport& report)
+{
+    QMutexLocker locker(&m_mutex);
+    auto entry = m_entries.find(key);
+    if (entry == m_entries.end() || !entry->reports.contains(context)) {
+        m_misses++;
+        return false;
+    }
+    entry->lastUse = ++m_useCounter;
+    report = entry->reports.value(context);
+    m_hits++;
+    return true;
+}
+
+void PatternValidationCache::storeReport(const QByteArray& key, const QString& context,
+                                         const PatternValidator::ValidationReport& report)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry& entry = m_entries[key];
+        entry.reports.insert(context, report);
+        entry.lastUse = ++m_useCounter;
+        evictIfNeeded();
+        m_dirty = true;
+    }
+    scheduleSave();
+}
+
+void PatternValidationCache::setCacheFilePath(const QString& filePath)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (filePath == m_cacheFilePath) {
+            return;
+        }
+        m_cacheFilePath = filePath;
+    }
+    load();
+}
+
+QString PatternValidationCache::cacheFilePath() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cacheFilePath;
+}
+
+QString PatternValidationCache::cacheFilePathFor(const QString& patternsFilePath)
+{
+    return QFileInfo(patternsFilePath).absoluteDir().filePath("pattern_validation_cache.json");
+}
+
+void PatternValidationCache::load()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_cacheFilePath.isEmpty() || !QFileInfo::exists(m_cacheFilePath)) {
+        return;
+    }
+
+    QJsonObject root;
+    if (!JsonFileHelper::loadObject(m_cacheFilePath, root)) {
+        return;
+    }
+    if (root["version"].toInt() != CACHE_FORMAT_VERSION) {
+        qDebug() << "Ignoring validation cache with format version" << root["version"].toInt();
+        return;
+    }
+
+    int loaded = 0;
+    const QJsonObject entries = root["entries"].toObject();
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const QByteArray key = it.key().toLatin1();
+        Entry& entry = m_entries[key];
+        const QJsonObject reports = it.value().toObject();
+        for (auto report = reports.constBegin(); report != reports.constEnd(); ++report) {
+            // Reports validated during this run are newer than the file
+            if (!entry.reports.contains(report.key())) {
+                entry.reports.insert(report.key(), reportFromJson(report.value().toObject()));
+            }
+        }
+        if (entry.lastUse == 0) {
+            entry.lastUse = ++m_useCounter;
+        }
+        loaded++;
+    }
+    evictIfNeeded();
+
+    qDebug() << "Loaded" << loaded << "cached pattern validations from" << m_cacheFilePath;
+}
+
+bool PatternValidationCache::save()
+{
+    QJsonObject entries;
+    QString filePath;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty || m_cacheFilePath.isEmpty()) {
+            return true;
+        }
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            if (it->reports.isEmpty()) {
+                continue;
+            }
+            QJsonObject reports;
+            for (auto report = it->reports.constBegin(); report != it->reports.constEnd(); ++report) {
+                reports[report.key()] = reportToJson(report.value());
+            }
+            entries[QString::fromLatin1(it.key())] = reports;
+        }
+        filePath = m_cacheFilePath;
+        m_dirty = false;
+    }
+
+    QJsonObject root;
+    root["version"] = CACHE_FORMAT_VERSION;
+    root["entries"] = entries;
+    if (!JsonFileHelper::saveObject(filePath, root, true)) {
+        qWarning() << "Failed to save pattern validation cache:" << filePath;
+        QMutexLocker locker(&m_mutex);
+        m_dirty = true;
+        return false;
+    }
+    return true;
+}
+
+void PatternValidationCache::scheduleSave()
+{
+    // Callers may be on any thread; the timer lives on ours
+    QMetaObject::invokeMethod(m_saveTimer, "start", Qt::QueuedConnection);
+}
+
+void PatternValidationCache::evictIfNeeded()
+{
+    while (m_entries.size() > MAX_ENTRIES) {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->lastUse < oldest->lastUse) {
+                oldest = it;
+            }
+        }
+        m_entries.erase(oldest);
+        m_dirty = true;
+    }
+}
+
+void PatternValidationCache::clear()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_entries.clear();
+        m_hits = 0;
+        m_misses = 0;
+        m_dirty = true;
+    }
+    scheduleSave();
+}
+
+int PatternValidationCache::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+quint64 PatternValidationCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+quint64 PatternValidationCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+QJsonObject PatternValidationCache::reportToJson(const PatternValidator::ValidationReport& report)
+{
+    QJsonArray issues;
+    for (const PatternValidator::ValidationIssue& issue : report.issues) {
+        QJsonObject json;
+        json["severity"] = static_cast<int>(issue.severity);
+        json["category"] = issue.category;
+        json["message"] = issue.message;
+        json["suggestion"] = issue.suggestion;
+        json["context"] = issue.context;
+        issues.append(json);
+    }
+
+    QJsonObject json;
+    json["overallResult"] = static_cast<int>(report.overallResult);
+    json["isSafeForExecution"] = report.isSafeForExecution;
+    json["issues"] = issues;
+    json["statistics"] = report.statistics;
+    json["recommendations"] = QJsonArray::fromStringList(report.recommendations);
+    return json;
+}
+
+PatternValidator::ValidationReport PatternValidationCache::reportFromJson(const QJsonObject& json)
+{
+    PatternValidator::ValidationReport report;
+    report.overallResult = static_cast<PatternValidator::ValidationResult>(json["overallResult"].toInt());
+    report.isSafeForExecution = json["isSafeForExecution"].toBool();
+    report.statistics = json["statistics"].toObject();
+
+    for (const QJsonValue& value : json["issues"].toArray()) {
+        const QJsonObject issue = value.toObject();
+        report.issues.append(PatternValidator::ValidationIssue(
+            static_cast<PatternValidator::ValidationResult>(issue["severity"].toInt()),
+            issue["category"].toString(), issue["message"].toString(),
+            issue["suggestion"].toString(), issue["context"].toObject()));
+    }
+    for (const QJsonValue& value : json["recommendations"].toArray()) {
+        report.recommendations.append(value.toString());
+    }
+    return report;
+}
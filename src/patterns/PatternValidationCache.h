@@ -0,0 +1,98 @@
+#ifndef PATTERNVALIDATIONCACHE_H
+#define PATTERNVALIDATIONCACHE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "PatternValidator.h"
+
+/**
+ * @brief Shared cache of pattern validation results keyed by content hash
+ *
+ * Patterns are identified by the SHA-256 of their canonical JSON (compact,
+ * keys sorted), so the same pattern reached through the selector, a
+ * template or the editor shares one entry, and any edit produces a new key.
+ * Each entry holds one report per validation context. A context names the
+ * validator and fingerprints everything besides the pattern that decides its
+ * verdict (limits, constants and the validator's build; see contextFor), so
+ * a persisted safety verdict is never reused by a validator that could
+ * judge differently.
+ *
+ * Reports are persisted to a JSON file next to patterns.json and reloaded at
+ * start, so unchanged patterns are not revalidated across runs. Saves are
+ * debounced; the least recently used entries are evicted past MAX_ENTRIES.
+ *
+ * Thread-safe.
+ */
+class PatternValidationCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static PatternValidationCache* instance();
+
+    // Content key for a pattern or a step array
+    static QByteArray canonicalJson(const QJsonObject& pattern);
+    static QByteArray contentKey(const QJsonObject& pattern);
+    static QByteArray contentKey(const QJsonArray& steps);
+
+    // Context for a validator: name plus a hash of its verdict inputs. Pass
+    // the validator's VALIDATION_RULES_VERSION among them and bump it when a
+    // rule changes without touching any constant, so stale reports (including
+    // persisted ones) are invalidated while unchanged rules keep their cache.
+    static QString contextFor(const QString& validator, const QStringList& inputs);
+
+    bool findReport(const QByteArray& key, const QString& context,
+                    PatternValidator::ValidationReport& report);
+    void storeReport(const QByteArray& key, const QString& context,
+                     const PatternValidator::ValidationReport& report);
+
+    // Persistence; setting a path loads whatever the file already holds
+    void setCacheFilePath(const QString& filePath);
+    QString cacheFilePath() const;
+    static QString cacheFilePathFor(const QString& patternsFilePath);
+    bool save();
+
+    void clear();
+    int size() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+    static const int MAX_ENTRIES = 256;
+    static const int CACHE_FORMAT_VERSION = 1;
+    static const int SAVE_DELAY_MS = 2000;
+
+private:
+    explicit PatternValidationCache(QObject* parent = nullptr);
+
+    struct Entry {
+        QHash<QString, PatternValidator::ValidationReport> reports;
+        quint64 lastUse = 0;
+    };
+
+    void load();
+    void scheduleSave();
+    void evictIfNeeded();
+
+    static QJsonObject reportToJson(const PatternValidator::ValidationReport& report);
+    static PatternValidator::ValidationReport reportFromJson(const QJsonObject& json);
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    quint64 m_useCounter;
+    quint64 m_hits;
+    quint64 m_misses;
+    bool m_dirty;
+
+    QString m_cacheFilePath;
+    QTimer* m_saveTimer;
+};
+
+#endif // PATTERNVALIDATIONCACHE_H
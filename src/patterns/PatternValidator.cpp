@@ -1,10 +1,133 @@
 #include "PatternValidator.h"
+#include "PatternValidationCache.h"
 #include <QDebug>
 #include <QJsonDocument>
+#include <algorithm>
 #include <cmath>
 
 // Constants are now defined as constexpr in the header
 
+namespace {
+// Step-to-step thresholds shared by the full and incremental checks
+const double LARGE_PRESSURE_CHANGE = 50.0;
+const double RAPID_PRESSURE_CHANGE = 30.0;
+const int RAPID_CHANGE_DURATION_MS = 500;
+const int SHORT_STEP_DURATION_MS = 200;
+const double GENTLE_PRESSURE_LIMIT = 60.0;
+const double INTENSE_PRESSURE_LEVEL = 70.0;
+
+// Per-step check results for incremental validation. STEP_* checks look at
+// the step alone, PAIR_* checks at the step and the one before it.
+enum IncrementalFlag : quint16 {
+    STEP_PRESSURE_BELOW_MIN = 0x0001,
+    STEP_PRESSURE_ABOVE_MAX = 0x0002,
+    STEP_PRESSURE_HIGH = 0x0004,
+    STEP_DURATION_SHORT = 0x0008,
+    STEP_DURATION_LONG = 0x0010,
+    STEP_GENTLE_TOO_HIGH = 0x0020,
+    PAIR_LARGE_CHANGE = 0x0040,
+    PAIR_SHORT_DURATIONS = 0x0080,
+    PAIR_LARGE_GRADIENT = 0x0100,
+    PAIR_RAPID_GRADIENT = 0x0200
+};
+const int INCREMENTAL_FLAG_COUNT = 10;
+
+const PatternValidator::ValidationResult INCREMENTAL_FLAG_SEVERITY[INCREMENTAL_FLAG_COUNT] = {
+    PatternValidator::ERROR, PatternValidator::CRITICAL, PatternValidator::WARNING,
+    PatternValidator::ERROR, PatternValidator::WARNING, PatternValidator::WARNING,
+    PatternValidator::WARNING, PatternValidator::WARNING, PatternValidator::WARNING,
+    PatternValidator::ERROR
+};
+
+/**
+ * @brief Count and sum of step durations, queryable below a threshold
+ *
+ * A Fenwick tree over whole milliseconds keeps the sum of absolute
+ * deviations from the mean duration (the timing term of the complexity
+ * score) at O(log range) per edit and query. Durations outside the indexed
+ * range are kept as plain totals: they are exact as long as the mean is
+ * inside the range, which the caller checks.
+ */
+class DurationIndex
+{
+public:
+    static const int RANGE_MS = 65536;
+
+    void add(int duration, int sign)
+    {
+        if (duration < 0) {
+            m_belowCount += sign;
+            m_belowSum += sign * qint64(duration);
+        } else if (duration < RANGE_MS) {
+            if (m_counts.isEmpty()) {
+                m_counts.fill(0, RANGE_MS + 1);
+                m_sums.fill(0, RANGE_MS + 1);
+            }
+            for (int i = duration + 1; i <= RANGE_MS; i += i & -i) {
+                m_counts[i] += sign;
+                m_sums[i] += sign * qint64(duration);
+            }
+        }
+        m_count += sign;
+        m_sum += sign * qint64(duration);
+    }
+
+    // Sum of |duration - mean|; false if the mean is outside the indexed range
+    bool absoluteDeviation(double mean, double& result) const
+    {
+        if (mean < 0.0 || mean >= RANGE_MS) {
+            return false;
+        }
+        qint64 countBelow = m_belowCount;
+        qint64 sumBelow = m_belowSum;
+        if (!m_counts.isEmpty()) {
+            for (int i = static_cast<int>(mean) + 1; i > 0; i -= i & -i) {
+                countBelow += m_counts[i];
+                sumBelow += m_sums[i];
+            }
+        }
+        // Everything not counted below the mean lies above it
+        result = (countBelow * mean - sumBelow) + ((m_sum - sumBelow) - (m_count - countBelow) * mean);
+        return true;
+    }
+
+private:
+    QVector<qint32> m_counts;
+    QVector<qint64> m_sums;
+    qint64 m_count = 0;
+    qint64 m_sum = 0;
+    qint64 m_belowCount = 0;
+    qint64 m_belowSum = 0;
+};
+}
+
+struct PatternValidator::IncrementalState {
+    ValidationLevel level = COMPREHENSIVE;
+    QString patternName;
+    bool gentle = false;
+    bool intense = false;
+    QList<ValidationIssue> patternIssues;   // Name, type and parameter checks
+
+    QVector<StepValues> steps;
+    QVector<quint16> flags;
+    int flagCounts[INCREMENTAL_FLAG_COUNT] = {};
+
+    qint64 totalDuration = 0;
+    double pressureSum = 0.0;
+    double pressureSquareSum = 0.0;
+    int intenseSteps = 0;
+    DurationIndex durations;
+
+    void setFlags(int index, quint16 value)
+    {
+        const quint16 previous = flags[index];
+        for (int bit = 0; bit < INCREMENTAL_FLAG_COUNT; ++bit) {
+            flagCounts[bit] += ((value >> bit) & 1) - ((previous >> bit) & 1);
+        }
+        flags[index] = value;
+    }
+};
+
 const QStringList PatternValidator::VALID_ACTIONS = {
     "pressure", "pause", "ramp", "hold", "release"
 };
@@ -41,7 +164,17 @@ PatternValidator::~PatternValidator()
 
 PatternValidator::ValidationReport PatternValidator::validatePattern(const QJsonObject& patternData, ValidationLevel level)
 {
+    // Unchanged patterns validated under the same limits reuse the stored report
+    PatternValidationCache* cache = PatternValidationCache::instance();
+    const QByteArray cacheKey = PatternValidationCache::contentKey(patternData);
+    const QString context = cacheContext(level);
+
     ValidationReport report;
+    if (cache->findReport(cacheKey, context, report)) {
+        emit validationCompleted(report);
+        return report;
+    }
+
     report.overallResult = VALID;
     report.isSafeForExecution = true;
     
@@ -89,11 +222,27 @@ PatternValidator::ValidationReport PatternValidator::validatePattern(const QJson
     }
     report.recommendations = generateRecommendations(report.issues);
     
+    cache->storeReport(cacheKey, context, report);
     emit validationCompleted(report);
     
     return report;
 }
 
+QString PatternValidator::cacheContext(ValidationLevel level) const
+{
+    // Every input that can change a report besides the pattern itself: the
+    // limits, the fixed rule lists, and the version of the rules coded here
+    QStringList inputs;
+    inputs << QString::number(VALIDATION_RULES_VERSION) << QString::number(level);
+    for (double limit : {m_minPressure, m_maxPressure, m_minDuration, m_maxDuration, m_maxPressureGradient,
+                         double(m_maxSteps), double(m_maxTotalDuration), m_maxComplexity,
+                         m_warningPressureThreshold, m_warningDurationThreshold, m_warningGradientThreshold}) {
+        inputs << QString::number(limit, 'g', 17);
+    }
+    inputs << VALID_ACTIONS.join(',') << REQUIRED_STEP_FIELDS.join(',') << REQUIRED_PATTERN_FIELDS.join(',');
+    return PatternValidationCache::contextFor("validator", inputs);
+}
+
 bool PatternValidator::isPatternSafe(const QJsonObject& patternData)
 {
     ValidationReport report = validatePattern(patternData, SAFETY);
@@ -190,7 +339,7 @@ void PatternValidator::validateSafetyConstraints(const QJsonArray& steps, Valida
             double currPressure = currStep["pressure"].toDouble();
             double pressureChange = std::abs(currPressure - prevPressure);
             
-            if (pressureChange > 50.0) { // More than 50% change
+            if (pressureChange > LARGE_PRESSURE_CHANGE) {
                 addIssue(report, WARNING, "Safety Constraint", 
                         QString("Steps %1-%2: Large pressure change %3%")
                         .arg(i).arg(i+1).arg(pressureChange),
@@ -383,7 +532,7 @@ void PatternValidator::validatePatternCoherence(const QJsonObject& patternData,
             QJsonObject step = stepValue.toObject();
             if (step.contains("pressure")) {
                 double pressure = step["pressure"].toDouble();
-                if (pressure > 60.0) {
+                if (pressure > GENTLE_PRESSURE_LIMIT) {
                     addIssue(report, WARNING, "Pattern Coherence", 
                             QString("Pattern named '%1' has high pressure %2%")
                             .arg(patternData["name"].toString()).arg(pressure),
@@ -400,7 +549,7 @@ void PatternValidator::validatePatternCoherence(const QJsonObject& patternData,
             QJsonObject step = stepValue.toObject();
             if (step.contains("pressure")) {
                 double pressure = step["pressure"].toDouble();
-                if (pressure > 70.0) {
+                if (pressure > INTENSE_PRESSURE_LEVEL) {
                     hasHighPressure = true;
                     break;
                 }
@@ -436,7 +585,7 @@ void PatternValidator::validatePerformanceImpact(const QJsonArray& steps, Valida
             int prevDuration = prevStep["duration"].toInt();
             int currDuration = currStep["duration"].toInt();
             
-            if (prevDuration < 200 && currDuration < 200) {
+            if (prevDuration < SHORT_STEP_DURATION_MS && currDuration < SHORT_STEP_DURATION_MS) {
                 addIssue(report, WARNING, "Performance Impact", 
                         QString("Steps %1-%2: Consecutive short durations may impact performance")
                         .arg(i).arg(i+1),
@@ -462,7 +611,7 @@ void PatternValidator::validatePressureGradients(const QJsonArray& steps, Valida
             double gradient = qAbs(currPressure - prevPressure);
 
             // Check for excessive pressure gradients
-            if (gradient > 50.0) { // More than 50 mmHg change
+            if (gradient > LARGE_PRESSURE_CHANGE) {
                 addIssue(report, WARNING, "Pressure Gradient",
                         QString("Step %1: Large pressure change (%2 mmHg)")
                         .arg(i+1).arg(gradient, 0, 'f', 1),
@@ -470,9 +619,9 @@ void PatternValidator::validatePressureGradients(const QJsonArray& steps, Valida
             }
 
             // Check for very rapid pressure changes with short durations
-            if (gradient > 30.0 && currStep.contains("duration")) {
+            if (gradient > RAPID_PRESSURE_CHANGE && currStep.contains("duration")) {
                 int duration = currStep["duration"].toInt();
-                if (duration < 500) { // Less than 500ms
+                if (duration < RAPID_CHANGE_DURATION_MS) {
                     addIssue(report, ERROR, "Pressure Gradient",
                             QString("Step %1: Rapid pressure change (%2 mmHg in %3ms)")
                             .arg(i+1).arg(gradient, 0, 'f', 1).arg(duration),
@@ -482,3 +631,397 @@ void PatternValidator::validatePressureGradients(const QJsonArray& steps, Valida
         }
     }
 }
+
+void PatternValidator::beginIncremental(const QJsonObject& patternData, const QVector<StepValues>& steps,
+                                        ValidationLevel level)
+{
+    m_incremental.reset(new IncrementalState());
+    IncrementalState& state = *m_incremental;
+    state.level = level;
+    state.patternName = patternData["name"].toString();
+    const QString name = state.patternName.toLower();
+    state.gentle = name.contains("gentle") || name.contains("soft");
+    state.intense = name.contains("intense") || name.contains("strong");
+
+    // Pattern-level checks do not depend on the steps; run them once
+    ValidationReport patternReport;
+    for (const QString& field : REQUIRED_PATTERN_FIELDS) {
+        if (field != "steps" && !patternData.contains(field)) {
+            addIssue(patternReport, CRITICAL, "Missing Field",
+                    QString("Required field '%1' is missing").arg(field),
+                    QString("Add the required field '%1' to the pattern").arg(field));
+        }
+    }
+    if (patternData.contains("parameters")) {
+        validateBasicParameters(patternData["parameters"].toObject(), patternReport);
+    }
+    state.patternIssues = patternReport.issues;
+
+    state.steps = steps;
+    state.flags.fill(0, steps.size());
+    for (const StepValues& step : steps) {
+        addIncrementalAggregates(step, 1);
+    }
+    for (int i = 0; i < steps.size(); ++i) {
+        refreshIncrementalStep(i);
+    }
+}
+
+void PatternValidator::endIncremental()
+{
+    m_incremental.reset();
+}
+
+int PatternValidator::incrementalStepCount() const
+{
+    return m_incremental ? m_incremental->steps.size() : 0;
+}
+
+void PatternValidator::insertStep(int index, const StepValues& step)
+{
+    if (!m_incremental || index < 0 || index > m_incremental->steps.size()) {
+        qWarning() << "PatternValidator: insertStep out of range:" << index;
+        return;
+    }
+    m_incremental->steps.insert(index, step);
+    m_incremental->flags.insert(index, 0);
+    addIncrementalAggregates(step, 1);
+    refreshIncrementalStep(index);
+    refreshIncrementalStep(index + 1);
+}
+
+void PatternValidator::removeStep(int index)
+{
+    if (!m_incremental || index < 0 || index >= m_incremental->steps.size()) {
+        qWarning() << "PatternValidator: removeStep out of range:" << index;
+        return;
+    }
+    IncrementalState& state = *m_incremental;
+    addIncrementalAggregates(state.steps[index], -1);
+    state.setFlags(index, 0);
+    state.steps.remove(index);
+    state.flags.remove(index);
+    refreshIncrementalStep(index);
+}
+
+void PatternValidator::updateStep(int index, const StepValues& step)
+{
+    if (!m_incremental || index < 0 || index >= m_incremental->steps.size()) {
+        qWarning() << "PatternValidator: updateStep out of range:" << index;
+        return;
+    }
+    addIncrementalAggregates(m_incremental->steps[index], -1);
+    m_incremental->steps[index] = step;
+    addIncrementalAggregates(step, 1);
+    refreshIncrementalStep(index);
+    refreshIncrementalStep(index + 1);
+}
+
+void PatternValidator::moveStep(int from, int to)
+{
+    if (!m_incremental || from < 0 || from >= m_incremental->steps.size() ||
+        to < 0 || to >= m_incremental->steps.size() || from == to) {
+        return;
+    }
+    const StepValues step = m_incremental->steps[from];
+    removeStep(from);
+    insertStep(to, step);
+}
+
+quint16 PatternValidator::incrementalStepFlags(int index) const
+{
+    const IncrementalState& state = *m_incremental;
+    const StepValues& step = state.steps[index];
+    quint16 flags = 0;
+
+    if (state.level >= SAFETY) {
+        if (step.pressure < m_minPressure) flags |= STEP_PRESSURE_BELOW_MIN;
+        if (step.pressure > m_maxPressure) flags |= STEP_PRESSURE_ABOVE_MAX;
+        if (step.pressure > m_warningPressureThreshold) flags |= STEP_PRESSURE_HIGH;
+        if (step.duration < m_minDuration) flags |= STEP_DURATION_SHORT;
+        if (step.duration > m_maxDuration) flags |= STEP_DURATION_LONG;
+    }
+    if (state.level >= COMPREHENSIVE && state.gentle && step.pressure > GENTLE_PRESSURE_LIMIT) {
+        flags |= STEP_GENTLE_TOO_HIGH;
+    }
+
+    if (index > 0) {
+        const StepValues& previous = state.steps[index - 1];
+        const double change = std::abs(step.pressure - previous.pressure);
+        if (state.level >= SAFETY && change > LARGE_PRESSURE_CHANGE) {
+            flags |= PAIR_LARGE_CHANGE;
+        }
+        if (state.level >= PERFORMANCE &&
+            previous.duration < SHORT_STEP_DURATION_MS && step.duration < SHORT_STEP_DURATION_MS) {
+            flags |= PAIR_SHORT_DURATIONS;
+        }
+        if (state.level >= COMPREHENSIVE) {
+            if (change > LARGE_PRESSURE_CHANGE) flags |= PAIR_LARGE_GRADIENT;
+            if (change > RAPID_PRESSURE_CHANGE && step.duration < RAPID_CHANGE_DURATION_MS) {
+                flags |= PAIR_RAPID_GRADIENT;
+            }
+        }
+    }
+    return flags;
+}
+
+void PatternValidator::refreshIncrementalStep(int index)
+{
+    if (index >= 0 && index < m_incremental->steps.size()) {
+        m_incremental->setFlags(index, incrementalStepFlags(index));
+    }
+}
+
+void PatternValidator::addIncrementalAggregates(const StepValues& step, int sign)
+{
+    IncrementalState& state = *m_incremental;
+    state.totalDuration += sign * step.duration;
+    state.pressureSum += sign * step.pressure;
+    state.pressureSquareSum += sign * step.pressure * step.pressure;
+    if (step.pressure > INTENSE_PRESSURE_LEVEL) {
+        state.intenseSteps += sign;
+    }
+    state.durations.add(step.duration, sign);
+}
+
+double PatternValidator::incrementalPressureVariability() const
+{
+    const IncrementalState& state = *m_incremental;
+    const int count = state.steps.size();
+    if (count < 2) {
+        return 0.0;
+    }
+    const double mean = state.pressureSum / count;
+    return std::sqrt(std::max(0.0, state.pressureSquareSum / count - mean * mean));
+}
+
+double PatternValidator::incrementalComplexity() const
+{
+    // Same score as calculatePatternComplexity(), from the running aggregates
+    const IncrementalState& state = *m_incremental;
+    const int count = state.steps.size();
+    if (count == 0) {
+        return 0.0;
+    }
+
+    double complexity = count * 0.1 + incrementalPressureVariability() * 0.5;
+
+    const double averageDuration = state.totalDuration / static_cast<double>(count);
+    if (averageDuration > 0.0) {
+        double deviation = 0.0;
+        if (!state.durations.absoluteDeviation(averageDuration, deviation)) {
+            for (const StepValues& step : state.steps) {
+                deviation += std::abs(step.duration - averageDuration);
+            }
+        }
+        complexity += deviation / averageDuration * 0.1;
+    }
+    return complexity;
+}
+
+PatternValidator::ValidationResult PatternValidator::incrementalResult() const
+{
+    if (!m_incremental) {
+        return VALID;
+    }
+    ValidationResult worst = VALID;
+    for (ValidationResult severity : {CRITICAL, ERROR, WARNING}) {
+        if (incrementalIssueCount(severity) > 0) {
+            worst = severity;
+            break;
+        }
+    }
+    return worst;
+}
+
+int PatternValidator::incrementalIssueCount(ValidationResult severity) const
+{
+    if (!m_incremental) {
+        return 0;
+    }
+    const IncrementalState& state = *m_incremental;
+
+    int count = 0;
+    for (const ValidationIssue& issue : state.patternIssues) {
+        if (issue.severity == severity) {
+            count++;
+        }
+    }
+    for (int bit = 0; bit < INCREMENTAL_FLAG_COUNT; ++bit) {
+        if (INCREMENTAL_FLAG_SEVERITY[bit] == severity) {
+            count += state.flagCounts[bit];
+        }
+    }
+
+    // Whole-pattern checks are all warnings
+    if (severity == WARNING) {
+        if (state.level >= SAFETY) {
+            count += state.totalDuration > m_maxTotalDuration;
+            count += state.steps.size() > m_maxSteps;
+        }
+        if (state.level >= PERFORMANCE) {
+            count += incrementalComplexity() > m_maxComplexity;
+        }
+        if (state.level >= COMPREHENSIVE) {
+            count += state.intense && state.intenseSteps == 0;
+        }
+    }
+    return count;
+}
+
+QJsonObject PatternValidator::incrementalStatistics() const
+{
+    QJsonObject stats;
+    if (!m_incremental) {
+        return stats;
+    }
+    stats["stepCount"] = m_incremental->steps.size();
+    stats["totalDuration"] = static_cast<double>(m_incremental->totalDuration);
+    stats["complexity"] = incrementalComplexity();
+    stats["pressureVariability"] = incrementalPressureVariability();
+    return stats;
+}
+
+PatternValidator::ValidationReport PatternValidator::incrementalReport()
+{
+    ValidationReport report;
+    if (!m_incremental) {
+        return report;
+    }
+    const IncrementalState& state = *m_incremental;
+    const QVector<StepValues>& steps = state.steps;
+    report.issues = state.patternIssues;
+
+    // Issues in the order validatePattern() reports them
+    auto any = [&state](quint16 mask) {
+        for (int bit = 0; bit < INCREMENTAL_FLAG_COUNT; ++bit) {
+            if (((mask >> bit) & 1) && state.flagCounts[bit] > 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (any(STEP_PRESSURE_BELOW_MIN | STEP_PRESSURE_ABOVE_MAX | STEP_PRESSURE_HIGH)) {
+        for (int i = 0; i < steps.size(); ++i) {
+            const double pressure = steps[i].pressure;
+            if (state.flags[i] & STEP_PRESSURE_BELOW_MIN) {
+                addIssue(report, ERROR, "Pressure Limit",
+                        QString("Step %1: Pressure %2% is below minimum %3%")
+                        .arg(i+1).arg(pressure).arg(m_minPressure),
+                        QString("Increase pressure to at least %1%").arg(m_minPressure));
+            }
+            if (state.flags[i] & STEP_PRESSURE_ABOVE_MAX) {
+                addIssue(report, CRITICAL, "Pressure Limit",
+                        QString("Step %1: Pressure %2% exceeds maximum %3%")
+                        .arg(i+1).arg(pressure).arg(m_maxPressure),
+                        QString("Reduce pressure to maximum %1%").arg(m_maxPressure));
+            }
+            if (state.flags[i] & STEP_PRESSURE_HIGH) {
+                addIssue(report, WARNING, "Pressure Warning",
+                        QString("Step %1: High pressure %2% detected")
+                        .arg(i+1).arg(pressure),
+                        "Consider reducing pressure for safety");
+            }
+        }
+    }
+
+    if (any(STEP_DURATION_SHORT | STEP_DURATION_LONG)) {
+        for (int i = 0; i < steps.size(); ++i) {
+            const int duration = steps[i].duration;
+            if (state.flags[i] & STEP_DURATION_SHORT) {
+                addIssue(report, ERROR, "Timing Constraint",
+                        QString("Step %1: Duration %2ms is below minimum %3ms")
+                        .arg(i+1).arg(duration).arg(m_minDuration),
+                        QString("Increase duration to at least %1ms").arg(m_minDuration));
+            }
+            if (state.flags[i] & STEP_DURATION_LONG) {
+                addIssue(report, WARNING, "Timing Constraint",
+                        QString("Step %1: Long duration %2ms detected")
+                        .arg(i+1).arg(duration),
+                        "Consider breaking into shorter steps");
+            }
+        }
+    }
+    if (state.level >= SAFETY && state.totalDuration > m_maxTotalDuration) {
+        addIssue(report, WARNING, "Total Duration",
+                QString("Total pattern duration %1ms exceeds recommended maximum %2ms")
+                .arg(state.totalDuration).arg(m_maxTotalDuration),
+                "Consider shortening the pattern");
+    }
+
+    if (any(PAIR_LARGE_CHANGE)) {
+        for (int i = 1; i < steps.size(); ++i) {
+            if (state.flags[i] & PAIR_LARGE_CHANGE) {
+                addIssue(report, WARNING, "Safety Constraint",
+                        QString("Steps %1-%2: Large pressure change %3%")
+                        .arg(i).arg(i+1).arg(std::abs(steps[i].pressure - steps[i-1].pressure)),
+                        "Consider adding intermediate steps for gradual change");
+            }
+        }
+    }
+    if (state.level >= SAFETY && steps.size() > m_maxSteps) {
+        addIssue(report, WARNING, "Complexity",
+                QString("Pattern has %1 steps, exceeding recommended maximum %2")
+                .arg(steps.size()).arg(m_maxSteps),
+                "Consider simplifying the pattern");
+    }
+
+    const double complexity = incrementalComplexity();
+    if (state.level >= PERFORMANCE && complexity > m_maxComplexity) {
+        addIssue(report, WARNING, "Performance Impact",
+                QString("Pattern complexity %1 exceeds recommended maximum %2")
+                .arg(complexity, 0, 'f', 2).arg(m_maxComplexity),
+                "Simplify pattern to improve performance");
+    }
+    if (any(PAIR_SHORT_DURATIONS)) {
+        for (int i = 1; i < steps.size(); ++i) {
+            if (state.flags[i] & PAIR_SHORT_DURATIONS) {
+                addIssue(report, WARNING, "Performance Impact",
+                        QString("Steps %1-%2: Consecutive short durations may impact performance")
+                        .arg(i).arg(i+1),
+                        "Consider combining short steps or increasing duration");
+            }
+        }
+    }
+
+    if (any(PAIR_LARGE_GRADIENT | PAIR_RAPID_GRADIENT)) {
+        for (int i = 1; i < steps.size(); ++i) {
+            const double gradient = std::abs(steps[i].pressure - steps[i-1].pressure);
+            if (state.flags[i] & PAIR_LARGE_GRADIENT) {
+                addIssue(report, WARNING, "Pressure Gradient",
+                        QString("Step %1: Large pressure change (%2 mmHg)")
+                        .arg(i+1).arg(gradient, 0, 'f', 1),
+                        "Consider adding intermediate steps for smoother transitions");
+            }
+            if (state.flags[i] & PAIR_RAPID_GRADIENT) {
+                addIssue(report, ERROR, "Pressure Gradient",
+                        QString("Step %1: Rapid pressure change (%2 mmHg in %3ms)")
+                        .arg(i+1).arg(gradient, 0, 'f', 1).arg(steps[i].duration),
+                        "Increase step duration or reduce pressure change");
+            }
+        }
+    }
+
+    if (any(STEP_GENTLE_TOO_HIGH)) {
+        for (int i = 0; i < steps.size(); ++i) {
+            if (state.flags[i] & STEP_GENTLE_TOO_HIGH) {
+                addIssue(report, WARNING, "Pattern Coherence",
+                        QString("Pattern named '%1' has high pressure %2%")
+                        .arg(state.patternName).arg(steps[i].pressure),
+                        "Consider reducing pressure for gentle patterns");
+            }
+        }
+    }
+    if (state.level >= COMPREHENSIVE && state.intense && state.intenseSteps == 0) {
+        addIssue(report, WARNING, "Pattern Coherence",
+                QString("Pattern named '%1' has no high pressure steps").arg(state.patternName),
+                "Consider adding higher pressure steps for intense patterns");
+    }
+
+    report.overallResult = determineOverallResult(report.issues);
+    report.isSafeForExecution = (report.overallResult != CRITICAL && report.overallResult != ERROR);
+    report.statistics = incrementalStatistics();
+    report.recommendations = generateRecommendations(report.issues);
+    return report;
+}
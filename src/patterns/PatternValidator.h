@@ -5,6 +5,8 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QStringList>
+#include <QVector>
+#include <memory>
 
 /**
  * @brief Pattern validation and safety checking system
@@ -60,6 +62,15 @@ public:
         ValidationReport() : overallResult(VALID), isSafeForExecution(true) {}
     };
 
+    // Step as seen by incremental validation
+    struct StepValues {
+        double pressure;
+        int duration;
+
+        StepValues() : pressure(0.0), duration(0) {}
+        StepValues(double p, int d) : pressure(p), duration(d) {}
+    };
+
     explicit PatternValidator(QObject *parent = nullptr);
     ~PatternValidator();
 
@@ -68,6 +79,26 @@ public:
     ValidationReport validatePatternSteps(const QJsonArray& steps, ValidationLevel level = COMPREHENSIVE);
     ValidationReport validatePatternParameters(const QJsonObject& parameters, ValidationLevel level = COMPREHENSIVE);
     
+    // Incremental validation for editors. beginIncremental() checks the
+    // pattern once; each edit then rechecks only the edited step and its
+    // neighbours and updates the running aggregates, so the result and
+    // statistics stay current in O(window) per edit. patternData supplies
+    // the name, type and parameters; its "steps" entry is ignored.
+    void beginIncremental(const QJsonObject& patternData, const QVector<StepValues>& steps,
+                          ValidationLevel level = COMPREHENSIVE);
+    void endIncremental();
+    bool isIncrementalActive() const { return m_incremental != nullptr; }
+    int incrementalStepCount() const;
+    void insertStep(int index, const StepValues& step);
+    void removeStep(int index);
+    void updateStep(int index, const StepValues& step);
+    void moveStep(int from, int to);
+    ValidationResult incrementalResult() const;
+    int incrementalIssueCount(ValidationResult severity) const;
+    QJsonObject incrementalStatistics() const;
+    // Full report with per-step messages; O(steps)
+    ValidationReport incrementalReport();
+
     // Quick validation
     bool isPatternSafe(const QJsonObject& patternData);
     bool areStepsSafe(const QJsonArray& steps);
@@ -118,6 +149,15 @@ private:
     ValidationResult determineOverallResult(const QList<ValidationIssue>& issues);
     QJsonObject generateStatistics(const QJsonArray& steps);
     QStringList generateRecommendations(const QList<ValidationIssue>& issues);
+    QString cacheContext(ValidationLevel level) const;
+
+    // Incremental validation
+    struct IncrementalState;
+    quint16 incrementalStepFlags(int index) const;
+    void refreshIncrementalStep(int index);
+    void addIncrementalAggregates(const StepValues& step, int sign);
+    double incrementalComplexity() const;
+    double incrementalPressureVariability() const;
     
     // Configuration
     ValidationLevel m_validationLevel;
@@ -138,6 +178,8 @@ private:
     double m_warningPressureThreshold;     // Pressure warning threshold
     double m_warningDurationThreshold;     // Duration warning threshold
     double m_warningGradientThreshold;     // Gradient warning threshold
+
+    std::unique_ptr<IncrementalState> m_incremental;
     
     // Constants
     static constexpr double DEFAULT_MAX_PRESSURE = 90.0;          // 90.0%
@@ -151,6 +193,7 @@ private:
     static constexpr double WARNING_PRESSURE_THRESHOLD = 80.0;    // 80.0%
     static constexpr int WARNING_DURATION_THRESHOLD = 30000;       // 30000ms (30 seconds)
     static constexpr double WARNING_GRADIENT_THRESHOLD = 30.0;    // 30.0%/s
+    static constexpr int VALIDATION_RULES_VERSION = 1;            // Bump whenever a rule's logic changes
     
     static const QStringList VALID_ACTIONS;
     static const QStringList REQUIRED_STEP_FIELDS;
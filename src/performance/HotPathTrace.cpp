@@ -0,0 +1,237 @@
+#include "HotPathTrace.h"
+#include <QDebug>
+#include <QTextStream>
+#include <mutex>
+#include <vector>
+#include <memory>
+
+namespace HotPathTrace {
+
+std::atomic<uint32_t> g_categoryMask{ALL_CATEGORIES};
+std::atomic<int> g_runtimeLevel{VC_TRACE_COMPILED_LEVEL};
+
+namespace {
+
+/**
+ * Per-thread single-producer/single-consumer ring. The owning thread is the
+ * only writer; the collector (serialized by g_drainMutex) is the only reader.
+ */
+struct ThreadRing {
+    static constexpr uint32_t CAPACITY = 4096;  // Power of two
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    alignas(64) std::atomic<uint32_t> head{0};   // Written by producer
+    alignas(64) std::atomic<uint32_t> tail{0};   // Written by consumer
+    uint16_t threadIndex = 0;
+    Record records[CAPACITY];
+};
+
+std::mutex g_registryMutex;                          // Ring registration and reuse
+std::mutex g_drainMutex;                             // Serializes consumers
+std::vector<std::unique_ptr<ThreadRing>> g_rings;    // Every ring ever created, drained in order
+std::vector<ThreadRing*> g_freeRings;                // Rings released by exited threads
+std::atomic<uint64_t> g_dropped{0};
+
+/**
+ * Binds a ring to the current thread and hands it back for reuse when the
+ * thread exits, so threads started per session (oscillator and TENS
+ * sequencers) do not grow the registry. The ring count is bounded by the
+ * number of threads tracing at once, which also keeps threadIndex in range.
+ * Records left in a released ring are still drained normally.
+ */
+struct ThreadRingLease {
+    ThreadRing* ring = nullptr;
+
+    ~ThreadRingLease()
+    {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            g_freeRings.push_back(ring);
+        }
+    }
+};
+
+ThreadRing* threadRing()
+{
+    thread_local ThreadRingLease lease;
+    if (!lease.ring) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        if (!g_freeRings.empty()) {
+            lease.ring = g_freeRings.back();
+            g_freeRings.pop_back();
+        } else {
+            auto created = std::make_unique<ThreadRing>();
+            created->threadIndex = static_cast<uint16_t>(g_rings.size());
+            lease.ring = created.get();
+            g_rings.push_back(std::move(created));
+        }
+    }
+    return lease.ring;
+}
+
+} // namespace
+
+void setCategoryMask(uint32_t mask)
+{
+    g_categoryMask.store(mask, std::memory_order_relaxed);
+}
+
+void setRuntimeLevel(int level)
+{
+    g_runtimeLevel.store(level, std::memory_order_relaxed);
+}
+
+void write(uint32_t category, int level, const char* event,
+           int argCount, double a0, double a1, double a2, double a3)
+{
+    ThreadRing* ring = threadRing();
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    const uint32_t tail = ring->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= ThreadRing::CAPACITY) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;  // Never block the hot path
+    }
+
+    Record& record = ring->records[head & ThreadRing::MASK];
+    record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    record.event = event;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+    record.args[3] = a3;
+    record.category = category;
+    record.threadIndex = ring->threadIndex;
+    record.level = static_cast<uint8_t>(level);
+    record.argCount = static_cast<uint8_t>(argCount);
+
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+int drain(const std::function<void(const Record&)>& sink)
+{
+    std::lock_guard<std::mutex> drainLock(g_drainMutex);
+
+    std::vector<ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        rings.reserve(g_rings.size());
+        for (const auto& ring : g_rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    int delivered = 0;
+    for (ThreadRing* ring : rings) {
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        while (tail != head) {
+            sink(ring->records[tail & ThreadRing::MASK]);
+            ++tail;
+            ++delivered;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    return delivered;
+}
+
+uint64_t droppedRecords()
+{
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+const char* categoryName(uint32_t category)
+{
+    switch (category) {
+        case SPI: return "SPI";
+        case ACQUISITION: return "ACQ";
+        case OSCILLATOR: return "OSC";
+        case TENS: return "TENS";
+        case PATTERN: return "PATTERN";
+        case CONTROL: return "CONTROL";
+        case SAFETY: return "SAFETY";
+        case LOGGING: return "LOG";
+        case GPIO: return "GPIO";
+        default: return "TRACE";
+    }
+}
+
+} // namespace HotPathTrace
+
+HotPathTraceCollector::HotPathTraceCollector(QObject *parent)
+    : QThread(parent)
+    , m_drainIntervalMs(DEFAULT_DRAIN_INTERVAL_MS)
+    , m_stopRequested(false)
+    , m_recordsWritten(0)
+{
+}
+
+HotPathTraceCollector::~HotPathTraceCollector()
+{
+    requestStop();
+    wait(2000);
+}
+
+void HotPathTraceCollector::setOutputFile(const QString& filePath)
+{
+    m_outputPath = filePath;
+}
+
+void HotPathTraceCollector::requestStop()
+{
+    m_stopRequested = true;
+}
+
+void HotPathTraceCollector::run()
+{
+    // Formatting and I/O must never compete with acquisition or valve timing
+    setPriority(QThread::LowestPriority);
+
+    if (!m_outputPath.isEmpty()) {
+        m_outputFile.setFileName(m_outputPath);
+        if (!m_outputFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            qWarning() << "HotPathTraceCollector: cannot open" << m_outputPath << "- falling back to qDebug";
+        }
+    }
+
+    while (!m_stopRequested) {
+        drainOnce();
+        msleep(m_drainIntervalMs);
+    }
+
+    drainOnce();  // Flush whatever is left
+    if (m_outputFile.isOpen()) {
+        m_outputFile.close();
+    }
+}
+
+void HotPathTraceCollector::drainOnce()
+{
+    if (m_outputFile.isOpen()) {
+        QTextStream stream(&m_outputFile);
+        int count = HotPathTrace::drain([&stream](const HotPathTrace::Record& record) {
+            stream << formatRecord(record) << '\n';
+        });
+        stream.flush();
+        m_recordsWritten += count;
+    } else {
+        int count = HotPathTrace::drain([](const HotPathTrace::Record& record) {
+            qDebug().noquote() << formatRecord(record);
+        });
+        m_recordsWritten += count;
+    }
+}
+
+QString HotPathTraceCollector::formatRecord(const HotPathTrace::Record& record)
+{
+    QString line = QString("%1 [%2] T%3 %4")
+                       .arg(record.timestampNs / 1000)
+                       .arg(HotPathTrace::categoryName(record.category))
+                       .arg(record.threadIndex)
+                       .arg(record.event ? record.event : "?");
+    for (int i = 0; i < record.argCount && i < 4; ++i) {
+        line += QString(" %1").arg(record.args[i], 0, 'g', 8);
+    }
+    return line;
+}
@@ -0,0 +1,164 @@
+#ifndef HOTPATHTRACE_H
+#define HOTPATHTRACE_H
+
+#include <QThread>
+#include <QString>
+#include <QFile>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @brief Compile-time removable tracing for per-sample and per-tick code paths
+ *
+ * qDebug() in the SPI transfer, oscillator tick or arousal update formats a
+ * QString and takes the logging lock on every call, which shifts timing
+ * enough to hide the bugs being chased. VC_TRACE() instead:
+ * - compiles to nothing when the level is above VC_TRACE_COMPILED_LEVEL
+ *   (Release builds default to OFF, see CMakeLists.txt)
+ * - otherwise checks an atomic category mask / level, then writes one
+ *   fixed-size binary record into a per-thread SPSC ring (no allocation,
+ *   no locks, no formatting)
+ * - records are formatted later by HotPathTraceCollector on its own
+ *   low-priority thread
+ *
+ * Usage:
+ * @code
+ * VC_TRACE(HotPathTrace::SPI, HotPathTrace::LEVEL_DEBUG, "mcp3008.transfer", channel, result);
+ * @endcode
+ *
+ * The event name must be a string literal (only the pointer is stored).
+ * Up to four numeric arguments are captured as doubles.
+ */
+
+#ifndef VC_TRACE_COMPILED_LEVEL
+#define VC_TRACE_COMPILED_LEVEL 0
+#endif
+
+namespace HotPathTrace {
+
+enum Level : uint8_t {
+    LEVEL_OFF = 0,
+    LEVEL_ERROR = 1,
+    LEVEL_WARNING = 2,
+    LEVEL_INFO = 3,
+    LEVEL_DEBUG = 4,
+    LEVEL_VERBOSE = 5
+};
+
+enum Category : uint32_t {
+    SPI         = 1u << 0,   // MCP3008 / SPI transfers
+    ACQUISITION = 1u << 1,   // DataAcquisitionThread sampling
+    OSCILLATOR  = 1u << 2,   // ClitoralOscillator phase machine
+    TENS        = 1u << 3,   // TENSController waveform
+    PATTERN     = 1u << 4,   // PatternEngine step execution
+    CONTROL     = 1u << 5,   // OrgasmControlAlgorithm
+    SAFETY      = 1u << 6,   // Safety monitors
+    LOGGING     = 1u << 7,   // DataLogger
+    GPIO        = 1u << 8,   // Actuator GPIO line writes
+    ALL_CATEGORIES = 0xFFFFFFFFu
+};
+
+/**
+ * @brief Fixed-size binary trace record (56 bytes, no heap data)
+ */
+struct Record {
+    int64_t timestampNs;      // steady_clock
+    const char* event;        // String literal, never freed
+    double args[4];
+    uint32_t category;
+    uint16_t threadIndex;     // Ring slot; reused once its thread exits
+    uint8_t level;
+    uint8_t argCount;
+};
+
+constexpr bool compiledIn(int level)
+{
+    return level > LEVEL_OFF && level <= VC_TRACE_COMPILED_LEVEL;
+}
+
+// Runtime filter (only consulted for compiled-in levels)
+extern std::atomic<uint32_t> g_categoryMask;
+extern std::atomic<int> g_runtimeLevel;
+
+inline bool enabled(uint32_t category, int level)
+{
+    return level <= g_runtimeLevel.load(std::memory_order_relaxed) &&
+           (g_categoryMask.load(std::memory_order_relaxed) & category) != 0;
+}
+
+void setCategoryMask(uint32_t mask);
+void setRuntimeLevel(int level);
+
+// Hot path: append a record to the calling thread's ring (drops when full)
+void write(uint32_t category, int level, const char* event,
+           int argCount, double a0, double a1, double a2, double a3);
+
+// Drain every registered per-thread ring; returns number of records delivered
+int drain(const std::function<void(const Record&)>& sink);
+
+// Records dropped because a ring was full (since process start)
+uint64_t droppedRecords();
+
+const char* categoryName(uint32_t category);
+
+template<typename... Args>
+inline void emitRecord(uint32_t category, int level, const char* event, Args... args)
+{
+    static_assert(sizeof...(Args) <= 4, "VC_TRACE supports at most four arguments");
+    double values[4] = { static_cast<double>(args)... };
+    write(category, level, event, static_cast<int>(sizeof...(Args)),
+          sizeof...(Args) > 0 ? values[0] : 0.0, sizeof...(Args) > 1 ? values[1] : 0.0,
+          sizeof...(Args) > 2 ? values[2] : 0.0, sizeof...(Args) > 3 ? values[3] : 0.0);
+}
+
+} // namespace HotPathTrace
+
+// VC_TRACE(category, level, "event.name", args...)
+#define VC_TRACE(category, level, ...)                                                     \
+    do {                                                                                   \
+        if constexpr (HotPathTrace::compiledIn(level)) {                                   \
+            if (HotPathTrace::enabled((category), (level))) {                              \
+                HotPathTrace::emitRecord((category), (level), __VA_ARGS__);                \
+            }                                                                              \
+        }                                                                                  \
+    } while (0)
+
+/**
+ * @brief Low-priority thread that drains trace rings and formats records
+ *
+ * Writes one text line per record to the configured file, or to qDebug()
+ * when no file is set. Formatting and I/O happen only on this thread.
+ */
+class HotPathTraceCollector : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit HotPathTraceCollector(QObject *parent = nullptr);
+    ~HotPathTraceCollector();
+
+    void setOutputFile(const QString& filePath);
+    void setDrainIntervalMs(int intervalMs) { m_drainIntervalMs = intervalMs; }
+    void requestStop();
+
+    quint64 getRecordsWritten() const { return m_recordsWritten.load(); }
+
+protected:
+    void run() override;
+
+private:
+    void drainOnce();
+    static QString formatRecord(const HotPathTrace::Record& record);
+
+    QString m_outputPath;
+    QFile m_outputFile;
+    int m_drainIntervalMs;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<quint64> m_recordsWritten;
+
+    static const int DEFAULT_DRAIN_INTERVAL_MS = 50;
+};
+
+#endif // HOTPATHTRACE_H
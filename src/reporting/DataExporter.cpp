@@ -1,6 +1,7 @@
 #include "DataExporter.h"
 #include "../VacuumController.h"
 #include "../logging/DataLogger.h"
+#include "../logging/SessionRecording.h"
 #include <QDebug>
 #include <QFile>
 #include <QDir>
@@ -16,6 +17,10 @@ const QString DataExporter::DEFAULT_EXPORT_PATH = QStandardPaths::writableLocati
 const QStringList DataExporter::CSV_HEADERS_PRESSURE = {"Timestamp", "AVL_Pressure", "Tank_Pressure", "Target_Pressure", "Pattern_Name"};
 const QStringList DataExporter::CSV_HEADERS_PATTERN = {"Timestamp", "Pattern_Name", "Step", "Action", "Pressure", "Duration"};
 const QStringList DataExporter::CSV_HEADERS_SAFETY = {"Timestamp", "Event_Type", "Severity", "Component", "Message", "Data"};
+const QStringList DataExporter::CSV_HEADERS_SESSION_RECORDING = {"Timestamp", "Session_ms", "AVL_Pressure", "Tank_Pressure",
+                                                                 "Clitoral_Pressure", "Valves_SOL1_5", "Pump_Speed",
+                                                                 "Oscillator_Hz", "Oscillator_Amplitude", "TENS_Amplitude",
+                                                                 "Arousal", "Control_State", "Mode", "Events"};
 
 DataExporter::DataExporter(VacuumController* controller, DataLogger* logger, QObject *parent)
     : QObject(parent)
@@ -167,6 +172,79 @@ bool DataExporter::exportPressureData(const QString& filePath, const QDateTime&
     return exportData(options);
 }
 
+bool DataExporter::exportSessionRecording(const QString& recordingPath, const QString& filePath)
+{
+    using namespace SessionRecording;
+
+    SessionRecordingReader reader;
+    if (!reader.open(recordingPath)) {
+        emit exportError(QString("Cannot read session recording: %1").arg(reader.lastError()));
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        emit exportError(QString("Cannot open file for writing: %1").arg(filePath));
+        return false;
+    }
+
+    emit exportStarted("Exporting session recording");
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << CSV_HEADERS_SESSION_RECORDING.join(",") << "\n";
+
+    // Records are read in place from the mapping; outputs, arousal and
+    // transitions carry forward to the next sensor row
+    ActuatorRecord actuators;
+    ArousalRecord arousal;
+    QStringList events;
+    const quint64 total = qMax<quint64>(1, reader.recordCount());
+    quint64 index = 0;
+    for (auto record = reader.first(); record.isValid(); record = reader.next(record), ++index) {
+        if (const ActuatorRecord* outputs = record.as<ActuatorRecord>()) {
+            actuators = *outputs;
+        } else if (const ArousalRecord* estimate = record.as<ArousalRecord>()) {
+            arousal = *estimate;
+        } else if (const TransitionRecord* transition = record.as<TransitionRecord>()) {
+            const char* kind = transition->kind == TransitionRecord::MODE ? "mode"
+                             : transition->kind == TransitionRecord::AROUSAL_STATE ? "arousal" : "state";
+            events << QString("%1 %2->%3").arg(kind).arg(transition->from).arg(transition->to);
+        } else if (const SensorRecord* sensor = record.as<SensorRecord>()) {
+            QString valves;
+            for (uint32_t valve : {ActuatorRecord::SOL1, ActuatorRecord::SOL2, ActuatorRecord::SOL3,
+                                   ActuatorRecord::SOL4, ActuatorRecord::SOL5}) {
+                valves += (actuators.outputs & valve) ? '1' : '0';
+            }
+            QStringList values;
+            values << QDateTime::fromMSecsSinceEpoch(sensor->timestampMs).toString(Qt::ISODateWithMs)
+                   << QString::number((record.monotonicNs() - reader.startMonotonicNs()) / 1.0e6, 'f', 1)
+                   << QString::number(sensor->avlPressure, 'f', 2)
+                   << QString::number(sensor->tankPressure, 'f', 2)
+                   << QString::number(sensor->clitoralPressure, 'f', 2)
+                   << valves
+                   << QString::number(actuators.has(ActuatorRecord::PUMP_ON) ? actuators.pumpSpeedPercent : 0.0, 'f', 1)
+                   << QString::number(actuators.oscillatorFrequencyHz, 'f', 1)
+                   << QString::number(actuators.oscillatorAmplitudeMmHg, 'f', 2)
+                   << QString::number(actuators.has(ActuatorRecord::TENS_RUNNING) ? actuators.tensAmplitudePercent : 0.0, 'f', 1)
+                   << QString::number(arousal.arousalLevel, 'f', 3)
+                   << QString::number(arousal.controlState)
+                   << QString::number(arousal.mode)
+                   << events.join(";");
+            stream << values.join(",") << "\n";
+            events.clear();
+        }
+
+        if (index % 10000 == 0) {
+            emit exportProgress(static_cast<int>(index * 100 / total));
+        }
+    }
+
+    stream.flush();
+    emit exportProgress(100);
+    emit exportCompleted(filePath, true);
+    return true;
+}
+
 DataExporter::ReportData DataExporter::generateSessionReport(const QDateTime& startTime, const QDateTime& endTime)
 {
     ReportData report;
@@ -90,6 +90,9 @@ public:
     bool exportPressureData(const QString& filePath, const QDateTime& startTime, const QDateTime& endTime);
     bool exportPatternUsage(const QString& filePath, const QDateTime& startTime, const QDateTime& endTime);
     bool exportSafetyEvents(const QString& filePath, const QDateTime& startTime, const QDateTime& endTime);
+    // One row per sensor snapshot of a session recording (.vcsr), with the
+    // actuator outputs, arousal estimate and transitions in force at the time
+    bool exportSessionRecording(const QString& recordingPath, const QString& filePath);
     
     // Report generation
     ReportData generateSessionReport(const QDateTime& startTime, const QDateTime& endTime);
@@ -200,6 +203,7 @@ private:
     static const QStringList CSV_HEADERS_PRESSURE;
     static const QStringList CSV_HEADERS_PATTERN;
     static const QStringList CSV_HEADERS_SAFETY;
+    static const QStringList CSV_HEADERS_SESSION_RECORDING;
 };
 
 #endif // DATAEXPORTER_H
@@ -48,7 +48,7 @@ AntiDetachmentMonitor::AntiDetachmentMonitor(HardwareManager* hardware, QObject
     , m_totalResponseTime(0.0)
     , m_responseCount(0)
     , m_averageResponseTime(0.0)
-    , m_monitoringTimer(new QTimer(this))
+    , m_monitoringTimer(new ControlTimer(this))
     , m_consecutiveErrors(0)
     , m_emergencyStopCoordinator(nullptr)
     , m_safetyLogger(nullptr)
@@ -56,7 +56,7 @@ AntiDetachmentMonitor::AntiDetachmentMonitor(HardwareManager* hardware, QObject
     // Set up monitoring timer for high-frequency monitoring
     m_monitoringTimer->setInterval(1000 / m_monitoringRateHz);  // Convert Hz to ms
     m_monitoringTimer->setTimerType(Qt::PreciseTimer);
-    connect(m_monitoringTimer, &QTimer::timeout, this, &AntiDetachmentMonitor::performMonitoringCycle);
+    connect(m_monitoringTimer, &ControlTimer::timeout, this, &AntiDetachmentMonitor::performMonitoringCycle);
 
     // Set up response timer for delayed response
     m_responseTimer->setSingleShot(true);
@@ -79,6 +79,12 @@ AntiDetachmentMonitor::~AntiDetachmentMonitor()
     shutdown();
 }
 
+void AntiDetachmentMonitor::attachToScheduler(ControlScheduler* scheduler)
+{
+    // Adjusts vacuum to hold the seal, so it runs with the actuators
+    m_monitoringTimer->attach(scheduler, ControlScheduler::Stage::ACTUATE, "AntiDetachment.monitor");
+}
+
 bool AntiDetachmentMonitor::initialize()
 {
     if (!m_hardware) {
@@ -251,7 +257,7 @@ bool AntiDetachmentMonitor::performSelfTest()
 
     try {
         // Test AVL pressure reading
-        double testPressure = m_hardware->readAVLPressure();
+        double testPressure = m_hardware->getSensorSnapshot().avlPressure;
         if (!SafetyConstants::isValidPressure(testPressure)) {
             throw std::runtime_error("Invalid AVL pressure reading during self-test");
         }
@@ -293,8 +299,8 @@ void AntiDetachmentMonitor::performMonitoringCycle()
     if (!m_active || !m_monitoring || m_paused) return;
 
     try {
-        // Read AVL pressure
-        double avlPressure = m_hardware->readAVLPressure();
+        // Read AVL pressure from the shared acquisition snapshot
+        double avlPressure = m_hardware->getSensorSnapshot().avlPressure;
 
         if (!SafetyConstants::isValidPressure(avlPressure)) {
             m_consecutiveErrors++;
@@ -713,7 +719,7 @@ bool AntiDetachmentMonitor::resetSystemError()
     // Use SafeOperationHelper for consistent error handling
     auto result = SafeOperationHelper::execute<double>(
         "resetSystemError", "AntiDetachmentMonitor",
-        [this]() { return m_hardware->readAVLPressure(); },
+        [this]() { return m_hardware->getSensorSnapshot().avlPressure; },
         [this](const QString& err) { emit systemError(err); }
     );
 
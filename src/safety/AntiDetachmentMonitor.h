@@ -7,6 +7,7 @@
 #include <QQueue>
 #include <QDateTime>
 #include "../core/StatefulComponent.h"
+#include "../threading/ControlScheduler.h"
 
 // Forward declarations
 class HardwareManager;
@@ -56,6 +57,9 @@ public:
     explicit AntiDetachmentMonitor(HardwareManager* hardware, QObject *parent = nullptr);
     ~AntiDetachmentMonitor();
 
+    // Drive the periodic tick from the shared control scheduler
+    void attachToScheduler(ControlScheduler* scheduler);
+
     // System control
     bool initialize();
     void shutdown();
@@ -185,7 +189,7 @@ private:
     double m_averageResponseTime;
 
     // Monitoring timer
-    QTimer* m_monitoringTimer;
+    ControlTimer* m_monitoringTimer;
 
     // Error handling
     QString m_lastError;
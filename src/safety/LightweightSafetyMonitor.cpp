@@ -146,9 +146,10 @@ void LightweightSafetyMonitor::checkPressureLimits()
 {
     if (!m_hardware) return;
     
-    // Read pressures (these calls should be fast)
-    double avlPressure = m_hardware->readAVLPressure();
-    double tankPressure = m_hardware->readTankPressure();
+    // Read pressures from the shared acquisition snapshot (lock-free)
+    const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+    double avlPressure = snapshot.avlPressure;
+    double tankPressure = snapshot.tankPressure;
     
     // Validate readings using centralized SafetyConstants
     if (!SafetyConstants::isValidPressure(avlPressure) || !SafetyConstants::isValidPressure(tankPressure)) {
@@ -29,7 +29,7 @@ SafetyManager::SafetyManager(HardwareManager* hardware, QObject *parent)
     , m_maxPressure(DEFAULT_MAX_PRESSURE)
     , m_warningThreshold(DEFAULT_WARNING_THRESHOLD)
     , m_sensorTimeoutMs(DEFAULT_SENSOR_TIMEOUT_MS)
-    , m_monitoringTimer(new QTimer(this))
+    , m_monitoringTimer(new ControlTimer(this))
     , m_lastAVLReading(0)
     , m_lastTankReading(0)
     , m_overpressureEvents(0)
@@ -44,7 +44,7 @@ SafetyManager::SafetyManager(HardwareManager* hardware, QObject *parent)
 {
     // Set up monitoring timer
     m_monitoringTimer->setInterval(MONITORING_INTERVAL_MS);
-    connect(m_monitoringTimer, &QTimer::timeout, this, &SafetyManager::performSafetyMonitoring);
+    connect(m_monitoringTimer, &ControlTimer::timeout, this, &SafetyManager::performSafetyMonitoring);
 
     // Register state transition callback with StatefulComponent base
     registerTransitionCallback([this](int oldState, int newState) {
@@ -61,6 +61,11 @@ SafetyManager::~SafetyManager()
     shutdown();
 }
 
+void SafetyManager::attachToScheduler(ControlScheduler* scheduler, int offset)
+{
+    m_monitoringTimer->attach(scheduler, ControlScheduler::Stage::CONTROL, "SafetyManager.monitor", ControlScheduler::DEFAULT_TASK_BUDGET_US, offset);
+}
+
 bool SafetyManager::initialize()
 {
     if (!m_hardware) {
@@ -371,8 +376,9 @@ bool SafetyManager::checkPressureLimits()
     }
 
     try {
-        double avlPressure = m_hardware->readAVLPressure();
-        double tankPressure = m_hardware->readTankPressure();
+        const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+        double avlPressure = snapshot.avlPressure;
+        double tankPressure = snapshot.tankPressure;
         
         // Evaluate complex safety conditions that combine sensor validity and pump behavior
         evaluateRunawayAndInvalidSensors(avlPressure, tankPressure);
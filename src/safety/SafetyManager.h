@@ -6,6 +6,7 @@
 #include <QMutex>
 #include "../core/StatefulComponent.h"
 #include "SafetyConstants.h"
+#include "../threading/ControlScheduler.h"
 
 // Forward declarations
 class HardwareManager;
@@ -37,6 +38,10 @@ public:
     explicit SafetyManager(HardwareManager* hardware, QObject *parent = nullptr);
     ~SafetyManager();
 
+    // Drive the periodic tick from the shared control scheduler; offset is
+    // the cycle within each period it runs on
+    void attachToScheduler(ControlScheduler* scheduler, int offset = 0);
+
     // Safety system states
     enum SafetyState {
         SAFE,           // All systems normal
@@ -154,7 +159,7 @@ private:
     int m_sensorTimeoutMs;       // Sensor timeout in milliseconds
 
     // Monitoring
-    QTimer* m_monitoringTimer;
+    ControlTimer* m_monitoringTimer;
 
     // Safety tracking
     QString m_lastSafetyError;
@@ -0,0 +1,454 @@
+#include "ControlScheduler.h"
+#include "RealTimeSupport.h"
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+ControlScheduler::ControlScheduler(int baseRateHz, QObject *parent)
+    : QObject(parent)
+    , m_baseRateHz(DEFAULT_BASE_RATE_HZ)
+    , m_periodNs(1000000000LL / DEFAULT_BASE_RATE_HZ)
+    , m_nextTaskId(0)
+    , m_inCycle(false)
+    , m_tasksDirty(false)
+    , m_timer(new QTimer(this))
+    , m_running(false)
+    , m_startNs(0)
+    , m_cycle(0)
+    , m_missedCycles(0)
+    , m_cycleOverruns(0)
+    , m_maxCycleUs(0.0)
+{
+    setBaseRateHz(baseRateHz);
+
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ControlScheduler::onBaseTick);
+}
+
+ControlScheduler::~ControlScheduler()
+{
+    stop();
+}
+
+bool ControlScheduler::setBaseRateHz(int hz)
+{
+    if (m_running) {
+        qWarning() << "ControlScheduler: base rate cannot change while running";
+        return false;
+    }
+    if (hz <= 0 || hz > MAX_BASE_RATE_HZ || 1000 % hz != 0) {
+        qWarning() << "ControlScheduler: invalid base rate" << hz << "Hz (must divide 1000)";
+        return false;
+    }
+
+    m_baseRateHz = hz;
+    m_periodNs = 1000000000LL / hz;
+    return true;
+}
+
+int ControlScheduler::divisorForIntervalMs(int intervalMs) const
+{
+    if (intervalMs <= 0) {
+        return 1;   // Interval not set yet; start(msec) retunes the divisor
+    }
+
+    const int periodMs = basePeriodMs();
+    const int divisor = qMax(1, (intervalMs + periodMs / 2) / periodMs);
+    if (divisor * periodMs != intervalMs) {
+        qWarning() << "ControlScheduler: interval" << intervalMs << "ms is not a multiple of the"
+                   << periodMs << "ms base period; using" << divisor * periodMs << "ms";
+    }
+    return divisor;
+}
+
+int ControlScheduler::addTask(const QString& name, Stage stage, int divisor, std::function<void()> task,
+                              double budgetUs, int offset)
+{
+    if (!task || divisor < 1 || offset < 0 || offset >= divisor) {
+        qWarning() << "ControlScheduler: rejected task" << name;
+        return -1;
+    }
+
+    const int id = m_nextTaskId++;
+
+    Task entry;
+    entry.id = id;
+    entry.name = name;
+    entry.stage = stage;
+    entry.divisor = divisor;
+    entry.offset = offset;
+    entry.enabled = true;
+    entry.removed = false;
+    entry.budgetUs = qMax(0.0, budgetUs);
+    entry.function = std::move(task);
+    entry.runs = 0;
+    entry.overruns = 0;
+    entry.lastUs = 0.0;
+    entry.maxUs = 0.0;
+    entry.totalUs = 0.0;
+
+    // A running cycle may be executing a function stored in m_tasks, so
+    // growing it then could move that function; new tasks join next cycle
+    m_pendingTasks.append(std::move(entry));
+    m_tasksDirty = true;
+    if (!m_inCycle) {
+        compactTasks();
+    }
+
+    qDebug() << "ControlScheduler: task" << name << "stage" << stageName(stage)
+             << "every" << divisor << "cycle(s)";
+    return id;
+}
+
+void ControlScheduler::removeTask(int id)
+{
+    Task* task = findTask(id);
+    if (!task) {
+        return;
+    }
+
+    // Never destroy a task function mid-cycle; it may be the one executing
+    task->removed = true;
+    task->enabled = false;
+    m_tasksDirty = true;
+    if (!m_inCycle) {
+        compactTasks();
+    }
+}
+
+void ControlScheduler::setTaskEnabled(int id, bool enabled)
+{
+    if (Task* task = findTask(id)) {
+        task->enabled = enabled;
+    }
+}
+
+void ControlScheduler::setTaskDivisor(int id, int divisor)
+{
+    Task* task = findTask(id);
+    if (task && divisor >= 1) {
+        task->divisor = divisor;
+        task->offset = qMin(task->offset, divisor - 1);
+    }
+}
+
+void ControlScheduler::setTaskOffset(int id, int offset)
+{
+    Task* task = findTask(id);
+    if (task && offset >= 0) {
+        task->offset = offset % task->divisor;
+    }
+}
+
+void ControlScheduler::setTaskBudget(int id, double budgetUs)
+{
+    if (Task* task = findTask(id)) {
+        task->budgetUs = qMax(0.0, budgetUs);
+    }
+}
+
+bool ControlScheduler::hasTask(int id) const
+{
+    return findTask(id) != nullptr;
+}
+
+void ControlScheduler::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_cycle = 0;
+    m_startNs = RealTime::monotonicNowNs();
+    armNextDeadline();
+
+    qDebug() << "ControlScheduler: started at" << m_baseRateHz << "Hz with" << m_tasks.size() << "tasks";
+}
+
+void ControlScheduler::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_timer->stop();
+    qDebug() << "ControlScheduler: stopped after" << m_cycle << "cycles";
+}
+
+void ControlScheduler::runCycle()
+{
+    executeCycle(m_cycle);
+    m_cycle++;
+}
+
+void ControlScheduler::onBaseTick()
+{
+    if (!m_running) {
+        return;
+    }
+
+    // Skip forward over whole periods that were missed instead of bursting
+    const int64_t elapsedNs = RealTime::monotonicNowNs() - m_startNs;
+    const quint64 dueCycle = static_cast<quint64>(elapsedNs / m_periodNs);
+    if (dueCycle > m_cycle) {
+        const quint64 missed = dueCycle - m_cycle;
+        m_missedCycles += missed;
+        m_cycle = dueCycle;
+        emit cyclesMissed(missed);
+    }
+
+    runCycle();
+
+    if (m_running) {
+        armNextDeadline();
+    }
+}
+
+void ControlScheduler::armNextDeadline()
+{
+    const int64_t deadlineNs = m_startNs + static_cast<int64_t>(m_cycle) * m_periodNs;
+    const int64_t remainingNs = deadlineNs - RealTime::monotonicNowNs();
+    const int delayMs = remainingNs > 0 ? static_cast<int>((remainingNs + 999999) / 1000000) : 0;
+    m_timer->start(delayMs);
+}
+
+void ControlScheduler::executeCycle(quint64 cycle)
+{
+    const int64_t cycleStartNs = RealTime::monotonicNowNs();
+    m_inCycle = true;
+
+    // Tasks are kept sorted by stage; size is fixed for the cycle
+    const int count = m_tasks.size();
+    for (int i = 0; i < count; ++i) {
+        if (!m_tasks[i].enabled || cycle % static_cast<quint64>(m_tasks[i].divisor)
+                                   != static_cast<quint64>(m_tasks[i].offset)) {
+            continue;
+        }
+
+        const int64_t taskStartNs = RealTime::monotonicNowNs();
+        m_tasks[i].function();
+        const double executionUs = (RealTime::monotonicNowNs() - taskStartNs) / 1000.0;
+
+        Task& task = m_tasks[i];
+        task.runs++;
+        task.lastUs = executionUs;
+        task.maxUs = qMax(task.maxUs, executionUs);
+        task.totalUs += executionUs;
+
+        if (task.budgetUs > 0.0 && executionUs > task.budgetUs) {
+            task.overruns++;
+            if (task.overruns == 1 || task.overruns % OVERRUN_LOG_INTERVAL == 0) {
+                qWarning() << "ControlScheduler: task" << task.name << "took" << executionUs
+                           << "us (budget" << task.budgetUs << "us, overrun" << task.overruns << ")";
+            }
+            emit taskOverrun(task.name, executionUs, task.budgetUs);
+        }
+    }
+
+    m_inCycle = false;
+    if (m_tasksDirty) {
+        compactTasks();
+    }
+
+    const double cycleUs = (RealTime::monotonicNowNs() - cycleStartNs) / 1000.0;
+    m_maxCycleUs = qMax(m_maxCycleUs, cycleUs);
+    if (cycleUs * 1000.0 > m_periodNs) {
+        m_cycleOverruns++;
+    }
+}
+
+void ControlScheduler::compactTasks()
+{
+    for (Task& task : m_pendingTasks) {
+        m_tasks.append(std::move(task));
+    }
+    m_pendingTasks.clear();
+
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(),
+                                 [](const Task& task) { return task.removed; }),
+                  m_tasks.end());
+    std::stable_sort(m_tasks.begin(), m_tasks.end(), [](const Task& a, const Task& b) {
+        return static_cast<int>(a.stage) < static_cast<int>(b.stage);
+    });
+    m_tasksDirty = false;
+}
+
+ControlScheduler::Task* ControlScheduler::findTask(int id)
+{
+    for (Task& task : m_tasks) {
+        if (task.id == id && !task.removed) {
+            return &task;
+        }
+    }
+    for (Task& task : m_pendingTasks) {
+        if (task.id == id && !task.removed) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+const ControlScheduler::Task* ControlScheduler::findTask(int id) const
+{
+    for (const Task& task : m_tasks) {
+        if (task.id == id && !task.removed) {
+            return &task;
+        }
+    }
+    for (const Task& task : m_pendingTasks) {
+        if (task.id == id && !task.removed) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+QVector<ControlScheduler::TaskStatistics> ControlScheduler::getTaskStatistics() const
+{
+    QVector<TaskStatistics> result;
+    result.reserve(m_tasks.size());
+    for (const Task& task : m_tasks) {
+        if (task.removed) {
+            continue;
+        }
+        TaskStatistics stats;
+        stats.id = task.id;
+        stats.name = task.name;
+        stats.stage = task.stage;
+        stats.divisor = task.divisor;
+        stats.offset = task.offset;
+        stats.enabled = task.enabled;
+        stats.budgetUs = task.budgetUs;
+        stats.runs = task.runs;
+        stats.overruns = task.overruns;
+        stats.lastUs = task.lastUs;
+        stats.maxUs = task.maxUs;
+        stats.meanUs = task.runs > 0 ? task.totalUs / task.runs : 0.0;
+        result.append(stats);
+    }
+    return result;
+}
+
+void ControlScheduler::resetStatistics()
+{
+    for (Task& task : m_tasks) {
+        task.runs = 0;
+        task.overruns = 0;
+        task.lastUs = 0.0;
+        task.maxUs = 0.0;
+        task.totalUs = 0.0;
+    }
+    m_missedCycles = 0;
+    m_cycleOverruns = 0;
+    m_maxCycleUs = 0.0;
+}
+
+const char* ControlScheduler::stageName(Stage stage)
+{
+    switch (stage) {
+        case Stage::SENSE: return "sense";
+        case Stage::ESTIMATE: return "estimate";
+        case Stage::CONTROL: return "control";
+        case Stage::ACTUATE: return "actuate";
+        case Stage::LOG: return "log";
+    }
+    return "unknown";
+}
+
+// ControlTimer
+
+ControlTimer::ControlTimer(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_taskId(-1)
+    , m_offset(0)
+    , m_intervalMs(0)
+    , m_active(false)
+{
+    connect(m_timer, &QTimer::timeout, this, &ControlTimer::timeout);
+}
+
+ControlTimer::~ControlTimer()
+{
+    m_active = false;
+    detach();
+}
+
+void ControlTimer::attach(ControlScheduler* scheduler, ControlScheduler::Stage stage, const QString& name,
+                          double budgetUs, int offset)
+{
+    detach();
+    if (!scheduler) {
+        return;
+    }
+
+    m_offset = qMax(0, offset);
+    const int divisor = scheduler->divisorForIntervalMs(m_intervalMs);
+    m_taskId = scheduler->addTask(name, stage, divisor, [this]() { emit timeout(); }, budgetUs,
+                                  m_offset % divisor);
+    if (m_taskId < 0) {
+        return;
+    }
+
+    m_scheduler = scheduler;
+    m_scheduler->setTaskEnabled(m_taskId, m_active);
+    m_timer->stop();
+}
+
+void ControlTimer::detach()
+{
+    if (m_scheduler && m_taskId >= 0) {
+        m_scheduler->removeTask(m_taskId);
+    }
+    m_scheduler = nullptr;
+    m_taskId = -1;
+
+    if (m_active && !m_timer->isActive()) {
+        m_timer->start(m_intervalMs);
+    }
+}
+
+void ControlTimer::setInterval(int msec)
+{
+    m_intervalMs = msec;
+    if (isScheduled()) {
+        const int divisor = m_scheduler->divisorForIntervalMs(msec);
+        m_scheduler->setTaskDivisor(m_taskId, divisor);
+        m_scheduler->setTaskOffset(m_taskId, m_offset % divisor);
+    } else {
+        m_timer->setInterval(msec);
+    }
+}
+
+void ControlTimer::setTimerType(Qt::TimerType type)
+{
+    m_timer->setTimerType(type);
+}
+
+void ControlTimer::start()
+{
+    m_active = true;
+    if (isScheduled()) {
+        m_scheduler->setTaskEnabled(m_taskId, true);
+    } else {
+        m_timer->start(m_intervalMs);
+    }
+}
+
+void ControlTimer::start(int msec)
+{
+    setInterval(msec);
+    start();
+}
+
+void ControlTimer::stop()
+{
+    m_active = false;
+    if (isScheduled()) {
+        m_scheduler->setTaskEnabled(m_taskId, false);
+    }
+    m_timer->stop();
+}
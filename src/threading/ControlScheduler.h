@@ -0,0 +1,199 @@
+#ifndef CONTROLSCHEDULER_H
+#define CONTROLSCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <cstdint>
+
+class QTimer;
+
+/**
+ * @brief Multi-rate cyclic executive for the control loop
+ *
+ * One base-rate tick drives every registered periodic task. A task runs on
+ * cycles where (cycle % divisor) == offset, so all rates are integer
+ * divisors of the base rate and stay phase-aligned with each other. Within
+ * a cycle tasks run in stage order (sense, estimate, control, actuate, log),
+ * then in registration order.
+ *
+ * Cycle deadlines are start + n * period, so timer latency never accumulates
+ * as drift. If a whole period is missed the schedule skips forward (counted
+ * as missed cycles) instead of bursting to catch up.
+ *
+ * Each task may declare an execution-time budget; runs that exceed it are
+ * counted and reported through taskOverrun(). Tasks run on the thread that
+ * owns the scheduler and may add, remove, enable or disable tasks (including
+ * themselves) while a cycle is in progress.
+ */
+class ControlScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Stage {
+        SENSE = 0,
+        ESTIMATE,
+        CONTROL,
+        ACTUATE,
+        LOG
+    };
+    Q_ENUM(Stage)
+
+    struct TaskStatistics {
+        int id = -1;
+        QString name;
+        Stage stage = Stage::SENSE;
+        int divisor = 1;
+        int offset = 0;
+        bool enabled = false;
+        double budgetUs = 0.0;      // 0 = no budget
+        quint64 runs = 0;
+        quint64 overruns = 0;
+        double lastUs = 0.0;
+        double maxUs = 0.0;
+        double meanUs = 0.0;
+    };
+
+    explicit ControlScheduler(int baseRateHz = DEFAULT_BASE_RATE_HZ, QObject *parent = nullptr);
+    ~ControlScheduler();
+
+    // Base rate can only change while stopped
+    bool setBaseRateHz(int hz);
+    int baseRateHz() const { return m_baseRateHz; }
+    int basePeriodMs() const { return 1000 / m_baseRateHz; }
+
+    // Divisor for a period in ms (rounded, at least 1)
+    int divisorForIntervalMs(int intervalMs) const;
+
+    // Returns a task id, or -1 if the arguments are invalid
+    int addTask(const QString& name, Stage stage, int divisor, std::function<void()> task,
+                double budgetUs = 0.0, int offset = 0);
+    void removeTask(int id);
+    void setTaskEnabled(int id, bool enabled);
+    void setTaskDivisor(int id, int divisor);
+    void setTaskOffset(int id, int offset);         // Reduced modulo the divisor
+    void setTaskBudget(int id, double budgetUs);
+    bool hasTask(int id) const;
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Execute the next cycle immediately (tests, manual stepping while stopped)
+    void runCycle();
+
+    quint64 cycleCount() const { return m_cycle; }
+    quint64 missedCycles() const { return m_missedCycles; }
+    quint64 cycleOverruns() const { return m_cycleOverruns; }   // Cycles whose tasks ran past the period
+    double maxCycleUs() const { return m_maxCycleUs; }
+
+    QVector<TaskStatistics> getTaskStatistics() const;
+    void resetStatistics();
+
+    static const char* stageName(Stage stage);
+
+    static const int DEFAULT_BASE_RATE_HZ = 100;
+    static const int MAX_BASE_RATE_HZ = 1000;
+    static const int OVERRUN_LOG_INTERVAL = 100;   // Log the first and every Nth overrun per task
+    static constexpr double DEFAULT_TASK_BUDGET_US = 1000.0;
+
+Q_SIGNALS:
+    void taskOverrun(const QString& name, double executionUs, double budgetUs);
+    void cyclesMissed(quint64 count);
+
+private Q_SLOTS:
+    void onBaseTick();
+
+private:
+    struct Task {
+        int id;
+        QString name;
+        Stage stage;
+        int divisor;
+        int offset;
+        bool enabled;
+        bool removed;
+        double budgetUs;
+        std::function<void()> function;
+
+        quint64 runs;
+        quint64 overruns;
+        double lastUs;
+        double maxUs;
+        double totalUs;
+    };
+
+    Task* findTask(int id);
+    const Task* findTask(int id) const;
+    void executeCycle(quint64 cycle);
+    void compactTasks();
+    void armNextDeadline();
+
+    int m_baseRateHz;
+    int64_t m_periodNs;
+    QVector<Task> m_tasks;           // Sorted by stage, then registration
+    QVector<Task> m_pendingTasks;    // Added during a cycle
+    int m_nextTaskId;
+    bool m_inCycle;
+    bool m_tasksDirty;
+
+    QTimer* m_timer;
+    bool m_running;
+    int64_t m_startNs;
+    quint64 m_cycle;             // Next cycle to execute
+
+    quint64 m_missedCycles;
+    quint64 m_cycleOverruns;
+    double m_maxCycleUs;
+};
+
+/**
+ * @brief QTimer stand-in that can be driven by a ControlScheduler
+ *
+ * Offers the subset of the QTimer API the periodic components use. Until
+ * attach() is called it runs on its own QTimer exactly as before; once
+ * attached, timeout() is emitted from the scheduler cycle at the divisor
+ * matching interval(), in the given stage, and no separate timer wakes the
+ * thread. Components keep calling start()/stop() as they did with QTimer.
+ * The offset picks which cycle of each period the task runs on (modulo the
+ * divisor, so it survives interval changes) to spread slow tasks apart.
+ */
+class ControlTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControlTimer(QObject *parent = nullptr);
+    ~ControlTimer();
+
+    void attach(ControlScheduler* scheduler, ControlScheduler::Stage stage, const QString& name,
+                double budgetUs = ControlScheduler::DEFAULT_TASK_BUDGET_US, int offset = 0);
+    void detach();
+    bool isScheduled() const { return m_scheduler && m_taskId >= 0; }
+
+    void setInterval(int msec);
+    int interval() const { return m_intervalMs; }
+    void setTimerType(Qt::TimerType type);
+    bool isActive() const { return m_active; }
+
+public Q_SLOTS:
+    void start();
+    void start(int msec);
+    void stop();
+
+Q_SIGNALS:
+    void timeout();
+
+private:
+    QTimer* m_timer;
+    QPointer<ControlScheduler> m_scheduler;
+    int m_taskId;
+    int m_offset;
+    int m_intervalMs;
+    bool m_active;
+};
+
+#endif // CONTROLSCHEDULER_H
@@ -5,7 +5,11 @@
 #include <QMutexLocker>
 #include <QCoreApplication>
 #include <cmath>
+#include <cstring>
+#include <cerrno>
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 DataAcquisitionThread::DataAcquisitionThread(HardwareManager* hardware, QObject *parent)
     : QThread(parent)
@@ -13,15 +17,24 @@ DataAcquisitionThread::DataAcquisitionThread(HardwareManager* hardware, QObject
     , m_acquiring(false)
     , m_paused(false)
     , m_stopRequested(false)
+    , m_sampleRing(DEFAULT_BUFFER_SIZE)
     , m_maxBufferSize(DEFAULT_BUFFER_SIZE)
+    , m_bufferFullSignalled(false)
     , m_samplingRateHz(DEFAULT_SAMPLING_RATE_HZ)
-    , m_samplingIntervalMs(1000 / DEFAULT_SAMPLING_RATE_HZ)
+    , m_samplingIntervalMs(qRound(1000.0 / DEFAULT_SAMPLING_RATE_HZ))
     , m_actualSamplingRate(0.0)
     , m_lastUpdateTime(0)
     , m_lastStatisticsUpdate(0)
     , m_sampleCount(0)
     , m_errorCount(0)
     , m_acquisitionTimer(nullptr)
+    , m_realTimeMode(false)
+    , m_realTimePriority(DEFAULT_REALTIME_PRIORITY)
+    , m_cpuAffinity(-1)
+    , m_lockMemory(false)
+    , m_memoryLocked(false)
+    , m_fifoActive(false)
+    , m_samplingPeriodNs(1000000000LL / DEFAULT_SAMPLING_RATE_HZ)
     , m_safetyEnabled(true)
     , m_safetyCheckCounter(0)
     , m_safetyCheckInterval(1)  // Check safety every sample by default
@@ -60,11 +73,14 @@ void DataAcquisitionThread::startAcquisition()
     m_errorCount = 0;
     m_sampleCount = 0;
     
-    // Clear existing buffer
-    {
-        QMutexLocker bufferLocker(&m_bufferMutex);
-        m_dataBuffer.clear();
+    // (Re)allocate the sample ring while no producer is running; nothing
+    // allocates on the acquisition path after this point
+    if (m_sampleRing.capacity() != static_cast<size_t>(m_maxBufferSize)) {
+        m_sampleRing.reset(m_maxBufferSize);
+    } else {
+        m_sampleRing.clear();
     }
+    m_bufferFullSignalled = false;
     
     // Start the thread
     start();
@@ -126,65 +142,125 @@ void DataAcquisitionThread::setSamplingRate(int hz)
     if (hz > 0 && hz <= 1000) {  // Reasonable limits
         QMutexLocker locker(&m_controlMutex);
         m_samplingRateHz = hz;
-        m_samplingIntervalMs = 1000 / hz;
+        m_samplingIntervalMs = qMax(1, qRound(1000.0 / hz));  // QTimer mode granularity
+        m_samplingPeriodNs = 1000000000LL / hz;               // Real-time mode: exact period
         qDebug() << QString("Sampling rate set to %1 Hz").arg(hz);
     }
 }
 
+void DataAcquisitionThread::setRealTimeMode(bool enabled)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_realTimeMode = enabled;
+    qDebug() << "Data acquisition real-time mode" << (enabled ? "enabled" : "disabled");
+}
+
+void DataAcquisitionThread::setRealTimePriority(int fifoPriority)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_realTimePriority = qBound(0, fifoPriority, 99);
+}
+
+void DataAcquisitionThread::setCpuAffinity(int cpu)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_cpuAffinity = cpu;
+}
+
+void DataAcquisitionThread::setLockMemory(bool enabled)
+{
+    QMutexLocker locker(&m_controlMutex);
+    m_lockMemory = enabled;
+}
+
 void DataAcquisitionThread::setBufferSize(int maxSamples)
 {
     if (maxSamples > 0) {
-        QMutexLocker locker(&m_bufferMutex);
+        QMutexLocker locker(&m_controlMutex);
         m_maxBufferSize = maxSamples;
-        
-        // Trim buffer if necessary
-        while (m_dataBuffer.size() > m_maxBufferSize) {
-            m_dataBuffer.dequeue();
+
+        // The ring is resized on the next start so the producer never sees
+        // its storage move underneath it
+        if (!m_acquiring) {
+            m_sampleRing.reset(m_maxBufferSize);
         }
-        
+
         qDebug() << QString("Buffer size set to %1 samples").arg(maxSamples);
     }
 }
 
-DataAcquisitionThread::SensorData DataAcquisitionThread::getLatestData()
+DataAcquisitionThread::SensorData DataAcquisitionThread::getLatestData() const
 {
-    QMutexLocker locker(&m_bufferMutex);
-    
-    if (m_dataBuffer.isEmpty()) {
-        return SensorData();  // Invalid data
-    }
-    
-    return m_dataBuffer.last();
+    SensorData data;  // Invalid unless the ring holds a sample
+    m_sampleRing.latest(data);
+    return data;
 }
 
-QList<DataAcquisitionThread::SensorData> DataAcquisitionThread::getBufferedData(int maxSamples)
+QList<DataAcquisitionThread::SensorData> DataAcquisitionThread::getBufferedData(int maxSamples) const
 {
-    QMutexLocker locker(&m_bufferMutex);
-    
+    // Convenience copy for non-realtime callers; hot consumers should use
+    // copyLatestData()/readDataSince() with their own preallocated storage
+    const int capacity = static_cast<int>(m_sampleRing.capacity());
+    const int count = (maxSamples > 0) ? std::min(maxSamples, capacity) : capacity;
+
+    std::vector<SensorData> scratch(count);
+    const int copied = copyLatestData(scratch.data(), count);
+
     QList<SensorData> result;
-    
-    int count = (maxSamples > 0) ? std::min(maxSamples, m_dataBuffer.size()) : m_dataBuffer.size();
-    
-    // Get the most recent samples
-    auto it = m_dataBuffer.end() - count;
-    for (; it != m_dataBuffer.end(); ++it) {
-        result.append(*it);
+    result.reserve(copied);
+    for (int i = 0; i < copied; ++i) {
+        result.append(scratch[i]);
     }
-    
     return result;
 }
 
+int DataAcquisitionThread::copyLatestData(SensorData* out, int maxSamples) const
+{
+    if (!out || maxSamples <= 0) {
+        return 0;
+    }
+    return static_cast<int>(m_sampleRing.copyLatest(out, static_cast<size_t>(maxSamples)));
+}
+
+int DataAcquisitionThread::readDataSince(quint64& cursor, SensorData* out, int maxSamples, quint64* skipped) const
+{
+    if (!out || maxSamples <= 0) {
+        return 0;
+    }
+    uint64_t position = cursor;
+    uint64_t lost = 0;
+    const size_t count = m_sampleRing.readSince(position, out, static_cast<size_t>(maxSamples), &lost);
+    cursor = position;
+    if (skipped) {
+        *skipped = lost;
+    }
+    return static_cast<int>(count);
+}
+
+int DataAcquisitionThread::subscribeBatches(int batchSize, int maxLatencyMs)
+{
+    int id = m_batchNotifier.subscribe(batchSize, maxLatencyMs);
+    if (id < 0) {
+        qWarning() << "No free batch subscription slot (max" << SampleBatchNotifier::MAX_SUBSCRIPTIONS << ")";
+    }
+    return id;
+}
+
+void DataAcquisitionThread::unsubscribeBatches(int subscriptionId)
+{
+    m_batchNotifier.unsubscribe(subscriptionId);
+}
+
 void DataAcquisitionThread::clearBuffer()
 {
-    QMutexLocker locker(&m_bufferMutex);
-    m_dataBuffer.clear();
+    m_sampleRing.clear();
+    m_bufferFullSignalled = false;
     qDebug() << "Data buffer cleared";
 }
 
 int DataAcquisitionThread::getBufferCount() const
 {
-    QMutexLocker locker(&m_bufferMutex);
-    return m_dataBuffer.size();
+    return static_cast<int>(m_sampleRing.size());
 }
 
 void DataAcquisitionThread::run()
@@ -194,6 +270,19 @@ void DataAcquisitionThread::run()
 
     initializeThread();
 
+    bool realTime;
+    {
+        QMutexLocker locker(&m_controlMutex);
+        realTime = m_realTimeMode;
+    }
+
+    if (realTime) {
+        runRealTimeLoop();
+        cleanupThread();
+        qDebug() << "Data acquisition thread finished";
+        return;
+    }
+
     // Create timer for precise timing on the worker thread
     // Use a local unique_ptr for RAII cleanup to prevent leaks if an exception occurs
     std::unique_ptr<QTimer> acquisitionTimer = std::make_unique<QTimer>();
@@ -276,11 +365,98 @@ void DataAcquisitionThread::initializeThread()
     m_lastStatisticsUpdate = QDateTime::currentMSecsSinceEpoch();
     m_sampleCount = 0;
     m_errorCount = 0;
+    m_timing.stats().reset();
 }
 
 void DataAcquisitionThread::cleanupThread()
 {
-    // Thread cleanup if needed
+    if (m_memoryLocked) {
+        RealTime::unlockProcessMemory();
+        m_memoryLocked = false;
+    }
+    m_fifoActive = false;
+}
+
+void DataAcquisitionThread::applyRealTimeSettings()
+{
+    int priority;
+    int cpu;
+    bool lockMemory;
+    {
+        QMutexLocker locker(&m_controlMutex);
+        priority = m_realTimePriority;
+        cpu = m_cpuAffinity;
+        lockMemory = m_lockMemory;
+    }
+
+    if (lockMemory) {
+        m_memoryLocked = RealTime::lockProcessMemory();
+        if (!m_memoryLocked) {
+            qWarning() << "mlockall failed (" << strerror(errno) << ") - continuing without locked memory";
+        }
+    }
+
+    if (cpu >= 0 && !RealTime::setCpuAffinity(cpu)) {
+        qWarning() << "Failed to pin acquisition thread to CPU" << cpu << "-" << strerror(errno);
+    }
+
+    if (priority > 0) {
+        m_fifoActive = RealTime::setFifoPriority(priority);
+        if (!m_fifoActive) {
+            // Typically EPERM without CAP_SYS_NICE / rtprio limits
+            qWarning() << "SCHED_FIFO priority" << priority << "not permitted (" << strerror(errno)
+                       << ") - using normal scheduling";
+        }
+    }
+}
+
+void DataAcquisitionThread::runRealTimeLoop()
+{
+    applyRealTimeSettings();
+
+    qDebug() << QString("Real-time acquisition loop: period %1 us, SCHED_FIFO %2")
+                .arg(m_samplingPeriodNs.load() / 1000.0, 0, 'f', 1)
+                .arg(m_fifoActive ? "active" : "inactive");
+
+    m_timing.start(m_samplingPeriodNs);
+
+    while (!isStopRequested()) {
+        // Rate changes from other threads are picked up at the next period
+        const qint64 periodNs = m_samplingPeriodNs.load(std::memory_order_relaxed);
+        if (periodNs != m_timing.periodNs()) {
+            m_timing.setPeriodNs(periodNs);
+        }
+
+        m_timing.waitNext();
+
+        if (!waitWhilePaused()) {
+            break;
+        }
+
+        performDataAcquisition();
+    }
+}
+
+bool DataAcquisitionThread::isStopRequested() const
+{
+    QMutexLocker locker(&m_controlMutex);
+    return m_stopRequested;
+}
+
+bool DataAcquisitionThread::waitWhilePaused()
+{
+    QMutexLocker locker(&m_controlMutex);
+    if (!m_paused) {
+        return !m_stopRequested;
+    }
+
+    while (m_paused && !m_stopRequested) {
+        m_pauseCondition.wait(&m_controlMutex);
+    }
+
+    // Deadlines missed while paused are not overruns
+    m_timing.resync();
+    return !m_stopRequested;
 }
 
 DataAcquisitionThread::SensorData DataAcquisitionThread::acquireSensorData()
@@ -290,14 +466,18 @@ DataAcquisitionThread::SensorData DataAcquisitionThread::acquireSensorData()
     }
     
     try {
-        qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
-        double avlPressure = m_hardware->readAVLPressure();
-        double tankPressure = m_hardware->readTankPressure();
-        
-        // Validate readings
-        bool valid = (avlPressure >= 0 && tankPressure >= 0);
-        
-        return SensorData(timestamp, avlPressure, tankPressure, valid);
+        // This thread is the single acquisition owner: sample every channel
+        // once and publish the snapshot for all other consumers to share.
+        SensorSnapshot snapshot = m_hardware->publishSensorSnapshot();
+
+        // Validate readings (AVL and Tank are essential)
+        bool valid = snapshot.hasAVL() && snapshot.hasTank();
+
+        SensorData data(snapshot.timestampMs, snapshot.avlPressure, snapshot.tankPressure, valid);
+        data.monotonicNs = snapshot.monotonicNs;
+        data.clitoralPressure = snapshot.clitoralPressure;
+        data.sequence = snapshot.sequence;
+        return data;
         
     } catch (const std::exception& e) {
         emit samplingError(QString("Sensor acquisition error: %1").arg(e.what()));
@@ -307,18 +487,13 @@ DataAcquisitionThread::SensorData DataAcquisitionThread::acquireSensorData()
 
 void DataAcquisitionThread::addToBuffer(const SensorData& data)
 {
-    QMutexLocker locker(&m_bufferMutex);
-    
-    // Add new data
-    m_dataBuffer.enqueue(data);
-    
-    // Remove old data if buffer is full
-    while (m_dataBuffer.size() > m_maxBufferSize) {
-        m_dataBuffer.dequeue();
-    }
-    
-    // Emit buffer full signal if at capacity
-    if (m_dataBuffer.size() >= m_maxBufferSize) {
+    // Oldest sample is overwritten once the ring is full
+    m_sampleRing.push(data);
+    m_batchNotifier.onSamplePublished(m_sampleRing.totalWritten(), RealTime::monotonicNowNs());
+
+    // Signal once per fill rather than on every subsequent sample
+    if (!m_bufferFullSignalled && m_sampleRing.size() >= m_sampleRing.capacity()) {
+        m_bufferFullSignalled = true;
         emit bufferFull();
     }
 }
@@ -5,8 +5,12 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QTimer>
-#include <QQueue>
 #include <QDateTime>
+#include <atomic>
+
+#include "RealTimeSupport.h"
+#include "SampleRing.h"
+#include "SampleBatchNotifier.h"
 
 // Forward declarations
 class HardwareManager;
@@ -17,9 +21,14 @@ class HardwareManager;
  * This thread runs at high priority to ensure consistent sensor sampling
  * for the safety-critical vacuum controller system. It provides:
  * - Consistent 50Hz sensor sampling rate
- * - Thread-safe data buffering
+ * - Lock-free sample history (fixed-capacity ring, no allocation while running)
  * - Automatic error detection and recovery
  * - Minimal latency for safety systems
+ *
+ * Optional real-time mode replaces the QTimer event loop with an
+ * absolute-deadline clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) loop,
+ * optionally under SCHED_FIFO with CPU affinity and mlockall, so 500 Hz to
+ * 1 kHz sampling stays deterministic on a loaded Pi.
  */
 class DataAcquisitionThread : public QThread
 {
@@ -28,13 +37,16 @@ class DataAcquisitionThread : public QThread
 public:
     struct SensorData {
         qint64 timestamp;
+        qint64 monotonicNs;   // Acquisition time on the monotonic clock (for rate/derivative math)
         double avlPressure;
         double tankPressure;
+        double clitoralPressure;
+        quint64 sequence;     // SensorSnapshotBus sequence this sample was published as
         bool valid;
         
-        SensorData() : timestamp(0), avlPressure(0.0), tankPressure(0.0), valid(false) {}
+        SensorData() : timestamp(0), monotonicNs(0), avlPressure(0.0), tankPressure(0.0), clitoralPressure(0.0), sequence(0), valid(false) {}
         SensorData(qint64 ts, double avl, double tank, bool v) 
-            : timestamp(ts), avlPressure(avl), tankPressure(tank), valid(v) {}
+            : timestamp(ts), monotonicNs(0), avlPressure(avl), tankPressure(tank), clitoralPressure(0.0), sequence(0), valid(v) {}
     };
 
     explicit DataAcquisitionThread(HardwareManager* hardware, QObject *parent = nullptr);
@@ -49,20 +61,48 @@ public:
     // Configuration
     void setSamplingRate(int hz);
     int getSamplingRate() const { return m_samplingRateHz; }
+
+    // Real-time mode (takes effect on the next startAcquisition())
+    void setRealTimeMode(bool enabled);
+    bool isRealTimeMode() const { return m_realTimeMode; }
+    void setRealTimePriority(int fifoPriority);   // 0 = keep normal scheduling, 1-99 = SCHED_FIFO
+    int getRealTimePriority() const { return m_realTimePriority; }
+    void setCpuAffinity(int cpu);                 // -1 = no pinning
+    int getCpuAffinity() const { return m_cpuAffinity; }
+    void setLockMemory(bool enabled);             // mlockall() while acquiring
+    bool isLockMemory() const { return m_lockMemory; }
     
-    void setBufferSize(int maxSamples);
+    void setBufferSize(int maxSamples);           // Applied on the next startAcquisition()
     int getBufferSize() const { return m_maxBufferSize; }
     
-    // Data access (thread-safe)
-    SensorData getLatestData();
-    QList<SensorData> getBufferedData(int maxSamples = -1);
+    // Data access (lock-free, never blocks the acquisition thread)
+    SensorData getLatestData() const;
+    QList<SensorData> getBufferedData(int maxSamples = -1) const;
+    int copyLatestData(SensorData* out, int maxSamples) const;
+    int readDataSince(quint64& cursor, SensorData* out, int maxSamples, quint64* skipped = nullptr) const;
+    quint64 getTotalSampleIndex() const { return m_sampleRing.totalWritten(); }
     void clearBuffer();
+
+    // Batched delivery: eventfd becomes readable once per batchSize samples
+    // or maxLatencyMs, whichever comes first; drain with readDataSince().
+    // Prefer this (or SampleBatchSubscriber) over dataReady at high rates.
+    int subscribeBatches(int batchSize, int maxLatencyMs);
+    void unsubscribeBatches(int subscriptionId);
+    int batchEventFd(int subscriptionId) const { return m_batchNotifier.eventFd(subscriptionId); }
     
     // Statistics
     int getBufferCount() const;
     double getActualSamplingRate() const { return m_actualSamplingRate; }
     int getErrorCount() const { return m_errorCount; }
     qint64 getLastUpdateTime() const { return m_lastUpdateTime; }
+
+    // Period timing statistics (real-time mode; wake-up lateness per period)
+    double getLastJitterUs() const { return m_timing.stats().lastErrorUs(); }
+    double getAverageJitterUs() const { return m_timing.stats().meanAbsErrorUs(); }
+    double getMaxJitterUs() const { return m_timing.stats().maxErrorUs(); }
+    quint64 getOverrunCount() const { return m_timing.stats().overruns(); }
+    bool isRealTimeSchedulingActive() const { return m_fifoActive; }
+    void resetTimingStatistics() { m_timing.stats().reset(); }
     
     // Thread status
     bool isAcquiring() const { return m_acquiring; }
@@ -75,6 +115,7 @@ public:
     bool isSafetyEnabled() const { return m_safetyEnabled; }
 
 Q_SIGNALS:
+    // Per-sample notification; each queued delivery allocates an event
     void dataReady(const SensorData& data);
     void bufferFull();
     void samplingError(const QString& error);
@@ -95,6 +136,10 @@ private Q_SLOTS:
 private:
     void initializeThread();
     void cleanupThread();
+    void runRealTimeLoop();
+    void applyRealTimeSettings();
+    bool isStopRequested() const;
+    bool waitWhilePaused();
     SensorData acquireSensorData();
     void addToBuffer(const SensorData& data);
     void updateStatistics();
@@ -110,10 +155,11 @@ private:
     mutable QMutex m_controlMutex;
     QWaitCondition m_pauseCondition;
     
-    // Data buffer (thread-safe)
-    QQueue<SensorData> m_dataBuffer;
-    mutable QMutex m_bufferMutex;
+    // Sample history: written only by the acquisition thread, read lock-free
+    SampleRing<SensorData> m_sampleRing;
     int m_maxBufferSize;
+    std::atomic<bool> m_bufferFullSignalled;
+    SampleBatchNotifier m_batchNotifier;
     
     // Timing and statistics
     int m_samplingRateHz;
@@ -127,6 +173,16 @@ private:
     // High-resolution timer for precise timing
     QTimer* m_acquisitionTimer;
 
+    // Real-time mode
+    bool m_realTimeMode;
+    int m_realTimePriority;
+    int m_cpuAffinity;
+    bool m_lockMemory;
+    bool m_memoryLocked;
+    std::atomic<bool> m_fifoActive;
+    std::atomic<qint64> m_samplingPeriodNs;   // Exact period (no ms truncation)
+    RealTime::PeriodicDeadline m_timing;
+
     // Integrated safety monitoring
     bool m_safetyEnabled;
     int m_safetyCheckCounter;
@@ -141,6 +197,7 @@ private:
     static const int STATISTICS_UPDATE_INTERVAL_MS = 1000;  // Update stats every second
     static const int MAX_CONSECUTIVE_ERRORS = 10;      // Max errors before stopping
     static const int MAX_CONSECUTIVE_SAFETY_ERRORS = 5; // Max safety errors before emergency stop
+    static const int DEFAULT_REALTIME_PRIORITY = 80;    // SCHED_FIFO priority when real-time mode is enabled
 };
 
 #endif // DATAACQUISITIONTHREAD_H
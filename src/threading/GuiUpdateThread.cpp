@@ -2,6 +2,7 @@
 #include <QDebug>
 #include <QApplication>
 #include <QDateTime>
+#include <algorithm>
 
 // Constants
 const double GuiUpdateThread::DEFAULT_FILTER_ALPHA = 0.2;
@@ -14,9 +15,12 @@ GuiUpdateThread::GuiUpdateThread(QObject *parent)
     , m_updating(false)
     , m_paused(false)
     , m_stopRequested(false)
+    , m_sampleCursor(0)
+    , m_skippedSamples(0)
     , m_updateRateFps(DEFAULT_UPDATE_RATE_FPS)
     , m_updateIntervalMs(1000 / DEFAULT_UPDATE_RATE_FPS)
     , m_filterAlpha(DEFAULT_FILTER_ALPHA)
+    , m_maxChartPoints(DEFAULT_MAX_CHART_POINTS)
     , m_warningThreshold(DEFAULT_WARNING_THRESHOLD)
     , m_criticalThreshold(DEFAULT_CRITICAL_THRESHOLD)
     , m_currentAlarmState(false)
@@ -29,6 +33,8 @@ GuiUpdateThread::GuiUpdateThread(QObject *parent)
     , m_frameCount(0)
     , m_updateTimer(new QTimer(this))
 {
+    m_rawDataBlock.resize(MAX_SAMPLES_PER_FRAME);
+
     // Set up update timer
     m_updateTimer->setSingleShot(false);
     m_updateTimer->setInterval(m_updateIntervalMs);
@@ -127,17 +133,137 @@ void GuiUpdateThread::run()
     qDebug() << "GUI Update Thread finished";
 }
 
+void GuiUpdateThread::setDataSource(DataAcquisitionThread* dataThread)
+{
+    QMutexLocker locker(&m_dataMutex);
+    m_dataThread = dataThread;
+    m_sampleCursor = dataThread ? dataThread->getTotalSampleIndex() : 0;
+}
+
 void GuiUpdateThread::processNewData()
 {
-    // This method would process new data from the data acquisition thread
-    // For now, just update statistics
+    double alpha;
+    {
+        QMutexLocker locker(&m_controlMutex);
+        alpha = m_filterAlpha;
+    }
+
+    // Drain everything published since the last frame as one contiguous
+    // block instead of receiving a queued event per sample
+    bool haveData = false;
+    bool alarmChanged = false;
+    ProcessedData latest;
+    {
+        QMutexLocker locker(&m_dataMutex);
+        if (m_dataThread) {
+            const quint64 newest = m_dataThread->getTotalSampleIndex();
+            const quint64 blockSize = static_cast<quint64>(m_rawDataBlock.size());
+            if (newest < m_sampleCursor) {
+                // Source index went backwards (new source): re-seed at its newest
+                m_sampleCursor = newest;
+            } else if (newest - m_sampleCursor > blockSize) {
+                // Only the newest MAX_SAMPLES_PER_FRAME matter for display
+                m_skippedSamples += newest - m_sampleCursor - blockSize;
+                m_sampleCursor = newest - blockSize;
+            }
+
+            quint64 skipped = 0;
+            const int count = m_dataThread->readDataSince(m_sampleCursor, m_rawDataBlock.data(),
+                                                          m_rawDataBlock.size(), &skipped);
+            m_skippedSamples += skipped;
+            m_processedSamples += count;
+
+            // Filter every sample; the display gets one point per frame
+            for (int i = 0; i < count; ++i) {
+                if (!m_rawDataBlock[i].valid) continue;
+                ProcessedData data = processRawData(m_rawDataBlock[i]);
+                applyFiltering(data, alpha);
+                m_previousData = data;
+                haveData = true;
+            }
+
+            if (haveData) {
+                latest = m_previousData;
+                const bool wasAlarm = m_currentAlarmState;
+                checkAlarmConditions(latest);
+                alarmChanged = latest.alarmState != wasAlarm;
+                m_latestProcessedData = latest;
+                addToChartBuffer(latest);
+            }
+        }
+    }
+
+    if (haveData) {
+        if (alarmChanged) {
+            emit alarmStateChanged(latest.alarmState, latest.statusMessage);
+        }
+        emit guiDataReady(latest);
+    }
+
     updateStatistics();
 }
 
+GuiUpdateThread::ProcessedData GuiUpdateThread::processRawData(const DataAcquisitionThread::SensorData& rawData)
+{
+    ProcessedData data;
+    data.timestamp = rawData.timestamp;
+    data.avlPressure = rawData.avlPressure;
+    data.tankPressure = rawData.tankPressure;
+    data.avlFiltered = rawData.avlPressure;
+    data.tankFiltered = rawData.tankPressure;
+    return data;
+}
+
+void GuiUpdateThread::applyFiltering(ProcessedData& data, double alpha)
+{
+    // First sample seeds the moving average
+    if (m_previousData.timestamp == 0) return;
+
+    data.avlFiltered = alpha * data.avlPressure + (1.0 - alpha) * m_previousData.avlFiltered;
+    data.tankFiltered = alpha * data.tankPressure + (1.0 - alpha) * m_previousData.tankFiltered;
+}
+
+void GuiUpdateThread::checkAlarmConditions(ProcessedData& data)
+{
+    const double pressure = std::max(data.avlFiltered, data.tankFiltered);
+    if (pressure >= m_criticalThreshold) {
+        data.alarmState = true;
+        data.statusMessage = QString("Critical pressure: %1 mmHg").arg(pressure, 0, 'f', 1);
+    } else if (pressure >= m_warningThreshold) {
+        data.alarmState = true;
+        data.statusMessage = QString("High pressure: %1 mmHg").arg(pressure, 0, 'f', 1);
+    } else {
+        data.alarmState = false;
+        data.statusMessage.clear();
+    }
+    m_currentAlarmState = data.alarmState;
+}
+
+void GuiUpdateThread::addToChartBuffer(const ProcessedData& data)
+{
+    m_chartDataBuffer.enqueue(data);
+    while (m_chartDataBuffer.size() > m_maxChartPoints) {
+        m_chartDataBuffer.dequeue();
+    }
+}
+
+GuiUpdateThread::ProcessedData GuiUpdateThread::getLatestProcessedData()
+{
+    QMutexLocker locker(&m_dataMutex);
+    return m_latestProcessedData;
+}
+
+QList<GuiUpdateThread::ProcessedData> GuiUpdateThread::getChartData(int maxPoints)
+{
+    QMutexLocker locker(&m_dataMutex);
+    const int count = (maxPoints > 0) ? std::min(maxPoints, m_chartDataBuffer.size())
+                                      : m_chartDataBuffer.size();
+    return m_chartDataBuffer.mid(m_chartDataBuffer.size() - count);
+}
+
 void GuiUpdateThread::updateStatistics()
 {
     m_updateCount++;
-    m_processedSamples++;
 
     // Update actual update rate every second
     qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
@@ -184,18 +310,6 @@ void GuiUpdateThread::setFilterAlpha(double alpha)
     m_filterAlpha = alpha;
 }
 
-void GuiUpdateThread::onSensorDataReady(const DataAcquisitionThread::SensorData& data)
-{
-    // Handle new sensor data
-    QMutexLocker locker(&m_dataMutex);
-    m_rawDataQueue.enqueue(data);
-
-    // Limit queue size
-    while (m_rawDataQueue.size() > 100) {
-        m_rawDataQueue.dequeue();
-    }
-}
-
 void GuiUpdateThread::calculateFrameRate(qint64 currentTime)
 {
     m_frameCount++;
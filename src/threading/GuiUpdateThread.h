@@ -6,6 +6,7 @@
 #include <QMutex>
 #include <QTimer>
 #include <QQueue>
+#include <QVector>
 #include <QWaitCondition>
 #include "DataAcquisitionThread.h"
 
@@ -51,6 +52,9 @@ public:
     void pauseUpdates();
     void resumeUpdates();
     
+    // Data source: samples are drained from its ring once per frame
+    void setDataSource(DataAcquisitionThread* dataThread);
+
     // Configuration
     void setUpdateRate(int fps);
     int getUpdateRate() const { return m_updateRateFps; }
@@ -85,13 +89,12 @@ protected:
 
 private Q_SLOTS:
     void processNewData();
-    void onSensorDataReady(const DataAcquisitionThread::SensorData& data);
 
 private:
     void initializeThread();
     void cleanupThread();
     ProcessedData processRawData(const DataAcquisitionThread::SensorData& rawData);
-    void applyFiltering(ProcessedData& data);
+    void applyFiltering(ProcessedData& data, double alpha);
     void checkAlarmConditions(ProcessedData& data);
     void updateStatistics();
     void addToChartBuffer(const ProcessedData& data);
@@ -107,13 +110,15 @@ private:
     mutable QMutex m_controlMutex;
     QWaitCondition m_pauseCondition;
     
-    // Data processing
-    QQueue<DataAcquisitionThread::SensorData> m_rawDataQueue;
+    // Data processing (block drained from the acquisition ring each frame)
+    QVector<DataAcquisitionThread::SensorData> m_rawDataBlock;
+    quint64 m_sampleCursor;
+    quint64 m_skippedSamples;
     QQueue<ProcessedData> m_chartDataBuffer;
     mutable QMutex m_dataMutex;
     
     ProcessedData m_latestProcessedData;
-    ProcessedData m_previousData;  // For filtering
+    ProcessedData m_previousData;  // Last filtered sample (moving average state)
     
     // Configuration
     int m_updateRateFps;
@@ -143,6 +148,7 @@ private:
     static const double DEFAULT_FILTER_ALPHA;          // 0.2 for moderate filtering
     static const int DEFAULT_MAX_CHART_POINTS = 600;   // 20 seconds at 30 FPS
     static const int STATISTICS_UPDATE_INTERVAL_MS = 1000;
+    static const int MAX_SAMPLES_PER_FRAME = 100;      // Older samples are dropped if the GUI falls behind
     static const double DEFAULT_WARNING_THRESHOLD;     // 80.0 mmHg
     static const double DEFAULT_CRITICAL_THRESHOLD;    // 95.0 mmHg
 };
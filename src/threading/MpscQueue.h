@@ -0,0 +1,115 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer / single-consumer queue
+ *
+ * Any number of threads may tryPush() concurrently; exactly one thread may
+ * tryPop(). Producers never block and never allocate: when the queue is
+ * full tryPush() fails and the caller decides what to drop. Each slot
+ * carries a sequence number (Vyukov's bounded queue), so a producer claims a
+ * slot with one CAS on the tail and publishes it with a release store; the
+ * consumer needs no atomic read-modify-write at all.
+ *
+ * T only needs to be default-constructible and move-assignable. Popped
+ * values are moved out, so heap storage allocated by a producer is released
+ * on the consumer's side.
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity)
+    {
+        size_t slots = 2;
+        while (slots < capacity) {
+            slots <<= 1;
+        }
+        m_slots.reset(new Slot[slots]);
+        m_mask = slots - 1;
+        for (size_t i = 0; i < slots; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Any thread. Returns false (leaving value untouched) when full.
+    bool tryPush(T&& value)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &m_slots[position & m_mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;       // Consumer has not freed this slot yet
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value)
+    {
+        T copy(value);
+        return tryPush(std::move(copy));
+    }
+
+    // Consumer only
+    bool tryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[head & m_mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(head + 1) < 0) {
+            return false;           // Empty, or the producer is still writing it
+        }
+
+        out = std::move(slot.value);
+        slot.sequence.store(head + m_mask + 1, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate while producers are pushing
+    size_t sizeApprox() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+
+    // Producers contend on the tail; keep the consumer's head off its line
+    alignas(64) std::atomic<size_t> m_tail{0};
+    alignas(64) std::atomic<size_t> m_head{0};     // Written by the consumer only
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,174 @@
+#include "RealTimeSupport.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <mutex>
+
+namespace RealTime {
+
+int64_t monotonicNowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+void sleepUntilNs(int64_t deadlineNs)
+{
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadlineNs / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(deadlineNs % 1000000000LL);
+
+    // clock_nanosleep returns the error directly; retry on signal interruption
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+}
+
+void sleepUntilPreciseNs(int64_t deadlineNs, int64_t spinWindowNs)
+{
+    if (deadlineNs - monotonicNowNs() > spinWindowNs) {
+        sleepUntilNs(deadlineNs - spinWindowNs);
+    }
+    while (monotonicNowNs() < deadlineNs) {
+    }
+}
+
+bool setFifoPriority(int priority)
+{
+    struct sched_param param = {};
+    param.sched_priority = std::clamp(priority,
+                                      sched_get_priority_min(SCHED_FIFO),
+                                      sched_get_priority_max(SCHED_FIFO));
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        errno = result;
+        return false;
+    }
+    return true;
+}
+
+bool setCpuAffinity(int cpu)
+{
+    long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpu < 0 || cpu >= cpuCount) {
+        errno = EINVAL;
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        errno = result;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+std::mutex g_memoryLockMutex;
+int g_memoryLockCount = 0;
+}
+
+bool lockProcessMemory()
+{
+    std::lock_guard<std::mutex> lock(g_memoryLockMutex);
+    if (g_memoryLockCount == 0 && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        return false;
+    }
+    ++g_memoryLockCount;
+    return true;
+}
+
+void unlockProcessMemory()
+{
+    std::lock_guard<std::mutex> lock(g_memoryLockMutex);
+    if (g_memoryLockCount == 0) {
+        return;
+    }
+    if (--g_memoryLockCount == 0) {
+        munlockall();
+    }
+}
+
+void TimingStats::record(int64_t errorNs)
+{
+    const int64_t absNs = std::llabs(errorNs);
+    m_lastNs.store(errorNs, std::memory_order_relaxed);
+    m_sumNs.fetch_add(errorNs, std::memory_order_relaxed);
+    m_sumAbsNs.fetch_add(absNs, std::memory_order_relaxed);
+    if (absNs > m_maxAbsNs.load(std::memory_order_relaxed)) {
+        m_maxAbsNs.store(absNs, std::memory_order_relaxed);
+    }
+    m_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TimingStats::reset()
+{
+    m_count.store(0, std::memory_order_relaxed);
+    m_overruns.store(0, std::memory_order_relaxed);
+    m_lastNs.store(0, std::memory_order_relaxed);
+    m_maxAbsNs.store(0, std::memory_order_relaxed);
+    m_sumNs.store(0, std::memory_order_relaxed);
+    m_sumAbsNs.store(0, std::memory_order_relaxed);
+}
+
+double TimingStats::meanErrorUs() const
+{
+    const uint64_t n = count();
+    return n > 0 ? (m_sumNs.load(std::memory_order_relaxed) / static_cast<double>(n)) / 1000.0 : 0.0;
+}
+
+double TimingStats::meanAbsErrorUs() const
+{
+    const uint64_t n = count();
+    return n > 0 ? (m_sumAbsNs.load(std::memory_order_relaxed) / static_cast<double>(n)) / 1000.0 : 0.0;
+}
+
+void PeriodicDeadline::start(int64_t periodNs)
+{
+    m_periodNs = std::max<int64_t>(1, periodNs);
+    m_nextNs = monotonicNowNs() + m_periodNs;
+}
+
+void PeriodicDeadline::setPeriodNs(int64_t periodNs)
+{
+    // Takes effect from the deadline after the one already scheduled
+    m_periodNs = std::max<int64_t>(1, periodNs);
+}
+
+int64_t PeriodicDeadline::waitNext()
+{
+    sleepUntilNs(m_nextNs);
+
+    const int64_t now = monotonicNowNs();
+    const int64_t lateness = now - m_nextNs;
+    m_stats.record(lateness);
+
+    m_nextNs += m_periodNs;
+    if (now >= m_nextNs) {
+        // Missed at least one whole period: count it and skip ahead rather
+        // than running several iterations back-to-back.
+        const int64_t missed = (now - m_nextNs) / m_periodNs + 1;
+        for (int64_t i = 0; i < missed; ++i) {
+            m_stats.recordOverrun();
+        }
+        m_nextNs += missed * m_periodNs;
+    }
+
+    return lateness;
+}
+
+void PeriodicDeadline::resync()
+{
+    m_nextNs = monotonicNowNs() + m_periodNs;
+}
+
+} // namespace RealTime
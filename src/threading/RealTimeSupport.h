@@ -0,0 +1,107 @@
+#ifndef REALTIMESUPPORT_H
+#define REALTIMESUPPORT_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Helpers for deterministic periodic work on Linux / PREEMPT_RT
+ *
+ * Used by threads that must hit absolute deadlines (data acquisition, valve
+ * sequencing, TENS waveform playback) instead of relying on QTimer, whose
+ * expiry depends on how busy the owning event loop is.
+ *
+ * All functions degrade gracefully: when the process lacks CAP_SYS_NICE or
+ * CAP_IPC_LOCK they return false and the caller keeps running with normal
+ * scheduling.
+ */
+namespace RealTime {
+
+// CLOCK_MONOTONIC in nanoseconds
+int64_t monotonicNowNs();
+
+// Sleep until an absolute CLOCK_MONOTONIC time (TIMER_ABSTIME, EINTR-safe)
+void sleepUntilNs(int64_t deadlineNs);
+
+// As sleepUntilNs, but sleep only until spinWindowNs before the deadline and
+// busy-wait the rest. For sub-millisecond edges where wake-up latency would
+// otherwise be a large fraction of the interval.
+void sleepUntilPreciseNs(int64_t deadlineNs, int64_t spinWindowNs);
+
+// Switch the calling thread to SCHED_FIFO at the given priority (1-99).
+// Returns false (errno preserved) if not permitted.
+bool setFifoPriority(int priority);
+
+// Pin the calling thread to one CPU. Returns false if the CPU is invalid.
+bool setCpuAffinity(int cpu);
+
+// mlockall(MCL_CURRENT | MCL_FUTURE) so page faults cannot stall deadlines.
+// Reference counted: every successful lockProcessMemory() must be paired with
+// one unlockProcessMemory(), and memory is unlocked only when the last holder
+// releases it, so one thread stopping cannot unlock memory under another.
+bool lockProcessMemory();
+void unlockProcessMemory();
+
+/**
+ * @brief Lock-free timing error statistics (single writer, any reader)
+ *
+ * Tracks the signed error between intended and actual event times. Readers
+ * may observe fields from slightly different updates; values are for
+ * telemetry, not control.
+ */
+class TimingStats
+{
+public:
+    void record(int64_t errorNs);
+    void recordOverrun() { m_overruns.fetch_add(1, std::memory_order_relaxed); }
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+    double lastErrorUs() const { return m_lastNs.load(std::memory_order_relaxed) / 1000.0; }
+    double maxErrorUs() const { return m_maxAbsNs.load(std::memory_order_relaxed) / 1000.0; }
+    double meanErrorUs() const;
+    double meanAbsErrorUs() const;
+
+private:
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_overruns{0};
+    std::atomic<int64_t> m_lastNs{0};
+    std::atomic<int64_t> m_maxAbsNs{0};
+    std::atomic<int64_t> m_sumNs{0};
+    std::atomic<int64_t> m_sumAbsNs{0};
+};
+
+/**
+ * @brief Absolute-deadline periodic timer
+ *
+ * Deadlines are computed as start + n * period, so sleep latency never
+ * accumulates as drift. If the caller misses a whole period the overrun is
+ * counted and the schedule skips forward instead of bursting to catch up.
+ */
+class PeriodicDeadline
+{
+public:
+    void start(int64_t periodNs);
+    void setPeriodNs(int64_t periodNs);
+    int64_t periodNs() const { return m_periodNs; }
+
+    // Sleep until the next deadline; returns wake-up lateness in ns
+    int64_t waitNext();
+
+    // Re-anchor the schedule to "now" (after a pause)
+    void resync();
+
+    int64_t nextDeadlineNs() const { return m_nextNs; }
+    const TimingStats& stats() const { return m_stats; }
+    TimingStats& stats() { return m_stats; }
+
+private:
+    int64_t m_periodNs = 0;
+    int64_t m_nextNs = 0;
+    TimingStats m_stats;
+};
+
+} // namespace RealTime
+
+#endif // REALTIMESUPPORT_H
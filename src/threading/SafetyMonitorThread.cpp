@@ -141,8 +141,9 @@ void SafetyMonitorThread::checkPressureLimits()
 {
     if (!m_hardware) return;
     
-    double avlPressure = m_hardware->readAVLPressure();
-    double tankPressure = m_hardware->readTankPressure();
+    const SensorSnapshot snapshot = m_hardware->getSensorSnapshot();
+    double avlPressure = snapshot.avlPressure;
+    double tankPressure = snapshot.tankPressure;
     
     if (avlPressure > MAX_SAFE_PRESSURE) {
         emit pressureAlarm(avlPressure, "AVL");
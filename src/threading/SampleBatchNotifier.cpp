@@ -0,0 +1,111 @@
+#include "SampleBatchNotifier.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+SampleBatchNotifier::SampleBatchNotifier()
+    : m_activeCount(0)
+{
+}
+
+SampleBatchNotifier::~SampleBatchNotifier()
+{
+    for (Slot& slot : m_slots) {
+        if (slot.eventFd >= 0) {
+            ::close(slot.eventFd);
+        }
+    }
+}
+
+int SampleBatchNotifier::subscribe(int batchSize, int maxLatencyMs)
+{
+    std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+
+    for (int id = 0; id < MAX_SUBSCRIPTIONS; ++id) {
+        Slot& slot = m_slots[id];
+        if (slot.active.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        if (slot.eventFd < 0) {
+            slot.eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (slot.eventFd < 0) {
+                return -1;
+            }
+        } else {
+            // Discard a wake-up left over from the previous subscriber
+            uint64_t stale;
+            while (::read(slot.eventFd, &stale, sizeof(stale)) == sizeof(stale)) {
+            }
+        }
+
+        slot.batchSize.store(batchSize > 0 ? batchSize : 1, std::memory_order_relaxed);
+        slot.maxLatencyNs.store(maxLatencyMs > 0 ? static_cast<int64_t>(maxLatencyMs) * 1000000 : 0,
+                                std::memory_order_relaxed);
+        slot.generation.fetch_add(1, std::memory_order_relaxed);
+        slot.active.store(true, std::memory_order_release);
+        m_activeCount.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+    return -1;
+}
+
+void SampleBatchNotifier::unsubscribe(int id)
+{
+    if (id < 0 || id >= MAX_SUBSCRIPTIONS) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+    if (m_slots[id].active.exchange(false, std::memory_order_acq_rel)) {
+        m_activeCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+int SampleBatchNotifier::eventFd(int id) const
+{
+    if (id < 0 || id >= MAX_SUBSCRIPTIONS) {
+        return -1;
+    }
+    return m_slots[id].eventFd;
+}
+
+void SampleBatchNotifier::onSamplePublished(uint64_t totalWritten, int64_t nowNs)
+{
+    if (m_activeCount.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    for (Slot& slot : m_slots) {
+        if (!slot.active.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        if (generation != slot.seenGeneration) {
+            // New subscriber: count from the sample just before this one
+            slot.seenGeneration = generation;
+            slot.lastNotifiedIndex = totalWritten > 0 ? totalWritten - 1 : 0;
+            slot.lastNotifyNs = nowNs;
+        }
+
+        const uint64_t pending = totalWritten - slot.lastNotifiedIndex;
+        const int64_t maxLatencyNs = slot.maxLatencyNs.load(std::memory_order_relaxed);
+        const bool batchReady = pending >= static_cast<uint64_t>(slot.batchSize.load(std::memory_order_relaxed));
+        const bool deadlineReached = maxLatencyNs > 0 && pending > 0 && nowNs - slot.lastNotifyNs >= maxLatencyNs;
+
+        if (batchReady || deadlineReached) {
+            signal(slot);
+            slot.lastNotifiedIndex = totalWritten;
+            slot.lastNotifyNs = nowNs;
+        }
+    }
+}
+
+void SampleBatchNotifier::signal(Slot& slot)
+{
+    const uint64_t one = 1;
+    // EAGAIN only if the counter would overflow; the consumer is then already awake
+    ssize_t written = ::write(slot.eventFd, &one, sizeof(one));
+    (void)written;
+}
@@ -0,0 +1,70 @@
+#ifndef SAMPLEBATCHNOTIFIER_H
+#define SAMPLEBATCHNOTIFIER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Producer-side batch wake-ups for sample consumers
+ *
+ * Instead of one queued signal per sample, a consumer subscribes with a
+ * batch size and a maximum latency. The producer calls onSamplePublished()
+ * after each push and signals the subscription's eventfd once at least
+ * batchSize samples have accumulated or maxLatency has elapsed since the
+ * last wake-up. The consumer then drains a contiguous block from the
+ * SampleRing with its own cursor.
+ *
+ * The producer path is lock-free and allocation-free: subscriptions live in
+ * a fixed table and the only syscall is one eventfd write per batch. The
+ * latency bound is evaluated when samples arrive, so a stalled producer
+ * produces no wake-ups (there is nothing new to drain).
+ *
+ * subscribe()/unsubscribe() may be called from any thread. Each slot's
+ * eventfd is kept open for reuse and closed when the notifier is destroyed.
+ */
+class SampleBatchNotifier
+{
+public:
+    static const int MAX_SUBSCRIPTIONS = 8;
+
+    SampleBatchNotifier();
+    ~SampleBatchNotifier();
+
+    SampleBatchNotifier(const SampleBatchNotifier&) = delete;
+    SampleBatchNotifier& operator=(const SampleBatchNotifier&) = delete;
+
+    // Returns a subscription id, or -1 if the table is full or eventfd fails
+    int subscribe(int batchSize, int maxLatencyMs);
+    void unsubscribe(int id);
+
+    // Readable (EFD_NONBLOCK) when a batch is ready; read 8 bytes to re-arm
+    int eventFd(int id) const;
+
+    // Producer only: called after the sample with index totalWritten-1 was published
+    void onSamplePublished(uint64_t totalWritten, int64_t nowNs);
+
+    int activeCount() const { return m_activeCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<bool> active{false};
+        std::atomic<uint32_t> generation{0};
+        std::atomic<int> batchSize{1};
+        std::atomic<int64_t> maxLatencyNs{0};
+        int eventFd = -1;
+
+        // Producer-private state
+        uint32_t seenGeneration = 0;
+        uint64_t lastNotifiedIndex = 0;
+        int64_t lastNotifyNs = 0;
+    };
+
+    void signal(Slot& slot);
+
+    Slot m_slots[MAX_SUBSCRIPTIONS];
+    std::atomic<int> m_activeCount;
+    std::mutex m_subscriptionMutex;   // subscribe/unsubscribe only, never the producer
+};
+
+#endif // SAMPLEBATCHNOTIFIER_H
@@ -0,0 +1,84 @@
+#include "SampleBatchSubscriber.h"
+#include <QSocketNotifier>
+#include <QDebug>
+#include <unistd.h>
+
+SampleBatchSubscriber::SampleBatchSubscriber(DataAcquisitionThread* source, int batchSize, int maxLatencyMs,
+                                             QObject *parent)
+    : QObject(parent)
+    , m_source(source)
+    , m_subscriptionId(-1)
+    , m_notifier(nullptr)
+    , m_cursor(0)
+    , m_delivered(0)
+    , m_skipped(0)
+    , m_wakeups(0)
+{
+    if (!m_source) {
+        qWarning() << "SampleBatchSubscriber: no data source";
+        return;
+    }
+
+    m_subscriptionId = m_source->subscribeBatches(batchSize, maxLatencyMs);
+    if (m_subscriptionId < 0) {
+        qWarning() << "SampleBatchSubscriber: no free subscription slot";
+        return;
+    }
+
+    // Enough room to drain the whole history in one pass
+    m_block.resize(qMax(1, m_source->getBufferSize()));
+    m_cursor = m_source->getTotalSampleIndex();
+
+    m_notifier = new QSocketNotifier(m_source->batchEventFd(m_subscriptionId), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &SampleBatchSubscriber::onEventFdActivated);
+}
+
+SampleBatchSubscriber::~SampleBatchSubscriber()
+{
+    if (m_notifier) {
+        m_notifier->setEnabled(false);
+    }
+    if (m_source && m_subscriptionId >= 0) {
+        m_source->unsubscribeBatches(m_subscriptionId);
+    }
+}
+
+void SampleBatchSubscriber::onEventFdActivated()
+{
+    // Reset the eventfd counter; several producer signals may have coalesced
+    uint64_t signals = 0;
+    ssize_t bytes = ::read(m_source->batchEventFd(m_subscriptionId), &signals, sizeof(signals));
+    (void)bytes;
+
+    m_wakeups++;
+    drain();
+}
+
+int SampleBatchSubscriber::drain()
+{
+    if (!m_source || m_block.isEmpty()) {
+        return 0;
+    }
+
+    int total = 0;
+    int count;
+    do {
+        quint64 skipped = 0;
+        count = m_source->readDataSince(m_cursor, m_block.data(), m_block.size(), &skipped);
+
+        if (skipped > 0) {
+            m_skipped += skipped;
+            emit samplesSkipped(skipped);
+        }
+        if (count > 0) {
+            if (m_handler) {
+                m_handler(m_block.constData(), count);
+            }
+            m_delivered += count;
+            total += count;
+            emit batchReady(count);
+        }
+    } while (count == m_block.size());
+
+    return total;
+}
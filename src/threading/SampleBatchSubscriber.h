@@ -0,0 +1,66 @@
+#ifndef SAMPLEBATCHSUBSCRIBER_H
+#define SAMPLEBATCHSUBSCRIBER_H
+
+#include <QObject>
+#include <QVector>
+#include <functional>
+#include "DataAcquisitionThread.h"
+
+class QSocketNotifier;
+
+/**
+ * @brief Event-loop consumer of batched acquisition samples
+ *
+ * Replaces a per-sample queued connection to DataAcquisitionThread::dataReady.
+ * The subscriber registers with the acquisition thread's batch notifier and
+ * watches the returned eventfd with a QSocketNotifier in the thread that owns
+ * this object. On wake-up it drains every sample published since its last
+ * drain into preallocated storage and hands the contiguous block to the
+ * handler (and emits batchReady) on the owning thread.
+ *
+ * No per-sample allocation or event is created; one socket notification is
+ * delivered per batch.
+ */
+class SampleBatchSubscriber : public QObject
+{
+    Q_OBJECT
+
+public:
+    using BatchHandler = std::function<void(const DataAcquisitionThread::SensorData* samples, int count)>;
+
+    SampleBatchSubscriber(DataAcquisitionThread* source, int batchSize, int maxLatencyMs,
+                          QObject *parent = nullptr);
+    ~SampleBatchSubscriber();
+
+    bool isSubscribed() const { return m_subscriptionId >= 0; }
+    void setHandler(BatchHandler handler) { m_handler = std::move(handler); }
+
+    // Drain immediately without waiting for a wake-up (returns samples delivered)
+    int drain();
+
+    quint64 getDeliveredCount() const { return m_delivered; }
+    quint64 getSkippedCount() const { return m_skipped; }
+    quint64 getWakeupCount() const { return m_wakeups; }
+
+Q_SIGNALS:
+    // Emitted on the owning thread after the handler has run
+    void batchReady(int count);
+    void samplesSkipped(quint64 count);
+
+private Q_SLOTS:
+    void onEventFdActivated();
+
+private:
+    DataAcquisitionThread* m_source;
+    int m_subscriptionId;
+    QSocketNotifier* m_notifier;
+    QVector<DataAcquisitionThread::SensorData> m_block;
+    quint64 m_cursor;
+    BatchHandler m_handler;
+
+    quint64 m_delivered;
+    quint64 m_skipped;
+    quint64 m_wakeups;
+};
+
+#endif // SAMPLEBATCHSUBSCRIBER_H
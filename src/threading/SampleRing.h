@@ -0,0 +1,244 @@
+#ifndef SAMPLERING_H
+#define SAMPLERING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-capacity single-producer / multi-reader overwrite ring
+ *
+ * The producer (acquisition thread) never blocks and never allocates after
+ * reset(); when the ring is full the oldest sample is overwritten. Readers
+ * never take a lock: each slot carries a sequence number (seqlock), which a
+ * reader checks before and after copying the slot, so a sample the producer
+ * overwrote during the copy is discarded rather than returned torn.
+ *
+ * Samples are addressed by a monotonically increasing 64-bit index, so a
+ * consumer can keep a cursor and read only what is new since its last call
+ * (readSince), or ask for the most recent N samples (copyLatest). Indices
+ * keep counting across reset() and clear(); a cursor is never ahead of the
+ * producer unless it came from somewhere else, and readSince clamps it.
+ *
+ * T must be trivially copyable. reset() must not race the producer, but may
+ * run while readers copy: storage is never freed before the ring is
+ * destroyed, and readers retry when the generation changes under them.
+ */
+template<typename T>
+class SampleRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SampleRing requires a trivially copyable type");
+
+public:
+    SampleRing() = default;
+    explicit SampleRing(size_t capacity) { reset(capacity); }
+
+    SampleRing(const SampleRing&) = delete;
+    SampleRing& operator=(const SampleRing&) = delete;
+
+    /**
+     * Make room for at least @p capacity readable samples and drop all
+     * contents. One extra slot is reserved for the sample being written.
+     * Shrinking reuses the current storage; growing allocates new storage
+     * and keeps the old one until destruction for readers still copying
+     * from it (at most the size of the final storage again, as it doubles).
+     */
+    void reset(size_t capacity)
+    {
+        // Not named "slots": Qt defines that as a macro
+        size_t slotCount = 2;
+        while (slotCount < capacity + 1) {
+            slotCount <<= 1;
+        }
+
+        Storage* current = m_current.load(std::memory_order_relaxed);
+        if (!current || current->mask + 1 < slotCount) {
+            std::unique_ptr<Storage> storage(new Storage);
+            storage->entries.reset(new Slot[slotCount]);
+            storage->mask = slotCount - 1;
+            m_storages.push_back(std::move(storage));
+            m_current.store(m_storages.back().get(), std::memory_order_release);
+        }
+
+        m_capacity.store(capacity, std::memory_order_relaxed);
+        clear();
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    size_t capacity() const { return m_capacity.load(std::memory_order_relaxed); }
+
+    // Incremented by every reset(); readers may use it to re-seed
+    uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+    // Producer only
+    void push(const T& value)
+    {
+        const Storage* storage = m_current.load(std::memory_order_relaxed);
+        const uint64_t index = m_published.load(std::memory_order_relaxed);
+        Slot& slot = storage->entries[index & storage->mask];
+
+        // Mark the slot as being written before touching it
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(slot.bytes, &value, sizeof(T));
+
+        slot.sequence.store(index + 1, std::memory_order_release);
+        m_published.store(index + 1, std::memory_order_release);
+    }
+
+    // Discard everything published so far (safe while the producer runs)
+    void clear() { m_floor.store(m_published.load(std::memory_order_acquire), std::memory_order_release); }
+
+    // Index one past the newest published sample
+    uint64_t totalWritten() const { return m_published.load(std::memory_order_acquire); }
+
+    size_t size() const
+    {
+        const uint64_t end = totalWritten();
+        const uint64_t begin = oldestReadable(end);
+        return static_cast<size_t>(end - begin);
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    bool latest(T& out) const { return copyLatest(&out, 1) == 1; }
+
+    /**
+     * Copy up to @p maxCount of the most recent samples into @p out, oldest
+     * first. Returns the number of samples written.
+     */
+    size_t copyLatest(T* out, size_t maxCount) const
+    {
+        for (;;) {
+            const uint64_t generation = m_generation.load(std::memory_order_acquire);
+            const Storage* storage = m_current.load(std::memory_order_acquire);
+            const uint64_t end = totalWritten();
+            uint64_t begin = oldestReadable(end);
+            if (end - begin > maxCount) {
+                begin = end - maxCount;
+            }
+
+            const uint64_t valid = copyRange(storage, begin, end, out);
+
+            if (valid <= begin && m_generation.load(std::memory_order_acquire) == generation) {
+                return static_cast<size_t>(end - begin);
+            }
+            // Producer lapped us mid-copy (reader was preempted) or the ring
+            // was reset; retry with fresh bounds
+        }
+    }
+
+    /**
+     * Copy samples published since @p cursor (up to @p maxCount) into @p out,
+     * oldest first, and advance @p cursor past them. Returns the number of
+     * samples written. If the producer overwrote samples the reader had not
+     * yet consumed, @p skipped receives how many were lost. A cursor ahead
+     * of the producer is moved back to the oldest readable sample.
+     */
+    size_t readSince(uint64_t& cursor, T* out, size_t maxCount, uint64_t* skipped = nullptr) const
+    {
+        uint64_t lost = 0;
+        size_t count = 0;
+
+        for (;;) {
+            const uint64_t generation = m_generation.load(std::memory_order_acquire);
+            const Storage* storage = m_current.load(std::memory_order_acquire);
+            const uint64_t end = totalWritten();
+            const uint64_t oldest = oldestReadable(end);
+            uint64_t begin = cursor;
+            if (begin > end) {
+                begin = oldest;
+            } else if (begin < oldest) {
+                lost += oldest - begin;
+                begin = oldest;
+            }
+            uint64_t stop = end;
+            if (stop - begin > maxCount) {
+                stop = begin + maxCount;
+            }
+
+            const uint64_t valid = copyRange(storage, begin, stop, out);
+
+            if (m_generation.load(std::memory_order_acquire) != generation) {
+                cursor = begin;     // Reset mid-copy: re-read from the new floor
+                continue;
+            }
+            if (valid <= begin) {
+                count = static_cast<size_t>(stop - begin);
+                cursor = stop;
+                break;
+            }
+            // Lapped during the copy: the samples before 'valid' are gone
+            lost += valid - begin;
+            cursor = valid;
+        }
+
+        if (skipped) {
+            *skipped = lost;
+        }
+        return count;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};      // Index + 1 once written, 0 while writing
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    struct Storage {
+        std::unique_ptr<Slot[]> entries;
+        uint64_t mask = 0;
+    };
+
+    uint64_t oldestReadable(uint64_t end) const
+    {
+        // clear() may have raced ahead of the 'end' the caller loaded
+        const uint64_t floor = std::min(m_floor.load(std::memory_order_acquire), end);
+        const size_t capacity = m_capacity.load(std::memory_order_relaxed);
+        const uint64_t begin = end > capacity ? end - capacity : 0;
+        return std::max(begin, floor);
+    }
+
+    /**
+     * Copy [begin, end) and validate every slot's sequence after its copy.
+     * Returns begin when all samples are intact, otherwise one past the
+     * newest sample that was overwritten while copying.
+     */
+    static uint64_t copyRange(const Storage* storage, uint64_t begin, uint64_t end, T* out)
+    {
+        uint64_t valid = begin;
+        for (uint64_t i = begin; i < end; ++i, ++out) {
+            const Slot& slot = storage->entries[i & storage->mask];
+            const uint64_t expected = i + 1;
+            if (slot.sequence.load(std::memory_order_acquire) != expected) {
+                valid = i + 1;
+                continue;
+            }
+            std::memcpy(out, slot.bytes, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+                valid = i + 1;
+            }
+        }
+        return valid;
+    }
+
+    // Every storage ever allocated; only the last one is current
+    std::vector<std::unique_ptr<Storage>> m_storages;
+    std::atomic<Storage*> m_current{nullptr};
+    std::atomic<size_t> m_capacity{0};
+    std::atomic<uint64_t> m_generation{0};
+
+    // Producer-written counter on its own cache line so reader traffic on
+    // m_floor does not false-share with the hot write path.
+    alignas(64) std::atomic<uint64_t> m_published{0};
+    alignas(64) std::atomic<uint64_t> m_floor{0};
+};
+
+#endif // SAMPLERING_H
@@ -21,6 +21,10 @@ ThreadManager::ThreadManager(HardwareManager* hardware, QObject *parent)
     , m_dataAcquisitionRateHz(DEFAULT_DATA_RATE_HZ)
     , m_guiUpdateRateFps(DEFAULT_GUI_RATE_FPS)
     , m_safetyMonitorRateHz(DEFAULT_SAFETY_RATE_HZ)
+    , m_realTimeAcquisition(false)
+    , m_realTimePriority(DEFAULT_REALTIME_PRIORITY)
+    , m_realTimeCpu(-1)
+    , m_realTimeLockMemory(false)
 {
     initializeThreads();
 }
@@ -154,6 +158,10 @@ bool ThreadManager::startDataAcquisition()
     
     try {
         m_dataThread->setSamplingRate(m_dataAcquisitionRateHz);
+        m_dataThread->setRealTimeMode(m_realTimeAcquisition);
+        m_dataThread->setRealTimePriority(m_realTimePriority);
+        m_dataThread->setCpuAffinity(m_realTimeCpu);
+        m_dataThread->setLockMemory(m_realTimeLockMemory);
         m_dataThread->startAcquisition();
         return true;
     } catch (const std::exception& e) {
@@ -238,6 +246,15 @@ void ThreadManager::setDataAcquisitionRate(int hz)
     }
 }
 
+void ThreadManager::setDataAcquisitionRealTime(bool enabled, int fifoPriority, int cpu, bool lockMemory)
+{
+    QMutexLocker locker(&m_stateMutex);
+    m_realTimeAcquisition = enabled;
+    m_realTimePriority = fifoPriority;
+    m_realTimeCpu = cpu;
+    m_realTimeLockMemory = lockMemory;
+}
+
 void ThreadManager::setGuiUpdateRate(int fps)
 {
     QMutexLocker locker(&m_stateMutex);
@@ -265,6 +282,13 @@ QString ThreadManager::getThreadStatistics() const
                 .arg(m_dataThread->getSamplingRate())
                 .arg(m_dataThread->getActualSamplingRate(), 0, 'f', 1)
                 .arg(m_dataThread->getBufferCount());
+        if (m_dataThread->isRealTimeMode()) {
+            stats += QString("  Period jitter: avg %1 us, max %2 us, overruns: %3, SCHED_FIFO: %4\n")
+                    .arg(m_dataThread->getAverageJitterUs(), 0, 'f', 1)
+                    .arg(m_dataThread->getMaxJitterUs(), 0, 'f', 1)
+                    .arg(m_dataThread->getOverrunCount())
+                    .arg(m_dataThread->isRealTimeSchedulingActive() ? "yes" : "no");
+        }
     }
     
     if (m_guiThread) {
@@ -348,6 +372,7 @@ void ThreadManager::initializeThreads()
 
     // Create GUI update thread
     m_guiThread = std::make_unique<GuiUpdateThread>(m_dataThread.get());
+    m_guiThread->setDataSource(m_dataThread.get());
 
     // DISABLED: Safety monitoring thread causes EGLFS display conflicts
     // Using integrated safety monitoring in DataAcquisitionThread instead
@@ -357,6 +382,7 @@ void ThreadManager::initializeThreads()
     connectThreadSignals();
 
     qDebug() << "Threads initialized with integrated safety monitoring (EGLFS compatible)";
+    emit dataSourceChanged(m_dataThread.get());
 }
 
 void ThreadManager::connectThreadSignals()
@@ -402,6 +428,9 @@ void ThreadManager::connectThreadSignals()
 
 void ThreadManager::cleanupThreads()
 {
+    if (m_dataThread) {
+        emit dataSourceChanged(nullptr);
+    }
     m_safetyThread.reset();
     m_guiThread.reset();
     m_dataThread.reset();
@@ -76,6 +76,13 @@ public:
     void setDataAcquisitionRate(int hz);
     void setGuiUpdateRate(int fps);
     void setSafetyMonitorRate(int hz);
+
+    // Real-time acquisition (clock_nanosleep loop; see DataAcquisitionThread).
+    // Applied when data acquisition next starts.
+    void setDataAcquisitionRealTime(bool enabled, int fifoPriority = DEFAULT_REALTIME_PRIORITY,
+                                    int cpu = -1, bool lockMemory = false);
+    bool isDataAcquisitionRealTime() const { return m_realTimeAcquisition; }
+    int getDataAcquisitionRealTimePriority() const { return m_realTimePriority; }
     
     // Statistics
     QString getThreadStatistics() const;
@@ -91,6 +98,9 @@ Q_SIGNALS:
     void threadError(const QString& threadName, const QString& error);
     void threadStateChanged(const QString& threadName, ThreadState state);
     void emergencyStopTriggered();
+    // Emitted with nullptr before the acquisition thread is destroyed and with
+    // the new thread after it is (re)created, so sample consumers can rebind
+    void dataSourceChanged(DataAcquisitionThread* source);
 
 private Q_SLOTS:
     void onDataThreadStarted();
@@ -144,11 +154,16 @@ private:
     int m_dataAcquisitionRateHz;
     int m_guiUpdateRateFps;
     int m_safetyMonitorRateHz;
+    bool m_realTimeAcquisition;
+    int m_realTimePriority;
+    int m_realTimeCpu;
+    bool m_realTimeLockMemory;
     
     // Constants
     static const int DEFAULT_DATA_RATE_HZ = 50;
     static const int DEFAULT_GUI_RATE_FPS = 30;
     static const int DEFAULT_SAFETY_RATE_HZ = 100;
+    static const int DEFAULT_REALTIME_PRIORITY = 80;
     static const int THREAD_STOP_TIMEOUT_MS = 5000;
     static const int MAX_THREAD_ERRORS = 5;
 };
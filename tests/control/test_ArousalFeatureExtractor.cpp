@@ -0,0 +1,155 @@
+#include <QTest>
+#include <cmath>
+#include <deque>
+
+#include "../../src/control/ArousalFeatureExtractor.h"
+
+/**
+ * @brief Tests for the streaming arousal feature extractor
+ *
+ * Checks the sliding variance against a direct window computation, that
+ * band power responds to 1 Hz contractions but not to slow drift or fast
+ * oscillation, that the derivative scales with the sample rate and spans
+ * the same time at any rate, and that timestamped samples drive the
+ * derivative and measured arrival rate.
+ */
+class TestArousalFeatureExtractor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testVarianceMatchesWindow();
+    void testBandPowerSelectsContractionBand();
+    void testBandPowerIndependentOfSampleRate();
+    void testDerivativeUsesSampleRate();
+    void testDerivativeSpanIsInSeconds();
+    void testTimestampedSamples();
+    void testResetToBaseline();
+};
+
+namespace {
+double steadyBandPower(double rateHz, double toneHz, double amplitude)
+{
+    ArousalFeatureExtractor features(rateHz, 100);
+    features.reset(30.0);
+    const int samples = static_cast<int>(30.0 * rateHz);
+    for (int n = 0; n < samples; ++n) {
+        features.addSample(30.0 + amplitude * std::sin(2.0 * M_PI * toneHz * n / rateHz));
+    }
+    return features.contractionPower();
+}
+}
+
+void TestArousalFeatureExtractor::testVarianceMatchesWindow()
+{
+    const int window = 50;
+    ArousalFeatureExtractor features(10.0, window);
+    features.reset(20.0);
+
+    std::deque<double> reference(window, 20.0);
+    uint32_t lcg = 12345;
+    for (int n = 0; n < 1000; ++n) {
+        lcg = lcg * 1103515245u + 12345u;
+        const double value = 20.0 + ((lcg >> 16) % 1000) / 100.0;
+        features.addSample(value);
+        reference.pop_front();
+        reference.push_back(value);
+
+        double mean = 0.0;
+        for (double v : reference) mean += v;
+        mean /= window;
+        double var = 0.0;
+        for (double v : reference) var += (v - mean) * (v - mean);
+        var /= window;
+
+        QVERIFY2(qAbs(features.variance() - var) < 1e-9, qPrintable(QString("sample %1").arg(n)));
+    }
+}
+
+void TestArousalFeatureExtractor::testBandPowerSelectsContractionBand()
+{
+    // Sine of amplitude A has mean square A^2 / 2 at the band center
+    const double inBand = steadyBandPower(50.0, 1.0, 4.0);
+    QVERIFY(inBand > 6.0 && inBand < 9.0);
+
+    QVERIFY(steadyBandPower(50.0, 0.1, 4.0) < inBand * 0.1);
+    QVERIFY(steadyBandPower(50.0, 8.0, 4.0) < inBand * 0.1);
+}
+
+void TestArousalFeatureExtractor::testBandPowerIndependentOfSampleRate()
+{
+    const double at10Hz = steadyBandPower(10.0, 1.0, 4.0);
+    const double at500Hz = steadyBandPower(500.0, 1.0, 4.0);
+    QVERIFY(qAbs(at10Hz - at500Hz) < 0.1 * at500Hz);
+}
+
+void TestArousalFeatureExtractor::testDerivativeUsesSampleRate()
+{
+    // 2 mmHg/s ramp sampled at 10 Hz and at 200 Hz
+    for (double rate : {10.0, 200.0}) {
+        ArousalFeatureExtractor features(rate, 20);
+        features.reset(0.0);
+        // Two seconds: longer than the derivative span at either rate
+        for (int n = 1; n <= 2 * rate; ++n) {
+            features.addSample(2.0 * n / rate);
+        }
+        QVERIFY(qAbs(features.derivativePerSecond() - 2.0) < 1e-9);
+    }
+}
+
+void TestArousalFeatureExtractor::testDerivativeSpanIsInSeconds()
+{
+    // A 1 mmHg step reads as 1 / DERIVATIVE_SPAN_S until it leaves the span,
+    // whatever the rate
+    const double spanS = ArousalFeatureExtractor::DERIVATIVE_SPAN_S;
+    for (double rate : {10.0, 50.0, 1000.0}) {
+        ArousalFeatureExtractor features(rate, 20);
+        features.reset(0.0);
+        QCOMPARE(features.derivativeSpanSamples(), qRound(spanS * rate));
+
+        features.addSample(1.0);
+        QVERIFY(qAbs(features.derivativePerSecond() - 1.0 / spanS) < 1e-9);
+
+        const int holdSamples = qRound(spanS * rate) - 1;
+        for (int n = 0; n < holdSamples; ++n) {
+            features.addSample(1.0);
+        }
+        QVERIFY(qAbs(features.derivativePerSecond() - 1.0 / spanS) < 1e-9);
+        features.addSample(1.0);
+        QCOMPARE(features.derivativePerSecond(), 0.0);
+    }
+}
+
+void TestArousalFeatureExtractor::testTimestampedSamples()
+{
+    // Configured for 10 Hz but fed at 100 Hz with one dropped sample: the
+    // derivative follows real time and the arrival rate is measured
+    ArousalFeatureExtractor features(10.0, 100);
+    features.reset(0.0);
+
+    const int64_t periodNs = 10000000;
+    for (int n = 1; n <= 200; ++n) {
+        if (n == 150) {
+            continue;
+        }
+        features.addSample(3.0 * n * periodNs * 1e-9, n * periodNs);
+    }
+
+    QVERIFY(qAbs(features.derivativePerSecond() - 3.0) < 1e-9);
+    QVERIFY(qAbs(features.measuredSampleRateHz() - 100.0) < 5.0);
+}
+
+void TestArousalFeatureExtractor::testResetToBaseline()
+{
+    ArousalFeatureExtractor features(10.0, 100);
+    features.reset(35.0);
+    features.addSample(35.0);
+
+    QCOMPARE(features.variance(), 0.0);
+    QCOMPARE(features.contractionPower(), 0.0);
+    QCOMPARE(features.derivativePerSecond(), 0.0);
+    QCOMPARE(features.sampleCount(), quint64(1));
+}
+
+QTEST_MAIN(TestArousalFeatureExtractor)
+#include "test_ArousalFeatureExtractor.moc"
@@ -0,0 +1,130 @@
+#include <QTest>
+#include <cmath>
+
+#include "../../src/control/PressureController.h"
+#include "../../src/hardware/PneumaticPlant.h"
+
+/**
+ * @brief Tests for the closed-loop outer-chamber pressure controller
+ *
+ * Closes the loop around the pneumatic plant model at the 50 Hz
+ * acquisition rate to check tracking and valve activity, then checks
+ * anti-windup, the valve deadband and the no-measurement fallback on
+ * synthetic readings.
+ */
+class TestPressureController : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testTracksSetpointStepsOnPlant();
+    void testNoWindupWhileSaturated();
+    void testValveDeadbandAndMissingReadings();
+};
+
+namespace {
+const int64_t SAMPLE_NS = 20000000;     // 50 Hz
+
+void runClosedLoop(PressureController& controller, PneumaticPlant& plant, int64_t& nowNs, int samples)
+{
+    for (int i = 0; i < samples; ++i) {
+        double avl, tank, clitoral;
+        plant.sampleSensors(avl, tank, clitoral);
+        const PressureController::Command command = controller.update(avl, nowNs);
+
+        PneumaticPlant::Inputs inputs;
+        inputs.pumpEnabled = command.pumpEnabled;
+        inputs.pumpSpeedPercent = command.pumpPercent;
+        inputs.sol1 = command.vacuumValveOpen;
+        inputs.sol2 = command.ventValveOpen;
+        plant.setInputs(inputs);
+        plant.advance(SAMPLE_NS);
+        nowNs += SAMPLE_NS;
+    }
+}
+}
+
+void TestPressureController::testTracksSetpointStepsOnPlant()
+{
+    PneumaticPlant::Parameters parameters;
+    parameters.sensorNoiseMmHg = 0.3;
+    PneumaticPlant plant(parameters);
+    PressureController controller;
+    int64_t nowNs = 1;
+
+    for (double setpoint : {40.0, 25.0}) {
+        controller.setSetpoint(setpoint);
+        runClosedLoop(controller, plant, nowNs, 500);      // Settle for 10 s
+
+        QVERIFY(controller.metrics().lastSettlingTimeMs >= 0.0);
+        QVERIFY(controller.metrics().lastSettlingTimeMs < 2000.0);
+
+        controller.resetMetrics();
+        runClosedLoop(controller, plant, nowNs, 250);      // Then measure 5 s
+        const PressureController::TrackingMetrics& metrics = controller.metrics();
+        QVERIFY2(metrics.meanAbsErrorMmHg() < 1.5, qPrintable(QString::number(metrics.meanAbsErrorMmHg())));
+        QVERIFY(metrics.inBandFraction() > 0.9);
+        QVERIFY(metrics.valveTransitions < 20);            // Under 4 per second
+        QCOMPARE(metrics.saturatedSamples, uint64_t(0));
+    }
+}
+
+void TestPressureController::testNoWindupWhileSaturated()
+{
+    PressureController controller;
+    controller.setSetpoint(70.0);
+    int64_t nowNs = 1;
+
+    // Chamber cannot follow (e.g. seal lost): output pinned at full speed
+    for (int i = 0; i < 500; ++i, nowNs += SAMPLE_NS) {
+        const PressureController::Command command = controller.update(0.0, nowNs);
+        QCOMPARE(command.pumpPercent, 100.0);
+    }
+    QCOMPARE(controller.integralPercent(), 0.0);
+
+    // Reaching the setpoint drops straight back to feed-forward
+    const PressureController::Command command = controller.update(70.0, nowNs);
+    QVERIFY(command.pumpChanged);
+    QVERIFY(std::fabs(command.pumpPercent - 70.0 / controller.config().pumpVacuumPerPercentMmHg) < 0.01);
+}
+
+void TestPressureController::testValveDeadbandAndMissingReadings()
+{
+    PressureController controller;
+    controller.setSetpoint(40.0);
+    int64_t nowNs = 1;
+
+    // Noise inside the deadband never moves the valves
+    PressureController::Command command = controller.update(40.0, nowNs);
+    QVERIFY(command.valvesChanged);
+    QVERIFY(command.vacuumValveOpen && !command.ventValveOpen);
+    for (int i = 1; i < 200; ++i) {
+        nowNs += SAMPLE_NS;
+        command = controller.update(40.0 + ((i % 2) ? 0.8 : -0.8), nowNs);
+        QVERIFY(!command.valvesChanged);
+    }
+    QCOMPARE(controller.metrics().valveTransitions, uint64_t(0));
+
+    // Overshoot past the vent threshold vents, then holds near the setpoint
+    nowNs += SAMPLE_NS;
+    command = controller.update(45.0, nowNs);
+    QVERIFY(command.ventValveOpen && !command.vacuumValveOpen);
+    QCOMPARE(command.pumpPercent, 0.0);
+    nowNs += SAMPLE_NS;
+    command = controller.update(40.2, nowNs);
+    QCOMPARE(controller.valveState(), PressureController::ValveState::HOLD);
+    QVERIFY(!command.ventValveOpen && !command.vacuumValveOpen);
+
+    // No reading: feed-forward only, integral untouched
+    const double integral = controller.integralPercent();
+    nowNs += SAMPLE_NS;
+    command = controller.update(-1.0, nowNs);
+    QCOMPARE(controller.metrics().invalidSamples, uint64_t(1));
+    QVERIFY(command.vacuumValveOpen);
+    QVERIFY(std::fabs(command.pumpPercent - 40.0 / controller.config().pumpVacuumPerPercentMmHg)
+            < controller.config().pumpDeadbandPercent);
+    QCOMPARE(controller.integralPercent(), integral);
+}
+
+QTEST_MAIN(TestPressureController)
+#include "test_PressureController.moc"
@@ -0,0 +1,142 @@
+#include <QTest>
+
+#include "../../src/hardware/ActuatorControl.h"
+#include "../../src/hardware/PWMBackend.h"
+
+/**
+ * @brief Tests for the pump PWM output stage
+ *
+ * Drives ActuatorControl against a SimulatedPWMBackend and checks the duty
+ * cycle, enable state and frequency the backend is left in after each pump
+ * command, and that a speed change costs exactly one backend write.
+ */
+class TestPWMBackend : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSimulatedBackend();
+    void testPumpSpeedSetsDuty();
+    void testSpeedChangeIsOneWrite();
+    void testFrequencyChange();
+    void testPumpOffAndEmergencyStop();
+};
+
+namespace {
+// The backend stays owned by the actuator; the raw pointer is for asserts
+SimulatedPWMBackend* attachBackend(ActuatorControl& actuators)
+{
+    auto backend = std::make_unique<SimulatedPWMBackend>();
+    backend->open();
+    backend->setFrequency(5000);
+    SimulatedPWMBackend* raw = backend.get();
+    actuators.setPWMBackend(std::move(backend));
+    return raw;
+}
+}
+
+void TestPWMBackend::testSimulatedBackend()
+{
+    SimulatedPWMBackend backend;
+    QVERIFY(!backend.isOpen());
+    QVERIFY(backend.open());
+
+    QVERIFY(!backend.setFrequency(0));
+    QVERIFY(!backend.lastError().isEmpty());
+    QVERIFY(backend.setFrequency(1000));
+    QCOMPARE(backend.frequency(), 1000);
+
+    QVERIFY(backend.setDutyCycle(1.5));
+    QCOMPARE(backend.dutyCycle(), 1.0);
+    QVERIFY(backend.setDutyCycle(-0.5));
+    QCOMPARE(backend.dutyCycle(), 0.0);
+    QVERIFY(backend.setEnabled(true));
+    QCOMPARE(backend.writeCount(), 4);
+
+    backend.close();
+    QVERIFY(!backend.isOpen());
+    QVERIFY(!backend.isEnabled());
+}
+
+void TestPWMBackend::testPumpSpeedSetsDuty()
+{
+    ActuatorControl actuators;
+    SimulatedPWMBackend* backend = attachBackend(actuators);
+
+    actuators.setPumpEnabled(true);
+    QVERIFY(!backend->isEnabled());         // Enabled at zero speed: output stays off
+
+    actuators.setPumpSpeed(50.0);
+    QVERIFY(backend->isEnabled());
+    QCOMPARE(backend->dutyCycle(), 0.5);
+
+    actuators.setPumpSpeed(75.0);
+    QCOMPARE(backend->dutyCycle(), 0.75);
+
+    // Below the minimum meaningful speed the pump runs at the minimum
+    actuators.setPumpSpeed(1.0);
+    QCOMPARE(backend->dutyCycle(), static_cast<int>(0.05 * 1024) / 1024.0);
+}
+
+void TestPWMBackend::testSpeedChangeIsOneWrite()
+{
+    ActuatorControl actuators;
+    SimulatedPWMBackend* backend = attachBackend(actuators);
+    actuators.setPumpEnabled(true);
+    actuators.setPumpSpeed(40.0);
+
+    int writes = backend->writeCount();
+    actuators.setPumpSpeed(60.0);
+    QCOMPARE(backend->writeCount(), writes + 1);
+
+    // Changes inside the speed deadband do not reach the backend
+    writes = backend->writeCount();
+    actuators.setPumpSpeed(60.05);
+    QCOMPARE(backend->writeCount(), writes);
+}
+
+void TestPWMBackend::testFrequencyChange()
+{
+    ActuatorControl actuators;
+    SimulatedPWMBackend* backend = attachBackend(actuators);
+    actuators.setPumpEnabled(true);
+    actuators.setPumpSpeed(50.0);
+
+    actuators.setPWMFrequency(2000);
+    QCOMPARE(backend->frequency(), 2000);
+    QCOMPARE(actuators.getPWMFrequency(), 2000);
+    QCOMPARE(backend->dutyCycle(), 0.5);    // Duty is a fraction, so it carries over
+
+    // Invalid frequencies are refused before they reach the backend
+    actuators.setPWMFrequency(0);
+    QCOMPARE(backend->frequency(), 2000);
+}
+
+void TestPWMBackend::testPumpOffAndEmergencyStop()
+{
+    ActuatorControl actuators;
+    SimulatedPWMBackend* backend = attachBackend(actuators);
+    actuators.setPumpEnabled(true);
+    actuators.setPumpSpeed(75.0);
+    QVERIFY(backend->isEnabled());
+
+    actuators.setPumpEnabled(false);
+    QVERIFY(!backend->isEnabled());
+    QCOMPARE(backend->dutyCycle(), 0.0);
+
+    actuators.setPumpEnabled(true);
+    actuators.setPumpSpeed(75.0);
+    QCOMPARE(backend->dutyCycle(), 0.75);
+
+    actuators.emergencyStop();
+    QVERIFY(!backend->isEnabled());
+    QCOMPARE(backend->dutyCycle(), 0.0);
+
+    // Speed commands are ignored until the stop is reset
+    actuators.setPumpSpeed(50.0);
+    QVERIFY(!backend->isEnabled());
+    QCOMPARE(backend->dutyCycle(), 0.0);
+}
+
+QTEST_MAIN(TestPWMBackend)
+#include "test_PWMBackend.moc"
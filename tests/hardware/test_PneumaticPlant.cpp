@@ -0,0 +1,135 @@
+#include <QTest>
+
+#include "../../src/hardware/PneumaticPlant.h"
+#include "../../src/hardware/VirtualClock.h"
+
+/**
+ * @brief Tests for the pneumatic plant model and its virtual clock
+ *
+ * Covers pump-down toward the dead-head vacuum, valve routing to the two
+ * chambers, venting, determinism across different advance() granularity,
+ * and the manual / scaled clock modes.
+ */
+class TestPneumaticPlant : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStartsAtAtmosphere();
+    void testPumpEvacuatesTank();
+    void testValvesRouteVacuum();
+    void testVentReleasesChamber();
+    void testAdvanceGranularityIsDeterministic();
+    void testManualClock();
+};
+
+namespace {
+constexpr int64_t MS = 1000000;
+constexpr int64_t SECOND = 1000 * MS;
+}
+
+void TestPneumaticPlant::testStartsAtAtmosphere()
+{
+    PneumaticPlant plant;
+    plant.advance(10 * SECOND);
+    QCOMPARE(plant.state().tankVacuumMmHg, 0.0);
+    QCOMPARE(plant.state().avlVacuumMmHg, 0.0);
+    QCOMPARE(plant.state().timeNs, 10 * SECOND);
+}
+
+void TestPneumaticPlant::testPumpEvacuatesTank()
+{
+    PneumaticPlant plant;
+    PneumaticPlant::Inputs inputs;
+    inputs.pumpEnabled = true;
+    inputs.pumpSpeedPercent = 50.0;
+    plant.setInputs(inputs);
+
+    plant.advance(1 * SECOND);
+    const double afterOneSecond = plant.state().tankVacuumMmHg;
+    QVERIFY(afterOneSecond > 10.0);
+
+    // Settles just below the dead-head vacuum for this speed (leak balance)
+    plant.advance(600 * SECOND);
+    const double deadHead = plant.parameters().pumpMaxVacuumMmHg * 0.5;
+    QVERIFY(plant.state().tankVacuumMmHg > afterOneSecond);
+    QVERIFY(plant.state().tankVacuumMmHg < deadHead);
+    QVERIFY(plant.state().tankVacuumMmHg > deadHead * 0.95);
+}
+
+void TestPneumaticPlant::testValvesRouteVacuum()
+{
+    PneumaticPlant plant;
+    plant.setPressures(0.0, 300.0, 0.0);
+
+    PneumaticPlant::Inputs inputs;
+    inputs.sol1 = true;     // Tank -> outer chamber only
+    plant.setInputs(inputs);
+    plant.advance(2 * SECOND);
+
+    const PneumaticPlant::State& s = plant.state();
+    QVERIFY(s.avlVacuumMmHg > 100.0);
+    QVERIFY(s.tankVacuumMmHg < 300.0);
+    QCOMPARE(s.clitoralVacuumMmHg, 0.0);
+
+    // Chambers equalize toward a common vacuum weighted by volume
+    QVERIFY(qAbs(s.avlVacuumMmHg - s.tankVacuumMmHg) < 5.0);
+}
+
+void TestPneumaticPlant::testVentReleasesChamber()
+{
+    PneumaticPlant plant;
+    plant.setPressures(0.0, 0.0, 80.0);
+
+    PneumaticPlant::Inputs inputs;
+    inputs.sol5 = true;
+    plant.setInputs(inputs);
+
+    // Clitoral vent time constant is ~13 ms; 100 ms leaves well under 1%
+    plant.advance(100 * MS);
+    QVERIFY(plant.state().clitoralVacuumMmHg < 0.8);
+}
+
+void TestPneumaticPlant::testAdvanceGranularityIsDeterministic()
+{
+    PneumaticPlant coarse;
+    PneumaticPlant fine;
+
+    PneumaticPlant::Inputs inputs;
+    inputs.pumpEnabled = true;
+    inputs.pumpSpeedPercent = 80.0;
+    inputs.sol4 = true;
+    coarse.setInputs(inputs);
+    fine.setInputs(inputs);
+
+    coarse.advance(3 * SECOND);
+    for (int i = 0; i < 3000; ++i) {
+        fine.advance(MS);       // Not a multiple of the sub-step boundary pattern
+    }
+
+    QCOMPARE(fine.stepCount(), coarse.stepCount());
+    QCOMPARE(fine.state().tankVacuumMmHg, coarse.state().tankVacuumMmHg);
+    QCOMPARE(fine.state().clitoralVacuumMmHg, coarse.state().clitoralVacuumMmHg);
+}
+
+void TestPneumaticPlant::testManualClock()
+{
+    VirtualClock clock;
+    clock.setManual(true);
+    const int64_t start = clock.nowNs();
+
+    QTest::qWait(5);
+    QCOMPARE(clock.nowNs(), start);
+
+    clock.advanceNs(250 * MS);
+    QCOMPARE(clock.nowNs(), start + 250 * MS);
+
+    // Switching back to real time continues from the manual time, no jump back
+    clock.setManual(false);
+    clock.setTimeScale(1000.0);
+    QTest::qWait(5);
+    QVERIFY(clock.nowNs() >= start + 250 * MS + 4 * SECOND);
+}
+
+QTEST_MAIN(TestPneumaticPlant)
+#include "test_PneumaticPlant.moc"
@@ -0,0 +1,97 @@
+#include <QTest>
+
+#include "../../src/hardware/TENSWaveform.h"
+
+using namespace TENSWaveform;
+
+/**
+ * @brief Tests for the TENS waveform compiler
+ *
+ * Covers the edge layout of a continuous biphasic frame, pulse width
+ * clamping to the pulse period, and how many pulses a burst frame holds.
+ */
+class TestTENSWaveform : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testContinuousFrame();
+    void testPulseWidthClamped();
+    void testBurstFrame();
+    void testBurstLimitedByFrame();
+};
+
+void TestTENSWaveform::testContinuousFrame()
+{
+    Spec spec;
+    spec.frequencyHz = 20.0;
+    spec.pulseWidthUs = 400;
+    const Program program = compile(spec);
+
+    QCOMPARE(program.frameNs, int64_t(50000000));
+    QCOMPARE(program.pulsePeriodNs, program.frameNs);
+    QCOMPARE(program.phaseNs, int64_t(400000));
+    QCOMPARE(program.pulsesPerFrame, 1);
+    QVERIFY(!program.pulseWidthClamped);
+
+    QCOMPARE(program.edges.size(), size_t(3));
+    QCOMPARE(program.edges[0].offsetNs, int64_t(0));
+    QVERIFY(program.edges[0].level == Level::POSITIVE);
+    QVERIFY(program.edges[0].pulseStart);
+    QCOMPARE(program.edges[1].offsetNs, int64_t(400000));
+    QVERIFY(program.edges[1].level == Level::NEGATIVE);
+    QCOMPARE(program.edges[2].offsetNs, int64_t(800000));
+    QVERIFY(program.edges[2].level == Level::OFF);
+    QVERIFY(program.edges[2].pulseEnd);
+}
+
+void TestTENSWaveform::testPulseWidthClamped()
+{
+    // Two 500 us phases do not fit a 1.5 kHz period
+    Spec spec;
+    spec.frequencyHz = 1500.0;
+    spec.pulseWidthUs = 500;
+    const Program program = compile(spec);
+
+    QVERIFY(program.pulseWidthClamped);
+    QCOMPARE(program.phaseNs, program.pulsePeriodNs / 2);
+    QVERIFY(program.edges.back().offsetNs <= program.frameNs);
+}
+
+void TestTENSWaveform::testBurstFrame()
+{
+    Spec spec;
+    spec.shape = Shape::BURST;
+    spec.frequencyHz = 100.0;
+    spec.pulseWidthUs = 200;
+    spec.pulsesPerBurst = 5;
+    spec.burstFrequencyHz = 2;
+    const Program program = compile(spec);
+
+    QCOMPARE(program.frameNs, int64_t(500000000));
+    QCOMPARE(program.pulsesPerFrame, 5);
+    QCOMPARE(program.edges.size(), size_t(15));
+    for (int pulse = 0; pulse < 5; ++pulse) {
+        const Edge& start = program.edges[pulse * 3];
+        QVERIFY(start.pulseStart);
+        QCOMPARE(start.offsetNs, pulse * program.pulsePeriodNs);
+        QVERIFY(program.edges[pulse * 3 + 2].pulseEnd);
+    }
+}
+
+void TestTENSWaveform::testBurstLimitedByFrame()
+{
+    // 10 Hz pulses in a 5 Hz burst frame: only two fit
+    Spec spec;
+    spec.shape = Shape::BURST;
+    spec.frequencyHz = 10.0;
+    spec.pulsesPerBurst = 8;
+    spec.burstFrequencyHz = 5;
+    const Program program = compile(spec);
+
+    QCOMPARE(program.pulsesPerFrame, 2);
+    QVERIFY(program.edges.back().offsetNs < program.frameNs);
+}
+
+QTEST_MAIN(TestTENSWaveform)
+#include "test_TENSWaveform.moc"
@@ -0,0 +1,147 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <cmath>
+
+#include "../../src/logging/BinarySensorLog.h"
+
+/**
+ * @brief Tests for the binary sensor log format
+ *
+ * Round-trips samples through the writer and reader, across block
+ * boundaries and timestamp gaps, checks that a file cut short without
+ * its index still yields every intact block, and that a time-range read
+ * returns exactly the samples in range.
+ */
+class TestBinarySensorLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTripAcrossBlocks();
+    void testRecoversUnclosedFile();
+    void testReadRange();
+};
+
+namespace {
+BinarySensorLog::Sample makeSample(int i, int64_t timestampUs)
+{
+    BinarySensorLog::Sample sample;
+    sample.timestampUs = timestampUs;
+    sample.values[BinarySensorLog::AVL] = 40.0f + i * 0.25f;
+    sample.values[BinarySensorLog::TANK] = 120.0f - i;
+    sample.values[BinarySensorLog::CLITORAL] = std::nanf("");
+    sample.values[BinarySensorLog::HEART_RATE] = 72.0f;
+    sample.values[BinarySensorLog::FLUID] = i * 0.01f;
+    sample.flags = BinarySensorLog::AVL_VALID | BinarySensorLog::TANK_VALID
+                 | (i % 2 ? BinarySensorLog::PUMP_ON : 0);
+    return sample;
+}
+
+void compareSamples(const BinarySensorLog::Sample& actual, const BinarySensorLog::Sample& expected)
+{
+    QCOMPARE(actual.timestampUs, expected.timestampUs);
+    QCOMPARE(actual.flags, expected.flags);
+    for (int channel = 0; channel < BinarySensorLog::CHANNEL_COUNT; ++channel) {
+        if (std::isnan(expected.values[channel])) {
+            QVERIFY(std::isnan(actual.values[channel]));
+        } else {
+            QCOMPARE(actual.values[channel], expected.values[channel]);
+        }
+    }
+}
+}
+
+void TestBinarySensorLog::testRoundTripAcrossBlocks()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("pressure.vcsl");
+
+    QVector<BinarySensorLog::Sample> written;
+    int64_t timestampUs = 1700000000000000;
+    BinarySensorLog log;
+    QVERIFY(log.open(path, 16));
+    for (int i = 0; i < 100; ++i) {
+        // 2 ms apart, with one gap too long for a 32-bit delta
+        timestampUs += (i == 40) ? int64_t(2) * 3600 * 1000000 : 2000;
+        written.append(makeSample(i, timestampUs));
+        QVERIFY(log.append(written.last()));
+    }
+    QVERIFY(log.flush());
+    QCOMPARE(log.pendingCount(), 0);
+    log.close();
+
+    // 0-39 fill two blocks and flush the rest of the third at the gap; 40-99
+    // fill three more and the final flush writes the remaining 12
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVector<BinarySensorLog::BlockInfo> blocks;
+    QVERIFY(BinarySensorLog::readIndex(file, blocks));
+    QCOMPARE(blocks.size(), 7);
+    QCOMPARE(blocks[2].count, uint32_t(8));
+    QCOMPARE(blocks[3].firstUs, written[40].timestampUs);
+    QCOMPARE(blocks.last().lastUs, written.last().timestampUs);
+
+    QVector<BinarySensorLog::Sample> read;
+    QVERIFY(BinarySensorLog::readAll(path, read));
+    QCOMPARE(read.size(), written.size());
+    for (int i = 0; i < read.size(); ++i) {
+        compareSamples(read[i], written[i]);
+    }
+}
+
+void TestBinarySensorLog::testRecoversUnclosedFile()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("crashed.vcsl");
+
+    QVector<BinarySensorLog::Sample> written;
+    {
+        BinarySensorLog log;
+        QVERIFY(log.open(path, 10));
+        for (int i = 0; i < 30; ++i) {
+            written.append(makeSample(i, 1000000 + i * 20000));
+            QVERIFY(log.append(written.last()));
+        }
+        log.close();
+    }
+
+    // Drop the index and tear the last block, as a power cut would
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const qint64 blockBytes = BinarySensorLog::BLOCK_HEADER_BYTES + 10 * BinarySensorLog::RECORD_BYTES;
+    QVERIFY(file.resize(BinarySensorLog::FILE_HEADER_BYTES + 2 * blockBytes + blockBytes / 2));
+    file.close();
+
+    QVector<BinarySensorLog::Sample> read;
+    QVERIFY(BinarySensorLog::readAll(path, read));
+    QCOMPARE(read.size(), 20);
+    for (int i = 0; i < read.size(); ++i) {
+        compareSamples(read[i], written[i]);
+    }
+}
+
+void TestBinarySensorLog::testReadRange()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("range.vcsl");
+
+    BinarySensorLog log;
+    QVERIFY(log.open(path, 16));
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(log.append(makeSample(i, 1000000 + int64_t(i) * 1000)));
+    }
+    QVERIFY(log.flush());
+
+    // Still open (no footer), then closed (footer index)
+    for (int pass = 0; pass < 2; ++pass) {
+        QVector<BinarySensorLog::Sample> read;
+        QVERIFY(BinarySensorLog::readRange(path, 1500000, 1600000, read));
+        QCOMPARE(read.size(), 101);
+        QCOMPARE(read.first().timestampUs, int64_t(1500000));
+        QCOMPARE(read.last().timestampUs, int64_t(1600000));
+        log.close();
+    }
+}
+
+QTEST_MAIN(TestBinarySensorLog)
+#include "test_BinarySensorLog.moc"
@@ -0,0 +1,107 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <zlib.h>
+
+#include "../../src/logging/LogCompressor.h"
+
+/**
+ * @brief Tests for in-process log segment compression
+ *
+ * Checks that a compressed segment inflates back to the original bytes,
+ * and that resuming a directory compresses closed segments, leaves open
+ * ones alone and records both in the manifest, even when a segment was
+ * tracked into a new manifest before the first resume.
+ */
+class TestLogCompressor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testResumeSkipsOpenSegments();
+};
+
+namespace {
+QByteArray makeLog(int lines)
+{
+    QByteArray data;
+    for (int i = 0; i < lines; ++i) {
+        data += QString("2024-01-01 00:00:%1.000,SensorInterface,pressure_reading,\"{\"\"avl_pressure\"\":%2}\"\n")
+                    .arg(i % 60, 2, 10, QChar('0')).arg(40.0 + i * 0.01).toUtf8();
+    }
+    return data;
+}
+
+bool writeFile(const QString& path, const QByteArray& data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray inflateFile(const QString& path)
+{
+    QByteArray data;
+    gzFile file = gzopen(QFile::encodeName(path).constData(), "rb");
+    if (!file) return data;
+    char buffer[8192];
+    int read;
+    while ((read = gzread(file, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, read);
+    }
+    gzclose(file);
+    return data;
+}
+}
+
+void TestLogCompressor::testRoundTrip()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("pressure_data_20240101_000000.csv");
+    const QByteArray original = makeLog(20000);     // Several CHUNK_BYTES
+    QVERIFY(writeFile(path, original));
+
+    qint64 bytesIn = 0;
+    qint64 bytesOut = 0;
+    QString error;
+    QVERIFY(LogCompressor::compressFile(path, path + ".gz", LogCompressor::DEFAULT_LEVEL,
+                                        bytesIn, bytesOut, error));
+    QCOMPARE(bytesIn, qint64(original.size()));
+    QVERIFY(bytesOut < bytesIn / 4);
+    QCOMPARE(inflateFile(path + ".gz"), original);
+}
+
+void TestLogCompressor::testResumeSkipsOpenSegments()
+{
+    QTemporaryDir dir;
+    const QString closedPath = dir.filePath("safety_events_20240101_000000.csv");
+    const QString openPath = dir.filePath("safety_events_20240101_010000.csv");
+    const QByteArray closedData = makeLog(500);
+    QVERIFY(writeFile(closedPath, closedData));
+    QVERIFY(writeFile(openPath, makeLog(10)));
+
+    LogCompressor compressor;
+    QSignalSpy compressed(&compressor, &LogCompressor::fileCompressed);
+    compressor.start(QThread::IdlePriority);
+    // As DataLogger does: the open segment is tracked (creating the
+    // manifest) before the first resume, which must still scan
+    compressor.trackSegment(openPath);
+    compressor.resume(dir.path(), QStringList() << openPath);
+
+    QVERIFY(compressed.wait(5000));
+    QCOMPARE(compressed.first().at(0).toString(), closedPath);
+    QVERIFY(!QFile::exists(closedPath));
+    QCOMPARE(inflateFile(closedPath + ".gz"), closedData);
+    QVERIFY(QFile::exists(openPath));
+    compressor.stopCompressor();
+
+    QFile manifest(dir.filePath(LogCompressor::MANIFEST_NAME));
+    QVERIFY(manifest.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString contents = QString::fromUtf8(manifest.readAll());
+    QVERIFY(contents.startsWith(QString(LogCompressor::MANIFEST_SCANNED) + '\n'));
+    QVERIFY(contents.contains("open\tsafety_events_20240101_010000.csv"));
+    QVERIFY(contents.contains("done\tsafety_events_20240101_000000.csv"));
+}
+
+QTEST_MAIN(TestLogCompressor)
+#include "test_LogCompressor.moc"
@@ -0,0 +1,98 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "../../src/logging/LogSegmentIndex.h"
+
+/**
+ * @brief Tests for the sparse time index of text log segments
+ *
+ * Writes a segment the way the writer thread does (buffer lines, note
+ * their timestamps, commit) and checks that a time-range lookup returns
+ * only the chunks overlapping the range, plus the unindexed tail.
+ */
+class TestLogSegmentIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSelectsOverlappingChunks();
+    void testAppendAfterCrashKeepsTail();
+};
+
+namespace {
+// One line per ms from startMs; a commit after every `perCommit` lines
+void writeSegment(QFile& segment, LogSegmentIndex& index, int64_t startMs, int lines, int perCommit)
+{
+    const QByteArray line(199, 'x');
+    for (int i = 0; i < lines; ++i) {
+        segment.write(line + '\n');
+        index.noteEntry(startMs + i);
+        if ((i + 1) % perCommit == 0) {
+            segment.flush();
+            index.noteCommitted(segment.size());
+        }
+    }
+    segment.flush();
+}
+}
+
+void TestLogSegmentIndex::testSelectsOverlappingChunks()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("pressure_data_20240101_000000.csv");
+
+    // 2000 lines of 200 bytes in commits of 100 lines: a chunk closes at
+    // every 400th line (80000 bytes >= 64 KB)
+    QFile segment(path);
+    QVERIFY(segment.open(QIODevice::WriteOnly));
+    LogSegmentIndex index;
+    QVERIFY(index.open(path, 0));
+    writeSegment(segment, index, 10000, 2000, 100);
+    index.close(segment.size());
+
+    QVector<LogSegmentIndex::Chunk> chunks;
+    QVERIFY(LogSegmentIndex::load(path, chunks));
+    QCOMPARE(chunks.size(), 5);
+    QCOMPARE(chunks[1].minMs, int64_t(10400));
+    QCOMPARE(chunks[1].maxMs, int64_t(10799));
+    QCOMPARE(chunks[1].offset, int64_t(400 * 200));
+
+    // Lines 900-1300 span chunks 2 and 3, merged into one range
+    QVector<LogSegmentIndex::Chunk> selected = LogSegmentIndex::chunksFor(path, segment.size(), 10900, 11300);
+    QCOMPARE(selected.size(), 1);
+    QCOMPARE(selected[0].offset, int64_t(800 * 200));
+    QCOMPARE(selected[0].endOffset, int64_t(1600 * 200));
+    QVERIFY(selected[0].indexed);
+
+    QVERIFY(LogSegmentIndex::chunksFor(path, segment.size(), 50000, 60000).isEmpty());
+}
+
+void TestLogSegmentIndex::testAppendAfterCrashKeepsTail()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("safety_events_20240101_000000.csv");
+
+    QFile segment(path);
+    QVERIFY(segment.open(QIODevice::WriteOnly));
+    {
+        // Never closed: the last 100 lines are past the indexed chunk
+        LogSegmentIndex index;
+        QVERIFY(index.open(path, 0));
+        writeSegment(segment, index, 0, 500, 100);
+    }
+    const qint64 crashedSize = segment.size();
+
+    // Reopened for append, the lost lines become a chunk of unknown range
+    LogSegmentIndex index;
+    QVERIFY(index.open(path, crashedSize));
+    writeSegment(segment, index, 100000, 50, 50);
+
+    QVector<LogSegmentIndex::Chunk> selected = LogSegmentIndex::chunksFor(path, segment.size(), 450, 460);
+    QCOMPARE(selected.size(), 1);
+    QCOMPARE(selected[0].offset, int64_t(400 * 200));
+    QCOMPARE(selected[0].endOffset, segment.size());
+    QVERIFY(!selected[0].indexed);
+}
+
+QTEST_MAIN(TestLogSegmentIndex)
+#include "test_LogSegmentIndex.moc"
@@ -0,0 +1,224 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "../../src/logging/LogWriterThread.h"
+
+/**
+ * @brief Tests for the group-commit log writer thread
+ *
+ * Checks that stopWriter() writes out a backlog far larger than one
+ * commit before closing the files, for both text entries and binary
+ * sensor samples; that full queues drop and count; that commits are
+ * triggered by size and by interval; and that open/close commands take
+ * effect only after the data queued before them.
+ */
+class TestLogWriterThread : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testStopDrainsBacklog();
+    void testQueueFullDropsAreCounted();
+    void testSizeTriggersCommit();
+    void testIntervalTriggersCommit();
+    void testCommandsFollowQueuedData();
+};
+
+namespace {
+LogWriterThread::Config quietConfig(int commitIntervalMs, int commitBytes)
+{
+    LogWriterThread::Config config;
+    config.commitIntervalMs = commitIntervalMs;
+    config.commitBytes = commitBytes;
+    config.syncPolicy = LogWriterThread::SyncPolicy::NONE;
+    return config;
+}
+
+DataLogger::LogEntry safetyEvent(const QString& event)
+{
+    return DataLogger::LogEntry(DataLogger::SAFETY_EVENTS, "SafetyManager", event);
+}
+
+QByteArray readFile(const QString& filePath)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+}
+
+void TestLogWriterThread::testStopDrainsBacklog()
+{
+    QTemporaryDir dir;
+    const QString sensorPath = dir.filePath("pressure_data.vcsl");
+    const QString eventPath = dir.filePath("safety_events.csv");
+
+    LogWriterThread writer;
+    LogWriterThread::Config config;
+    config.commitIntervalMs = 60000;    // Only size and stop trigger commits
+    config.commitBytes = 4096;
+    config.syncPolicy = LogWriterThread::SyncPolicy::NONE;
+    writer.setConfig(config);
+    writer.start();
+
+    writer.openFile(DataLogger::PRESSURE_DATA, sensorPath, DataLogger::BINARY_FORMAT);
+    writer.openFile(DataLogger::SAFETY_EVENTS, eventPath, DataLogger::CSV_FORMAT);
+    QVERIFY(writer.waitForCommit());
+
+    const int sampleCount = 10000;      // Many times commitBytes
+    for (int i = 0; i < sampleCount; ++i) {
+        BinarySensorLog::Sample sample;
+        sample.timestampUs = 1000000 + i * 10000;
+        sample.values[BinarySensorLog::AVL] = 40.0f;
+        QVERIFY(writer.submitSample(sample));
+    }
+    const int entryCount = 2000;
+    for (int i = 0; i < entryCount; ++i) {
+        QVERIFY(writer.submitEntry(DataLogger::LogEntry(DataLogger::SAFETY_EVENTS, "SafetyManager",
+                                                        QString("event_%1").arg(i))));
+    }
+    writer.stopWriter();
+
+    const LogWriterThread::Statistics stats = writer.statistics();
+    QCOMPARE(stats.samplesWritten, quint64(sampleCount));
+    QCOMPARE(stats.entriesWritten, quint64(entryCount));
+    QCOMPARE(stats.unrouted, quint64(0));
+
+    QVector<BinarySensorLog::Sample> samples;
+    QVERIFY(BinarySensorLog::readAll(sensorPath, samples));
+    QCOMPARE(samples.size(), sampleCount);
+    QCOMPARE(samples.last().timestampUs, int64_t(1000000) + (sampleCount - 1) * 10000);
+
+    QFile events(eventPath);
+    QVERIFY(events.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QList<QByteArray> lines = events.readAll().split('\n');
+    QCOMPARE(lines.size(), entryCount + 2);     // Header, entries, trailing newline
+    QVERIFY(lines.at(entryCount).contains("event_1999"));
+}
+
+void TestLogWriterThread::testQueueFullDropsAreCounted()
+{
+    // Not started, so nothing drains the queues
+    LogWriterThread writer;
+
+    for (int i = 0; i < LogWriterThread::ENTRY_QUEUE_CAPACITY; ++i) {
+        QVERIFY(writer.submitEntry(safetyEvent("queued")));
+    }
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(!writer.submitEntry(safetyEvent("dropped")));
+    }
+
+    BinarySensorLog::Sample sample;
+    for (int i = 0; i < LogWriterThread::SAMPLE_QUEUE_CAPACITY; ++i) {
+        QVERIFY(writer.submitSample(sample));
+    }
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(!writer.submitSample(sample));
+    }
+
+    const LogWriterThread::Statistics stats = writer.statistics();
+    QCOMPARE(stats.entriesDropped, quint64(3));
+    QCOMPARE(stats.samplesDropped, quint64(5));
+    QCOMPARE(writer.queuedCount(), LogWriterThread::ENTRY_QUEUE_CAPACITY + LogWriterThread::SAMPLE_QUEUE_CAPACITY);
+}
+
+void TestLogWriterThread::testSizeTriggersCommit()
+{
+    QTemporaryDir dir;
+    LogWriterThread writer;
+    writer.setConfig(quietConfig(60000, 1024));     // Only size can trigger
+    writer.start();
+    writer.openFile(DataLogger::PRESSURE_DATA, dir.filePath("pressure_data.vcsl"), DataLogger::BINARY_FORMAT);
+    QVERIFY(writer.waitForCommit());
+    const quint64 commits = writer.statistics().commits;
+
+    // Below the threshold: buffered, not committed
+    BinarySensorLog::Sample sample;
+    QVERIFY(writer.submitSample(sample));
+    QTest::qWait(10 * LogWriterThread::POLL_INTERVAL_MS);
+    QCOMPARE(writer.statistics().samplesWritten, quint64(1));
+    QCOMPARE(writer.statistics().commits, commits);
+
+    // Crossing it commits without being asked
+    const int sampleCount = 1024 / BinarySensorLog::RECORD_BYTES + 1;
+    for (int i = 0; i < sampleCount; ++i) {
+        QVERIFY(writer.submitSample(sample));
+    }
+    QTRY_VERIFY(writer.statistics().commits > commits);
+    QTRY_COMPARE(writer.statistics().samplesWritten, quint64(sampleCount + 1));
+    writer.stopWriter();
+}
+
+void TestLogWriterThread::testIntervalTriggersCommit()
+{
+    QTemporaryDir dir;
+    const QString eventPath = dir.filePath("safety_events.csv");
+
+    LogWriterThread writer;
+    writer.setConfig(quietConfig(60000, 1024 * 1024));
+    writer.start();
+    writer.openFile(DataLogger::SAFETY_EVENTS, eventPath, DataLogger::CSV_FORMAT);
+    QVERIFY(writer.waitForCommit());
+    const quint64 commits = writer.statistics().commits;
+
+    QVERIFY(writer.submitEntry(safetyEvent("interval_event")));
+    QTest::qWait(10 * LogWriterThread::POLL_INTERVAL_MS);
+    QCOMPARE(writer.statistics().entriesWritten, quint64(1));
+    QCOMPARE(writer.statistics().commits, commits);
+    QVERIFY(!readFile(eventPath).contains("interval_event"));
+
+    // A short interval commits the buffered entry on its own
+    writer.setConfig(quietConfig(50, 1024 * 1024));
+    QTRY_VERIFY(writer.statistics().commits > commits);
+    QVERIFY(readFile(eventPath).contains("interval_event"));
+    writer.stopWriter();
+}
+
+void TestLogWriterThread::testCommandsFollowQueuedData()
+{
+    QTemporaryDir dir;
+    const QString firstPath = dir.filePath("safety_events_1.csv");
+    const QString secondPath = dir.filePath("safety_events_2.csv");
+
+    // Queued before the writer runs: the entry precedes the open command,
+    // so no file is open for it yet
+    LogWriterThread writer;
+    writer.setConfig(quietConfig(60000, 1024 * 1024));
+    QVERIFY(writer.submitEntry(safetyEvent("before_open")));
+    writer.openFile(DataLogger::SAFETY_EVENTS, firstPath, DataLogger::CSV_FORMAT);
+    writer.start();
+    QVERIFY(writer.waitForCommit());
+    QCOMPARE(writer.statistics().unrouted, quint64(1));
+
+    // Rotation: entries queued before the new open land in the old file
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(writer.submitEntry(safetyEvent(QString("first_%1").arg(i))));
+    }
+    writer.openFile(DataLogger::SAFETY_EVENTS, secondPath, DataLogger::CSV_FORMAT);
+    QVERIFY(writer.waitForCommit());
+    const QByteArray first = readFile(firstPath);
+    QVERIFY(!first.contains("before_open"));
+    QVERIFY(first.contains("first_0") && first.contains("first_9"));
+    QVERIFY(!readFile(secondPath).contains("first_"));
+
+    // Entries queued before a close are written before the file is closed
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(writer.submitEntry(safetyEvent(QString("second_%1").arg(i))));
+    }
+    writer.closeFile(DataLogger::SAFETY_EVENTS);
+    QVERIFY(writer.waitForCommit());
+    const QByteArray second = readFile(secondPath);
+    QVERIFY(second.contains("second_0") && second.contains("second_4"));
+    QCOMPARE(writer.fileSize(DataLogger::SAFETY_EVENTS), qint64(0));
+
+    QVERIFY(writer.submitEntry(safetyEvent("after_close")));
+    QVERIFY(writer.waitForCommit());
+
+    const LogWriterThread::Statistics stats = writer.statistics();
+    QCOMPARE(stats.entriesWritten, quint64(15));
+    QCOMPARE(stats.unrouted, quint64(2));
+    QVERIFY(!readFile(secondPath).contains("after_close"));
+    writer.stopWriter();
+}
+
+QTEST_MAIN(TestLogWriterThread)
+#include "test_LogWriterThread.moc"
@@ -0,0 +1,192 @@
+#include <QTest>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVector>
+
+#include "../../src/logging/SessionRecording.h"
+
+using namespace SessionRecording;
+
+/**
+ * @brief Tests for memory-mapped session recordings
+ *
+ * Checks that records read back in place with their virtual timestamps,
+ * that a reader tailing a live recording follows it across file growth,
+ * that unchanged actuator states are recorded only once, and that
+ * producers on several threads all reach the file.
+ */
+class TestSessionRecording : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testTailAcrossGrowth();
+    void testActuatorDeduplication();
+    void testConcurrentProducers();
+};
+
+namespace {
+SensorRecord makeSensor(int i)
+{
+    SensorRecord record;
+    record.timestampMs = 1000 + i;
+    record.avlPressure = 40.0 + i * 0.01;
+    record.tankPressure = 50.0;
+    record.clitoralPressure = 20.0;
+    return record;
+}
+}
+
+void TestSessionRecording::testRoundTrip()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath(SessionRecorder::defaultFileName());
+
+    int64_t virtualNs = 5000000;
+    SessionRecorder recorder;
+    recorder.setClock([&virtualNs]() { return virtualNs; });
+    QVERIFY(recorder.open(path));
+
+    for (int i = 0; i < 100; ++i) {
+        virtualNs += 20000000;
+        QVERIFY(recorder.append(makeSensor(i)));
+    }
+    TransitionRecord transition;
+    transition.kind = TransitionRecord::CONTROL_STATE;
+    transition.from = 1;
+    transition.to = 2;
+    QVERIFY(recorder.append(transition));
+    QVERIFY(recorder.flush());
+    const qint64 committed = recorder.committedBytes();
+    recorder.close();
+    QVERIFY(!recorder.append(transition));
+    QCOMPARE(QFileInfo(path).size(), committed);
+
+    SessionRecordingReader reader;
+    QVERIFY(reader.open(path));
+    QVERIFY(reader.isComplete());
+    QCOMPARE(reader.recordCount(), quint64(101));
+    QCOMPARE(reader.startMonotonicNs(), int64_t(5000000));
+
+    int sensors = 0;
+    SessionRecordingReader::Record record = reader.first();
+    for (; record.isValid(); record = reader.next(record)) {
+        if (const SensorRecord* sensor = record.as<SensorRecord>()) {
+            QCOMPARE(sensor->timestampMs, int64_t(1000 + sensors));
+            QCOMPARE(record.monotonicNs(), int64_t(5000000) + (sensors + 1) * int64_t(20000000));
+            ++sensors;
+        } else {
+            const TransitionRecord* read = record.as<TransitionRecord>();
+            QVERIFY(read);
+            QCOMPARE(read->to, 2);
+        }
+    }
+    QCOMPARE(sensors, 100);
+}
+
+void TestSessionRecording::testTailAcrossGrowth()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("tail.vcsr");
+
+    SessionRecorder recorder;
+    QVERIFY(recorder.open(path, 4096));
+    QVERIFY(recorder.append(makeSensor(0)));
+    QVERIFY(recorder.flush());
+
+    SessionRecordingReader reader;
+    QVERIFY(reader.open(path));
+    QVERIFY(!reader.isComplete());
+    QCOMPARE(reader.recordCount(), quint64(1));
+
+    // Several doublings of the initial page
+    for (int i = 1; i < 1000; ++i) {
+        QVERIFY(recorder.append(makeSensor(i)));
+    }
+    QVERIFY(recorder.flush());
+    QVERIFY(reader.refresh());
+    QCOMPARE(reader.recordCount(), quint64(1000));
+
+    int count = 0;
+    for (SessionRecordingReader::Record record = reader.first(); record.isValid(); record = reader.next(record)) {
+        QCOMPARE(record.as<SensorRecord>()->timestampMs, int64_t(1000 + count));
+        ++count;
+    }
+    QCOMPARE(count, 1000);
+
+    recorder.close();
+    QVERIFY(reader.refresh());
+    QVERIFY(reader.isComplete());
+}
+
+void TestSessionRecording::testActuatorDeduplication()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("actuators.vcsr");
+
+    SessionRecorder recorder;
+    QVERIFY(recorder.open(path));
+
+    ActuatorRecord actuators;
+    actuators.outputs = ActuatorRecord::SOL1 | ActuatorRecord::PUMP_ON;
+    actuators.pumpSpeedPercent = 60.0;
+    QVERIFY(recorder.append(actuators));
+    QVERIFY(recorder.append(actuators));      // Unchanged: dropped by the writer
+    actuators.outputs |= ActuatorRecord::SOL2;
+    QVERIFY(recorder.append(actuators));
+    QVERIFY(recorder.flush());
+    QCOMPARE(recorder.recordCount(), quint64(2));
+    recorder.close();
+
+    SessionRecordingReader reader;
+    QVERIFY(reader.open(path));
+    const SessionRecordingReader::Record last = reader.next(reader.first());
+    QVERIFY(last.as<ActuatorRecord>()->has(ActuatorRecord::SOL2));
+    QVERIFY(!reader.next(last).isValid());
+}
+
+void TestSessionRecording::testConcurrentProducers()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("concurrent.vcsr");
+
+    SessionRecorder recorder;
+    QVERIFY(recorder.open(path, 4096));
+
+    const int producers = 4;
+    const int perProducer = 500;
+    QVector<QThread*> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.append(QThread::create([&recorder, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                recorder.append(makeSensor(p * perProducer + i));
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread* thread : threads) {
+        QVERIFY(thread->wait(5000));
+        delete thread;
+    }
+    recorder.close();
+
+    // Every record either reached the file or was counted as dropped
+    QCOMPARE(recorder.recordCount() + recorder.droppedCount(), quint64(producers * perProducer));
+
+    SessionRecordingReader reader;
+    QVERIFY(reader.open(path));
+    QVector<bool> seen(producers * perProducer, false);
+    uint32_t sequence = 0;
+    for (SessionRecordingReader::Record record = reader.first(); record.isValid(); record = reader.next(record)) {
+        QCOMPARE(record.header->sequence, sequence++);
+        const int index = static_cast<int>(record.as<SensorRecord>()->timestampMs - 1000);
+        QVERIFY(!seen[index]);
+        seen[index] = true;
+    }
+    QCOMPARE(quint64(sequence), recorder.recordCount());
+}
+
+QTEST_MAIN(TestSessionRecording)
+#include "test_SessionRecording.moc"
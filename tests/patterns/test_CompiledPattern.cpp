@@ -0,0 +1,258 @@
+#include <QTest>
+#include <cmath>
+
+#include "../../src/patterns/CompiledPattern.h"
+
+/**
+ * @brief Tests for the compiled keyframe form of a pattern
+ *
+ * Covers the pressure curves evaluated by the setpoint generator: every
+ * curve meets its keyframes at both ends, t is clamped to the step, and
+ * each curve has the shape its name promises in between. Also covers
+ * compiling steps (change flags derived from the previous step, action
+ * names interned once, total duration) and the action and seal profile
+ * lookups.
+ */
+class TestCompiledPattern : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCurvesMeetKeyframes();
+    void testHoldKeepsStartValue();
+    void testCurveShapes();
+    void testInterpolateClampsT();
+    void testPressureAtUsesStepCurve();
+    void testFirstStepCarriesEveryFlag();
+    void testFlagsTrackChanges();
+    void testOscillatorTolerance();
+    void testActionNamesInterned();
+    void testActionLookup();
+    void testSealProfiles();
+};
+
+namespace {
+CompiledPattern::Step makeStep(double pressure, int durationMs)
+{
+    CompiledPattern::Step step{};
+    step.pressurePercent = pressure;
+    step.endPressurePercent = pressure;
+    step.durationMs = durationMs;
+    step.curve = CompiledPattern::Curve::HOLD;
+    return step;
+}
+
+CompiledPattern::Step oscillating(CompiledPattern::Step step, float frequencyHz, float amplitudeMmHg)
+{
+    step.flags |= CompiledPattern::OSCILLATE;
+    step.oscFrequencyHz = frequencyHz;
+    step.oscAmplitudeMmHg = amplitudeMmHg;
+    return step;
+}
+
+CompiledPattern::Step withTens(CompiledPattern::Step step, float frequencyHz, float amplitudePercent)
+{
+    step.flags |= CompiledPattern::TENS_ON;
+    step.tensFrequencyHz = frequencyHz;
+    step.tensPulseWidthUs = 200;
+    step.tensAmplitudePercent = amplitudePercent;
+    return step;
+}
+
+const CompiledPattern::Curve MOVING_CURVES[] = {
+    CompiledPattern::Curve::LINEAR,
+    CompiledPattern::Curve::CUBIC,
+    CompiledPattern::Curve::SINE,
+    CompiledPattern::Curve::EASE_IN,
+    CompiledPattern::Curve::EASE_OUT
+};
+}
+
+void TestCompiledPattern::testCurvesMeetKeyframes()
+{
+    for (CompiledPattern::Curve curve : MOVING_CURVES) {
+        QCOMPARE(CompiledPattern::interpolate(curve, 30.0, 70.0, 0.0), 30.0);
+        QCOMPARE(CompiledPattern::interpolate(curve, 30.0, 70.0, 1.0), 70.0);
+        QCOMPARE(CompiledPattern::interpolate(curve, 70.0, 30.0, 1.0), 30.0);
+    }
+}
+
+void TestCompiledPattern::testHoldKeepsStartValue()
+{
+    QCOMPARE(CompiledPattern::interpolate(CompiledPattern::Curve::HOLD, 40.0, 80.0, 0.0), 40.0);
+    QCOMPARE(CompiledPattern::interpolate(CompiledPattern::Curve::HOLD, 40.0, 80.0, 0.5), 40.0);
+    QCOMPARE(CompiledPattern::interpolate(CompiledPattern::Curve::HOLD, 40.0, 80.0, 1.0), 40.0);
+}
+
+void TestCompiledPattern::testCurveShapes()
+{
+    using Curve = CompiledPattern::Curve;
+
+    // Symmetric curves cross the midpoint halfway through the step
+    QCOMPARE(CompiledPattern::interpolate(Curve::LINEAR, 0.0, 100.0, 0.5), 50.0);
+    QCOMPARE(CompiledPattern::interpolate(Curve::CUBIC, 0.0, 100.0, 0.5), 50.0);
+    QCOMPARE(CompiledPattern::interpolate(Curve::SINE, 0.0, 100.0, 0.5), 50.0);
+
+    QCOMPARE(CompiledPattern::interpolate(Curve::LINEAR, 0.0, 100.0, 0.25), 25.0);
+    QCOMPARE(CompiledPattern::interpolate(Curve::CUBIC, 0.0, 100.0, 0.25), 15.625);
+    QCOMPARE(CompiledPattern::interpolate(Curve::EASE_IN, 0.0, 100.0, 0.5), 25.0);
+    QCOMPARE(CompiledPattern::interpolate(Curve::EASE_OUT, 0.0, 100.0, 0.5), 75.0);
+
+    // Half-cosine: at a quarter of the step it has covered (1 - cos 45°) / 2
+    const double expected = 50.0 * (1.0 - std::sqrt(0.5));
+    QVERIFY(qAbs(CompiledPattern::interpolate(Curve::SINE, 0.0, 100.0, 0.25) - expected) < 1e-9);
+
+    // Smooth curves leave and arrive with almost no slope
+    const double dt = 1e-4;
+    QVERIFY(CompiledPattern::interpolate(Curve::SINE, 0.0, 100.0, dt) < 100.0 * dt * 0.01);
+    QVERIFY(CompiledPattern::interpolate(Curve::CUBIC, 0.0, 100.0, 1.0 - dt) > 100.0 * (1.0 - dt * 0.01));
+}
+
+void TestCompiledPattern::testInterpolateClampsT()
+{
+    for (CompiledPattern::Curve curve : MOVING_CURVES) {
+        QCOMPARE(CompiledPattern::interpolate(curve, 30.0, 70.0, -0.5), 30.0);
+        QCOMPARE(CompiledPattern::interpolate(curve, 30.0, 70.0, 1.5), 70.0);
+    }
+}
+
+void TestCompiledPattern::testPressureAtUsesStepCurve()
+{
+    CompiledPattern::Step step{};
+    step.pressurePercent = 20.0;
+    step.endPressurePercent = 60.0;
+    step.durationMs = 1000;
+    step.curve = CompiledPattern::Curve::EASE_IN;
+
+    QCOMPARE(CompiledPattern::pressureAt(step, 0.5), 30.0);
+
+    step.curve = CompiledPattern::Curve::HOLD;
+    QCOMPARE(CompiledPattern::pressureAt(step, 0.5), 20.0);
+}
+
+void TestCompiledPattern::testFirstStepCarriesEveryFlag()
+{
+    CompiledPattern pattern;
+    CompiledPattern::Step first = makeStep(50.0, 1000);
+    first.sealProfile = CompiledPattern::SealProfile::CRITICAL;
+    pattern.append(first, "climax_maintain");
+
+    // Entering the pattern re-establishes every output
+    const CompiledPattern::Step& step = pattern[0];
+    QVERIFY(step.has(CompiledPattern::OSC_RETUNE));
+    QVERIFY(step.has(CompiledPattern::TENS_RECONFIGURE));
+    QVERIFY(step.has(CompiledPattern::PHASE_CHANGED));
+    QVERIFY(step.has(CompiledPattern::SEAL_CHANGED));
+    QVERIFY(!step.has(CompiledPattern::OSCILLATE));
+    QVERIFY(!step.has(CompiledPattern::TENS_ON));
+
+    // Callers cannot smuggle derived flags in
+    CompiledPattern other;
+    CompiledPattern::Step plain = makeStep(50.0, 1000);
+    plain.flags = CompiledPattern::SEAL_CHANGED;
+    other.append(plain, "vacuum");
+    QVERIFY(!other[0].has(CompiledPattern::SEAL_CHANGED));
+}
+
+void TestCompiledPattern::testFlagsTrackChanges()
+{
+    CompiledPattern pattern;
+    pattern.append(withTens(oscillating(makeStep(40.0, 1000), 8.0f, 50.0f), 20.0f, 30.0f), "tens_warmup");
+    pattern.append(withTens(oscillating(makeStep(60.0, 2000), 8.0f, 50.0f), 20.0f, 30.0f), "tens_warmup");
+    pattern.append(withTens(oscillating(makeStep(60.0, 2000), 10.0f, 50.0f), 20.0f, 45.0f), "tens_buildup");
+    pattern.append(makeStep(20.0, 500), "tens_buildup");
+    pattern.append(withTens(makeStep(20.0, 500), 20.0f, 45.0f), "tens_buildup");
+
+    QCOMPARE(pattern.size(), 5);
+    QCOMPARE(pattern.totalDurationMs(), qint64(6000));
+
+    // Same settings, same phase: nothing to reconfigure
+    QVERIFY(pattern[1].has(CompiledPattern::OSCILLATE));
+    QVERIFY(!pattern[1].has(CompiledPattern::OSC_RETUNE));
+    QVERIFY(!pattern[1].has(CompiledPattern::TENS_RECONFIGURE));
+    QVERIFY(!pattern[1].has(CompiledPattern::PHASE_CHANGED));
+
+    QVERIFY(pattern[2].has(CompiledPattern::OSC_RETUNE));
+    QVERIFY(pattern[2].has(CompiledPattern::TENS_RECONFIGURE));
+    QVERIFY(pattern[2].has(CompiledPattern::PHASE_CHANGED));
+
+    // Outputs switched off carry no reconfigure flags
+    QVERIFY(!pattern[3].has(CompiledPattern::OSCILLATE));
+    QVERIFY(!pattern[3].has(CompiledPattern::OSC_RETUNE));
+    QVERIFY(!pattern[3].has(CompiledPattern::TENS_RECONFIGURE));
+
+    // Switching TENS back on reconfigures it even with unchanged settings
+    QVERIFY(pattern[4].has(CompiledPattern::TENS_RECONFIGURE));
+}
+
+void TestCompiledPattern::testOscillatorTolerance()
+{
+    CompiledPattern pattern;
+    pattern.append(oscillating(makeStep(50.0, 1000), 8.0f, 50.0f), "dual_stimulation");
+    pattern.append(oscillating(makeStep(50.0, 1000), 8.05f, 50.5f), "dual_stimulation");
+    pattern.append(oscillating(makeStep(50.0, 1000), 8.05f, 52.0f), "dual_stimulation");
+
+    QVERIFY(!pattern[1].has(CompiledPattern::OSC_RETUNE));
+    QVERIFY(pattern[2].has(CompiledPattern::OSC_RETUNE));
+}
+
+void TestCompiledPattern::testActionNamesInterned()
+{
+    CompiledPattern pattern;
+    pattern.append(makeStep(50.0, 100), "vacuum");
+    pattern.append(makeStep(0.0, 100), "release");
+    pattern.append(makeStep(50.0, 100), "vacuum");
+    pattern.append(makeStep(30.0, 100), "my_custom_action");
+
+    QCOMPARE(pattern[0].nameIndex, pattern[2].nameIndex);
+    QVERIFY(pattern[0].nameIndex != pattern[1].nameIndex);
+    QCOMPARE(pattern.actionName(pattern[2]), QString("vacuum"));
+    QCOMPARE(pattern.actionName(pattern[3]), QString("my_custom_action"));
+
+    pattern.clear();
+    QVERIFY(pattern.isEmpty());
+    QCOMPARE(pattern.totalDurationMs(), qint64(0));
+
+    // After a clear the next step is a first step again
+    pattern.append(makeStep(50.0, 100), "release");
+    QCOMPARE(pattern[0].nameIndex, uint16_t(0));
+    QVERIFY(pattern[0].has(CompiledPattern::PHASE_CHANGED));
+}
+
+void TestCompiledPattern::testActionLookup()
+{
+    QCOMPARE(CompiledPattern::actionFromName("vacuum"), CompiledPattern::Action::VACUUM);
+    QCOMPARE(CompiledPattern::actionFromName("climax_maintain"), CompiledPattern::Action::CLIMAX_MAINTAIN);
+    QCOMPARE(CompiledPattern::actionFromName("tens_afterglow"), CompiledPattern::Action::TENS_AFTERGLOW);
+    QCOMPARE(CompiledPattern::actionFromName("Vacuum"), CompiledPattern::Action::CUSTOM);
+    QCOMPARE(CompiledPattern::actionFromName(QString()), CompiledPattern::Action::CUSTOM);
+}
+
+void TestCompiledPattern::testSealProfiles()
+{
+    using Action = CompiledPattern::Action;
+    using SealProfile = CompiledPattern::SealProfile;
+
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::CLIMAX_MAINTAIN), SealProfile::CRITICAL);
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::CONTINUOUS_AROUSAL_INTENSIFY), SealProfile::CRITICAL);
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::POST_CLIMAX_RECOVERY), SealProfile::RECOVERY);
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::CONTINUOUS_BRIEF_RECOVERY), SealProfile::RECOVERY);
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::VACUUM), SealProfile::UNCHANGED);
+    QCOMPARE(CompiledPattern::sealProfileFor(Action::CUSTOM), SealProfile::UNCHANGED);
+
+    // A profile only counts as a change when it differs from the last step's
+    CompiledPattern pattern;
+    CompiledPattern::Step critical = makeStep(70.0, 1000);
+    critical.sealProfile = SealProfile::CRITICAL;
+    pattern.append(critical, "arousal_intensify");
+    pattern.append(critical, "climax_maintain");
+    CompiledPattern::Step recovery = makeStep(30.0, 1000);
+    recovery.sealProfile = SealProfile::RECOVERY;
+    pattern.append(recovery, "post_climax_recovery");
+
+    QVERIFY(!pattern[1].has(CompiledPattern::SEAL_CHANGED));
+    QVERIFY(pattern[2].has(CompiledPattern::SEAL_CHANGED));
+}
+
+QTEST_APPLESS_MAIN(TestCompiledPattern)
+#include "test_CompiledPattern.moc"
@@ -0,0 +1,172 @@
+#include <QTest>
+#include <QSignalSpy>
+
+#include "../../src/patterns/PatternEngine.h"
+#include "../../src/hardware/HardwareManager.h"
+
+/**
+ * @brief Step timeline tests for PatternEngine on a virtual clock
+ *
+ * Checks that step boundaries stay on the absolute timeline however late
+ * each one is entered, that a stall re-anchors the timeline but still
+ * counts toward the cycle drift, and that cycles report their measured
+ * length with pauses left out. Also checks that sine keyframes trace the
+ * waveform on that timeline and close the phase on the midline.
+ */
+class TestPatternEngineTiming : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testStepsFollowTimeline();
+    void testStallCountsTowardCycleDrift();
+    void testCycleReportsMeasuredLength();
+    void testSinePhaseEndsOnMidline();
+
+private:
+    void advanceMs(int64_t ms, int64_t stepMs);
+
+    HardwareManager* m_hardware = nullptr;
+    PatternEngine* m_engine = nullptr;
+    int64_t m_clockNs = 0;
+};
+
+namespace {
+const int64_t NS_PER_MS = 1000000;
+
+QJsonObject continuousParameters()
+{
+    return QJsonObject{{"type", "continuous orgasm"}};
+}
+}
+
+void TestPatternEngineTiming::init()
+{
+    m_hardware = new HardwareManager();
+    m_hardware->setSimulationMode(true);
+    QVERIFY(m_hardware->initialize());
+
+    m_clockNs = 1000 * NS_PER_MS;
+    m_engine = new PatternEngine(m_hardware);
+    m_engine->setVirtualClock([this]() { return m_clockNs; });
+}
+
+void TestPatternEngineTiming::cleanup()
+{
+    delete m_engine;
+    m_engine = nullptr;
+    delete m_hardware;
+    m_hardware = nullptr;
+}
+
+void TestPatternEngineTiming::advanceMs(int64_t ms, int64_t stepMs)
+{
+    for (int64_t elapsed = 0; elapsed < ms; elapsed += stepMs) {
+        m_clockNs += stepMs * NS_PER_MS;
+        m_engine->runDueSteps();
+    }
+}
+
+void TestPatternEngineTiming::testStepsFollowTimeline()
+{
+    // Steps at 0, 1000, 1500, 2500, 3000 ms; each entered up to 7 ms late
+    const QJsonObject parameters{{"type", "pulse"}, {"pulse_duration_ms", 1000}, {"pause_duration_ms", 500}};
+    QVERIFY(m_engine->startPattern("Slow Pulse", parameters));
+
+    advanceMs(3206, 7);
+
+    QCOMPARE(m_engine->getCurrentStep(), 4);
+    QCOMPARE(m_engine->getElapsedTime(), qint64(3206));
+    // Rest of step 4, then steps 5-19: eight pauses and seven pulses
+    QCOMPARE(m_engine->getRemainingTime(), qint64(4000 - 3206 + 8 * 500 + 7 * 1000));
+
+    const RealTime::TimingStats& stats = m_engine->getStepTimingStats();
+    QCOMPARE(stats.count(), quint64(4));
+    QCOMPARE(stats.overruns(), quint64(0));
+    QVERIFY(stats.maxErrorUs() < 7000.0);
+}
+
+void TestPatternEngineTiming::testStallCountsTowardCycleDrift()
+{
+    QSignalSpy reports(m_engine, &PatternEngine::cycleTimingReport);
+    QVERIFY(m_engine->startPattern("Continuous Orgasm Marathon", continuousParameters()));
+    const int64_t startNs = m_clockNs;
+    const int64_t cycleNs = m_engine->getRemainingTime() * NS_PER_MS;
+
+    advanceMs(30000, 10);
+
+    // Longer than any step, so the timeline is re-anchored
+    m_clockNs += 61000 * NS_PER_MS;
+    m_engine->runDueSteps();
+    QCOMPARE(m_engine->getStepTimingStats().overruns(), quint64(1));
+
+    while (reports.isEmpty() && m_clockNs - startNs < 2 * cycleNs) {
+        advanceMs(10, 10);
+    }
+    QCOMPARE(reports.count(), 1);
+
+    // Drift is measured against the schedule set when the pattern began
+    const double expectedDriftMs = static_cast<double>(m_clockNs - startNs - cycleNs) / NS_PER_MS;
+    QVERIFY(expectedDriftMs > 60000.0);
+    QCOMPARE(m_engine->getLastCycleDriftMs(), expectedDriftMs);
+    QCOMPARE(reports.first().at(2).toDouble(), expectedDriftMs);
+}
+
+void TestPatternEngineTiming::testCycleReportsMeasuredLength()
+{
+    QSignalSpy reports(m_engine, &PatternEngine::cycleTimingReport);
+    QVERIFY(m_engine->startPattern("Continuous Orgasm Marathon", continuousParameters()));
+    const int64_t startNs = m_clockNs;
+    const int64_t cycleNs = m_engine->getRemainingTime() * NS_PER_MS;
+
+    advanceMs(10000, 10);
+    m_engine->pausePattern();
+    advanceMs(5000, 10);
+    m_engine->resumePattern();
+    const int64_t pausedNs = 5000 * NS_PER_MS;
+
+    while (reports.isEmpty() && m_clockNs - startNs < 2 * cycleNs) {
+        advanceMs(10, 10);
+    }
+    QCOMPARE(reports.count(), 1);
+
+    // Measured boundary, pause excluded: at most one clock tick past the schedule
+    const double measuredMs = static_cast<double>(m_clockNs - startNs - pausedNs) / NS_PER_MS;
+    QCOMPARE(reports.first().at(0).toInt(), 1);
+    QCOMPARE(reports.first().at(1).toDouble(), measuredMs);
+    QVERIFY(measuredMs >= cycleNs / NS_PER_MS);
+    QVERIFY(measuredMs < cycleNs / NS_PER_MS + 10.0);
+    QVERIFY(m_engine->getLastCycleDriftMs() < 10.0);
+}
+
+void TestPatternEngineTiming::testSinePhaseEndsOnMidline()
+{
+    // One 4 s period around 50% with amplitude 20%; the wave does not loop
+    const QJsonObject parameters{{"type", "wave"}, {"wave_period_ms", 4000},
+                                 {"min_pressure_percent", 30.0}, {"max_pressure_percent", 70.0}};
+    QVERIFY(m_engine->startPattern("Slow Wave Pattern", parameters));
+
+    const CompiledPattern& pattern = m_engine->getCompiledPattern();
+    QCOMPARE(pattern.size(), 4);
+    QCOMPARE(pattern.totalDurationMs(), qint64(4000));
+
+    // Midline, crest, trough, then the closing midline keyframe
+    const double starts[] = {50.0, 70.0, 30.0, 50.0};
+    const double ends[] = {70.0, 30.0, 50.0, 50.0};
+    for (int i = 0; i < pattern.size(); ++i) {
+        QCOMPARE(pattern[i].curve, CompiledPattern::Curve::SINE);
+        QCOMPARE(pattern[i].pressurePercent, starts[i]);
+        QCOMPARE(pattern[i].endPressurePercent, ends[i]);
+    }
+
+    // Crest a quarter period in, trough at three quarters
+    QCOMPARE(pattern[0].durationMs, 1000);
+    QCOMPARE(pattern[1].durationMs, 2000);
+    QCOMPARE(CompiledPattern::pressureAt(pattern[2], 1.0), 50.0);
+    QCOMPARE(CompiledPattern::pressureAt(pattern[3], 1.0), 50.0);
+}
+
+QTEST_MAIN(TestPatternEngineTiming)
+#include "test_PatternEngineTiming.moc"
@@ -0,0 +1,106 @@
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "../../src/patterns/PatternValidationCache.h"
+
+/**
+ * @brief Tests for the content-hashed pattern validation cache
+ *
+ * Covers canonical content keys, reports surviving a save and reload, and
+ * that a validator with different limits never reuses another's verdict.
+ */
+class TestPatternValidationCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void testContentKeyIsCanonical();
+    void testReportsPersistAcrossLoad();
+    void testContextTracksValidatorLimits();
+};
+
+namespace {
+QJsonObject pattern(double pressure)
+{
+    QJsonArray steps;
+    steps.append(QJsonObject{{"action", "pressure"}, {"pressure", pressure}, {"duration", 2000}});
+    steps.append(QJsonObject{{"action", "release"}, {"pressure", 0.0}, {"duration", 1000}});
+    return QJsonObject{{"name", "Cache Test"}, {"type", "custom"}, {"steps", steps}};
+}
+}
+
+void TestPatternValidationCache::init()
+{
+    PatternValidationCache* cache = PatternValidationCache::instance();
+    cache->setCacheFilePath(QString());
+    cache->clear();
+}
+
+void TestPatternValidationCache::testContentKeyIsCanonical()
+{
+    QJsonObject first;
+    first["name"] = "A";
+    first["type"] = "custom";
+    QJsonObject second;
+    second["type"] = "custom";
+    second["name"] = "A";
+    QCOMPARE(PatternValidationCache::contentKey(first), PatternValidationCache::contentKey(second));
+
+    second["name"] = "B";
+    QVERIFY(PatternValidationCache::contentKey(first) != PatternValidationCache::contentKey(second));
+    QVERIFY(PatternValidationCache::contentKey(pattern(50.0)) != PatternValidationCache::contentKey(pattern(51.0)));
+}
+
+void TestPatternValidationCache::testReportsPersistAcrossLoad()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("pattern_validation_cache.json");
+    PatternValidationCache* cache = PatternValidationCache::instance();
+    cache->setCacheFilePath(path);
+
+    PatternValidator::ValidationReport report;
+    report.overallResult = PatternValidator::CRITICAL;
+    report.isSafeForExecution = false;
+    report.issues.append(PatternValidator::ValidationIssue(PatternValidator::CRITICAL, "Pressure Limit", "Too high"));
+    const QByteArray key = PatternValidationCache::contentKey(pattern(95.0));
+    const QString context = PatternValidationCache::contextFor("test", QStringList() << "limits");
+    cache->storeReport(key, context, report);
+    QVERIFY(cache->save());
+
+    cache->setCacheFilePath(QString());
+    cache->clear();
+    QCOMPARE(cache->size(), 0);
+    cache->setCacheFilePath(path);
+
+    PatternValidator::ValidationReport loaded;
+    QVERIFY(cache->findReport(key, context, loaded));
+    QCOMPARE(loaded.overallResult, PatternValidator::CRITICAL);
+    QVERIFY(!loaded.isSafeForExecution);
+    QCOMPARE(loaded.issues.size(), 1);
+    QCOMPARE(loaded.issues.first().message, QString("Too high"));
+
+    const QString otherContext = PatternValidationCache::contextFor("test", QStringList() << "other limits");
+    QVERIFY(otherContext != context);
+    QVERIFY(!cache->findReport(key, otherContext, loaded));
+}
+
+void TestPatternValidationCache::testContextTracksValidatorLimits()
+{
+    PatternValidationCache* cache = PatternValidationCache::instance();
+    const QJsonObject data = pattern(70.0);
+
+    PatternValidator validator;
+    QVERIFY(validator.validatePattern(data, PatternValidator::SAFETY).isSafeForExecution);
+    const quint64 hits = cache->hits();
+    QVERIFY(validator.validatePattern(data, PatternValidator::SAFETY).isSafeForExecution);
+    QCOMPARE(cache->hits(), hits + 1);
+
+    // Stricter limits must produce a fresh verdict, not the cached one
+    validator.setSafetyLimits(60.0, validator.getMaxDuration(), validator.getMaxPressureGradient());
+    QVERIFY(!validator.validatePattern(data, PatternValidator::SAFETY).isSafeForExecution);
+    QCOMPARE(cache->hits(), hits + 1);
+}
+
+QTEST_MAIN(TestPatternValidationCache)
+#include "test_PatternValidationCache.moc"
@@ -0,0 +1,133 @@
+#include <QTest>
+#include <QRandomGenerator>
+#include <cmath>
+
+#include "../../src/patterns/PatternValidator.h"
+
+/**
+ * @brief Tests for incremental pattern validation
+ *
+ * Applies random step edits through the incremental API and checks after
+ * each one that the result, issue counts and statistics match a full
+ * validatePattern() run over the same steps.
+ */
+class TestPatternValidator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testIncrementalMatchesFullValidation();
+    void testEditsOnlyTouchNeighbours();
+};
+
+namespace {
+QJsonObject patternFor(const QString& name, const QVector<PatternValidator::StepValues>& steps)
+{
+    QJsonArray stepArray;
+    for (const PatternValidator::StepValues& step : steps) {
+        stepArray.append(QJsonObject{{"action", "pressure"}, {"pressure", step.pressure}, {"duration", step.duration}});
+    }
+    return QJsonObject{{"name", name}, {"type", "custom"}, {"steps", stepArray}};
+}
+
+PatternValidator::StepValues randomStep(QRandomGenerator& random)
+{
+    // Wide enough to trip every per-step and pair check now and then
+    return PatternValidator::StepValues(random.bounded(100.0), 50 + random.bounded(70000));
+}
+
+int countIssues(const PatternValidator::ValidationReport& report, PatternValidator::ValidationResult severity)
+{
+    int count = 0;
+    for (const PatternValidator::ValidationIssue& issue : report.issues) {
+        count += issue.severity == severity;
+    }
+    return count;
+}
+}
+
+void TestPatternValidator::testIncrementalMatchesFullValidation()
+{
+    PatternValidator validator;
+    QRandomGenerator random(1234);
+    const QString name = "Gentle Intense Wave";     // Enables both coherence checks
+
+    QVector<PatternValidator::StepValues> steps;
+    for (int i = 0; i < 20; ++i) {
+        steps.append(randomStep(random));
+    }
+    validator.beginIncremental(patternFor(name, steps), steps);
+
+    for (int edit = 0; edit < 300; ++edit) {
+        const int index = steps.isEmpty() ? 0 : random.bounded(steps.size());
+        switch (random.bounded(4)) {
+            case 0:
+                steps.insert(index, randomStep(random));
+                validator.insertStep(index, steps[index]);
+                break;
+            case 1:
+                if (steps.size() > 1) {
+                    steps.remove(index);
+                    validator.removeStep(index);
+                }
+                break;
+            case 2:
+                if (!steps.isEmpty()) {
+                    steps[index] = randomStep(random);
+                    validator.updateStep(index, steps[index]);
+                }
+                break;
+            default:
+                if (steps.size() > 1) {
+                    const int to = random.bounded(steps.size());
+                    steps.move(index, to);
+                    validator.moveStep(index, to);
+                }
+                break;
+        }
+
+        const PatternValidator::ValidationReport full = validator.validatePattern(patternFor(name, steps));
+        QCOMPARE(validator.incrementalStepCount(), steps.size());
+        QCOMPARE(validator.incrementalResult(), full.overallResult);
+        for (auto severity : {PatternValidator::WARNING, PatternValidator::ERROR, PatternValidator::CRITICAL}) {
+            QCOMPARE(validator.incrementalIssueCount(severity), countIssues(full, severity));
+        }
+
+        const QJsonObject stats = validator.incrementalStatistics();
+        QCOMPARE(stats["totalDuration"].toInt(), full.statistics["totalDuration"].toInt());
+        QVERIFY(std::fabs(stats["complexity"].toDouble() - full.statistics["complexity"].toDouble()) < 1e-6);
+        QVERIFY(std::fabs(stats["pressureVariability"].toDouble() -
+                          full.statistics["pressureVariability"].toDouble()) < 1e-6);
+    }
+
+    // The materialized report lists the same issues in the same order
+    const PatternValidator::ValidationReport full = validator.validatePattern(patternFor(name, steps));
+    const PatternValidator::ValidationReport incremental = validator.incrementalReport();
+    QCOMPARE(incremental.issues.size(), full.issues.size());
+    for (int i = 0; i < full.issues.size(); ++i) {
+        QCOMPARE(incremental.issues[i].severity, full.issues[i].severity);
+        QCOMPARE(incremental.issues[i].category, full.issues[i].category);
+    }
+}
+
+void TestPatternValidator::testEditsOnlyTouchNeighbours()
+{
+    PatternValidator validator;
+    QVector<PatternValidator::StepValues> steps(1000, PatternValidator::StepValues(40.0, 1000));
+    validator.beginIncremental(patternFor("Long", steps), steps);
+    // Only the whole-pattern step count and complexity warnings
+    QCOMPARE(validator.incrementalResult(), PatternValidator::WARNING);
+    QCOMPARE(validator.incrementalIssueCount(PatternValidator::WARNING), 2);
+
+    // A fast 40% jump is an error on the step after it, and clears again
+    validator.updateStep(500, PatternValidator::StepValues(80.0, 300));
+    QCOMPARE(validator.incrementalIssueCount(PatternValidator::ERROR), 1);
+    validator.updateStep(500, PatternValidator::StepValues(40.0, 1000));
+    QCOMPARE(validator.incrementalIssueCount(PatternValidator::ERROR), 0);
+
+    validator.removeStep(999);
+    QCOMPARE(validator.incrementalStatistics()["totalDuration"].toInt(), 999000);
+}
+
+QTEST_MAIN(TestPatternValidator)
+#include "test_PatternValidator.moc"
@@ -0,0 +1,175 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QStringList>
+
+#include "../../src/threading/ControlScheduler.h"
+#include "../../src/threading/RealTimeSupport.h"
+
+/**
+ * @brief Tests for the multi-rate cyclic executive
+ *
+ * Steps the scheduler manually so rates, phase offsets, stage ordering,
+ * budgets and ControlTimer hand-over are checked without depending on host
+ * timing.
+ */
+class TestControlScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDivisorsArePhaseAligned();
+    void testStageOrder();
+    void testBudgetOverrun();
+    void testTaskRemovesItselfMidCycle();
+    void testControlTimerFollowsScheduler();
+    void testOffsetsSpreadTasks();
+};
+
+void TestControlScheduler::testDivisorsArePhaseAligned()
+{
+    ControlScheduler scheduler(100);
+    QVector<quint64> fast;
+    QVector<quint64> slow;
+    scheduler.addTask("fast", ControlScheduler::Stage::SENSE, 2, [&]() { fast.append(scheduler.cycleCount()); });
+    scheduler.addTask("slow", ControlScheduler::Stage::CONTROL, 10, [&]() { slow.append(scheduler.cycleCount()); });
+
+    for (int i = 0; i < 40; ++i) {
+        scheduler.runCycle();
+    }
+
+    QCOMPARE(fast.size(), 20);
+    QCOMPARE(slow.size(), 4);
+    for (quint64 cycle : slow) {
+        QVERIFY(fast.contains(cycle));
+    }
+}
+
+void TestControlScheduler::testStageOrder()
+{
+    ControlScheduler scheduler;
+    QStringList order;
+    scheduler.addTask("log", ControlScheduler::Stage::LOG, 1, [&]() { order << "log"; });
+    scheduler.addTask("actuate", ControlScheduler::Stage::ACTUATE, 1, [&]() { order << "actuate"; });
+    scheduler.addTask("sense", ControlScheduler::Stage::SENSE, 1, [&]() { order << "sense"; });
+    scheduler.addTask("control", ControlScheduler::Stage::CONTROL, 1, [&]() { order << "control"; });
+    scheduler.addTask("estimate", ControlScheduler::Stage::ESTIMATE, 1, [&]() { order << "estimate"; });
+
+    scheduler.runCycle();
+    QCOMPARE(order, QStringList({"sense", "estimate", "control", "actuate", "log"}));
+}
+
+void TestControlScheduler::testBudgetOverrun()
+{
+    ControlScheduler scheduler;
+    QSignalSpy overruns(&scheduler, &ControlScheduler::taskOverrun);
+
+    const int id = scheduler.addTask("busy", ControlScheduler::Stage::CONTROL, 1, []() {
+        RealTime::sleepUntilNs(RealTime::monotonicNowNs() + 2000000);
+    }, 500.0);
+
+    scheduler.runCycle();
+    scheduler.setTaskBudget(id, 0.0);
+    scheduler.runCycle();
+
+    QCOMPARE(overruns.count(), 1);
+    const ControlScheduler::TaskStatistics stats = scheduler.getTaskStatistics().first();
+    QCOMPARE(stats.runs, quint64(2));
+    QCOMPARE(stats.overruns, quint64(1));
+    QVERIFY(stats.maxUs >= 2000.0);
+}
+
+void TestControlScheduler::testTaskRemovesItselfMidCycle()
+{
+    ControlScheduler scheduler;
+    int selfRuns = 0;
+    int addedRuns = 0;
+    int selfId = -1;
+    selfId = scheduler.addTask("once", ControlScheduler::Stage::SENSE, 1, [&]() {
+        selfRuns++;
+        scheduler.removeTask(selfId);
+        scheduler.addTask("added", ControlScheduler::Stage::SENSE, 1, [&]() { addedRuns++; });
+    });
+
+    scheduler.runCycle();
+    QCOMPARE(selfRuns, 1);
+    QCOMPARE(addedRuns, 0);     // Joins at the next cycle
+
+    scheduler.runCycle();
+    QCOMPARE(selfRuns, 1);
+    QCOMPARE(addedRuns, 1);
+    QVERIFY(!scheduler.hasTask(selfId));
+}
+
+void TestControlScheduler::testControlTimerFollowsScheduler()
+{
+    ControlScheduler scheduler(100);
+    ControlTimer timer;
+    QSignalSpy ticks(&timer, &ControlTimer::timeout);
+
+    timer.setInterval(50);
+    timer.attach(&scheduler, ControlScheduler::Stage::SENSE, "timer");
+    QVERIFY(timer.isScheduled());
+
+    for (int i = 0; i < 20; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(ticks.count(), 0);     // Not started
+
+    timer.start();
+    for (int i = 0; i < 20; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(ticks.count(), 4);
+
+    timer.start(100);
+    for (int i = 0; i < 20; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(ticks.count(), 6);
+
+    timer.stop();
+    for (int i = 0; i < 20; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(ticks.count(), 6);
+}
+
+void TestControlScheduler::testOffsetsSpreadTasks()
+{
+    ControlScheduler scheduler(100);
+    QVector<quint64> early;
+    QVector<quint64> late;
+    scheduler.addTask("early", ControlScheduler::Stage::SENSE, 10, [&]() { early.append(scheduler.cycleCount()); },
+                      0.0, 2);
+    QCOMPARE(scheduler.addTask("invalid", ControlScheduler::Stage::SENSE, 10, []() {}, 0.0, 10), -1);
+
+    // A ControlTimer keeps its offset modulo the divisor across interval changes
+    ControlTimer timer;
+    timer.setInterval(100);
+    timer.attach(&scheduler, ControlScheduler::Stage::CONTROL, "late", ControlScheduler::DEFAULT_TASK_BUDGET_US, 7);
+    connect(&timer, &ControlTimer::timeout, [&]() { late.append(scheduler.cycleCount()); });
+    timer.start();
+
+    for (int i = 0; i < 20; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(early, (QVector<quint64>{2, 12}));
+    QCOMPARE(late, (QVector<quint64>{7, 17}));
+
+    late.clear();
+    timer.setInterval(50);
+    for (int i = 0; i < 10; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(late, (QVector<quint64>{22, 27}));
+
+    late.clear();
+    timer.setInterval(100);
+    for (int i = 0; i < 10; ++i) {
+        scheduler.runCycle();
+    }
+    QCOMPARE(late, (QVector<quint64>{37}));
+}
+
+QTEST_MAIN(TestControlScheduler)
+#include "test_ControlScheduler.moc"
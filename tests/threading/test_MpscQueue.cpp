@@ -0,0 +1,93 @@
+#include <QTest>
+#include <QString>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../../src/threading/MpscQueue.h"
+
+/**
+ * @brief Tests for the bounded multi-producer / single-consumer queue
+ *
+ * Checks FIFO order and the full/empty edges on one thread, then runs
+ * several producers against a live consumer and verifies every item
+ * arrives exactly once and in per-producer order.
+ */
+class TestMpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFifoAndCapacity();
+    void testConcurrentProducers();
+};
+
+void TestMpscQueue::testFifoAndCapacity()
+{
+    MpscQueue<QString> queue(6);
+    QCOMPARE(queue.capacity(), size_t(8));
+
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY(queue.tryPush(QString::number(i)));
+    }
+    QString rejected("overflow");
+    QVERIFY(!queue.tryPush(std::move(rejected)));
+    QCOMPARE(rejected, QString("overflow"));     // Left untouched on failure
+    QCOMPARE(queue.sizeApprox(), size_t(8));
+
+    QString value;
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY(queue.tryPop(value));
+        QCOMPARE(value, QString::number(i));
+    }
+    QVERIFY(!queue.tryPop(value));
+
+    // Wraps around after being drained
+    QVERIFY(queue.tryPush(QString("again")));
+    QVERIFY(queue.tryPop(value));
+    QCOMPARE(value, QString("again"));
+}
+
+void TestMpscQueue::testConcurrentProducers()
+{
+    const int producers = 4;
+    const int perProducer = 50000;
+    MpscQueue<uint64_t> queue(1024);
+    std::atomic<int> finished{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &finished, p]() {
+            for (uint64_t i = 0; i < uint64_t(perProducer); ++i) {
+                const uint64_t item = (uint64_t(p) << 32) | i;
+                while (!queue.tryPush(uint64_t(item))) {
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    std::vector<uint64_t> next(producers, 0);
+    int received = 0;
+    uint64_t item;
+    while (received < producers * perProducer) {
+        if (!queue.tryPop(item)) {
+            QVERIFY(finished.load() < producers || queue.sizeApprox() > 0);
+            std::this_thread::yield();
+            continue;
+        }
+        const int producer = static_cast<int>(item >> 32);
+        QCOMPARE(item & 0xffffffffu, next[producer]);
+        next[producer]++;
+        received++;
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    QVERIFY(!queue.tryPop(item));
+}
+
+QTEST_MAIN(TestMpscQueue)
+#include "test_MpscQueue.moc"
@@ -0,0 +1,177 @@
+#include <QTest>
+#include <QThread>
+#include <atomic>
+
+#include "../../src/threading/SampleRing.h"
+
+/**
+ * @brief Tests for the single-producer / multi-reader sample ring
+ *
+ * Covers overwrite-oldest semantics, cursor-based incremental reads with
+ * loss reporting, clear(), cursors across reset(), and lock-free readers
+ * racing the producer.
+ */
+class TestSampleRing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyRing();
+    void testOverwritesOldest();
+    void testReadSinceAdvancesCursor();
+    void testReadSinceReportsSkipped();
+    void testClear();
+    void testResetKeepsIndicesMonotonic();
+    void testCursorAheadIsClamped();
+    void testConcurrentReadersSeeOrderedSamples();
+};
+
+namespace {
+struct Sample {
+    quint64 a;
+    quint64 b;
+};
+}
+
+void TestSampleRing::testEmptyRing()
+{
+    SampleRing<Sample> ring(8);
+    Sample s;
+    QVERIFY(ring.isEmpty());
+    QVERIFY(!ring.latest(s));
+    QCOMPARE(ring.copyLatest(&s, 1), size_t(0));
+}
+
+void TestSampleRing::testOverwritesOldest()
+{
+    SampleRing<Sample> ring(4);
+    for (quint64 i = 0; i < 10; ++i) {
+        ring.push({i, i});
+    }
+    QCOMPARE(ring.size(), size_t(4));
+
+    Sample out[8];
+    QCOMPARE(ring.copyLatest(out, 8), size_t(4));
+    QCOMPARE(out[0].a, quint64(6));
+    QCOMPARE(out[3].a, quint64(9));
+
+    Sample last;
+    QVERIFY(ring.latest(last));
+    QCOMPARE(last.a, quint64(9));
+}
+
+void TestSampleRing::testReadSinceAdvancesCursor()
+{
+    SampleRing<Sample> ring(16);
+    uint64_t cursor = 0;
+    Sample out[16];
+
+    ring.push({1, 1});
+    ring.push({2, 2});
+    QCOMPARE(ring.readSince(cursor, out, 16), size_t(2));
+    QCOMPARE(cursor, uint64_t(2));
+    QCOMPARE(ring.readSince(cursor, out, 16), size_t(0));
+
+    ring.push({3, 3});
+    QCOMPARE(ring.readSince(cursor, out, 16), size_t(1));
+    QCOMPARE(out[0].a, quint64(3));
+}
+
+void TestSampleRing::testReadSinceReportsSkipped()
+{
+    SampleRing<Sample> ring(4);
+    uint64_t cursor = 0;
+    uint64_t skipped = 0;
+    Sample out[4];
+
+    for (quint64 i = 0; i < 10; ++i) {
+        ring.push({i, i});
+    }
+    QCOMPARE(ring.readSince(cursor, out, 4, &skipped), size_t(4));
+    QCOMPARE(skipped, uint64_t(6));
+    QCOMPARE(out[0].a, quint64(6));
+}
+
+void TestSampleRing::testClear()
+{
+    SampleRing<Sample> ring(4);
+    ring.push({1, 1});
+    ring.clear();
+    QVERIFY(ring.isEmpty());
+    ring.push({2, 2});
+    QCOMPARE(ring.size(), size_t(1));
+}
+
+void TestSampleRing::testResetKeepsIndicesMonotonic()
+{
+    SampleRing<Sample> ring(4);
+    uint64_t cursor = 0;
+    Sample out[16];
+
+    for (quint64 i = 0; i < 3; ++i) {
+        ring.push({i, i});
+    }
+    QCOMPARE(ring.readSince(cursor, out, 16), size_t(3));
+
+    const uint64_t generation = ring.generation();
+    ring.reset(16);
+    QVERIFY(ring.generation() != generation);
+    QCOMPARE(ring.capacity(), size_t(16));
+    QVERIFY(ring.isEmpty());
+    QCOMPARE(ring.totalWritten(), uint64_t(3));
+
+    // The old cursor stays valid and sees only new samples
+    ring.push({7, 7});
+    QCOMPARE(ring.readSince(cursor, out, 16), size_t(1));
+    QCOMPARE(out[0].a, quint64(7));
+    QCOMPARE(cursor, uint64_t(4));
+}
+
+void TestSampleRing::testCursorAheadIsClamped()
+{
+    SampleRing<Sample> ring(8);
+    for (quint64 i = 0; i < 5; ++i) {
+        ring.push({i, i});
+    }
+
+    uint64_t cursor = 1000;     // E.g. kept from another ring
+    uint64_t skipped = 0;
+    Sample out[8];
+    QCOMPARE(ring.readSince(cursor, out, 8, &skipped), size_t(5));
+    QCOMPARE(skipped, uint64_t(0));
+    QCOMPARE(out[0].a, quint64(0));
+    QCOMPARE(cursor, uint64_t(5));
+}
+
+void TestSampleRing::testConcurrentReadersSeeOrderedSamples()
+{
+    SampleRing<Sample> ring(64);
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+
+    QThread* reader = QThread::create([&]() {
+        Sample out[64];
+        while (!done.load()) {
+            size_t n = ring.copyLatest(out, 64);
+            for (size_t i = 0; i < n; ++i) {
+                if (out[i].a != out[i].b || (i > 0 && out[i].a != out[i - 1].a + 1)) {
+                    bad.fetch_add(1);
+                }
+            }
+        }
+    });
+    reader->start();
+
+    for (quint64 i = 0; i < 500000; ++i) {
+        ring.push({i, i});
+    }
+    done.store(true);
+    reader->wait();
+    delete reader;
+
+    QCOMPARE(bad.load(), 0);
+    QCOMPARE(ring.totalWritten(), uint64_t(500000));
+}
+
+QTEST_APPLESS_MAIN(TestSampleRing)
+#include "test_SampleRing.moc"
@@ -0,0 +1,423 @@
+/**
+ * @brief pattern_render - deterministic offline pattern renderer
+ *
+ * Runs patterns through PatternEngine against the simulated pneumatic plant
+ * on a virtual clock, as fast as the host allows, and writes the resulting
+ * pressure/valve timeline as CSV or as a compact binary trace. Identical
+ * inputs give byte-identical traces, so two releases can be compared with a
+ * plain diff, and the summary reports step-scheduling latency percentiles
+ * for benchmarking engine changes.
+ *
+ * Patterns come from config/patterns.json (or --patterns FILE); with
+ * --builtin the parameters built into PatternDefinitions are used instead.
+ *
+ * Only the outer-chamber path (step sequencing, setpoint generator,
+ * pressure loop, pump and SOL1/SOL2) runs on virtual time. The clitoral
+ * oscillator and TENS keep their own real-time threads and are not part of
+ * the trace.
+ *
+ * Usage: pattern_render [options] [pattern names...]
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+
+#include "../src/core/JsonFileHelper.h"
+#include "../src/hardware/HardwareManager.h"
+#include "../src/hardware/PneumaticPlant.h"
+#include "../src/patterns/PatternDefinitions.h"
+#include "../src/patterns/PatternEngine.h"
+#include "../src/threading/ControlScheduler.h"
+
+namespace {
+
+const int64_t VIRTUAL_START_NS = 1000000000;    // Engine treats 0 as "not started"
+const int DEFAULT_TICK_US = 1000;
+const qint64 DEFAULT_MAX_DURATION_MS = 600000;  // Bounds looping patterns
+const quint32 TRACE_MAGIC = 0x52504356;         // "VCPR" little-endian
+const quint16 TRACE_VERSION = 1;
+const quint16 TRACE_RECORD_BYTES = 29;
+
+enum TraceFlag : quint8 {
+    PUMP_ON = 0x01,
+    SOL1_OPEN = 0x02,
+    SOL2_OPEN = 0x04
+};
+
+struct TraceRecord {
+    qint64 timeNs;              // Since pattern start
+    qint32 step;
+    float targetPercent;
+    float avlMmHg;
+    float tankMmHg;
+    float pumpPercent;
+    quint8 flags;
+};
+
+struct RenderResult {
+    QString name;
+    bool started = false;
+    bool completed = false;
+    qint64 virtualMs = 0;
+    qint64 hostNs = 0;
+    int stepsEntered = 0;
+    int valveTransitions = 0;
+    QVector<TraceRecord> trace;
+    QVector<double> stepLatenessUs;     // Virtual: tick quantization and timeline logic
+    QVector<double> stepHostUs;         // Host time to process one step transition
+    QVector<double> cycleHostUs;        // Host time for one control cycle
+    PressureController::TrackingMetrics tracking;
+    double meanStepLatenessUs = 0.0;
+    double maxStepLatenessUs = 0.0;
+};
+
+struct RenderOptions {
+    int tickUs = DEFAULT_TICK_US;
+    qint64 maxDurationMs = DEFAULT_MAX_DURATION_MS;
+    bool closedLoop = true;
+    PneumaticPlant::Parameters plant;
+};
+
+bool g_verbose = false;
+
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    // The engine logs every step; keep the output to the trace and summary
+    if (type == QtDebugMsg && !g_verbose) return;
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+double percentile(QVector<double> values, double p)
+{
+    if (values.isEmpty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const int rank = std::min<int>(values.size() - 1, static_cast<int>(p / 100.0 * values.size()));
+    return values[rank];
+}
+
+QString percentileLine(const QString& label, const QVector<double>& values)
+{
+    return QString("  %1 n=%2 p50=%3 p90=%4 p99=%5 max=%6 us")
+        .arg(label, -22)
+        .arg(values.size())
+        .arg(percentile(values, 50.0), 0, 'f', 1)
+        .arg(percentile(values, 90.0), 0, 'f', 1)
+        .arg(percentile(values, 99.0), 0, 'f', 1)
+        .arg(values.isEmpty() ? 0.0 : *std::max_element(values.begin(), values.end()), 0, 'f', 1);
+}
+
+// name -> pattern object, across every category of the file
+bool loadPatternFile(const QString& filePath, QMap<QString, QJsonObject>& patterns, QStringList& order)
+{
+    QJsonObject root;
+    if (!JsonFileHelper::loadObject(filePath, root)) {
+        return false;
+    }
+    const QJsonObject categories = root["vacuum_patterns"].toObject();
+    for (auto category = categories.constBegin(); category != categories.constEnd(); ++category) {
+        for (const QJsonValue& value : category.value().toArray()) {
+            const QJsonObject pattern = value.toObject();
+            const QString name = pattern["name"].toString();
+            if (name.isEmpty() || patterns.contains(name)) continue;
+            patterns.insert(name, pattern);
+            order.append(name);
+        }
+    }
+    return true;
+}
+
+RenderResult renderPattern(const QString& name, const QJsonObject& parameters, const RenderOptions& options)
+{
+    RenderResult result;
+    result.name = name;
+
+    // Fresh hardware, scheduler and engine per pattern, so every render
+    // starts from atmosphere with an idle controller
+    HardwareManager hardware;
+    hardware.setSimulationMode(true);
+    hardware.setSimulationManualClock(true);
+    hardware.setPlantSimulationEnabled(true, options.plant);
+    if (!hardware.initialize()) {
+        qWarning() << "Simulated hardware failed to initialize:" << hardware.getLastError();
+        return result;
+    }
+
+    ControlScheduler scheduler;
+    PatternEngine engine(&hardware);
+    engine.attachToScheduler(&scheduler);
+    engine.setClosedLoopPressureEnabled(options.closedLoop);
+
+    int64_t virtualNs = VIRTUAL_START_NS;
+    engine.setVirtualClock([&virtualNs]() { return virtualNs; });
+
+    double targetPercent = 0.0;
+    bool finished = false;
+    QObject::connect(&engine, &PatternEngine::pressureTargetChanged,
+                     [&targetPercent](double target) { targetPercent = target; });
+    QObject::connect(&engine, &PatternEngine::patternCompleted, [&finished]() { finished = true; });
+
+    if (!engine.startPattern(name, parameters)) {
+        return result;
+    }
+    result.started = true;
+
+    const int64_t tickNs = static_cast<int64_t>(options.tickUs) * 1000;
+    const int64_t cycleNs = static_cast<int64_t>(scheduler.basePeriodMs()) * 1000000;
+    const int64_t endNs = VIRTUAL_START_NS + options.maxDurationMs * 1000000;
+    int64_t nextCycleNs = VIRTUAL_START_NS;
+    quint8 lastValves = 0;
+    QElapsedTimer host;
+    QElapsedTimer total;
+    total.start();
+
+    while (!finished && virtualNs < endNs && engine.getState() == PatternEngine::RUNNING) {
+        // Steps first: at a shared instant the new step's setpoint is what
+        // the control cycle should see
+        const uint64_t recordedBefore = engine.getStepTimingStats().count();
+        host.start();
+        const int entered = engine.runDueSteps();
+        const qint64 stepNs = host.nsecsElapsed();
+        if (entered > 0) {
+            result.stepsEntered += entered;
+            result.stepHostUs.append(stepNs / 1000.0 / entered);
+            if (engine.getStepTimingStats().count() == recordedBefore + 1) {
+                result.stepLatenessUs.append(engine.getStepTimingStats().lastErrorUs());
+            }
+        }
+        if (finished) break;
+
+        if (virtualNs >= nextCycleNs) {
+            host.start();
+            scheduler.runCycle();
+            result.cycleHostUs.append(host.nsecsElapsed() / 1000.0);
+            nextCycleNs += cycleNs;
+
+            const PneumaticPlant::State plant = hardware.getPlantState();
+            TraceRecord record;
+            record.timeNs = virtualNs - VIRTUAL_START_NS;
+            record.step = engine.getCurrentStep();
+            record.targetPercent = static_cast<float>(targetPercent);
+            record.avlMmHg = static_cast<float>(plant.avlVacuumMmHg);
+            record.tankMmHg = static_cast<float>(plant.tankVacuumMmHg);
+            record.pumpPercent = static_cast<float>(hardware.getPumpSpeed());
+            record.flags = (hardware.isPumpEnabled() ? PUMP_ON : 0)
+                         | (hardware.getSOL1State() ? SOL1_OPEN : 0)
+                         | (hardware.getSOL2State() ? SOL2_OPEN : 0);
+            const quint8 valves = record.flags & (SOL1_OPEN | SOL2_OPEN);
+            if (!result.trace.isEmpty() && valves != lastValves) {
+                result.valveTransitions++;
+            }
+            lastValves = valves;
+            result.trace.append(record);
+        }
+
+        virtualNs += tickNs;
+        hardware.advanceSimulation(options.tickUs / 1000.0);
+    }
+
+    result.completed = finished;
+    result.virtualMs = (virtualNs - VIRTUAL_START_NS) / 1000000;
+    result.hostNs = total.nsecsElapsed();
+    result.tracking = engine.getPressureTrackingMetrics();
+    result.meanStepLatenessUs = engine.getStepTimingStats().meanErrorUs();
+    result.maxStepLatenessUs = engine.getStepTimingStats().maxErrorUs();
+
+    engine.stopPattern();
+    return result;
+}
+
+void writeCsv(QTextStream& out, const RenderResult& result, bool header)
+{
+    if (header) {
+        out << "pattern,time_ms,step,target_percent,avl_mmhg,tank_mmhg,pump_on,pump_percent,sol1,sol2\n";
+    }
+    for (const TraceRecord& record : result.trace) {
+        out << '"' << result.name << "\","
+            << QString::number(record.timeNs / 1.0e6, 'f', 1) << ','
+            << record.step << ','
+            << QString::number(record.targetPercent, 'f', 2) << ','
+            << QString::number(record.avlMmHg, 'f', 2) << ','
+            << QString::number(record.tankMmHg, 'f', 2) << ','
+            << ((record.flags & PUMP_ON) ? 1 : 0) << ','
+            << QString::number(record.pumpPercent, 'f', 2) << ','
+            << ((record.flags & SOL1_OPEN) ? 1 : 0) << ','
+            << ((record.flags & SOL2_OPEN) ? 1 : 0) << '\n';
+    }
+}
+
+// Binary trace: header (magic, version, record size), then per pattern a
+// UTF-8 name, a record count and fixed-size little-endian records
+void writeBinaryHeader(QDataStream& out)
+{
+    out << TRACE_MAGIC << TRACE_VERSION << TRACE_RECORD_BYTES;
+}
+
+void writeBinary(QDataStream& out, const RenderResult& result)
+{
+    const QByteArray name = result.name.toUtf8();
+    out << static_cast<quint32>(name.size());
+    out.writeRawData(name.constData(), name.size());
+    out << static_cast<quint32>(result.trace.size());
+    for (const TraceRecord& record : result.trace) {
+        out << record.timeNs << record.step << record.targetPercent << record.avlMmHg
+            << record.tankMmHg << record.pumpPercent << record.flags;
+    }
+}
+
+void writeSummary(QTextStream& out, const RenderResult& result)
+{
+    if (!result.started) {
+        out << result.name << ": failed to start\n";
+        return;
+    }
+
+    const double speedup = result.hostNs > 0 ? result.virtualMs * 1.0e6 / result.hostNs : 0.0;
+    out << QString("%1: %2 ms virtual in %3 ms host (%4x), %5 steps, %6\n")
+               .arg(result.name)
+               .arg(result.virtualMs)
+               .arg(result.hostNs / 1.0e6, 0, 'f', 1)
+               .arg(speedup, 0, 'f', 0)
+               .arg(result.stepsEntered)
+               .arg(result.completed ? "completed" : "stopped at duration limit");
+    out << percentileLine("step lateness", result.stepLatenessUs)
+        << QString(" (mean %1, max %2)\n").arg(result.meanStepLatenessUs, 0, 'f', 1).arg(result.maxStepLatenessUs, 0, 'f', 1);
+    out << percentileLine("step processing", result.stepHostUs) << '\n';
+    out << percentileLine("control cycle", result.cycleHostUs) << '\n';
+    if (result.tracking.samples > 0) {
+        out << QString("  tracking: mean |e| %1 mmHg, rms %2 mmHg, max %3 mmHg, in band %4%\n")
+                   .arg(result.tracking.meanAbsErrorMmHg(), 0, 'f', 2)
+                   .arg(result.tracking.rmsErrorMmHg(), 0, 'f', 2)
+                   .arg(result.tracking.maxAbsErrorMmHg, 0, 'f', 2)
+                   .arg(result.tracking.inBandFraction() * 100.0, 0, 'f', 1);
+    }
+    out << QString("  valve transitions: %1\n").arg(result.valveTransitions);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pattern_render");
+    qInstallMessageHandler(messageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render patterns offline against the simulated plant on virtual time.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("patterns", "Pattern names to render (default: all).", "[patterns...]");
+
+    QCommandLineOption patternsOption("patterns", "Pattern file.", "file", "config/patterns.json");
+    QCommandLineOption builtinOption("builtin", "Use the parameters built into PatternDefinitions.");
+    QCommandLineOption listOption("list", "List available patterns and exit.");
+    QCommandLineOption traceOption({"o", "trace"}, "Write the trace to file ('-' for stdout).", "file");
+    QCommandLineOption binaryOption("binary", "Write a binary trace instead of CSV.");
+    QCommandLineOption durationOption("duration-ms", "Virtual time limit per pattern.", "ms",
+                                      QString::number(DEFAULT_MAX_DURATION_MS));
+    QCommandLineOption tickOption("tick-us", "Virtual clock resolution.", "us", QString::number(DEFAULT_TICK_US));
+    QCommandLineOption openLoopOption("open-loop", "Disable closed-loop pressure regulation.");
+    QCommandLineOption noiseOption("noise", "Sensor noise sigma in mmHg.", "mmHg", "0");
+    QCommandLineOption seedOption("seed", "Sensor noise seed.", "n", "1");
+    QCommandLineOption verboseOption("verbose", "Show engine debug output.");
+    parser.addOptions({patternsOption, builtinOption, listOption, traceOption, binaryOption, durationOption,
+                       tickOption, openLoopOption, noiseOption, seedOption, verboseOption});
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+
+    QMap<QString, QJsonObject> patterns;
+    QStringList order;
+    if (parser.isSet(builtinOption)) {
+        PatternDefinitions definitions;
+        definitions.loadDefaultPatterns();
+        for (const QString& name : definitions.getPatternNames()) {
+            const PatternDefinitions::PatternInfo info = definitions.getPattern(name);
+            QJsonObject parameters = info.parameters;
+            if (!parameters.contains("type")) parameters["type"] = info.type;
+            patterns.insert(name, parameters);
+            order.append(name);
+        }
+    } else if (!loadPatternFile(parser.value(patternsOption), patterns, order)) {
+        qCritical() << "Cannot read pattern file" << parser.value(patternsOption);
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.isSet(listOption)) {
+        for (const QString& name : order) {
+            out << name << '\t' << patterns[name]["type"].toString() << '\n';
+        }
+        return 0;
+    }
+
+    QStringList selected = parser.positionalArguments();
+    if (selected.isEmpty()) selected = order;
+    for (const QString& name : selected) {
+        if (!patterns.contains(name)) {
+            qCritical() << "Unknown pattern:" << name;
+            return 1;
+        }
+    }
+
+    RenderOptions options;
+    options.tickUs = std::max(1, parser.value(tickOption).toInt());
+    options.maxDurationMs = std::max<qint64>(1, parser.value(durationOption).toLongLong());
+    options.closedLoop = !parser.isSet(openLoopOption);
+    options.plant.sensorNoiseMmHg = parser.value(noiseOption).toDouble();
+    options.plant.noiseSeed = parser.value(seedOption).toUInt();
+
+    const QString tracePath = parser.value(traceOption);
+    const bool traceToStdout = tracePath == "-";
+    const bool binary = parser.isSet(binaryOption);
+    QFile traceFile;
+    if (traceToStdout) {
+        traceFile.open(stdout, QIODevice::WriteOnly);
+    } else if (!tracePath.isEmpty()) {
+        traceFile.setFileName(tracePath);
+        if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "Cannot write trace file" << tracePath;
+            return 1;
+        }
+    }
+
+    QTextStream csv(&traceFile);
+    QDataStream data(&traceFile);
+    data.setByteOrder(QDataStream::LittleEndian);
+    data.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    if (traceFile.isOpen() && binary) {
+        writeBinaryHeader(data);
+    }
+
+    // Keep stdout clean for the trace when it goes there
+    QTextStream& report = traceToStdout ? err : out;
+    int failures = 0;
+    for (int i = 0; i < selected.size(); ++i) {
+        const RenderResult result = renderPattern(selected[i], patterns[selected[i]], options);
+        if (!result.started) failures++;
+
+        if (traceFile.isOpen()) {
+            if (binary) {
+                writeBinary(data, result);
+            } else {
+                writeCsv(csv, result, i == 0);
+                csv.flush();
+            }
+        }
+        writeSummary(report, result);
+        report.flush();
+    }
+
+    return failures > 0 ? 1 : 0;
+}
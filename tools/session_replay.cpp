@@ -0,0 +1,416 @@
+/**
+ * @brief session_replay - deterministic replay of a recorded session
+ *
+ * Feeds the sensor snapshots of a session recording (.vcsr) back through
+ * OrgasmControlAlgorithm, and optionally a PatternEngine pattern, on a
+ * virtual clock, as fast as the host allows. Each session is restarted from
+ * its recorded start parameters (thresholds can be overridden for tuning),
+ * and the replayed arousal estimates and control state/mode transitions are
+ * compared with the recorded ones. The replay is itself written as a
+ * recording (-o FILE, or a temporary file), so replays of two builds or two
+ * parameter sets can be compared the same way.
+ *
+ * Sensor values come from the recording, not from a plant model: a replay
+ * answers "what would the controller have done with this input", not how
+ * the plant would have responded to different outputs. Heart rate and fluid
+ * readings are not recorded and do not take part.
+ *
+ * With --max-arousal-diff the tool is a regression check: it exits with 2
+ * when the arousal estimate drifts further than that from the recording or
+ * the transition sequence differs.
+ *
+ * Usage: session_replay [options] recording.vcsr
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include "../src/control/OrgasmControlAlgorithm.h"
+#include "../src/hardware/HardwareManager.h"
+#include "../src/logging/SessionRecording.h"
+#include "../src/patterns/PatternDefinitions.h"
+#include "../src/patterns/PatternEngine.h"
+#include "../src/threading/ControlScheduler.h"
+
+using namespace SessionRecording;
+
+namespace {
+
+struct ReplayOptions {
+    double edgeThreshold = -1.0;        // < 0: as recorded
+    double orgasmThreshold = -1.0;
+    double recoveryThreshold = -1.0;
+    QString pattern;
+    QJsonObject patternParameters;
+};
+
+struct Timeline {
+    int sensorRecords = 0;
+    int sessions = 0;
+    int64_t startNs = 0;
+    int64_t endNs = 0;
+    QVector<int64_t> arousalNs;
+    QVector<double> arousal;
+    QVector<int64_t> transitionNs;
+    QVector<TransitionRecord> transitions;      // Control state and mode only
+    int arousalTransitions = 0;
+};
+
+struct Comparison {
+    double meanArousalDiff = 0.0;
+    double maxArousalDiff = 0.0;
+    int64_t maxArousalDiffNs = 0;
+    int firstDivergence = -1;                   // Transition index, -1 = identical
+    double maxTransitionShiftMs = 0.0;
+};
+
+bool g_verbose = false;
+
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    // The algorithm logs every tick in places; keep the output to the report
+    if ((type == QtDebugMsg || type == QtInfoMsg) && !g_verbose) return;
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+bool readTimeline(const QString& filePath, Timeline& timeline, QString& error)
+{
+    SessionRecordingReader reader;
+    if (!reader.open(filePath)) {
+        error = reader.lastError();
+        return false;
+    }
+
+    timeline.startNs = reader.startMonotonicNs();
+    timeline.endNs = timeline.startNs;
+    for (auto record = reader.first(); record.isValid(); record = reader.next(record)) {
+        timeline.endNs = record.monotonicNs();
+        if (record.as<SensorRecord>()) {
+            timeline.sensorRecords++;
+        } else if (record.as<SessionStartRecord>()) {
+            timeline.sessions++;
+        } else if (const ArousalRecord* arousal = record.as<ArousalRecord>()) {
+            timeline.arousalNs.append(record.monotonicNs());
+            timeline.arousal.append(arousal->arousalLevel);
+        } else if (const TransitionRecord* transition = record.as<TransitionRecord>()) {
+            if (transition->kind == TransitionRecord::AROUSAL_STATE) {
+                timeline.arousalTransitions++;
+            } else {
+                timeline.transitionNs.append(record.monotonicNs());
+                timeline.transitions.append(*transition);
+            }
+        }
+    }
+    return true;
+}
+
+QString transitionName(const TransitionRecord& transition)
+{
+    if (transition.kind == TransitionRecord::MODE) {
+        const QMetaEnum modes = QMetaEnum::fromType<OrgasmControlAlgorithm::Mode>();
+        return QString("mode %1->%2").arg(modes.valueToKey(transition.from), modes.valueToKey(transition.to));
+    }
+    const QMetaEnum states = QMetaEnum::fromType<OrgasmControlAlgorithm::ControlState>();
+    return QString("state %1->%2").arg(states.valueToKey(transition.from), states.valueToKey(transition.to));
+}
+
+void applySessionStart(OrgasmControlAlgorithm& algorithm, const SessionStartRecord& start, const ReplayOptions& options)
+{
+    if (algorithm.getState() != OrgasmControlAlgorithm::ControlState::STOPPED) {
+        algorithm.stop();
+    }
+
+    algorithm.setEdgeThreshold(options.edgeThreshold >= 0.0 ? options.edgeThreshold : start.edgeThreshold);
+    algorithm.setOrgasmThreshold(options.orgasmThreshold >= 0.0 ? options.orgasmThreshold : start.orgasmThreshold);
+    algorithm.setRecoveryThreshold(options.recoveryThreshold >= 0.0 ? options.recoveryThreshold : start.recoveryThreshold);
+    algorithm.setTENSEnabled((start.flags & SessionStartRecord::TENS_ENABLED) != 0);
+    algorithm.setAntiEscapeEnabled((start.flags & SessionStartRecord::ANTI_ESCAPE_ENABLED) != 0);
+
+    const int durationMs = static_cast<int>(std::min<int64_t>(start.maxDurationMs, std::numeric_limits<int>::max()));
+    switch (static_cast<OrgasmControlAlgorithm::Mode>(start.mode)) {
+    case OrgasmControlAlgorithm::Mode::ADAPTIVE_EDGING:
+        algorithm.startAdaptiveEdging(start.targetEdges);
+        break;
+    case OrgasmControlAlgorithm::Mode::FORCED_ORGASM:
+        algorithm.startForcedOrgasm(start.targetOrgasms, durationMs);
+        break;
+    case OrgasmControlAlgorithm::Mode::DENIAL:
+        algorithm.startDenial(durationMs);
+        break;
+    case OrgasmControlAlgorithm::Mode::MILKING:
+        algorithm.startMilking(durationMs, start.milkingFailureMode);
+        break;
+    default:
+        qWarning() << "Recorded session mode" << start.mode << "cannot be started; skipped";
+        break;
+    }
+}
+
+// Replays inputPath into outputPath; returns the host time taken, or -1
+qint64 replay(const QString& inputPath, const QString& outputPath, const ReplayOptions& options)
+{
+    SessionRecordingReader input;
+    if (!input.open(inputPath)) {
+        qCritical() << "Cannot read recording:" << input.lastError();
+        return -1;
+    }
+
+    // Recorded times are the virtual time base, so replayed records line up
+    // with the ones they are compared against
+    int64_t virtualNs = input.startMonotonicNs();
+    auto clock = [&virtualNs]() { return virtualNs; };
+
+    // Declared before the hardware, which records into it until destroyed
+    SessionRecorder output;
+    output.setClock(clock);
+    if (!output.open(outputPath, qMax<qint64>(input.committedBytes() * 2, SessionRecorder::DEFAULT_INITIAL_BYTES))) {
+        qCritical() << "Cannot write replay:" << output.lastError();
+        return -1;
+    }
+
+    HardwareManager hardware;
+    hardware.setSimulationMode(true);
+    hardware.setSimulationManualClock(true);
+    if (!hardware.initialize()) {
+        qCritical() << "Simulated hardware failed to initialize:" << hardware.getLastError();
+        return -1;
+    }
+
+    ControlScheduler scheduler;
+    OrgasmControlAlgorithm algorithm(&hardware);
+    algorithm.attachToScheduler(&scheduler);
+    algorithm.setVirtualClock(clock);
+    algorithm.setSessionRecorder(&output);
+    hardware.setSessionRecorder(&output);
+
+    PatternEngine engine(&hardware);
+    if (!options.pattern.isEmpty()) {
+        engine.attachToScheduler(&scheduler);
+        engine.setVirtualClock(clock);
+    }
+    bool patternStarted = false;
+
+    const int64_t cycleNs = static_cast<int64_t>(scheduler.basePeriodMs()) * 1000000;
+    int64_t nextCycleNs = virtualNs;
+    auto advanceTo = [&](int64_t targetNs) {
+        while (nextCycleNs <= targetNs) {
+            virtualNs = nextCycleNs;
+            if (patternStarted) {
+                engine.runDueSteps();
+            }
+            scheduler.runCycle();
+            nextCycleNs += cycleNs;
+        }
+        virtualNs = std::max(virtualNs, targetNs);
+    };
+
+    QElapsedTimer host;
+    host.start();
+    for (auto record = input.first(); record.isValid(); record = input.next(record)) {
+        advanceTo(record.monotonicNs());
+
+        if (const SensorRecord* sensor = record.as<SensorRecord>()) {
+            hardware.setSimulatedSensorValues(sensor->avlPressure, sensor->tankPressure, sensor->clitoralPressure);
+            output.append(*sensor);     // The replay is a complete recording too
+        } else if (const SessionStartRecord* start = record.as<SessionStartRecord>()) {
+            applySessionStart(algorithm, *start, options);
+            if (!options.pattern.isEmpty() && !patternStarted) {
+                patternStarted = engine.startPattern(options.pattern, options.patternParameters);
+            }
+        }
+    }
+
+    algorithm.stop();
+    if (patternStarted) {
+        engine.stopPattern();
+    }
+    const qint64 hostNs = host.nsecsElapsed();
+    output.close();
+    return hostNs;
+}
+
+Comparison compare(const Timeline& recorded, const Timeline& replayed)
+{
+    Comparison result;
+
+    // Each replayed estimate against the recorded one nearest in time
+    int nearest = 0;
+    double sum = 0.0;
+    for (int i = 0; i < replayed.arousal.size() && !recorded.arousal.isEmpty(); ++i) {
+        const int64_t t = replayed.arousalNs[i];
+        while (nearest + 1 < recorded.arousalNs.size()
+               && std::llabs(recorded.arousalNs[nearest + 1] - t) <= std::llabs(recorded.arousalNs[nearest] - t)) {
+            nearest++;
+        }
+        const double diff = std::fabs(replayed.arousal[i] - recorded.arousal[nearest]);
+        sum += diff;
+        if (diff > result.maxArousalDiff) {
+            result.maxArousalDiff = diff;
+            result.maxArousalDiffNs = t;
+        }
+    }
+    if (!replayed.arousal.isEmpty()) {
+        result.meanArousalDiff = sum / replayed.arousal.size();
+    }
+
+    const int common = std::min(recorded.transitions.size(), replayed.transitions.size());
+    for (int i = 0; i < common; ++i) {
+        const TransitionRecord& a = recorded.transitions[i];
+        const TransitionRecord& b = replayed.transitions[i];
+        if (a.kind != b.kind || a.from != b.from || a.to != b.to) {
+            result.firstDivergence = i;
+            break;
+        }
+        result.maxTransitionShiftMs = std::max(result.maxTransitionShiftMs,
+            std::fabs(static_cast<double>(replayed.transitionNs[i] - recorded.transitionNs[i])) / 1.0e6);
+    }
+    if (result.firstDivergence < 0 && recorded.transitions.size() != replayed.transitions.size()) {
+        result.firstDivergence = common;
+    }
+    return result;
+}
+
+void writeReport(QTextStream& out, const Timeline& recorded, const Timeline& replayed,
+                 const Comparison& comparison, qint64 hostNs)
+{
+    const double sessionS = (recorded.endNs - recorded.startNs) / 1.0e9;
+    out << QString("recording: %1 s, %2 sensor snapshots, %3 sessions, %4 arousal estimates, %5 transitions\n")
+               .arg(sessionS, 0, 'f', 1)
+               .arg(recorded.sensorRecords)
+               .arg(recorded.sessions)
+               .arg(recorded.arousal.size())
+               .arg(recorded.transitions.size());
+    out << QString("replay:    %1 ms host (%2x real time), %3 arousal estimates, %4 transitions\n")
+               .arg(hostNs / 1.0e6, 0, 'f', 1)
+               .arg(hostNs > 0 ? sessionS * 1.0e9 / hostNs : 0.0, 0, 'f', 0)
+               .arg(replayed.arousal.size())
+               .arg(replayed.transitions.size());
+    out << QString("arousal:   mean |diff| %1, max |diff| %2 at %3 s\n")
+               .arg(comparison.meanArousalDiff, 0, 'f', 4)
+               .arg(comparison.maxArousalDiff, 0, 'f', 4)
+               .arg((comparison.maxArousalDiffNs - recorded.startNs) / 1.0e9, 0, 'f', 1);
+    out << QString("           arousal state changes %1 recorded, %2 replayed\n")
+               .arg(recorded.arousalTransitions)
+               .arg(replayed.arousalTransitions);
+
+    if (comparison.firstDivergence < 0) {
+        out << QString("transitions: identical, max time shift %1 ms\n").arg(comparison.maxTransitionShiftMs, 0, 'f', 1);
+        return;
+    }
+    const int i = comparison.firstDivergence;
+    out << QString("transitions: diverge at #%1\n").arg(i);
+    if (i < recorded.transitions.size()) {
+        out << QString("  recorded %1 at %2 s\n").arg(transitionName(recorded.transitions[i]))
+                   .arg((recorded.transitionNs[i] - recorded.startNs) / 1.0e9, 0, 'f', 2);
+    }
+    if (i < replayed.transitions.size()) {
+        out << QString("  replayed %1 at %2 s\n").arg(transitionName(replayed.transitions[i]))
+                   .arg((replayed.transitionNs[i] - recorded.startNs) / 1.0e9, 0, 'f', 2);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("session_replay");
+    qInstallMessageHandler(messageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replay a session recording through the control algorithm on virtual time.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("recording", "Session recording (.vcsr) to replay.");
+
+    QCommandLineOption outputOption({"o", "output"}, "Write the replay as a session recording.", "file");
+    QCommandLineOption edgeOption("edge-threshold", "Override the recorded edge threshold.", "value");
+    QCommandLineOption orgasmOption("orgasm-threshold", "Override the recorded orgasm threshold.", "value");
+    QCommandLineOption recoveryOption("recovery-threshold", "Override the recorded recovery threshold.", "value");
+    QCommandLineOption patternOption("pattern", "Also run this built-in pattern from the first session start.", "name");
+    QCommandLineOption toleranceOption("max-arousal-diff",
+                                       "Exit with 2 if the arousal estimate differs by more, or transitions differ.",
+                                       "value");
+    QCommandLineOption verboseOption("verbose", "Show algorithm debug output.");
+    parser.addOptions({outputOption, edgeOption, orgasmOption, recoveryOption, patternOption,
+                       toleranceOption, verboseOption});
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    const QString inputPath = parser.positionalArguments().first();
+
+    ReplayOptions options;
+    if (parser.isSet(edgeOption)) options.edgeThreshold = parser.value(edgeOption).toDouble();
+    if (parser.isSet(orgasmOption)) options.orgasmThreshold = parser.value(orgasmOption).toDouble();
+    if (parser.isSet(recoveryOption)) options.recoveryThreshold = parser.value(recoveryOption).toDouble();
+    if (parser.isSet(patternOption)) {
+        PatternDefinitions definitions;
+        definitions.loadDefaultPatterns();
+        options.pattern = parser.value(patternOption);
+        if (!definitions.getPatternNames().contains(options.pattern)) {
+            qCritical() << "Unknown pattern:" << options.pattern;
+            return 1;
+        }
+        const PatternDefinitions::PatternInfo info = definitions.getPattern(options.pattern);
+        options.patternParameters = info.parameters;
+        if (!options.patternParameters.contains("type")) options.patternParameters["type"] = info.type;
+    }
+
+    QTemporaryFile temporary(QDir::tempPath() + "/session_replay_XXXXXX.vcsr");
+    QString outputPath = parser.value(outputOption);
+    if (outputPath.isEmpty()) {
+        if (!temporary.open()) {
+            qCritical() << "Cannot create a temporary replay file";
+            return 1;
+        }
+        outputPath = temporary.fileName();
+    }
+
+    Timeline recorded;
+    QString error;
+    if (!readTimeline(inputPath, recorded, error)) {
+        qCritical() << "Cannot read recording:" << error;
+        return 1;
+    }
+    if (recorded.sessions == 0) {
+        qWarning() << "Recording has no session start; replaying sensor input only";
+    }
+
+    const qint64 hostNs = replay(inputPath, outputPath, options);
+    if (hostNs < 0) {
+        return 1;
+    }
+
+    Timeline replayed;
+    if (!readTimeline(outputPath, replayed, error)) {
+        qCritical() << "Cannot read replay:" << error;
+        return 1;
+    }
+
+    const Comparison comparison = compare(recorded, replayed);
+    QTextStream out(stdout);
+    writeReport(out, recorded, replayed, comparison, hostNs);
+    out.flush();
+
+    if (parser.isSet(toleranceOption)) {
+        const double tolerance = parser.value(toleranceOption).toDouble();
+        if (comparison.maxArousalDiff > tolerance || comparison.firstDivergence >= 0) {
+            return 2;
+        }
+    }
+    return 0;
+}